@@ -0,0 +1,230 @@
+// LZ decompression microbenchmarks: Decompressor::decompress_into (wide
+// match copies, bulk literal runs) vs. the original byte-at-a-time loop, on
+// compressed blocks built from synthetic page images. The benchmark argument
+// selects the corpus (0 = Table, 1 = Sparse, 2 = Text).
+
+#include "bakread/decompressor.h"
+#include "bakread/page.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace bakread;
+
+namespace {
+
+// -------------------------------------------------------------------------
+// Synthetic corpora (one 1MB block of 8KB pages each)
+//   Table:  data pages of fixed-width records with counters and names --
+//           mid-length matches at record-sized offsets, few literals
+//   Sparse: mostly empty pages -- long zero runs (offset-1 matches)
+//   Text:   pages of short words -- short matches and literal runs
+// -------------------------------------------------------------------------
+enum CorpusKind { Table = 0, Sparse = 1, Text = 2 };
+
+constexpr size_t BLOCK_SIZE = 128 * PAGE_SIZE;
+
+std::vector<uint8_t> make_input(int kind) {
+    std::vector<uint8_t> data(BLOCK_SIZE, 0);
+    uint32_t rng = 12345;
+    auto next = [&] { rng = rng * 1103515245u + 12345u; return rng >> 8; };
+
+    for (size_t p = 0; p < BLOCK_SIZE / PAGE_SIZE; ++p) {
+        uint8_t* page = data.data() + p * PAGE_SIZE;
+        PageHeader hdr{};
+        hdr.header_version = 1;
+        hdr.type = static_cast<uint8_t>(PageType::Data);
+        hdr.this_file = 1;
+        hdr.this_page = static_cast<uint32_t>(1000 + p);
+        hdr.obj_id = 77;
+
+        size_t pos = PAGE_HEADER_SIZE;
+        size_t fill = kind == Sparse ? PAGE_SIZE / 8 : PAGE_SIZE - 512;
+        uint32_t row = static_cast<uint32_t>(p * 100);
+        while (pos + 64 < fill) {
+            if (kind == Text) {
+                static const char* words[] = { "order ", "customer ", "shipped ", "pending ",
+                                               "invoice ", "the ", "of ", "returned " };
+                const char* w = words[next() % 8];
+                size_t n = std::strlen(w);
+                std::memcpy(page + pos, w, n);
+                pos += n;
+                if (next() % 5 == 0) page[pos++] = static_cast<uint8_t>('0' + next() % 10);
+                continue;
+            }
+            uint8_t rec[48] = { 0x30, 0, 40, 0 };
+            std::memcpy(rec + 4, &row, 4);
+            uint64_t amount = 1000 + next() % 50000;
+            std::memcpy(rec + 8, &amount, 8);
+            std::string name = "name-" + std::to_string(row);
+            std::memcpy(rec + 16, name.data(), std::min<size_t>(name.size(), 24));
+            std::memcpy(page + pos, rec, sizeof(rec));
+            pos += sizeof(rec);
+            ++row;
+        }
+        hdr.slot_count = static_cast<uint16_t>((pos - PAGE_HEADER_SIZE) / 48);
+        std::memcpy(page, &hdr, sizeof(hdr));
+    }
+    return data;
+}
+
+// Greedy single-candidate LZ encoder producing the format decompress_into
+// reads: a 32-bit flag word per 32 items, matches as (offset-1)<<3 | (len-3)
+// with the extended-length escapes
+std::vector<uint8_t> compress(const std::vector<uint8_t>& in) {
+    std::vector<uint8_t> out(sizeof(CompressedBlockHeader) + 4, 0);
+    std::vector<int64_t> table(1 << 16, -1);
+
+    size_t flag_pos = sizeof(CompressedBlockHeader);
+    uint32_t flags = 0;
+    int items = 0;
+    auto put16 = [&](uint16_t v) { out.push_back(v & 0xFF); out.push_back(v >> 8); };
+    auto end_item = [&](bool match) {
+        if (match) flags |= 1u << items;
+        if (++items == 32) {
+            std::memcpy(out.data() + flag_pos, &flags, 4);
+            flag_pos = out.size();
+            out.insert(out.end(), 4, 0);
+            flags = 0;
+            items = 0;
+        }
+    };
+
+    for (size_t i = 0; i < in.size();) {
+        size_t len = 0, off = 0;
+        if (i + 3 <= in.size()) {
+            uint32_t h = (in[i] | (in[i + 1] << 8) | (in[i + 2] << 16)) * 2654435761u >> 16;
+            int64_t cand = table[h];
+            table[h] = static_cast<int64_t>(i);
+            if (cand >= 0 && i - static_cast<size_t>(cand) <= 8192) {
+                off = i - static_cast<size_t>(cand);
+                while (i + len < in.size() && len < 65535 && in[cand + len] == in[i + len]) ++len;
+            }
+        }
+        if (len < 3) {
+            out.push_back(in[i++]);
+            end_item(false);
+            continue;
+        }
+        uint16_t v = static_cast<uint16_t>((off - 1) << 3);
+        if (len <= 9) {
+            put16(static_cast<uint16_t>(v | (len - 3)));
+        } else if (len <= 264) {
+            put16(static_cast<uint16_t>(v | 7));
+            out.push_back(static_cast<uint8_t>(len - 10));
+        } else {
+            put16(static_cast<uint16_t>(v | 7));
+            out.push_back(0xFF);
+            put16(static_cast<uint16_t>(len));
+        }
+        i += len;
+        end_item(true);
+    }
+    std::memcpy(out.data() + flag_pos, &flags, 4);
+
+    CompressedBlockHeader hdr{0xDAC0, sizeof(CompressedBlockHeader),
+                              static_cast<uint32_t>(out.size() - sizeof(hdr)),
+                              static_cast<uint32_t>(in.size())};
+    std::memcpy(out.data(), &hdr, sizeof(hdr));
+    return out;
+}
+
+// The decoder as it was before the fast path: one byte per iteration for
+// literals and matches alike
+size_t decompress_scalar(const uint8_t* block, size_t block_len, uint8_t* dst, size_t cap) {
+    CompressedBlockHeader hdr;
+    std::memcpy(&hdr, block, sizeof(hdr));
+    const uint8_t* src = block + hdr.header_size;
+    size_t src_len = block_len - hdr.header_size;
+
+    size_t si = 0, di = 0;
+    while (si < src_len && di < cap) {
+        if (si + 4 > src_len) break;
+        uint32_t flags;
+        std::memcpy(&flags, src + si, 4);
+        si += 4;
+        for (int bit = 0; bit < 32 && si < src_len && di < cap; ++bit) {
+            if (!(flags & (1u << bit))) { dst[di++] = src[si++]; continue; }
+            if (si + 2 > src_len) return di;
+            uint16_t info;
+            std::memcpy(&info, src + si, 2);
+            si += 2;
+            uint32_t off = (info >> 3) + 1, len = (info & 7) + 3;
+            if ((info & 7) == 7) {
+                if (si >= src_len) return di;
+                uint8_t extra = src[si++];
+                len = extra + 10;
+                if (extra == 0xFF) {
+                    if (si + 2 > src_len) return di;
+                    uint16_t ext16;
+                    std::memcpy(&ext16, src + si, 2);
+                    si += 2;
+                    len = ext16;
+                    if (len == 0) {
+                        if (si + 4 > src_len) return di;
+                        std::memcpy(&len, src + si, 4);
+                        si += 4;
+                    }
+                }
+            }
+            if (off > di) return 0;
+            for (uint32_t j = 0; j < len && di < cap; ++j) { dst[di] = dst[di - off]; ++di; }
+        }
+    }
+    return di;
+}
+
+struct Fixture {
+    std::vector<uint8_t> input;
+    std::vector<uint8_t> block;
+
+    explicit Fixture(int kind) : input(make_input(kind)), block(compress(input)) {}
+};
+
+const Fixture& fixture(int kind) {
+    static const Fixture fixtures[] = { Fixture(Table), Fixture(Sparse), Fixture(Text) };
+    return fixtures[kind];
+}
+
+void report(benchmark::State& state, const Fixture& f, size_t n) {
+    if (n != f.input.size()) state.SkipWithError("decompressed size mismatch");
+    state.SetBytesProcessed(state.iterations() * f.input.size());
+    state.counters["ratio"] = static_cast<double>(f.input.size()) / f.block.size();
+}
+
+}  // namespace
+
+// -------------------------------------------------------------------------
+// Benchmarks
+// -------------------------------------------------------------------------
+
+static void BM_LzDecompress_Fast(benchmark::State& state) {
+    const Fixture& f = fixture(static_cast<int>(state.range(0)));
+    Decompressor decomp;
+    std::vector<uint8_t> out(f.input.size());
+    size_t n = 0;
+    for (auto _ : state) {
+        n = decomp.decompress_into(f.block.data(), f.block.size(), out.data(), out.size());
+        benchmark::DoNotOptimize(out.data());
+    }
+    if (out != f.input) state.SkipWithError("output differs from input");
+    report(state, f, n);
+}
+BENCHMARK(BM_LzDecompress_Fast)->Arg(Table)->Arg(Sparse)->Arg(Text);
+
+static void BM_LzDecompress_Scalar(benchmark::State& state) {
+    const Fixture& f = fixture(static_cast<int>(state.range(0)));
+    std::vector<uint8_t> out(f.input.size());
+    size_t n = 0;
+    for (auto _ : state) {
+        n = decompress_scalar(f.block.data(), f.block.size(), out.data(), out.size());
+        benchmark::DoNotOptimize(out.data());
+    }
+    if (out != f.input) state.SkipWithError("output differs from input");
+    report(state, f, n);
+}
+BENCHMARK(BM_LzDecompress_Scalar)->Arg(Table)->Arg(Sparse)->Arg(Text);
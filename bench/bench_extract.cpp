@@ -0,0 +1,183 @@
+// End-to-end Mode A benchmarks over synthetic striped backups (see
+// bench_synthetic.h): header parse, catalog pass, data page pass and decode
+// of one table, with a fresh DirectExtractor and no catalog sidecar on every
+// iteration. Arguments are {stripes, table shape}; each backup holds two
+// tables of ROWS rows, and Bench2 is extracted.
+
+#include "bench_synthetic.h"
+
+#include "bakread/direct_extractor.h"
+#include "bakread/logging.h"
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace bakread;
+using namespace bakread::bench;
+
+namespace {
+
+constexpr int ROWS = 200000;
+constexpr int LOB_ROWS = 5000;   // Lob rows average ~12KB of off-row data
+
+// Generated backups, written once per {stripes, shape} and removed at exit
+class Backups {
+public:
+    Backups() {
+        Logger::instance().set_level(LogLevel::Error);
+        dir_ = std::filesystem::temp_directory_path() / "bakread_bench_backups";
+    }
+    ~Backups() {
+        std::error_code ec;
+        std::filesystem::remove_all(dir_, ec);
+    }
+
+    const std::vector<std::string>& get(int stripes, int kind) {
+        auto& paths = made_[{stripes, kind}];
+        if (paths.empty()) {
+            BackupTemplate t;
+            t.kind           = kind;
+            t.tables         = 2;
+            t.rows_per_table = (kind == Lob) ? LOB_ROWS : ROWS;
+            t.stripes        = stripes;
+            t.database       = "Bench_" + std::to_string(stripes) + "_" + std::to_string(kind);
+            paths = write_synthetic_backup(dir_.string(), t);
+        }
+        return paths;
+    }
+
+    std::string index_dir() const { return (dir_ / "index").string(); }
+
+private:
+    std::filesystem::path dir_;
+    std::map<std::pair<int, int>, std::vector<std::string>> made_;
+};
+
+Backups& backups() {
+    static Backups b;
+    return b;
+}
+
+int64_t stripe_bytes(const std::vector<std::string>& paths) {
+    int64_t total = 0;
+    for (const auto& p : paths) total += static_cast<int64_t>(std::filesystem::file_size(p));
+    return total;
+}
+
+DirectExtractorConfig bench_config() {
+    DirectExtractorConfig config;
+    config.catalog_cache = false;
+    return config;
+}
+
+void report(benchmark::State& state, const std::vector<std::string>& paths,
+            uint64_t rows) {
+    state.SetItemsProcessed(static_cast<int64_t>(rows));
+    state.SetBytesProcessed(state.iterations() * stripe_bytes(paths));
+}
+
+}  // namespace
+
+// -------------------------------------------------------------------------
+// Benchmarks
+// -------------------------------------------------------------------------
+
+static void BM_Extract_Rows(benchmark::State& state) {
+    const auto& paths = backups().get(static_cast<int>(state.range(0)),
+                                      static_cast<int>(state.range(1)));
+    uint64_t rows = 0;
+    for (auto _ : state) {
+        DirectExtractor extractor(paths, bench_config());
+        extractor.set_table("dbo", synthetic_table_name(1));
+        auto result = extractor.extract([&](const Row& row) {
+            benchmark::DoNotOptimize(row.data());
+            return true;
+        });
+        if (!result.success) {
+            state.SkipWithError(result.error_message.c_str());
+            break;
+        }
+        rows += result.rows_read;
+    }
+    report(state, paths, rows);
+}
+BENCHMARK(BM_Extract_Rows)
+    ->Args({1, Mixed})->Args({4, Mixed})->Args({1, Text})->Args({4, Text})->Args({1, Lob})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Columnar decode in the typed layout the Parquet writer takes
+static void BM_Extract_Columns(benchmark::State& state) {
+    const auto& paths = backups().get(static_cast<int>(state.range(0)),
+                                      static_cast<int>(state.range(1)));
+    uint64_t rows = 0;
+    for (auto _ : state) {
+        DirectExtractor extractor(paths, bench_config());
+        extractor.set_table("dbo", synthetic_table_name(1));
+        auto result = extractor.extract_columns([&](const ColumnBatch& batch) {
+            benchmark::DoNotOptimize(batch.num_rows());
+            return true;
+        }, ColumnLayout::Typed);
+        if (!result.success) {
+            state.SkipWithError(result.error_message.c_str());
+            break;
+        }
+        rows += result.rows_read;
+    }
+    report(state, paths, rows);
+}
+BENCHMARK(BM_Extract_Columns)
+    ->Args({1, Mixed})->Args({4, Mixed})->Args({1, Lob})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Indexed mode, rebuilding the page index on every iteration
+static void BM_Extract_Indexed(benchmark::State& state) {
+    const auto& paths = backups().get(static_cast<int>(state.range(0)),
+                                      static_cast<int>(state.range(1)));
+    DirectExtractorConfig config = bench_config();
+    config.use_indexed_mode = true;
+    config.index_dir        = backups().index_dir();
+    config.force_rescan     = true;
+
+    uint64_t rows = 0;
+    for (auto _ : state) {
+        DirectExtractor extractor(paths, config);
+        extractor.set_table("dbo", synthetic_table_name(1));
+        auto result = extractor.extract([&](const Row& row) {
+            benchmark::DoNotOptimize(row.data());
+            return true;
+        });
+        if (!result.success) {
+            state.SkipWithError(result.error_message.c_str());
+            break;
+        }
+        rows += result.rows_read;
+    }
+    report(state, paths, rows);
+}
+BENCHMARK(BM_Extract_Indexed)
+    ->Args({1, Mixed})->Args({4, Mixed})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Header parse and catalog pass only
+static void BM_Scan_ListTables(benchmark::State& state) {
+    const auto& paths = backups().get(static_cast<int>(state.range(0)),
+                                      static_cast<int>(state.range(1)));
+    for (auto _ : state) {
+        DirectExtractor extractor(paths, bench_config());
+        auto result = extractor.list_tables();
+        if (!result.success) {
+            state.SkipWithError(result.error_message.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(result.tables.size());
+    }
+    state.SetBytesProcessed(state.iterations() * stripe_bytes(paths));
+}
+BENCHMARK(BM_Scan_ListTables)
+    ->Args({1, Mixed})->Args({4, Mixed})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,100 @@
+// LRUPageCache microbenchmarks: hits, inserts under eviction, and the page
+// store's get-then-put pattern, each from 1..N threads sharing one cache so
+// shard lock contention shows up in the per-thread rates.
+
+#include "bakread/lru_cache.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace bakread;
+
+namespace {
+
+constexpr size_t CACHE_PAGES = 4096;
+
+// Page key of slot n, spread over a few files like a striped scan
+int64_t key_of(uint64_t n) {
+    return (static_cast<int64_t>(1 + n % 4) << 32) | static_cast<uint32_t>(n / 4);
+}
+
+// Per-thread xorshift, so threads do not walk the keys in lockstep
+struct KeyStream {
+    uint64_t s;
+    explicit KeyStream(int thread) : s(0x9E3779B97F4A7C15ull * (thread + 1)) {}
+    uint64_t next(uint64_t range) {
+        s ^= s << 13; s ^= s >> 7; s ^= s << 17;
+        return s % range;
+    }
+};
+
+std::vector<uint8_t> page_image() {
+    std::vector<uint8_t> page(LRUPageCache::PAGE_SIZE);
+    for (size_t i = 0; i < page.size(); ++i) page[i] = static_cast<uint8_t>(i * 31);
+    return page;
+}
+
+// Shared cache holding keys [0, CACHE_PAGES / 2), so every get() hits
+LRUPageCache& warm_cache() {
+    static LRUPageCache* cache = [] {
+        auto* c = new LRUPageCache(CACHE_PAGES);
+        auto page = page_image();
+        for (uint64_t n = 0; n < CACHE_PAGES / 2; ++n) c->put(key_of(n), page.data());
+        return c;
+    }();
+    return *cache;
+}
+
+}  // namespace
+
+// -------------------------------------------------------------------------
+// Benchmarks
+// -------------------------------------------------------------------------
+
+static void BM_LRUCache_GetHit(benchmark::State& state) {
+    LRUPageCache& cache = warm_cache();
+    KeyStream keys(state.thread_index());
+    std::vector<uint8_t> out(LRUPageCache::PAGE_SIZE);
+    for (auto _ : state) {
+        bool hit = cache.get(key_of(keys.next(CACHE_PAGES / 2)), out.data());
+        benchmark::DoNotOptimize(hit);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * LRUPageCache::PAGE_SIZE);
+}
+BENCHMARK(BM_LRUCache_GetHit)->ThreadRange(1, 8)->UseRealTime();
+
+// Every put() misses and evicts: the key space is 4x the capacity. The
+// argument is the CachePriority (0 = Normal, 2 = Probation).
+static void BM_LRUCache_PutEvict(benchmark::State& state) {
+    static LRUPageCache cache(CACHE_PAGES);
+    const auto priority = static_cast<CachePriority>(state.range(0));
+    const auto page = page_image();
+    KeyStream keys(state.thread_index());
+    for (auto _ : state) {
+        cache.put(key_of(keys.next(CACHE_PAGES * 4)), page.data(), priority);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LRUCache_PutEvict)
+    ->Arg(static_cast<int>(CachePriority::Normal))
+    ->Arg(static_cast<int>(CachePriority::Probation))
+    ->ThreadRange(1, 8)->UseRealTime();
+
+// Page store access: get, and put the page on a miss. The working set is
+// 1.5x the capacity, so hits and evictions mix.
+static void BM_LRUCache_GetOrPut(benchmark::State& state) {
+    static LRUPageCache cache(CACHE_PAGES);
+    const auto page = page_image();
+    std::vector<uint8_t> out(LRUPageCache::PAGE_SIZE);
+    KeyStream keys(state.thread_index());
+    for (auto _ : state) {
+        int64_t key = key_of(keys.next(CACHE_PAGES * 3 / 2));
+        if (!cache.get(key, out.data())) cache.put(key, page.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) state.counters["hit_rate"] = cache.hit_rate();
+}
+BENCHMARK(BM_LRUCache_GetOrPut)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,109 @@
+// PageIndex microbenchmarks: building-state inserts (single thread, and
+// concurrent writers on the sharded maps), seal(), and lookups against the
+// building maps vs. the sealed sorted arrays.
+
+#include "bakread/page_index.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace bakread;
+
+namespace {
+
+// Entry for page n of a 4-stripe backup whose tables own 64-page runs
+PageIndexEntry entry_of(uint32_t n) {
+    PageIndexEntry e{};
+    e.stripe_index = static_cast<uint8_t>(n % 4);
+    e.page_type    = static_cast<uint8_t>(IndexedPageType::Data);
+    e.object_id    = 100 + n / 64;
+    e.file_offset  = static_cast<uint64_t>(n / 4 + 1) * 8192;
+    return e;
+}
+
+void fill(PageIndex& index, uint32_t pages) {
+    for (uint32_t n = 0; n < pages; ++n) {
+        index.add_entry(1, static_cast<int32_t>(n), entry_of(n));
+    }
+}
+
+// Shared 1M-page index, sealed or still building
+PageIndex& filled_index(bool sealed) {
+    constexpr uint32_t PAGES = 1 << 20;
+    static PageIndex* building = [] { auto* i = new PageIndex; fill(*i, PAGES); return i; }();
+    static PageIndex* frozen   = [] { auto* i = new PageIndex; fill(*i, PAGES); i->seal(); return i; }();
+    return sealed ? *frozen : *building;
+}
+
+}  // namespace
+
+// -------------------------------------------------------------------------
+// Benchmarks
+// -------------------------------------------------------------------------
+
+static void BM_PageIndex_Insert(benchmark::State& state) {
+    const uint32_t pages = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        PageIndex index;
+        fill(index, pages);
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(state.iterations() * pages);
+}
+BENCHMARK(BM_PageIndex_Insert)->Arg(1 << 14)->Arg(1 << 18);
+
+// Scan threads inserting into one index: each thread owns a key range, so
+// only the per-map mutexes are contended
+static void BM_PageIndex_InsertContended(benchmark::State& state) {
+    static PageIndex index;
+    const int32_t file = state.thread_index() + 1;
+    uint32_t n = 0;
+    for (auto _ : state) {
+        index.add_entry(file, static_cast<int32_t>(n & 0xFFFF), entry_of(n));
+        ++n;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PageIndex_InsertContended)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_PageIndex_Seal(benchmark::State& state) {
+    const uint32_t pages = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        PageIndex index;
+        fill(index, pages);
+        state.ResumeTiming();
+        index.seal();
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(state.iterations() * pages);
+}
+BENCHMARK(BM_PageIndex_Seal)->Arg(1 << 14)->Arg(1 << 18);
+
+static void BM_PageIndex_Lookup(benchmark::State& state) {
+    const PageIndex& index = filled_index(state.range(0) != 0);
+    uint64_t s = 0x9E3779B97F4A7C15ull * (state.thread_index() + 1);
+    PageIndexEntry e;
+    for (auto _ : state) {
+        s ^= s << 13; s ^= s >> 7; s ^= s << 17;
+        bool found = index.lookup(1, static_cast<int32_t>(s & ((1 << 20) - 1)), e);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PageIndex_Lookup)->Arg(0)->Arg(1)->ThreadRange(1, 8)->UseRealTime();
+
+// One table's page list, as collect_candidate_pages() asks for it
+static void BM_PageIndex_PagesByObject(benchmark::State& state) {
+    const PageIndex& index = filled_index(state.range(0) != 0);
+    uint32_t obj = 100;
+    for (auto _ : state) {
+        auto keys = index.get_pages_by_object(obj);
+        benchmark::DoNotOptimize(keys.data());
+        obj = 100 + (obj - 99) % 1024;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PageIndex_PagesByObject)->Arg(0)->Arg(1);
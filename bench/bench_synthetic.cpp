@@ -0,0 +1,565 @@
+#include "bench_synthetic.h"
+
+#include "bakread/backup_stream.h"
+#include "bakread/error.h"
+#include "bakread/page.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace bakread {
+namespace bench {
+
+TableSchema make_schema(int kind) {
+    TableSchema s;
+    s.schema_name = "dbo";
+    s.table_name  = "Bench";
+
+    auto add = [&](const char* name, SqlType t, int16_t len,
+                   uint8_t prec = 0, uint8_t scale = 0) {
+        ColumnDef c;
+        c.column_id  = static_cast<int32_t>(s.columns.size()) + 1;
+        c.name       = name;
+        c.type       = t;
+        c.max_length = len;
+        c.precision  = prec;
+        c.scale      = scale;
+        s.columns.push_back(c);
+    };
+    if (kind == Mixed) {
+        add("Id",      SqlType::Int,       4);
+        add("Qty",     SqlType::BigInt,    8);
+        add("Created", SqlType::DateTime,  8);
+        add("Price",   SqlType::Decimal,   9, 18, 2);
+        add("Active",  SqlType::Bit,       1);
+        add("RowGuid", SqlType::UniqueId, 16);
+        add("Name",    SqlType::NVarChar, 100);
+        add("Note",    SqlType::VarChar,  100);
+    } else if (kind == Numeric) {
+        add("Id",      SqlType::Int,       4);
+        add("Qty",     SqlType::BigInt,    8);
+        add("Flags",   SqlType::SmallInt,  2);
+        add("Ratio",   SqlType::Float,     8);
+        add("Active",  SqlType::Bit,       1);
+        add("Code",    SqlType::VarChar,  20);
+    } else if (kind == Lob) {
+        add("Id",   SqlType::Int,       4);
+        add("Body", SqlType::NVarChar, -1);
+        add("Doc",  SqlType::NText,    16);
+        add("Code", SqlType::VarChar,  20);
+    } else {
+        add("Id",        SqlType::Int,       4);
+        add("FirstName", SqlType::NVarChar, 100);
+        add("LastName",  SqlType::NVarChar, 100);
+        add("Email",     SqlType::NVarChar, 200);
+        add("City",      SqlType::NVarChar, 100);
+        add("Code",      SqlType::VarChar,   20);
+    }
+    return s;
+}
+
+// -------------------------------------------------------------------------
+// Off-row values
+// -------------------------------------------------------------------------
+
+namespace {
+
+using PageList = std::vector<std::pair<int32_t, std::vector<uint8_t>>>;
+
+constexpr size_t LOB_RECORD_HEADER = 14;     // Record header, blob id, type
+constexpr size_t LOB_FRAGMENT      = 8040;   // Data bytes per DATA record
+constexpr size_t LOB_SMALL_ROOT    = 1000;   // Text values up to this are one SMALL_ROOT
+
+// Packs LOB records into the TextMix pages of one allocation unit, taking
+// page ids from next_page and appending each page to `pages` when started
+class LobPageWriter {
+public:
+    LobPageWriter(uint32_t obj_id, int32_t& next_page, PageList& pages)
+        : obj_id_(obj_id), next_page_(next_page), pages_(pages) {}
+
+    // MAX value: DATA fragments and the in-row root linking them
+    // (12-byte header, then {cumulative size, row id} per fragment)
+    std::vector<uint8_t> inline_root(const std::vector<uint8_t>& value) {
+        std::vector<uint8_t> root(12, 0);
+        root[0] = 2;
+        for (size_t off = 0; off < value.size(); off += LOB_FRAGMENT)
+            append_link(root, data_fragment(value, off), std::min(value.size(), off + LOB_FRAGMENT));
+        return root;
+    }
+
+    // TEXT/NTEXT/IMAGE value: a SMALL_ROOT, or a LARGE_ROOT_YUKON over DATA
+    // fragments, behind a 16-byte text pointer {timestamp, row id}
+    std::vector<uint8_t> text_pointer(const std::vector<uint8_t>& value) {
+        std::vector<uint8_t> root_id;
+        if (value.size() <= LOB_SMALL_ROOT) {
+            auto rec = record(0, 6 + value.size());
+            uint16_t size = static_cast<uint16_t>(value.size());
+            std::memcpy(rec.data() + 14, &size, 2);
+            std::memcpy(rec.data() + 20, value.data(), value.size());
+            root_id = add(rec);
+        } else {
+            std::vector<uint8_t> links;
+            uint16_t count = 0;
+            for (size_t off = 0; off < value.size(); off += LOB_FRAGMENT, ++count)
+                append_link(links, data_fragment(value, off), std::min(value.size(), off + LOB_FRAGMENT));
+            auto rec = record(5, 10 + links.size());
+            uint16_t max_links = 5;
+            std::memcpy(rec.data() + 14, &max_links, 2);
+            std::memcpy(rec.data() + 16, &count, 2);
+            std::memcpy(rec.data() + 24, links.data(), links.size());
+            root_id = add(rec);
+        }
+        std::vector<uint8_t> ptr(8, 0);
+        ptr.insert(ptr.end(), root_id.begin(), root_id.end());
+        return ptr;
+    }
+
+private:
+    // LOB record of `type` with body_len bytes after the 14-byte header
+    std::vector<uint8_t> record(uint16_t type, size_t body_len) {
+        std::vector<uint8_t> rec(LOB_RECORD_HEADER + body_len, 0);
+        rec[0] = 0x08;   // Blob fragment
+        uint16_t len = static_cast<uint16_t>(rec.size());
+        std::memcpy(rec.data() + 2, &len, 2);
+        int64_t blob_id = ++blob_id_;
+        std::memcpy(rec.data() + 4, &blob_id, 8);
+        std::memcpy(rec.data() + 12, &type, 2);
+        return rec;
+    }
+
+    std::vector<uint8_t> data_fragment(const std::vector<uint8_t>& value, size_t off) {
+        size_t n = std::min(LOB_FRAGMENT, value.size() - off);
+        auto rec = record(3, n);
+        std::memcpy(rec.data() + LOB_RECORD_HEADER, value.data() + off, n);
+        return add(rec);
+    }
+
+    static void append_link(std::vector<uint8_t>& out, const std::vector<uint8_t>& row_id,
+                            size_t end) {
+        uint32_t size = static_cast<uint32_t>(end);
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&size);
+        out.insert(out.end(), p, p + 4);
+        out.insert(out.end(), row_id.begin(), row_id.end());
+    }
+
+    // Store a record; returns its row id {page (4), file (2), slot (2)}
+    std::vector<uint8_t> add(const std::vector<uint8_t>& rec) {
+        if (!page_ || pos_ + rec.size() + 2 * (slots_ + 1) > PAGE_SIZE) start_page();
+
+        std::memcpy(page_ + pos_, rec.data(), rec.size());
+        uint16_t off = static_cast<uint16_t>(pos_);
+        std::memcpy(page_ + PAGE_SIZE - 2 * (slots_ + 1), &off, 2);
+        pos_ += rec.size();
+        uint16_t slot = slots_++;
+
+        PageHeader hdr;
+        std::memcpy(&hdr, page_, sizeof(hdr));
+        hdr.slot_count = slots_;
+        hdr.free_data  = static_cast<uint16_t>(pos_);
+        hdr.free_count = static_cast<uint16_t>(PAGE_SIZE - 2 * slots_ - pos_);
+        std::memcpy(page_, &hdr, sizeof(hdr));
+
+        std::vector<uint8_t> row_id(8);
+        uint16_t file_id = 1;
+        std::memcpy(row_id.data(), &page_id_, 4);
+        std::memcpy(row_id.data() + 4, &file_id, 2);
+        std::memcpy(row_id.data() + 6, &slot, 2);
+        return row_id;
+    }
+
+    void start_page() {
+        page_id_ = next_page_++;
+        pages_.emplace_back(page_id_, std::vector<uint8_t>(PAGE_SIZE));
+        page_ = pages_.back().second.data();   // Heap buffer: stable while pages_ grows
+        pack_page(page_, static_cast<uint8_t>(PageType::TextMix), 1,
+                  static_cast<uint32_t>(page_id_), obj_id_, 0, 0, nullptr);
+        pos_   = PAGE_HEADER_SIZE;
+        slots_ = 0;
+    }
+
+    uint32_t  obj_id_;
+    int32_t&  next_page_;
+    PageList& pages_;
+    uint8_t*  page_ = nullptr;
+    int32_t   page_id_ = 0;
+    size_t    pos_ = 0;
+    uint16_t  slots_ = 0;
+    int64_t   blob_id_ = 0;
+};
+
+// Text of an off-row column for row i: the column name, the row number and
+// a non-BMP character (a surrogate pair in UTF-16) repeated to `chars`
+std::string lob_text(const ColumnDef& col, int i, size_t chars) {
+    std::string unit = col.name + " " + std::to_string(i) + " \xF0\x9F\x98\x80 ";
+    std::string text;
+    while (text.size() < chars) text += unit;
+    return text;
+}
+
+// UTF-8 -> UTF-16LE for the synthetic text (ASCII and 4-byte sequences)
+std::vector<uint8_t> to_utf16(const std::string& text) {
+    std::vector<uint8_t> out;
+    for (size_t k = 0; k < text.size();) {
+        uint32_t cp = static_cast<uint8_t>(text[k]);
+        if (cp >= 0xF0 && k + 3 < text.size()) {
+            cp = ((cp & 0x07) << 18) | ((text[k + 1] & 0x3F) << 12) |
+                 ((text[k + 2] & 0x3F) << 6) | (text[k + 3] & 0x3F);
+            k += 4;
+            uint32_t v = cp - 0x10000;
+            uint16_t units[2] = { static_cast<uint16_t>(0xD800 + (v >> 10)),
+                                  static_cast<uint16_t>(0xDC00 + (v & 0x3FF)) };
+            for (uint16_t u : units) {
+                out.push_back(static_cast<uint8_t>(u));
+                out.push_back(static_cast<uint8_t>(u >> 8));
+            }
+            continue;
+        }
+        out.push_back(static_cast<uint8_t>(cp));
+        out.push_back(0);
+        ++k;
+    }
+    return out;
+}
+
+}  // namespace
+
+// Record for row i; with `lobs`, MAX and TEXT/NTEXT/IMAGE columns get long
+// values stored off-row and the record holds their pointers
+static std::vector<uint8_t> make_record(const TableSchema& schema, int i, LobPageWriter* lobs) {
+    std::vector<uint8_t> rec = {
+        RecordStatus::HasNullBitmap | RecordStatus::HasVarColumns, 0, 0, 0
+    };
+
+    std::vector<const ColumnDef*> var_cols;
+    for (auto& col : schema.columns) {
+        if (!is_fixed_length(col.type)) { var_cols.push_back(&col); continue; }
+        uint32_t seed = static_cast<uint32_t>(i) * 2654435761u + col.column_id;
+        for (int b = 0; b < col.max_length; ++b)
+            rec.push_back(static_cast<uint8_t>(seed >> ((b % 4) * 8)));
+        if (col.type == SqlType::DateTime) {
+            int32_t days = 45000 + i % 1000, ticks = (i * 977) % (300 * 86400);
+            std::memcpy(&rec[rec.size() - 8], &days, 4);
+            std::memcpy(&rec[rec.size() - 4], &ticks, 4);
+        }
+    }
+    uint16_t fixed_end = static_cast<uint16_t>(rec.size());
+    std::memcpy(&rec[2], &fixed_end, 2);
+
+    uint16_t ncols = static_cast<uint16_t>(schema.columns.size());
+    bool last_null = (i % 7) == 0;
+    rec.push_back(static_cast<uint8_t>(ncols));
+    rec.push_back(static_cast<uint8_t>(ncols >> 8));
+    std::vector<uint8_t> bitmap((ncols + 7) / 8, 0);
+    if (last_null) bitmap[(ncols - 1) / 8] |= static_cast<uint8_t>(1u << ((ncols - 1) % 8));
+    rec.insert(rec.end(), bitmap.begin(), bitmap.end());
+
+    std::vector<std::vector<uint8_t>> values;
+    std::vector<bool> complex;
+    for (auto* col : var_cols) {
+        const bool max_type = col->max_length == -1;
+        if (lobs && (max_type || is_lob(col->type))) {
+            size_t chars = max_type ? 300 + static_cast<size_t>(i % 8) * 1200
+                         : (i % 3 == 0) ? 40 : 2000 + static_cast<size_t>(i % 4) * 1500;
+            std::string text = lob_text(*col, i, chars);
+            std::vector<uint8_t> v = is_unicode(col->type)
+                ? to_utf16(text) : std::vector<uint8_t>(text.begin(), text.end());
+            values.push_back(max_type ? lobs->inline_root(v) : lobs->text_pointer(v));
+            complex.push_back(max_type);
+            continue;
+        }
+        std::string text = (col == &schema.columns.back() && last_null)
+            ? std::string() : col->name + " " + std::to_string(i);
+        std::vector<uint8_t> v;
+        for (char c : text) {
+            v.push_back(static_cast<uint8_t>(c));
+            if (is_unicode(col->type)) v.push_back(0);
+        }
+        values.push_back(std::move(v));
+        complex.push_back(false);
+    }
+
+    uint16_t nvar = static_cast<uint16_t>(var_cols.size());
+    rec.push_back(static_cast<uint8_t>(nvar));
+    rec.push_back(static_cast<uint8_t>(nvar >> 8));
+    size_t end = rec.size() + 2 * nvar;
+    for (size_t v = 0; v < values.size(); ++v) {
+        end += values[v].size();
+        uint16_t stored = static_cast<uint16_t>(end | (complex[v] ? 0x8000 : 0));
+        rec.push_back(static_cast<uint8_t>(stored));
+        rec.push_back(static_cast<uint8_t>(stored >> 8));
+    }
+    for (auto& v : values) rec.insert(rec.end(), v.begin(), v.end());
+    return rec;
+}
+
+std::vector<uint8_t> make_record(const TableSchema& schema, int i) {
+    return make_record(schema, i, nullptr);
+}
+
+int pack_page(uint8_t* page, uint8_t type, uint16_t file_id, uint32_t page_id,
+              uint32_t obj_id, int first, int end,
+              const std::function<std::vector<uint8_t>(int)>& make) {
+    std::memset(page, 0, PAGE_SIZE);
+
+    size_t pos = PAGE_HEADER_SIZE;
+    uint16_t slots = 0;
+    int i = first;
+    for (; i < end; ++i) {
+        auto rec = make(i);
+        size_t slot_array_start = PAGE_SIZE - 2 * (slots + 1);
+        if (pos + rec.size() > slot_array_start) break;
+        std::memcpy(page + pos, rec.data(), rec.size());
+        uint16_t off = static_cast<uint16_t>(pos);
+        std::memcpy(page + slot_array_start, &off, 2);
+        pos += rec.size();
+        ++slots;
+    }
+
+    PageHeader hdr{};
+    hdr.header_version = 1;
+    hdr.type       = type;
+    hdr.slot_count = slots;
+    hdr.obj_id     = obj_id;
+    hdr.free_data  = static_cast<uint16_t>(pos);
+    hdr.free_count = static_cast<uint16_t>(PAGE_SIZE - 2 * slots - pos);
+    hdr.this_page  = page_id;
+    hdr.this_file  = file_id;
+    std::memcpy(page, &hdr, sizeof(hdr));
+    return i;
+}
+
+std::vector<uint8_t> make_page(const TableSchema& schema) {
+    std::vector<uint8_t> page(PAGE_SIZE);
+    pack_page(page.data(), static_cast<uint8_t>(PageType::Data), 1, 0, 0, 0, INT_MAX,
+              [&](int i) { return make_record(schema, i); });
+    return page;
+}
+
+std::string synthetic_table_name(int t) {
+    return "Bench" + std::to_string(t + 1);
+}
+
+// -------------------------------------------------------------------------
+// Catalog rows
+// -------------------------------------------------------------------------
+
+namespace {
+
+// Page header obj_ids of the system tables Mode A parses
+constexpr uint32_t OBJ_SYSSCHOBJS    = 34;
+constexpr uint32_t OBJ_SYSCOLPARS    = 41;
+constexpr uint32_t OBJ_SYSROWSETS    = 5;
+constexpr uint32_t OBJ_SYSALLOCUNITS = 7;
+
+constexpr int32_t  BOOT_PAGE_ID      = 9;
+constexpr int32_t  FIRST_CATALOG_PAGE = 16;
+constexpr int32_t  FIRST_DATA_PAGE   = 1024;   // Above the catalog page limit
+constexpr int      EXTENT_PAGES      = 8;
+
+// Table t: object_id, heap rowset (hobt) id, and the page header obj_ids of
+// its in-row and LOB allocation units (auid = obj_id << 16)
+int32_t  table_object_id(int t) { return 1977058079 + t; }
+int64_t  table_hobt_id(int t)   { return 72057594043105280LL + (static_cast<int64_t>(t) << 16); }
+uint32_t table_page_obj(int t)  { return 200u + static_cast<uint32_t>(t); }
+uint32_t table_lob_obj(int t)   { return 400u + static_cast<uint32_t>(t); }
+
+template <class T>
+void put(std::vector<uint8_t>& rec, size_t off, T value) {
+    std::memcpy(rec.data() + off, &value, sizeof(value));
+}
+
+// Finish a catalog row whose fixed region is rec[0, rec.size()): status
+// bits and fixed_end, a null bitmap over ncols (no NULLs), and -- when given
+// -- the UTF-16 name as the only variable-length column
+std::vector<uint8_t> catalog_record(std::vector<uint8_t> rec, uint16_t ncols,
+                                    const std::string& name = "") {
+    rec[0] = RecordStatus::PrimaryRecord | RecordStatus::HasNullBitmap |
+             (name.empty() ? 0 : RecordStatus::HasVarColumns);
+    put<uint16_t>(rec, 2, static_cast<uint16_t>(rec.size()));
+
+    rec.push_back(static_cast<uint8_t>(ncols));
+    rec.push_back(static_cast<uint8_t>(ncols >> 8));
+    rec.insert(rec.end(), (ncols + 7) / 8, 0);
+    if (name.empty()) return rec;
+
+    uint16_t name_end = static_cast<uint16_t>(rec.size() + 4 + 2 * name.size());
+    rec.push_back(1);
+    rec.push_back(0);
+    rec.push_back(static_cast<uint8_t>(name_end));
+    rec.push_back(static_cast<uint8_t>(name_end >> 8));
+    for (char c : name) {
+        rec.push_back(static_cast<uint8_t>(c));
+        rec.push_back(0);
+    }
+    return rec;
+}
+
+// sysschobjs: id @4, nsid @8, nsclass @12, status @13, type char(2) @17
+std::vector<uint8_t> object_row(int32_t id, const std::string& name) {
+    std::vector<uint8_t> rec(25, 0);
+    put<int32_t>(rec, 4, id);
+    put<int32_t>(rec, 8, 1);            // dbo
+    rec[17] = 'U';
+    rec[18] = ' ';
+    return catalog_record(std::move(rec), 13, name);
+}
+
+// syscolpars: id @4, number @8, colid @10, xtype @14, utype @15,
+// length @19, prec @21, scale @22
+std::vector<uint8_t> column_row(int32_t id, const ColumnDef& col) {
+    std::vector<uint8_t> rec(31, 0);
+    put<int32_t>(rec, 4, id);
+    put<int32_t>(rec, 10, col.column_id);
+    rec[14] = static_cast<uint8_t>(col.type);
+    put<int32_t>(rec, 15, static_cast<int32_t>(col.type));
+    put<int16_t>(rec, 19, col.max_length);
+    rec[21] = col.precision;
+    rec[22] = col.scale;
+    return catalog_record(std::move(rec), 18, col.name);
+}
+
+// sysrowsets: rowsetid @4, ownertype @12, idmajor @13, idminor @17
+std::vector<uint8_t> rowset_row(int64_t hobt, int32_t object_id) {
+    std::vector<uint8_t> rec(25, 0);
+    put<int64_t>(rec, 4, hobt);
+    rec[12] = 1;
+    put<int32_t>(rec, 13, object_id);
+    put<int32_t>(rec, 17, 0);           // heap
+    return catalog_record(std::move(rec), 9);
+}
+
+// sysallocunits: auid @4, type @12 (1 = in-row, 2 = LOB), ownerid @13.
+// No page pointers, so the table's pages are found by header obj_id.
+std::vector<uint8_t> allocunit_row(uint32_t page_obj, int64_t hobt, uint8_t type = 1) {
+    std::vector<uint8_t> rec(21, 0);
+    put<int64_t>(rec, 4, static_cast<int64_t>(page_obj) << 16);
+    rec[12] = type;
+    put<int64_t>(rec, 13, hobt);
+    return catalog_record(std::move(rec), 9);
+}
+
+// MTF TAPE block at 0 and an SSET at 1024 whose description names the
+// database, padded to one page; Mode A scans pages from the next 8KB
+std::vector<uint8_t> header_region(const std::string& database) {
+    std::vector<uint8_t> region(PAGE_SIZE, 0);
+
+    MtfTapeHeader tape{};
+    tape.common.block_type = static_cast<uint32_t>(MtfBlockType::TAPE);
+    tape.media_family_id = 1;
+    tape.media_sequence_number = 1;
+    std::memcpy(region.data(), &tape, sizeof(tape));
+
+    MtfStartOfSet sset{};
+    sset.common.block_type = static_cast<uint32_t>(MtfBlockType::SSET);
+    sset.data_set_number = 1;
+    std::memcpy(region.data() + 1024, &sset, sizeof(sset));
+
+    std::string desc = database + "-Full Database Backup";
+    size_t off = 1024 + 64;
+    for (char c : desc) {
+        region[off++] = static_cast<uint8_t>(c);
+        region[off++] = 0;
+    }
+    return region;
+}
+
+}  // namespace
+
+// -------------------------------------------------------------------------
+// Backup layout
+// -------------------------------------------------------------------------
+
+std::vector<std::string> write_synthetic_backup(const std::string& dir,
+                                                const BackupTemplate& tmpl) {
+    namespace fs = std::filesystem;
+    const TableSchema schema = make_schema(tmpl.kind);
+    const int stripes = std::max(1, tmpl.stripes);
+
+    // Catalog rows of every table
+    std::vector<std::vector<uint8_t>> objects, columns, rowsets, allocunits;
+    for (int t = 0; t < tmpl.tables; ++t) {
+        objects.push_back(object_row(table_object_id(t), synthetic_table_name(t)));
+        for (const auto& col : schema.columns)
+            columns.push_back(column_row(table_object_id(t), col));
+        rowsets.push_back(rowset_row(table_hobt_id(t), table_object_id(t)));
+        allocunits.push_back(allocunit_row(table_page_obj(t), table_hobt_id(t)));
+        if (tmpl.kind == Lob)
+            allocunits.push_back(allocunit_row(table_lob_obj(t), table_hobt_id(t), 2));
+    }
+
+    // File 1 in page order: (page id, image)
+    PageList pages;
+    auto add_page = [&](int32_t page_id) -> uint8_t* {
+        pages.emplace_back(page_id, std::vector<uint8_t>(PAGE_SIZE));
+        return pages.back().second.data();
+    };
+
+    pack_page(add_page(BOOT_PAGE_ID), static_cast<uint8_t>(PageType::Boot),
+              1, BOOT_PAGE_ID, 0, 0, 0, nullptr);
+
+    int32_t next_page = FIRST_CATALOG_PAGE;
+    auto add_catalog = [&](uint32_t obj_id, const std::vector<std::vector<uint8_t>>& rows) {
+        int n = static_cast<int>(rows.size());
+        for (int i = 0; i < n;) {
+            int32_t id = next_page++;
+            i = pack_page(add_page(id), static_cast<uint8_t>(PageType::Data), 1, id,
+                          obj_id, i, n, [&](int r) { return rows[r]; });
+        }
+    };
+    add_catalog(OBJ_SYSSCHOBJS, objects);
+    add_catalog(OBJ_SYSCOLPARS, columns);
+    add_catalog(OBJ_SYSROWSETS, rowsets);
+    add_catalog(OBJ_SYSALLOCUNITS, allocunits);
+    if (next_page >= FIRST_DATA_PAGE) {
+        throw BakReadError("Synthetic backup template has too many catalog rows");
+    }
+
+    next_page = FIRST_DATA_PAGE;
+    for (int t = 0; t < tmpl.tables; ++t) {
+        // Off-row values are written once, ahead of the data pages: pack_page
+        // may build a record twice when it does not fit on a page
+        std::vector<std::vector<uint8_t>> lob_records;
+        if (tmpl.kind == Lob) {
+            LobPageWriter lobs(table_lob_obj(t), next_page, pages);
+            for (int i = 0; i < tmpl.rows_per_table; ++i)
+                lob_records.push_back(make_record(schema, i, &lobs));
+        }
+        for (int row = 0; row < tmpl.rows_per_table;) {
+            int32_t id = next_page++;
+            row = pack_page(add_page(id), static_cast<uint8_t>(PageType::Data), 1, id,
+                            table_page_obj(t), row, tmpl.rows_per_table,
+                            [&](int i) {
+                                return lob_records.empty() ? make_record(schema, i)
+                                                           : lob_records[i];
+                            });
+        }
+    }
+
+    // Extents go round-robin over the stripes, the way a striped backup
+    // spreads its writes
+    fs::create_directories(dir);
+    const std::vector<uint8_t> header = header_region(tmpl.database);
+    std::vector<std::string> paths;
+    std::vector<std::ofstream> files;
+    for (int s = 0; s < stripes; ++s) {
+        paths.push_back((fs::path(dir) / (tmpl.database + "_" + std::to_string(s + 1) + ".bak")).string());
+        files.emplace_back(paths.back(), std::ios::binary | std::ios::trunc);
+        if (!files.back()) throw FileIOError("Cannot create " + paths.back());
+        files.back().write(reinterpret_cast<const char*>(header.data()), header.size());
+    }
+    for (const auto& [page_id, image] : pages) {
+        auto& out = files[(page_id / EXTENT_PAGES) % stripes];
+        out.write(reinterpret_cast<const char*>(image.data()), image.size());
+    }
+    for (size_t s = 0; s < files.size(); ++s) {
+        files[s].close();
+        if (!files[s]) throw FileIOError("Cannot write " + paths[s]);
+    }
+    return paths;
+}
+
+}  // namespace bench
+}  // namespace bakread
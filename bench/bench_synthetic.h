@@ -0,0 +1,78 @@
+#pragma once
+
+// Synthetic data for the benchmarks: table shapes, FixedVar records, packed
+// data pages, and whole striped .bak files generated from a template that
+// Mode A can scan and extract end to end.
+
+#include "bakread/types.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bakread {
+namespace bench {
+
+// -------------------------------------------------------------------------
+// Table shapes
+//   Mixed:   Id INT, Qty BIGINT, Created DATETIME, Price DECIMAL(18,2),
+//            Active BIT, RowGuid UNIQUEIDENTIFIER, Name NVARCHAR(50),
+//            Note VARCHAR(100)
+//   Numeric: Id INT, Qty BIGINT, Flags SMALLINT, Ratio FLOAT, Active BIT,
+//            Code VARCHAR(20) -- cheap cells, so per-cell overhead dominates
+//   Text:    Id INT, FirstName/LastName/Email/City NVARCHAR, Code
+//            VARCHAR(20) -- variable-length and UTF-16 heavy
+//   Lob:     Id INT, Body NVARCHAR(MAX), Doc NTEXT, Code VARCHAR(20) --
+//            in a synthetic backup, Body and Doc are stored off-row
+//            (0.6-17KB and up to 13KB) and reached through LOB pages
+// -------------------------------------------------------------------------
+enum SchemaKind { Mixed = 0, Numeric = 1, Text = 2, Lob = 3 };
+
+TableSchema make_schema(int kind);
+
+// One FixedVar record for row i. Fixed columns get deterministic bytes of
+// their declared width; the last column is NULL on every 7th row.
+std::vector<uint8_t> make_record(const TableSchema& schema, int i);
+
+// Pack make(first), make(first + 1), ... into the 8KB page at `page` until
+// it is full or `end` is reached, with a header naming the page (file_id,
+// page_id) and its allocation unit (obj_id). Returns the index of the first
+// record that did not fit.
+int pack_page(uint8_t* page, uint8_t type, uint16_t file_id, uint32_t page_id,
+              uint32_t obj_id, int first, int end,
+              const std::function<std::vector<uint8_t>(int)>& make);
+
+// As many rows of `schema` as fit into one data page
+std::vector<uint8_t> make_page(const TableSchema& schema);
+
+// -------------------------------------------------------------------------
+// Synthetic backups
+//
+// A template describes the database: `tables` heaps dbo.Bench1..BenchN of
+// one shape with rows_per_table rows each. write_synthetic_backup() lays out
+// file 1 the way Mode A reads it -- boot page, catalog pages (sysschobjs,
+// syscolpars, sysrowsets, sysallocunits) below page 1000, then the data
+// pages -- and deals its extents round-robin over `stripes` files, each
+// behind an MTF TAPE/SSET header region. No IAM pages are written, so the
+// data pages are found by their header obj_id. Off-row values of the Lob
+// shape go to TextMix pages of a LOB_DATA allocation unit per table.
+// -------------------------------------------------------------------------
+struct BackupTemplate {
+    std::string database       = "BenchDb";
+    int         kind           = Mixed;
+    int         tables         = 1;
+    int         rows_per_table = 100000;
+    int         stripes        = 1;
+};
+
+// Write the stripes into dir as <database>_<n>.bak and return their paths
+// in order. Throws FileIOError if a file cannot be written.
+std::vector<std::string> write_synthetic_backup(const std::string& dir,
+                                                const BackupTemplate& tmpl);
+
+// Name of table t (0-based) in a synthetic backup
+std::string synthetic_table_name(int t);
+
+}  // namespace bench
+}  // namespace bakread
@@ -0,0 +1,111 @@
+// Export writer microbenchmarks: one iteration opens a file in the system
+// temp directory, writes BATCHES batches of rows decoded from a synthetic
+// Mixed page, and closes it. Writers that accept columns are also fed
+// ColumnBatches in their own layout. The argument is the OutputFormat.
+
+#include "bench_synthetic.h"
+
+#include "bakread/column_batch.h"
+#include "bakread/export_writer.h"
+#include "bakread/row_batch.h"
+#include "bakread/row_decoder.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace bakread;
+using namespace bakread::bench;
+
+namespace {
+
+constexpr int BATCHES = 16;
+
+struct Fixture {
+    TableSchema          schema;
+    std::vector<uint8_t> page;
+    RowBatch             rows;
+
+    Fixture() : schema(make_schema(Mixed)), page(make_page(schema)) {
+        RowDecoder decoder(schema);
+        std::vector<Row> decoded;
+        decoder.decode_page(page.data(), decoded);
+        rows = RowBatch(decoded.size());
+        for (auto& r : decoded) rows.add(std::move(r));
+    }
+};
+
+const Fixture& fixture() {
+    static const Fixture f;
+    return f;
+}
+
+std::string output_path(OutputFormat format) {
+    static const char* const ext[] = { "csv", "parquet", "jsonl" };
+    auto dir = std::filesystem::temp_directory_path();
+    return (dir / ("bakread_bench_writer." + std::string(ext[static_cast<int>(format)]))).string();
+}
+
+}  // namespace
+
+// -------------------------------------------------------------------------
+// Benchmarks
+// -------------------------------------------------------------------------
+
+static void BM_Writer_Rows(benchmark::State& state) {
+    const Fixture& f = fixture();
+    const auto format = static_cast<OutputFormat>(state.range(0));
+    const std::string path = output_path(format);
+    for (auto _ : state) {
+        auto writer = create_writer(format);
+        if (!writer->open(path, f.schema)) {
+            state.SkipWithError("cannot open output file");
+            break;
+        }
+        for (int b = 0; b < BATCHES; ++b) writer->write_batch(f.rows);
+        writer->close();
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * BATCHES * f.rows.size());
+}
+BENCHMARK(BM_Writer_Rows)
+    ->Arg(static_cast<int>(OutputFormat::CSV))
+    ->Arg(static_cast<int>(OutputFormat::JSONL))
+#ifdef BAKREAD_HAS_PARQUET
+    ->Arg(static_cast<int>(OutputFormat::Parquet))
+#endif
+    ;
+
+// Columnar input (Parquet is the only writer that takes it)
+#ifdef BAKREAD_HAS_PARQUET
+static void BM_Writer_Columns(benchmark::State& state) {
+    const Fixture& f = fixture();
+    const auto format = static_cast<OutputFormat>(state.range(0));
+    const std::string path = output_path(format);
+
+    auto probe = create_writer(format);
+    if (!probe->accepts_columns()) {
+        state.SkipWithError("writer does not accept columns");
+        return;
+    }
+    RowDecoder decoder(f.schema);
+    ColumnBatch batch(f.schema, probe->column_layout());
+    decoder.decode_page_columnar(f.page.data(), batch);
+
+    for (auto _ : state) {
+        auto writer = create_writer(format);
+        if (!writer->open(path, f.schema)) {
+            state.SkipWithError("cannot open output file");
+            break;
+        }
+        for (int b = 0; b < BATCHES; ++b) writer->write_columns(batch);
+        writer->close();
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * BATCHES * batch.num_rows());
+}
+BENCHMARK(BM_Writer_Columns)->Arg(static_cast<int>(OutputFormat::Parquet));
+#endif
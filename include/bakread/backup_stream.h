@@ -1,5 +1,6 @@
 #pragma once
 
+#include "bakread/mapped_stripe.h"
 #include "bakread/types.h"
 
 #include <cstdint>
@@ -85,10 +86,17 @@ struct SqlBackupMediaHeader {
 
 // -------------------------------------------------------------------------
 // BackupStream -- streaming reader for .bak files
+//
+// By default the file is memory-mapped and reads are served straight from
+// the mapping; read_view() hands out pointers into it with no copy. If the
+// mapping cannot be created (or use_mmap is false) the stream falls back
+// to a buffered ifstream.
 // -------------------------------------------------------------------------
 class BackupStream {
 public:
-    explicit BackupStream(const std::string& path, size_t buffer_size = 4 * 1024 * 1024);
+    explicit BackupStream(const std::string& path,
+                          size_t buffer_size = 4 * 1024 * 1024,
+                          bool use_mmap = true);
     ~BackupStream();
 
     BackupStream(const BackupStream&) = delete;
@@ -114,12 +122,25 @@ public:
     // Read raw bytes into a vector
     std::vector<uint8_t> read_bytes(size_t count);
 
+    // Zero-copy read: returns a pointer to up to `count` bytes at the
+    // current position and advances past them. When the stream is mapped
+    // the pointer refers into the mapping; otherwise the bytes are read
+    // into `scratch` (which must hold `count` bytes) and scratch is returned.
+    const uint8_t* read_view(size_t count, size_t& got, uint8_t* scratch);
+
+    // True when reads are served from a memory mapping
+    bool is_mapped() const { return map_ != nullptr; }
+
+    // Underlying mapping (nullptr when not mapped)
+    const MappedStripe* mapping() const { return map_.get(); }
+
     // Progress
     double progress_pct() const;
 
 private:
     void refill();
 
+    std::unique_ptr<MappedStripe> map_;
     std::ifstream file_;
     uint64_t      file_size_   = 0;
     uint64_t      logical_pos_ = 0;
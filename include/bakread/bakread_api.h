@@ -10,6 +10,7 @@
 #   define BAKREAD_API __attribute__((visibility("default")))
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -98,8 +99,8 @@ typedef struct BakTableInfoData {
     const char* table_name;
     const char* full_name;
     int32_t object_id;
-    int64_t row_count;
-    int64_t page_count;
+    int64_t row_count;      // Estimate from data page headers; -1 = unknown (needs indexed mode)
+    int64_t page_count;     // Pages of all allocation units; -1 = unknown (needs indexed mode)
 } BakTableInfoData;
 
 // Column info structure
@@ -164,6 +165,52 @@ typedef void (*BakProgressCallback)(uint64_t bytes_processed, uint64_t bytes_tot
 // Row callback - return 0 to continue, non-zero to stop
 typedef int (*BakRowCallback)(const char** values, int column_count, void* user_data);
 
+// Arrow C Data Interface (https://arrow.apache.org/docs/format/CDataInterface.html)
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+// Batch callback - one struct array ("+s") per batch, one child per output
+// column: bit-packed validity, then int8..int64 / float / double values,
+// or int32 offsets + bytes for strings ("u") and binary ("z"). Temporal,
+// decimal and GUID columns arrive as formatted strings. Both structs and
+// every buffer they point to are owned by the library and valid only until
+// the callback returns (release() is a no-op); pyarrow can import them
+// with RecordBatch._import_from_c and consume them inside the callback.
+// Return 0 to continue, non-zero to stop.
+typedef int (*BakBatchCallback)(const struct ArrowSchema* schema, const struct ArrowArray* batch,
+                                void* user_data);
+
 // -------------------------------------------------------------------------
 // API Functions
 // -------------------------------------------------------------------------
@@ -177,6 +224,12 @@ BAKREAD_API void bakread_close(HBakReader handle);
 // Get the last error message
 BAKREAD_API const char* bakread_get_error(HBakReader handle);
 
+// Telemetry of the last extraction or export on the handle (stage timings,
+// scan and cache counters, queue stalls) as a JSON document, the same one
+// --stats-json writes. The string is owned by the handle and valid until
+// the next bakread_get_stats or bakread_close call.
+BAKREAD_API BakReadResult bakread_get_stats(HBakReader handle, const char** out_json);
+
 // Get backup info
 BAKREAD_API BakReadResult bakread_get_info(HBakReader handle, BakBackupInfo* out_info);
 
@@ -190,8 +243,17 @@ BAKREAD_API void bakread_free_table_list(BakTableInfoData* tables, int count);
 BAKREAD_API BakReadResult bakread_set_table(HBakReader handle, const char* schema, const char* table);
 BAKREAD_API BakReadResult bakread_set_columns(HBakReader handle, const char** columns, int column_count);
 BAKREAD_API BakReadResult bakread_set_max_rows(HBakReader handle, int64_t max_rows);
+// Row filter evaluated during decoding (see --where; NULL or "" = all rows)
+BAKREAD_API BakReadResult bakread_set_where(HBakReader handle, const char* condition);
 BAKREAD_API BakReadResult bakread_set_indexed_mode(HBakReader handle, int enabled, size_t cache_mb);
+BAKREAD_API BakReadResult bakread_set_decode_workers(HBakReader handle, int workers, int preserve_order);
 BAKREAD_API BakReadResult bakread_set_progress_callback(HBakReader handle, BakProgressCallback cb, void* user_data);
+// Parquet tuning for bakread_export_parquet (see --row-group-rows, --compression,
+// --dictionary, --parquet-threads). row_group_rows <= 0 and NULL strings keep
+// the defaults; dictionary is "all", "none" or a comma-separated column list
+BAKREAD_API BakReadResult bakread_set_parquet_options(HBakReader handle, int64_t row_group_rows,
+                                                      const char* codec, int codec_level,
+                                                      const char* dictionary, int use_threads);
 
 // Get table schema (after setting table)
 BAKREAD_API BakReadResult bakread_get_schema(HBakReader handle, BakColumnInfo** out_columns, int* out_count);
@@ -200,19 +262,39 @@ BAKREAD_API void bakread_free_schema(BakColumnInfo* columns, int count);
 // Extract rows using callback
 BAKREAD_API BakReadResult bakread_extract(HBakReader handle, BakRowCallback callback, void* user_data, uint64_t* out_row_count);
 
-// Streaming row extraction - initialize extraction
+// Extract rows as columnar batches (no per-cell formatting of numbers)
+BAKREAD_API BakReadResult bakread_extract_batches(HBakReader handle, BakBatchCallback callback, void* user_data, uint64_t* out_row_count);
+
+// Streaming row extraction - start the extraction on a background thread,
+// which fills a bounded queue of row batches. Don't call other functions
+// on the handle until bakread_end_extract (progress callbacks run on that
+// thread).
 BAKREAD_API BakReadResult bakread_begin_extract(HBakReader handle);
 
 // Streaming row extraction - get next row (returns values as strings)
-// Returns BAKREAD_OK if row available, BAKREAD_ERROR_NO_MORE_ROWS when done
+// Returns BAKREAD_OK if row available, BAKREAD_ERROR_NO_MORE_ROWS when done,
+// or the extraction's error code if it failed. Values stay valid until the
+// next bakread_next_row / bakread_next_batch / bakread_end_extract call.
 BAKREAD_API BakReadResult bakread_next_row(HBakReader handle, const char*** out_values, int* out_column_count);
 
-// End extraction and cleanup
+// Streaming row extraction - get the next run of rows at once, as
+// row_count * column_count values in row-major order (same return codes
+// and lifetime as bakread_next_row)
+BAKREAD_API BakReadResult bakread_next_batch(HBakReader handle, const char*** out_values,
+                                             int* out_row_count, int* out_column_count);
+
+// End extraction and cleanup (stops the background thread if still running)
 BAKREAD_API void bakread_end_extract(HBakReader handle);
 
-// Export directly to file
+// Export directly to file with the library's threaded writer pipeline (same
+// writers as the CLI; the progress callback is honoured). JSON output is
+// JSON Lines. Parquet needs a build with Apache Arrow.
 BAKREAD_API BakReadResult bakread_export_csv(HBakReader handle, const char* output_path, const char* delimiter);
 BAKREAD_API BakReadResult bakread_export_json(HBakReader handle, const char* output_path);
+BAKREAD_API BakReadResult bakread_export_parquet(HBakReader handle, const char* output_path);
+
+// Rows written by the last export call
+BAKREAD_API uint64_t bakread_get_export_row_count(HBakReader handle);
 
 // -------------------------------------------------------------------------
 // Module (Stored Procedures, Functions, Views) API
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "bakread/page.h"
+#include "bakread/page_store.h"
 #include "bakread/types.h"
 
 #include <cstdint>
@@ -113,12 +114,33 @@ struct SystemAllocationUnit {
 using PageProvider = std::function<bool(int32_t file_id, int32_t page_id,
                                         uint8_t* page_buf)>;
 
+// Zero-copy variant: returns a pointer to the 8KB page (valid at least until
+// the next call), or nullptr if the page cannot be served without a copy.
+using PageViewProvider = std::function<const uint8_t*(int32_t file_id,
+                                                      int32_t page_id)>;
+
+// Header metadata of a page without reading it (page index, page store).
+// Returns false if the page is not in the backup. slot_count may be any
+// nonzero value when the source does not record it.
+using PageMetaProvider = std::function<bool(int32_t file_id, int32_t page_id,
+                                            PageMeta& meta)>;
+
 class CatalogReader {
 public:
-    explicit CatalogReader(PageProvider provider);
+    // Catalog scans only look at pages [1, CATALOG_PAGE_LIMIT) of this file
+    // (module text up to MODULE_PAGE_LIMIT)
+    static constexpr int32_t CATALOG_FILE_ID    = 1;
+    static constexpr int32_t CATALOG_PAGE_LIMIT = 1000;
+    static constexpr int32_t MODULE_PAGE_LIMIT  = 2000;   // sysobjvalues reaches further
+
+    explicit CatalogReader(PageProvider provider,
+                           PageViewProvider view_provider = nullptr,
+                           PageMetaProvider meta_provider = nullptr);
 
     // Scan system catalog pages to build metadata.
-    // This reads the boot page and follows references to system tables.
+    // This reads the boot page, then sweeps the catalog pages once: each
+    // page is fetched at most once (pages the meta provider rules out not
+    // at all) and handed to the parser of the system table it belongs to.
     bool scan_catalog();
 
     // Resolve a table by schema + name
@@ -141,27 +163,61 @@ public:
     // Get all database permissions
     std::vector<SystemPermission> list_permissions() const;
 
-    // Get allocation info for a table (which pages contain its data)
+    // Get allocation info for a table (which pages contain its data): its
+    // heap/clustered allocation units, in-row data, LOB and row-overflow
     std::vector<SystemAllocationUnit> get_allocation_units(int32_t object_id) const;
 
     // Get IAM chain for a specific allocation unit
     std::vector<PageId> get_iam_chain(const PageId& first_iam) const;
 
+    // Every page the unit's IAM chain allocates (single-page slots and
+    // uniform extents), sorted by file and page. Empty without an IAM.
+    std::vector<PageId> get_allocated_pages(const SystemAllocationUnit& au) const;
+
     // Get the page header m_objId value for a given object_id.
     // Returns 0 if not found.
     uint32_t get_page_obj_id(int32_t object_id) const;
 
+    // Page header m_objId values of the table's LOB_DATA and
+    // ROW_OVERFLOW_DATA allocation units (the pages off-row values live on);
+    // empty if it has none
+    std::vector<uint32_t> get_lob_page_obj_ids(int32_t object_id) const;
+
+    // Persist the resolved catalog (objects, columns, indexes, allocation
+    // units, modules, security tables, obj_id mapping) as a binary sidecar.
+    // identity ties the file to one backup: load_from_file() rejects a file
+    // written for anything else, and leaves the reader empty on failure.
+    bool save_to_file(const std::string& path, uint64_t identity) const;
+    bool load_from_file(const std::string& path, uint64_t identity);
+
 private:
+    // System table pages gathered by the catalog sweep: copies of the data
+    // pages of each parsed system table, by page header obj_id
+    class SystemPages {
+    public:
+        void add(uint32_t obj_id, const uint8_t* page);
+        std::vector<const uint8_t*> of(uint32_t obj_id) const;
+        size_t size() const { return count_; }
+
+    private:
+        std::unordered_map<uint32_t, std::vector<uint8_t>> pages_;   // concatenated 8KB pages
+        size_t count_ = 0;
+    };
+
+    // One pass over file 1: IAM chain heads go straight to the allocation
+    // unit list, system table pages into the returned buckets
+    SystemPages sweep_catalog_pages();
+
     bool read_boot_page();
-    bool scan_system_objects();
-    bool scan_system_columns();
+    bool scan_system_objects(const SystemPages& pages);
+    bool scan_system_columns(const SystemPages& pages);
     bool scan_system_indexes();
-    bool scan_system_allocation_units();
-    bool scan_rowset_allocunit_mapping();
-    bool scan_module_definitions();
-    bool scan_principals();
-    bool scan_role_members();
-    bool scan_permissions();
+    void add_iam_page(int32_t page_id, const uint8_t* page);
+    bool scan_rowset_allocunit_mapping(const SystemPages& pages);
+    bool scan_module_definitions(const SystemPages& pages);
+    bool scan_principals(const SystemPages& pages);
+    bool scan_role_members(const SystemPages& pages);
+    bool scan_permissions(const SystemPages& pages);
 
     // Extract system table rows from a known set of pages
     void scan_pages_for_objects(int32_t start_page, int32_t file_id);
@@ -170,13 +226,25 @@ private:
     // System schema IDs -> names (e.g., 1 -> "dbo")
     std::string schema_name_for_id(int32_t schema_id) const;
 
+    // Visit every persisted member in file order (Self is const for saving)
+    template <typename IO, typename Self>
+    static void persist_members(IO& io, Self& self);
+
+    // Fetch a page, preferring a view; copies into scratch only on fallback.
+    // Returns nullptr if the page is not available.
+    const uint8_t* fetch_page(int32_t file_id, int32_t page_id,
+                              uint8_t* scratch) const;
+
     PageProvider page_provider_;
+    PageViewProvider view_provider_;
+    PageMetaProvider meta_provider_;
 
     // Discovered system metadata
     std::unordered_map<int32_t, SystemObject>  objects_;   // by object_id
     std::unordered_map<int32_t, std::vector<SystemColumn>> columns_;  // by object_id
     std::unordered_map<int32_t, std::vector<SystemIndex>>  indexes_;  // by object_id
-    std::vector<SystemAllocationUnit> alloc_units_;
+    std::vector<SystemAllocationUnit> alloc_units_;   // Heads of IAM chains (catalog pages)
+    std::unordered_map<int32_t, std::vector<SystemAllocationUnit>> object_alloc_units_;  // by object_id
     std::unordered_map<int32_t, std::string> schema_names_;  // schema_id -> name
 
     // Modules (procedures, functions, views)
@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace bakread {
@@ -11,6 +12,9 @@ namespace bakread {
 struct Options {
     // Required (one or more .bak files for striped backups)
     std::vector<std::string> bak_paths;
+    // Differential backups of the same database, layered over the full
+    // backup in direct mode (the newest copy of each page wins)
+    std::vector<std::string> diff_paths;
     std::string  table_qualified;   // "schema.table"
     std::string  output_path;
     OutputFormat format = OutputFormat::CSV;
@@ -19,6 +23,12 @@ struct Options {
     std::string  schema_name = "dbo";
     std::string  table_name;
 
+    // Multi-table mode (--tables): one backup pass, one output file per
+    // table. output_path is then a directory, or a template in which
+    // {table} is replaced by schema.table.
+    std::vector<std::string> tables_qualified;
+    std::vector<std::pair<std::string, std::string>> tables;   // (schema, table)
+
     // Mode
     ExecMode     mode = ExecMode::Auto;
 
@@ -32,6 +42,7 @@ struct Options {
     // Logging
     bool         verbose       = false;
     std::string  log_file;
+    std::string  stats_json;    // Per-stage telemetry report (JSON); empty = none
 
     // Special modes
     bool         print_data_offset = false;  // Parse backup and print data region offset, then exit
@@ -45,6 +56,40 @@ struct Options {
     size_t       cache_size_mb = 256;        // LRU cache size in MB (default 256MB = 32K pages)
     std::string  index_dir;                  // Directory for index files (empty = auto)
     bool         force_rescan = false;       // Ignore existing index files
+    bool         catalog_cache = true;       // Reuse/persist the catalog sidecar (--no-catalog-cache disables)
+
+    // I/O
+    bool         use_mmap = true;            // Memory-map backup files (--no-mmap disables)
+    size_t       readahead_depth = 4;        // Scan read-ahead buffers in flight
+    size_t       readahead_mb = 4;           // Size of each read-ahead buffer in MB
+    bool         direct_io = false;          // Unbuffered scan reads (--direct-io)
+    size_t       memory_budget_mb = 512;     // Resident page budget in direct mode
+    std::string  spill_dir;                  // Spill directory when over budget (empty = temp)
+    size_t       lob_cache_mb = 64;          // LOB page cache for off-row values (0 = placeholders)
+
+    // Parallel decode (direct mode)
+    int          workers = 0;                // Decode threads (0 = hardware threads)
+    bool         preserve_order = true;      // Keep page order (--unordered disables)
+
+    // Partitioned output: output_path is a directory of part-NNNNN.<ext>
+    // files plus _manifest.json
+    size_t       writers = 1;                // Writer threads, one open part file each
+    uint64_t     split_rows = 0;             // Start a new part after this many rows (0 = never)
+
+    // Parquet tuning (row group size, codec, dictionary, encode threads)
+    ParquetOptions parquet;
+
+    // Restore mode: concurrent range queries over the restored table
+    int          restore_queries = 1;
+
+    // Restore mode: RESTORE tuning and file placement, and keeping the
+    // restored database for later runs on the same backup set
+    int          restore_buffer_count = 0;         // BUFFERCOUNT (0 = server default)
+    int          restore_max_transfer = 0;         // MAXTRANSFERSIZE in bytes (0 = server default)
+    std::vector<std::string> restore_data_dirs;    // Data files round-robin across these
+    std::string  restore_log_dir;
+    bool         keep_restored_db = false;
+    bool         reuse_restored_db = false;        // Set per table by multi-table runs
 
     // SQL Server Authentication
     std::string  sql_username;       // SQL login (if not using Windows Auth)
@@ -64,8 +109,16 @@ struct Options {
     // Validate options and set defaults
     void validate() const;
 
-    // Parse schema.table into schema_name / table_name
+    // Parse schema.table into schema_name / table_name (and each entry
+    // of tables_qualified into tables)
     void resolve_table_name();
+
+    // Output file (or part directory, when partitioned) for one table of
+    // a multi-table run
+    std::string table_output_path(const std::string& schema, const std::string& table) const;
+
+    // True if rows are written to several part files (--writers / --split-rows)
+    bool partitioned() const { return writers > 1 || split_rows > 0; }
 };
 
 Options parse_args(int argc, char* argv[]);
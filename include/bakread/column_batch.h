@@ -0,0 +1,250 @@
+#pragma once
+
+#include "bakread/types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace bakread {
+
+// -------------------------------------------------------------------------
+// Physical storage class of an output column (what the columnar decoder
+// writes and what the Parquet/Arrow schema is built from)
+// -------------------------------------------------------------------------
+enum class ColumnKind : uint8_t {
+    Bool,
+    Int8,
+    Int16,
+    Int32,
+    Int64,
+    Float32,
+    Float64,
+    Utf8,      // variable-length text (also formatted temporal/decimal/guid)
+    Binary,    // variable-length bytes
+
+    // Typed layout only (see ColumnLayout)
+    Decimal128,    // 16-byte little-endian two's complement unscaled value
+    Uuid,          // 16 GUID bytes in RFC 4122 (display) order
+    Date32,        // int32 days since 1970-01-01
+    TimestampUs,   // int64 microseconds since 1970-01-01 (UTC for datetimeoffset)
+    Time64Us,      // int64 microseconds since midnight
+};
+
+// -------------------------------------------------------------------------
+// How the columnar decoder stores decimal, GUID and date/time columns:
+// as the text the row writers print, or as typed binary values for
+// writers with native types for them (Parquet)
+// -------------------------------------------------------------------------
+enum class ColumnLayout : uint8_t {
+    Text,
+    Typed,
+};
+
+inline ColumnKind column_kind_for(SqlType t, ColumnLayout layout = ColumnLayout::Text) {
+    if (layout == ColumnLayout::Typed) {
+        switch (t) {
+            case SqlType::Decimal:
+            case SqlType::Numeric:        return ColumnKind::Decimal128;
+            case SqlType::UniqueId:       return ColumnKind::Uuid;
+            case SqlType::Date:           return ColumnKind::Date32;
+            case SqlType::DateTime:
+            case SqlType::SmallDateTime:
+            case SqlType::DateTime2:
+            case SqlType::DateTimeOffset: return ColumnKind::TimestampUs;
+            case SqlType::Time:           return ColumnKind::Time64Us;
+            default:                      break;
+        }
+    }
+    switch (t) {
+        case SqlType::Bit:        return ColumnKind::Bool;
+        case SqlType::TinyInt:    return ColumnKind::Int8;
+        case SqlType::SmallInt:   return ColumnKind::Int16;
+        case SqlType::Int:        return ColumnKind::Int32;
+        case SqlType::BigInt:     return ColumnKind::Int64;
+        case SqlType::Real:       return ColumnKind::Float32;
+        case SqlType::Float:
+        case SqlType::Money:
+        case SqlType::SmallMoney: return ColumnKind::Float64;
+        case SqlType::Binary:
+        case SqlType::VarBinary:
+        case SqlType::Image:
+        case SqlType::Timestamp:  return ColumnKind::Binary;
+        default:                  return ColumnKind::Utf8;
+    }
+}
+
+// Bytes per value for fixed-width kinds (0 for variable-length kinds)
+inline size_t column_kind_width(ColumnKind k) {
+    switch (k) {
+        case ColumnKind::Bool:
+        case ColumnKind::Int8:    return 1;
+        case ColumnKind::Int16:   return 2;
+        case ColumnKind::Int32:
+        case ColumnKind::Float32: return 4;
+        case ColumnKind::Int64:
+        case ColumnKind::Float64: return 8;
+        case ColumnKind::Date32:  return 4;
+        case ColumnKind::TimestampUs:
+        case ColumnKind::Time64Us:   return 8;
+        case ColumnKind::Decimal128:
+        case ColumnKind::Uuid:       return 16;
+        default:                  return 0;
+    }
+}
+
+// -------------------------------------------------------------------------
+// ColumnBuffer -- one column of a ColumnBatch
+//
+// Arrow-compatible layout: one validity byte per row, packed fixed-width
+// values, or int32 offsets (size + 1 entries) into a contiguous data buffer
+// for variable-length kinds. clear() keeps all capacity.
+// -------------------------------------------------------------------------
+struct ColumnBuffer {
+    ColumnKind            kind = ColumnKind::Utf8;
+    size_t                width = 0;
+    std::vector<uint8_t>  validity;   // 1 = value present, 0 = NULL
+    std::vector<uint8_t>  values;     // fixed-width kinds
+    std::vector<int32_t>  offsets;    // variable-length kinds
+    std::vector<char>     data;       // variable-length kinds
+
+    bool is_variable() const { return width == 0; }
+
+    void clear() {
+        validity.clear();
+        values.clear();
+        data.clear();
+        offsets.assign(1, 0);
+    }
+
+    void append_null() {
+        validity.push_back(0);
+        if (is_variable()) {
+            offsets.push_back(static_cast<int32_t>(data.size()));
+        } else {
+            values.resize(values.size() + width, 0);
+        }
+    }
+
+    template <typename T>
+    void append_fixed(T v) {
+        validity.push_back(1);
+        size_t pos = values.size();
+        values.resize(pos + sizeof(T));
+        std::memcpy(values.data() + pos, &v, sizeof(T));
+    }
+
+    // One fixed-width value of `width` bytes (Decimal128, Uuid)
+    void append_fixed_bytes(const uint8_t* p) {
+        validity.push_back(1);
+        values.insert(values.end(), p, p + width);
+    }
+
+    void append_bytes(const void* p, size_t len) {
+        validity.push_back(1);
+        const char* c = static_cast<const char*>(p);
+        data.insert(data.end(), c, c + len);
+        offsets.push_back(static_cast<int32_t>(data.size()));
+    }
+
+    // Reserve max_len bytes at the end of data for an in-place write;
+    // finish with commit_var(actual_len)
+    char* begin_var(size_t max_len) {
+        size_t pos = data.size();
+        data.resize(pos + max_len);
+        return data.data() + pos;
+    }
+
+    void commit_var(size_t reserved, size_t used) {
+        data.resize(data.size() - reserved + used);
+        validity.push_back(1);
+        offsets.push_back(static_cast<int32_t>(data.size()));
+    }
+
+    // A value that arrives in pieces (off-row LOB data): append_part() or
+    // begin_var() + end_part() per piece, then commit_parts(). A value
+    // abandoned halfway is dropped with discard_parts(start), start being
+    // data.size() before its first piece.
+    void append_part(const void* p, size_t len) {
+        const char* c = static_cast<const char*>(p);
+        data.insert(data.end(), c, c + len);
+    }
+
+    void end_part(size_t reserved, size_t used) {
+        data.resize(data.size() - reserved + used);
+    }
+
+    void commit_parts() {
+        validity.push_back(1);
+        offsets.push_back(static_cast<int32_t>(data.size()));
+    }
+
+    void discard_parts(size_t start) { data.resize(start); }
+
+    // Drop rows beyond n
+    void truncate(size_t n) {
+        if (n >= validity.size()) return;
+        validity.resize(n);
+        if (is_variable()) {
+            offsets.resize(n + 1);
+            data.resize(static_cast<size_t>(offsets.back()));
+        } else {
+            values.resize(n * width);
+        }
+    }
+};
+
+// -------------------------------------------------------------------------
+// ColumnBatch -- a block of decoded rows stored column by column
+//
+// Filled by RowDecoder::decode_page_columnar() without building a Row or a
+// std::string per cell; consumed by IExportWriter::write_columns().
+// -------------------------------------------------------------------------
+class ColumnBatch {
+public:
+    ColumnBatch() = default;
+    explicit ColumnBatch(const TableSchema& schema,
+                         ColumnLayout layout = ColumnLayout::Text) { reset(schema, layout); }
+
+    // Set up one buffer per schema column (drops existing data)
+    void reset(const TableSchema& schema, ColumnLayout layout = ColumnLayout::Text) {
+        layout_ = layout;
+        columns_.assign(schema.columns.size(), ColumnBuffer{});
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            columns_[i].kind  = column_kind_for(schema.columns[i].type, layout);
+            columns_[i].width = column_kind_width(columns_[i].kind);
+            columns_[i].clear();
+        }
+        rows_ = 0;
+    }
+
+    // Empty all columns; capacity is kept
+    void clear() {
+        for (auto& c : columns_) c.clear();
+        rows_ = 0;
+    }
+
+    void truncate(size_t n) {
+        if (n >= rows_) return;
+        for (auto& c : columns_) c.truncate(n);
+        rows_ = n;
+    }
+
+    size_t num_rows() const    { return rows_; }
+    size_t num_columns() const { return columns_.size(); }
+    ColumnLayout layout() const { return layout_; }
+
+    ColumnBuffer&       column(size_t i)       { return columns_[i]; }
+    const ColumnBuffer& column(size_t i) const { return columns_[i]; }
+
+    // Called by the decoder after every column of a row has been appended
+    void commit_row() { ++rows_; }
+
+private:
+    std::vector<ColumnBuffer> columns_;
+    size_t                    rows_ = 0;
+    ColumnLayout              layout_ = ColumnLayout::Text;
+};
+
+}  // namespace bakread
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "bakread/decompressor.h"
+#include "bakread/mapped_stripe.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bakread {
+
+// Location of a page inside a compressed stripe
+struct CompressedPageRef {
+    uint64_t block_offset = 0;   // Stripe offset of the block's CompressedBlockHeader
+    uint32_t intra_offset = 0;   // Byte offset of the page in the decompressed block
+};
+
+// One decompressed block, shared between the cache and its readers
+struct DecodedBlock {
+    std::vector<uint8_t> data;   // Decompressed bytes
+    uint64_t             end = 0; // Stripe offset just past the stored block
+};
+
+// -------------------------------------------------------------------------
+// CompressedBlockCache -- LRU of decompressed blocks, bounded in bytes
+//
+// Random page reads on a compressed stripe cost a block decompression
+// each; consecutive pages of one block share it through this cache. Blocks
+// are handed out as shared_ptr, so an entry evicted while a reader copies
+// from it stays alive until the copy is done. Thread-safe.
+// -------------------------------------------------------------------------
+class CompressedBlockCache {
+public:
+    using BlockPtr = std::shared_ptr<const DecodedBlock>;
+
+    explicit CompressedBlockCache(size_t capacity_bytes = 64u * 1024 * 1024);
+
+    CompressedBlockCache(const CompressedBlockCache&) = delete;
+    CompressedBlockCache& operator=(const CompressedBlockCache&) = delete;
+
+    // nullptr on a miss
+    BlockPtr get(uint64_t key);
+
+    // Insert (or refresh) a block, evicting least recently used ones
+    void put(uint64_t key, BlockPtr block);
+
+    // Raise the capacity, e.g. to fit at least a few of the largest blocks
+    void reserve(size_t capacity_bytes);
+
+    void clear();
+
+    // Statistics
+    size_t   size() const;
+    size_t   memory_usage_bytes() const;
+    size_t   capacity_bytes() const;
+    uint64_t hits() const { return hits_.load(); }
+    uint64_t misses() const { return misses_.load(); }
+
+private:
+    struct Entry {
+        uint64_t key;
+        BlockPtr block;
+    };
+
+    void evict_locked();
+
+    mutable std::mutex mutex_;
+    size_t capacity_bytes_;
+    size_t bytes_ = 0;
+    std::list<Entry> lru_list_;   // Front = most recent
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> lookup_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+};
+
+// -------------------------------------------------------------------------
+// CompressedStripe -- block-aware reader for compressed backup stripes
+//
+// The data region of a compressed stripe is a chain of blocks, each a
+// CompressedBlockHeader followed by compressed_size bytes. Decompressed,
+// the blocks concatenate into the same 8KB page stream an uncompressed
+// stripe holds. The chain is followed header to header; where it breaks
+// (trailing markers, damage) the reader resyncs on the next plausible
+// header.
+//
+// scan_pages() decompresses blocks on a pool of workers, each with its own
+// Decompressor, and hands pages to the caller in stream order. Pages are
+// addressed by (block offset, offset inside the decompressed block), so
+// read_page() can later fetch one page by decompressing only its block --
+// and the next one when the page straddles a block boundary -- through a
+// CompressedBlockCache shared by all readers.
+// -------------------------------------------------------------------------
+class CompressedStripe {
+public:
+    // Upper bound on header-declared sizes; larger values mean a bad header
+    static constexpr uint32_t MAX_BLOCK_SIZE = 64u * 1024 * 1024;
+
+    // `map` may be null (buffered reads). Throws FileIOError if the file
+    // cannot be opened.
+    CompressedStripe(const std::string& path, const MappedStripe* map);
+
+    CompressedStripe(const CompressedStripe&) = delete;
+    CompressedStripe& operator=(const CompressedStripe&) = delete;
+
+    using PageFn  = std::function<void(const uint8_t* page, const CompressedPageRef& ref)>;
+    using BlockFn = std::function<void(uint64_t block_offset, uint32_t stored_size,
+                                       uint32_t uncompressed_size)>;
+
+    // Deliver every 8KB page of the decompressed stream that starts at the
+    // first block at or after `begin`. Blocks are decompressed on `threads`
+    // workers; fn runs on the calling thread, in stream order. on_block, if
+    // set, runs for each decoded block before the pages that start in it.
+    // Returns the number of blocks decoded.
+    size_t scan_pages(uint64_t begin, size_t threads, const PageFn& fn,
+                      const BlockFn& on_block = nullptr);
+
+    // Stored and decoded size of the block at a stripe offset, when the
+    // caller already knows them (a sealed page index); false if unknown
+    using BlockSizeFn = std::function<bool(uint64_t block_offset, uint32_t& stored_size,
+                                           uint32_t& uncompressed_size)>;
+
+    // Random access to one page (thread-safe). Blocks are looked up in and
+    // added to `cache`; on a miss, block_size saves re-reading the header.
+    bool read_page(const CompressedPageRef& ref, uint8_t* out, CompressedBlockCache& cache,
+                   const BlockSizeFn& block_size = nullptr);
+
+    const std::string& path() const { return path_; }
+
+private:
+    struct Block {
+        uint64_t offset            = 0;
+        uint32_t header_size       = 0;
+        uint32_t compressed_size   = 0;
+        uint32_t uncompressed_size = 0;
+
+        uint64_t stored_size() const { return uint64_t(header_size) + compressed_size; }
+        uint64_t end() const { return offset + stored_size(); }
+    };
+
+    // Parse and validate the header at `offset`
+    bool block_at(uint64_t offset, Block& out);
+
+    // First valid header at or after `from` (scans for the magic)
+    bool find_block(uint64_t from, Block& out);
+
+    // [offset, offset + len) from the mapping, or read into scratch
+    const uint8_t* bytes(uint64_t offset, size_t len, std::vector<uint8_t>& scratch);
+
+    // Decompress one stored block into out (resized to the decoded length)
+    bool decode(const Block& blk, const uint8_t* stored, Decompressor& decomp,
+                std::vector<uint8_t>& out) const;
+
+    // Decoded block at `offset`, from the cache or decompressed into it
+    CompressedBlockCache::BlockPtr load_block(uint64_t offset, CompressedBlockCache& cache,
+                                              const BlockSizeFn& block_size);
+
+    std::string         path_;
+    const MappedStripe* map_  = nullptr;
+    uint64_t            size_ = 0;
+    uint64_t            id_   = 0;   // Distinguishes instances in a shared cache
+
+    std::mutex    file_mutex_;
+    std::ifstream file_;
+};
+
+}  // namespace bakread
@@ -0,0 +1,27 @@
+#pragma once
+
+// -------------------------------------------------------------------------
+// Runtime CPU feature checks for the SIMD kernels
+//
+// SSE2 and NEON are part of the x86-64 / AArch64 baselines and are used
+// unconditionally. AVX2 kernels are compiled per function with
+// BAKREAD_TARGET_AVX2, so the rest of the build keeps the baseline ISA,
+// and are only called when cpu_has_avx2() is true.
+// -------------------------------------------------------------------------
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#if defined(_MSC_VER) && !defined(__clang__)
+#define BAKREAD_HAS_AVX2_KERNELS 1
+#define BAKREAD_TARGET_AVX2
+#elif defined(__GNUC__) || defined(__clang__)
+#define BAKREAD_HAS_AVX2_KERNELS 1
+#define BAKREAD_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace bakread {
+
+// True when the CPU and OS support AVX2 (checked once, then cached)
+bool cpu_has_avx2();
+
+}  // namespace bakread
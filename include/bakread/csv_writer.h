@@ -4,28 +4,52 @@
 
 #include <fstream>
 #include <string>
+#include <vector>
 
 namespace bakread {
 
+// -------------------------------------------------------------------------
+// CsvWriter -- RFC 4180 style CSV with a UTF-8 BOM and CRLF line endings
+//
+// Values are formatted straight into one reusable output buffer (to_chars
+// for numbers, table lookups for hex, a vectorised scan to decide whether a
+// string needs quoting) and the buffer is written out in multi-megabyte
+// chunks; no per-cell strings are allocated.
+// -------------------------------------------------------------------------
 class CsvWriter : public IExportWriter {
 public:
+    static constexpr size_t BUFFER_SIZE = 4 << 20;   // Spill threshold (4MB)
+
     explicit CsvWriter(const std::string& delimiter = ",");
     ~CsvWriter() override;
 
     bool open(const std::string& path, const TableSchema& schema) override;
     bool write_row(const Row& row) override;
+    bool write_batch(const RowBatch& batch) override;
     bool close() override;
     uint64_t rows_written() const override { return rows_written_; }
 
 private:
-    std::string format_value(const RowValue& val) const;
-    std::string escape_csv(const std::string& s) const;
-
-    std::string   delimiter_;
-    std::ofstream file_;
-    TableSchema   schema_;
-    uint64_t      rows_written_ = 0;
-    bool          open_ = false;
+    // Append one row (values, delimiters, CRLF) to the buffer
+    void append_row(const Row& row);
+    void append_value(const RowValue& val);
+    void append_escaped(const char* s, size_t len);
+
+    // Room for n more bytes at the end of the buffer, spilling it first
+    // (or growing it, for a single value larger than the buffer) if needed
+    char* reserve(size_t n);
+    void append(const char* s, size_t len);
+
+    // Write the buffered bytes to the file
+    bool spill();
+
+    std::string       delimiter_;
+    std::ofstream     file_;
+    TableSchema       schema_;
+    std::vector<char> buffer_;
+    size_t            used_ = 0;
+    uint64_t          rows_written_ = 0;
+    bool              open_ = false;
 };
 
 }  // namespace bakread
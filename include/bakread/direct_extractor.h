@@ -3,9 +3,13 @@
 #include "bakread/backup_header.h"
 #include "bakread/backup_stream.h"
 #include "bakread/catalog_reader.h"
-#include "bakread/decompressor.h"
+#include "bakread/column_batch.h"
 #include "bakread/indexed_page_store.h"
+#include "bakread/lob_reader.h"
+#include "bakread/page_store.h"
 #include "bakread/row_decoder.h"
+#include "bakread/row_filter.h"
+#include "bakread/run_stats.h"
 #include "bakread/types.h"
 
 #include <cstdint>
@@ -24,23 +28,37 @@ namespace bakread {
 // Orchestrates the full pipeline:
 //   1. Parse backup header for metadata
 //   2. Detect TDE/encryption (abort if found)
-//   3. Stream pages from backup, decompress as needed
-//   4. Build page cache (indexed by file:page)
-//   5. Read system catalog to resolve table schema
+//   3. Stream catalog pages (low pages of file 1) from the backup
+//   4. Read system catalog to resolve table schema
+//   5. Stream the backup again, keeping only the target table's pages
+//      (page store indexed by file:page, bounded by a memory budget)
 //   6. Traverse data pages for the target table
 //   7. Decode rows and emit to the callback
 //
+// Differential backups (DirectExtractorConfig::diff_paths) are scanned
+// right after the full backup's stripes in every pass. Of each page the
+// copy with the newest page LSN is kept, so the catalog, allocation maps
+// and data pages all reflect the latest differential without a restore.
+//
+// Off-row values (row-overflow data, MAX types, TEXT/NTEXT/IMAGE) are
+// read by following their pointers through the table's LOB and
+// row-overflow pages, which phase 3b loads alongside the data pages when a
+// variable-length column is extracted. The LobReader fetches them through
+// a page cache of its own (lob_cache_mb) and streams each value into the
+// output fragment by fragment.
+//
 // Limitations (by design):
 //   - Does NOT support TDE-encrypted databases
 //   - Does NOT support backup-level encryption
 //   - May fail on very complex schemas or unusual page layouts
-//   - LOB data (MAX types) is not fully supported
+//   - XML values are returned in SQL Server's binary XML format
 //   - Not all SQL Server versions are handled identically
 //
 // When this mode fails, the caller should fall back to Mode B (restore).
 // -------------------------------------------------------------------------
 
 using RowCallback = std::function<bool(const Row& row)>;
+using ColumnBatchCallback = std::function<bool(const ColumnBatch& batch)>;
 
 struct DirectExtractResult {
     bool     success     = false;
@@ -55,8 +73,8 @@ struct TableInfo {
     std::string schema_name;
     std::string table_name;
     int32_t     object_id = 0;
-    int64_t     row_count = -1;  // -1 = unknown
-    int64_t     page_count = -1; // -1 = unknown
+    int64_t     row_count = -1;  // Record slots on data pages (estimate); -1 = unknown
+    int64_t     page_count = -1; // Pages of all its allocation units; -1 = unknown
 };
 
 struct ListTablesResult {
@@ -71,6 +89,18 @@ struct DirectExtractorConfig {
     size_t cache_size_mb = 256;        // LRU cache size in MB
     std::string index_dir;             // Directory for index files
     bool   force_rescan = false;       // Ignore existing index
+    bool   use_mmap = true;            // Memory-map backup files (zero-copy page views)
+    size_t readahead_depth = 4;        // Scan read-ahead buffers in flight
+    size_t readahead_mb = 4;           // Size of each read-ahead buffer in MB
+    bool   direct_io = false;          // Scan with unbuffered reads (bypass page cache)
+    size_t memory_budget_mb = 512;     // Resident page budget for the in-memory store
+    std::string spill_dir;             // Spill directory when over budget (empty = temp)
+    int    decode_workers = 0;         // Row decode threads (0 = hardware threads, 1 = serial)
+    bool   preserve_order = true;      // Emit rows in page order when decoding in parallel
+    bool   catalog_cache = true;       // Keep the resolved catalog in a sidecar next to the index
+    std::vector<std::string> diff_paths;   // Differential backups layered over the full one
+                                           // (newest page LSN wins; in-memory store only)
+    size_t lob_cache_mb = 64;          // LOB page cache for off-row values (0 = placeholders)
 };
 
 class DirectExtractor {
@@ -88,22 +118,48 @@ public:
     // Set column filter (empty = all columns)
     void set_columns(const std::vector<std::string>& columns);
 
+    // Set a row filter (T-SQL search condition subset, see RowFilter;
+    // empty = all rows). Evaluated on raw records before decoding.
+    void set_where(const std::string& condition);
+
     // Set max rows to extract (-1 = unlimited)
     void set_max_rows(int64_t max_rows);
 
+    // Set decode parallelism (0 = hardware threads, 1 = serial)
+    void set_decode_workers(int workers, bool preserve_order = true);
+
     // Set allocation hints: only cache pages in this set (empty = cache all)
     void set_allocation_hints(std::unordered_set<int64_t> hints);
 
     // Set progress callback
     void set_progress_callback(ProgressCallback cb);
 
+    // Report phase timings, scan counters and cache statistics to stats
+    // (nullptr = off). stats must outlive the extractor's calls.
+    void set_stats(RunStats* stats);
+
     // Check if using indexed mode
     bool is_indexed_mode() const { return config_.use_indexed_mode; }
 
     // Execute the extraction. Calls row_callback for each row.
     DirectExtractResult extract(RowCallback row_callback);
 
-    // List all user tables in the backup
+    // Columnar extraction: rows are decoded straight into column buffers
+    // and handed over a batch at a time (no Row / per-cell string). With
+    // ColumnLayout::Typed, decimal, GUID and date/time columns arrive as
+    // binary values instead of text.
+    DirectExtractResult extract_columns(ColumnBatchCallback batch_callback,
+                                        ColumnLayout layout = ColumnLayout::Text);
+
+    // Multi-table: parse headers, build the catalog and load the data pages
+    // of every listed (schema, table) in a single pass over the backup.
+    // Later set_table() + extract() calls for any of them reuse that state
+    // instead of reading the backup again. Tables missing from the catalog
+    // are logged and skipped.
+    DirectExtractResult load_tables(const std::vector<std::pair<std::string, std::string>>& tables);
+
+    // List all user tables in the backup. In indexed mode each table also
+    // gets page and row estimates, taken from the page index alone.
     ListTablesResult list_tables();
 
     // List all modules (stored procedures, functions, views)
@@ -128,44 +184,136 @@ private:
     // Phase 1: Parse headers, detect encryption
     bool phase_parse_headers();
 
-    // Phase 2: Stream and cache pages from the backup
+    // Phase 1b: Parse each differential backup's header (database, type,
+    // encryption, data offset)
+    bool parse_differential_headers();
+
+    // Phase 2: Stream the backup and cache the catalog pages
     bool phase_load_pages();
 
-    // Phase 3: Build catalog and resolve table
+    // Phase 3b: Stream the backup again, keeping only the target table's pages
+    bool phase_load_table_pages();
+
+    // Scan every stripe and cache the valid pages accepted by keep().
+    // Returns the number of pages kept. Timed as `stage` in stats_.
+    uint64_t scan_stripes(const char* stage, const std::function<bool(const PageHeader&)>& keep);
+
+    // Phases 1-2 and the catalog scan, once per extractor. Fills the
+    // error fields of result on failure.
+    bool prepare_catalog(DirectExtractResult& result);
+
+    // Phase 3: Resolve the target table from the catalog
     bool phase_resolve_table();
 
     // Phase 4: Extract rows
     uint64_t phase_extract_rows(RowCallback& callback);
 
+    // Phase 4 (columnar): decode candidate pages into ColumnBatches
+    uint64_t phase_extract_columns(ColumnBatchCallback& callback, ColumnLayout layout);
+
+    // Phases 1-3b, then extract_phase for phase 4
+    DirectExtractResult run_extract(const std::function<uint64_t()>& extract_phase);
+
+    // Data pages of the target table, from its IAM chain when the catalog
+    // has one; in stripe order (indexed mode) or (file, page) order
+    std::vector<int64_t> collect_candidate_pages();
+
+    // Fetch a page for decoding (view or copy into scratch); nullptr if
+    // missing. Thread-safe.
+    const uint8_t* fetch_page(int32_t file_id, int32_t page_id, uint8_t* scratch);
+
+    // Same, nullptr unless it is a data page with rows
+    const uint8_t* fetch_data_page(int32_t file_id, int32_t page_id, uint8_t* scratch);
+
+    // True if the extracted columns include a variable-length one, whose
+    // values may be stored off-row
+    bool projects_var_columns() const;
+
+    // Fill info's page_count and row_count from the page index (indexed
+    // mode only; left at -1 otherwise)
+    void estimate_table_size(TableInfo& info) const;
+
+    // Number of decode threads to use for this many candidate pages
+    int decode_worker_count(size_t candidate_count) const;
+
+    // Decode candidate pages in DECODE_BATCH_PAGES units, on a worker pool
+    // when more than one worker is configured, and feed emit() on the
+    // calling thread (in page order unless preserve_order is off)
+    template <typename Batch, typename DecodeFn, typename EmitFn>
+    void run_decode_pool(const std::vector<int64_t>& pages, DecodeFn decode, EmitFn emit);
+
+    // Pages per unit of work handed to a decode worker
+    static constexpr size_t DECODE_BATCH_PAGES = 16;
+
     // Page provider for CatalogReader and data extraction
     bool provide_page(int32_t file_id, int32_t page_id, uint8_t* buf);
 
-    // Cache a page from the backup stream
-    void cache_page(int32_t file_id, int32_t page_id, const uint8_t* data);
+    // Zero-copy page provider (nullptr if the page needs a copy)
+    const uint8_t* provide_page_view(int32_t file_id, int32_t page_id);
+
+    // Report page store / page cache counters to stats_
+    void report_store_stats();
+
+    // Build a CatalogReader bound to this extractor's page providers
+    std::unique_ptr<CatalogReader> make_catalog_reader();
+
+    // Catalog sidecar location (next to the page index) and the identity
+    // of the backup it must match: stripe sizes and mtimes, data offset,
+    // database name and backup start date
+    std::string catalog_cache_path() const;
+    uint64_t backup_identity() const;
+
+    // Cache a page from the backup stream (stripe/offset allow re-reading it
+    // instead of keeping a copy once the memory budget is used up). With
+    // differential backups, a newer copy replaces the stored one.
+    void cache_page(int32_t file_id, int32_t page_id, const uint8_t* data,
+                    int stripe_index = -1, uint64_t file_offset = 0);
+
+    // A file scanned for pages: a stripe of the full backup, or a
+    // differential backup whose pages replace older copies. The index is
+    // the stripe index of page locations.
+    struct ScanSource {
+        std::string path;
+        uint64_t    data_start = 0;
+        bool        compressed = false;
+        bool        overlay    = false;
+    };
 
     std::vector<std::string> bak_paths_;
+    std::vector<ScanSource>  sources_;
+    uint64_t                 overlay_replaced_ = 0;   // Pages superseded by a differential
     DirectExtractorConfig config_;
     std::string target_schema_;
     std::string target_table_;
     std::vector<std::string> target_columns_;
+    std::string where_clause_;
     int64_t     max_rows_ = -1;
     ProgressCallback progress_cb_ = nullptr;
+    RunStats*   stats_ = nullptr;
 
     std::unique_ptr<BackupStream>       stream_;
     std::unique_ptr<BackupHeaderParser>  header_parser_;
-    std::unique_ptr<Decompressor>        decompressor_;
     std::unique_ptr<CatalogReader>       catalog_;
-    TableSchema                          schema_;
+    TableSchema                          schema_;           // output (projected) columns
+    TableSchema                          physical_schema_;  // every column, record layout
+    std::vector<int>                     projection_;       // physical indices; empty = all
+    std::unique_ptr<RowFilter>           filter_;           // compiled where_clause_
+    std::unique_ptr<LobReader>           lob_reader_;       // off-row values, created on demand
 
     // Indexed page store (for large backups)
     std::unique_ptr<IndexedPageStore>    indexed_store_;
 
-    // Legacy in-memory page cache: key = (file_id << 32) | page_id
-    std::unordered_map<int64_t, std::vector<uint8_t>> page_cache_;
+    // Bounded in-memory page store: key = (file_id << 32) | page_id
+    std::unique_ptr<PageStore>           page_store_;
 
     // Allocation hints: if non-empty, only cache pages in this set
     std::unordered_set<int64_t> allocation_hints_;
 
+    // Reuse across extractions: catalog built, and the page obj_ids whose
+    // data pages phase 3b has already loaded in full
+    bool                         catalog_loaded_ = false;
+    std::unordered_set<uint32_t> loaded_objids_;
+
     static int64_t page_key(int32_t file_id, int32_t page_id) {
         return (static_cast<int64_t>(file_id) << 32) | static_cast<uint32_t>(page_id);
     }
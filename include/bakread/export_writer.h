@@ -1,5 +1,7 @@
 #pragma once
 
+#include "bakread/column_batch.h"
+#include "bakread/row_batch.h"
 #include "bakread/types.h"
 
 #include <cstdint>
@@ -21,6 +23,23 @@ public:
     // Write a single row
     virtual bool write_row(const Row& row) = 0;
 
+    // Write every row of a batch. Writers that can amortise per-row work
+    // (column builders, buffered output) override this.
+    virtual bool write_batch(const RowBatch& batch) {
+        for (const auto& row : batch) {
+            if (!write_row(row)) return false;
+        }
+        return true;
+    }
+
+    // Columnar input. Writers returning true from accepts_columns() can be
+    // fed ColumnBatches from the direct-mode columnar decoder instead of rows.
+    virtual bool accepts_columns() const { return false; }
+    virtual bool write_columns(const ColumnBatch& batch) { (void)batch; return false; }
+
+    // Layout the columnar decoder should fill for write_columns()
+    virtual ColumnLayout column_layout() const { return ColumnLayout::Text; }
+
     // Flush buffered data and close the file
     virtual bool close() = 0;
 
@@ -30,6 +49,7 @@ public:
 
 // Factory function to create the appropriate writer based on format
 std::unique_ptr<IExportWriter> create_writer(OutputFormat format,
-                                              const std::string& delimiter = ",");
+                                              const std::string& delimiter = ",",
+                                              const ParquetOptions& parquet = {});
 
 }  // namespace bakread
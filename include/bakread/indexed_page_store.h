@@ -1,8 +1,9 @@
 #pragma once
 
+#include "bakread/compressed_stripe.h"
 #include "bakread/lru_cache.h"
+#include "bakread/mapped_stripe.h"
 #include "bakread/page_index.h"
-#include "bakread/decompressor.h"
 
 #include <atomic>
 #include <cstdint>
@@ -12,6 +13,7 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace bakread {
@@ -20,14 +22,26 @@ namespace bakread {
 // (pages_scanned, total_bytes_read, stripe_index)
 using ScanProgressCallback = std::function<void(uint64_t, uint64_t, int)>;
 
+// How a caller expects to use a page it fetches, for cache admission
+enum class PageAccess : uint8_t {
+    Normal   = 0,   // May be read again (catalog walks, B-tree descents)
+    ReadOnce = 1,   // Sequential table scan: don't let it displace hot pages
+};
+
 // Configuration for indexed page store
 struct IndexedStoreConfig {
     size_t cache_pages = 4096;          // LRU cache size (default 32MB)
     size_t scan_chunk_size = 65536;     // 64KB read chunks (8 pages)
-    size_t num_threads = 0;             // 0 = auto (num cores)
+    uint64_t scan_range_bytes = 256ull << 20;  // Unit of scan work per thread (256MB)
+    size_t num_threads = 0;             // 0 = auto (num cores); also decompression workers
     std::string index_dir;              // Directory for index files (empty = temp dir)
     bool force_rescan = false;          // Ignore existing index files
     bool save_index = true;             // Persist index to disk
+    bool use_mmap = true;               // Memory-map stripes (falls back to ifstream)
+    size_t readahead_depth = 4;         // Scan read-ahead buffers in flight
+    size_t readahead_bytes = 4 << 20;   // Size of each read-ahead buffer (4MB)
+    bool direct_io = false;             // Scan with unbuffered reads (bypass page cache)
+    size_t block_cache_bytes = 64 << 20; // Decompressed-block cache for compressed backups
 };
 
 // Manages parallel scanning of backup stripes and on-demand page access
@@ -48,17 +62,30 @@ public:
     bool is_indexed() const { return indexed_.load(); }
 
     // Get a page by file_id and page_id
-    // Returns true if page was found, false otherwise
-    bool get_page(int32_t file_id, int32_t page_id, uint8_t* out_buffer);
+    // Returns true if page was found, false otherwise. System, boot and IAM
+    // pages are cached pinned; ReadOnce pages go on probation.
+    bool get_page(int32_t file_id, int32_t page_id, uint8_t* out_buffer,
+                  PageAccess access = PageAccess::Normal);
+
+    // Zero-copy page access: returns a pointer into the mapped stripe, or
+    // nullptr if the page is unknown or cannot be served without a copy
+    // (stripe not mapped, or backup compressed). Callers fall back to
+    // get_page() on nullptr. The pointer is valid for the store's lifetime.
+    const uint8_t* get_page_view(int32_t file_id, int32_t page_id);
 
     // Get page index (for catalog building, allocation unit queries)
     const PageIndex& index() const { return index_; }
 
     // Statistics
-    uint64_t pages_scanned() const { return pages_scanned_.load(); }
+    uint64_t pages_scanned() const { return pages_scanned_.load(); }   // Page slots tested
+    uint64_t pages_valid() const { return pages_valid_.load(); }       // Passed header checks
     uint64_t bytes_read() const { return bytes_read_.load(); }
     size_t cache_size() const { return cache_.size(); }
     double cache_hit_rate() const { return cache_.hit_rate(); }
+    uint64_t cache_hits() const { return cache_.hits(); }
+    uint64_t cache_misses() const { return cache_.misses(); }
+    size_t cache_pinned_pages() const { return cache_.pinned_pages(); }
+    const CompressedBlockCache& block_cache() const { return block_cache_; }
 
     // Check if backup appears compressed
     bool is_compressed() const { return is_compressed_; }
@@ -67,8 +94,29 @@ public:
     uint64_t data_start_offset() const { return data_start_offset_; }
 
 private:
-    // Scan a single stripe file (called from worker thread)
-    void scan_stripe(int stripe_index, ScanProgressCallback progress);
+    // Aligned byte range of one stripe; the scan's unit of work
+    struct ScanRange {
+        int      stripe_index;
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    // Cut every stripe into scan_range_bytes ranges, interleaved by stripe
+    std::vector<ScanRange> plan_ranges();
+
+    // Data page totals of one scan thread, by page header obj_id
+    using RowStatsShard = std::unordered_map<uint32_t, ObjectRowStats>;
+
+    // Scan one range into a thread-local shard (called from worker thread)
+    void scan_range(const ScanRange& range, std::vector<PageIndexRecord>& shard,
+                    RowStatsShard& row_stats, ScanProgressCallback& progress);
+
+    // Scan one compressed stripe: blocks are decompressed on num_threads
+    // workers and pages land in a shard of their own
+    void scan_compressed(int stripe_index, size_t threads, ScanProgressCallback& progress);
+
+    // Let the block cache hold a few of the largest indexed blocks
+    void size_block_cache();
 
     // Parse page header to extract metadata
     IndexedPageType classify_page(const uint8_t* page_data, uint32_t& out_object_id);
@@ -79,23 +127,31 @@ private:
     // Generate index file path for persistence
     std::string index_file_path() const;
 
+    // Map every stripe read-only (stripes that fail stay on the ifstream path)
+    void open_mappings();
+
     std::vector<std::string> bak_paths_;
     IndexedStoreConfig config_;
 
     PageIndex index_;
     LRUPageCache cache_;
 
-    // Per-stripe file handles (opened lazily)
+    // Per-stripe memory mappings (read path needs no locking)
+    std::vector<std::unique_ptr<MappedStripe>> mapped_stripes_;
+
+    // Per-stripe file handles for unmapped stripes (opened lazily)
     std::vector<std::unique_ptr<std::ifstream>> stripe_files_;
     std::vector<std::mutex> stripe_mutexes_;
 
-    // Decompressor for compressed backups
-    std::unique_ptr<Decompressor> decompressor_;
+    // Block readers for compressed backups (one per stripe)
+    std::vector<std::unique_ptr<CompressedStripe>> compressed_stripes_;
+    CompressedBlockCache block_cache_;
     bool is_compressed_ = false;
 
     // Scan state
     std::atomic<bool> indexed_{false};
     std::atomic<uint64_t> pages_scanned_{0};
+    std::atomic<uint64_t> pages_valid_{0};
     std::atomic<uint64_t> bytes_read_{0};
     uint64_t data_start_offset_ = 0;
 
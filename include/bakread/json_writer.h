@@ -18,9 +18,11 @@ public:
     bool close() override;
     uint64_t rows_written() const override { return rows_written_; }
 
+    // JSON string escaping (also used for the partitioned-export manifest)
+    static std::string escape_json(const std::string& s);
+
 private:
     std::string format_value(const RowValue& val) const;
-    static std::string escape_json(const std::string& s);
 
     std::ofstream file_;
     TableSchema   schema_;
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "bakread/lru_cache.h"
+#include "bakread/types.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace bakread {
+
+// -------------------------------------------------------------------------
+// LobReader -- follows off-row value pointers through LOB pages
+//
+// A record keeps only a pointer to values stored outside the row:
+//   - complex column (high bit set in the variable offset array): an
+//     in-row root of 12 header bytes and one 12-byte link per fragment,
+//     {size (4), row id (8)}. Row-overflow data (VARCHAR(n) pushed off a
+//     full row) has one link, MAX types up to five.
+//   - text pointer (TEXT / NTEXT / IMAGE): 16 bytes, a timestamp and the
+//     row id of the value's root.
+// A row id is {page (4), file (2), slot (2)} and names a record on a
+// TextMix or TextTree page. LOB records start with the usual 4-byte record
+// header, an 8-byte blob id and a 2-byte type:
+//   0 SMALL_ROOT        length (2) at 14, data from 20
+//   2 INTERNAL          link count (2) at 16, 16-byte links
+//                       {offset (8), row id (8)} from 20
+//   3 DATA              data from 14 to the end of the record
+//   5 LARGE_ROOT_YUKON  link count (2) at 16, 12-byte links
+//                       {size (4), row id (8)} from 24
+// Leaves are visited in link order, so the sink sees the value's bytes in
+// sequence, one fragment (at most 8040 bytes) at a time, straight from the
+// page buffer; no copy of the whole value is built here.
+//
+// Pages come from a caller-supplied source and go through a bounded LRU
+// cache of their own, so a long LOB chain neither displaces the table's
+// data pages nor re-reads (or re-decompresses) pages shared by adjacent
+// values. Thread-safe; one reader serves every decode worker.
+// -------------------------------------------------------------------------
+
+// Page source: the 8KB page (a view, or scratch after a copy), nullptr if
+// it is not in the backup. Must be thread-safe.
+using LobPageSource = std::function<const uint8_t*(int32_t file_id, int32_t page_id,
+                                                   uint8_t* scratch)>;
+
+// Receives a value's bytes in order, one fragment per call
+using LobChunkSink = std::function<void(const uint8_t* data, size_t len)>;
+
+class LobReader {
+public:
+    LobReader(LobPageSource source, size_t cache_pages);
+
+    LobReader(const LobReader&) = delete;
+    LobReader& operator=(const LobReader&) = delete;
+
+    // True if len bytes of a column can be an off-row pointer of this kind
+    static bool is_inline_root(size_t len) { return len >= 24 && (len - 12) % 12 == 0; }
+    static bool is_text_pointer(size_t len) { return len == 16; }
+
+    // Value size the pointer declares (the sum of its links), 0 if unknown.
+    // Only a hint for reserving output space.
+    static uint64_t declared_size(const uint8_t* pointer, size_t len, bool text_pointer);
+
+    // Feed the value behind pointer to sink. Returns false if a page or
+    // record of the chain is missing or malformed; sink may have received
+    // part of the value by then.
+    bool read(const uint8_t* pointer, size_t len, bool text_pointer,
+              const LobChunkSink& sink) const;
+
+    // Values read / not resolvable, and the LOB page cache's counters
+    uint64_t values_read() const { return values_read_.load(std::memory_order_relaxed); }
+    uint64_t unresolved() const  { return unresolved_.load(std::memory_order_relaxed); }
+    uint64_t cache_hits() const   { return cache_.hits(); }
+    uint64_t cache_misses() const { return cache_.misses(); }
+
+private:
+    // Visit the record at (file, page, slot); depth bounds the tree walk
+    bool read_record(int32_t file_id, int32_t page_id, uint16_t slot, int depth,
+                     const LobChunkSink& sink) const;
+
+    // Page through the cache; nullptr if missing or not a LOB page
+    const uint8_t* fetch(int32_t file_id, int32_t page_id, uint8_t* scratch) const;
+
+    static constexpr int MAX_DEPTH = 8;
+
+    LobPageSource        source_;
+    mutable LRUPageCache cache_;
+    mutable std::atomic<uint64_t> values_read_{0};
+    mutable std::atomic<uint64_t> unresolved_{0};
+};
+
+}  // namespace bakread
@@ -1,15 +1,32 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdarg>
+#include <cstdint>
 #include <fstream>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 
 namespace bakread {
 
 enum class LogLevel { Trace, Debug, Info, Warn, Error, Fatal };
 
+// -------------------------------------------------------------------------
+// Logger
+//
+// Synchronous by default: every message is formatted, written and flushed
+// by the calling thread. set_async(true) switches to a background flusher:
+// callers format the line, copy it into a slot of a lock-free ring and
+// return; the flusher drains the ring in batches with one write per stream
+// and one log-file flush per batch. When the ring is full, TRACE/DEBUG
+// lines are dropped (and counted) while INFO and above wait for room, so
+// nothing that matters is lost. Lines too long for a slot are written
+// synchronously after the ring has drained, keeping their order.
+// -------------------------------------------------------------------------
 class Logger {
 public:
     static Logger& instance();
@@ -18,6 +35,17 @@ public:
     void set_verbose(bool v);
     void set_log_file(const std::string& path);
 
+    // Start/stop the background flusher. Stopping drains the ring first.
+    void set_async(bool on);
+
+    // Block until every line logged so far has been written (no-op when
+    // synchronous). Call before writing to stdout/stderr directly.
+    void flush();
+
+    bool enabled(LogLevel level) const {
+        return level >= level_.load(std::memory_order_relaxed);
+    }
+
     void log(LogLevel level, const char* fmt, ...);
 
     void trace(const char* fmt, ...);
@@ -33,20 +61,94 @@ private:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
+    static constexpr size_t RING_SLOTS = 4096;   // Power of two
+    static constexpr size_t SLOT_TEXT  = 496;    // Formatted line incl. timestamp
+
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        LogLevel level = LogLevel::Info;
+        uint32_t len   = 0;
+        char     text[SLOT_TEXT];
+    };
+
     void log_impl(LogLevel level, const char* fmt, va_list args);
+    void enqueue(LogLevel level, const char* line, size_t len);
+    bool try_enqueue(LogLevel level, const char* line, size_t len);
+    void write_sync(LogLevel level, const char* line, size_t len);
+    void wake_flusher();
+    void flusher_main();
+    size_t drain();
 
-    LogLevel           level_    = LogLevel::Info;
+    std::atomic<LogLevel> level_{LogLevel::Info};
     bool               verbose_  = false;
     std::ofstream      file_;
-    mutable std::mutex mu_;
+    mutable std::mutex mu_;      // Serializes console and file writes
+
+    // Async ring (bounded MPSC, per-slot sequence numbers)
+    std::unique_ptr<Slot[]> ring_;
+    std::atomic<uint64_t>   enqueue_pos_{0};
+    uint64_t                dequeue_pos_ = 0;   // Flusher only
+    std::atomic<uint64_t>   written_pos_{0};    // Lines written by the flusher
+    std::atomic<uint64_t>   dropped_{0};
+    std::atomic<bool>       async_{false};
+    std::atomic<int>        producers_{0};      // Callers inside the async path
+    std::atomic<bool>       flusher_running_{false};
+    bool                    stop_ = false;
+    std::thread             flusher_;
+    std::mutex              wake_mu_;
+    std::condition_variable wake_cv_;
+    std::condition_variable written_cv_;
+    std::mutex              async_mu_;          // Serializes set_async
+};
+
+// -------------------------------------------------------------------------
+// LogRateLimiter -- lets at most one caller through per interval, for
+// progress lines reported from many threads or many chunks. Thread-safe.
+// -------------------------------------------------------------------------
+class LogRateLimiter {
+public:
+    explicit LogRateLimiter(std::chrono::milliseconds interval)
+        : interval_(std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count()) {}
+
+    bool allow() {
+        int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        int64_t next = next_.load(std::memory_order_relaxed);
+        if (now < next) return false;
+        return next_.compare_exchange_strong(next, now + interval_,
+                                             std::memory_order_relaxed);
+    }
+
+private:
+    int64_t              interval_;
+    std::atomic<int64_t> next_{0};
 };
 
-// Convenience macros
-#define LOG_TRACE(...)  ::bakread::Logger::instance().trace(__VA_ARGS__)
-#define LOG_DEBUG(...)  ::bakread::Logger::instance().debug(__VA_ARGS__)
-#define LOG_INFO(...)   ::bakread::Logger::instance().info(__VA_ARGS__)
-#define LOG_WARN(...)   ::bakread::Logger::instance().warn(__VA_ARGS__)
-#define LOG_ERROR(...)  ::bakread::Logger::instance().error(__VA_ARGS__)
+// Convenience macros. The level check is inline, so arguments of disabled
+// messages are never evaluated.
+#define BAKREAD_LOG_AT(lvl, fn, ...)                                         \
+    do {                                                                     \
+        auto& bakread_log_ = ::bakread::Logger::instance();                  \
+        if (bakread_log_.enabled(::bakread::LogLevel::lvl))                  \
+            bakread_log_.fn(__VA_ARGS__);                                    \
+    } while (0)
+
+#define LOG_TRACE(...)  BAKREAD_LOG_AT(Trace, trace, __VA_ARGS__)
+#define LOG_DEBUG(...)  BAKREAD_LOG_AT(Debug, debug, __VA_ARGS__)
+#define LOG_INFO(...)   BAKREAD_LOG_AT(Info,  info,  __VA_ARGS__)
+#define LOG_WARN(...)   BAKREAD_LOG_AT(Warn,  warn,  __VA_ARGS__)
+#define LOG_ERROR(...)  BAKREAD_LOG_AT(Error, error, __VA_ARGS__)
 #define LOG_FATAL(...)  ::bakread::Logger::instance().fatal(__VA_ARGS__)
 
+// Per-page / per-record diagnostics. Compiled out unless the build defines
+// BAKREAD_HOT_PATH_LOGGING (CMake option of the same name), so release
+// decode loops carry no logging code at all.
+#ifdef BAKREAD_HOT_PATH_LOGGING
+#define LOG_TRACE_HOT(...)  LOG_TRACE(__VA_ARGS__)
+#define LOG_DEBUG_HOT(...)  LOG_DEBUG(__VA_ARGS__)
+#else
+#define LOG_TRACE_HOT(...)  ((void)0)
+#define LOG_DEBUG_HOT(...)  ((void)0)
+#endif
+
 }  // namespace bakread
@@ -1,22 +1,50 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
-#include <list>
-#include <mutex>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace bakread {
 
-// Thread-safe LRU cache for 8KB pages
+// Admission class of a cached page
+enum class CachePriority : uint8_t {
+    Normal    = 0,   // Regular CLOCK replacement
+    Pinned    = 1,   // Never evicted while the shard's pinned quota lasts
+    Probation = 2,   // Read-once: recycled within a small ring unless hit again
+};
+
+// -------------------------------------------------------------------------
+// LRUPageCache -- thread-safe, sharded page cache with CLOCK eviction
 // Key: int64_t (file_id << 32 | page_id)
-// Value: 8KB page buffer
+// Value: 8KB page
+//
+// All pages live in one slab of max_pages * 8KB allocated up front; nothing
+// is allocated per entry. Keys are hashed onto a power-of-two number of
+// shards, each owning a contiguous run of slab slots, a key -> slot map and
+// a clock hand. A hit takes its shard's lock shared and sets the slot's
+// atomic reference bit, so readers of one shard run concurrently and never
+// reorder anything; inserts take the lock exclusively and sweep the hand
+// past referenced slots (clearing their bit) to the first unreferenced one,
+// which approximates LRU.
+//
+// Scan resistance: up to a quarter of each shard can hold Pinned pages
+// (catalog, boot, IAM), which the hand skips. Probation pages (a table
+// scan's data pages) enter with no reference bit; once a full shard holds
+// 1/16 of them, a new one replaces the oldest, so a long scan churns
+// through that ring instead of the whole cache. A probation page that is
+// hit before its turn comes is promoted to Normal.
+// -------------------------------------------------------------------------
 class LRUPageCache {
 public:
     static constexpr size_t PAGE_SIZE = 8192;
 
     explicit LRUPageCache(size_t max_pages = 1024);
-    ~LRUPageCache() = default;
+    ~LRUPageCache();
 
     LRUPageCache(const LRUPageCache&) = delete;
     LRUPageCache& operator=(const LRUPageCache&) = delete;
@@ -24,8 +52,10 @@ public:
     // Try to get a page from cache. Returns true if found.
     bool get(int64_t key, uint8_t* out_page);
 
-    // Add/update a page in cache. Evicts LRU if full.
-    void put(int64_t key, const uint8_t* page_data);
+    // Add/update a page in cache. Evicts an unreferenced page if the
+    // key's shard is full (the oldest probation page, for Probation).
+    void put(int64_t key, const uint8_t* page_data,
+             CachePriority priority = CachePriority::Normal);
 
     // Check if page is cached
     bool contains(int64_t key) const;
@@ -40,31 +70,62 @@ public:
     size_t size() const;
     size_t capacity() const { return max_pages_; }
     size_t memory_usage_bytes() const;
-    uint64_t hits() const { return hits_; }
-    uint64_t misses() const { return misses_; }
+    uint64_t hits() const;
+    uint64_t misses() const;
     double hit_rate() const;
+    size_t pinned_pages() const;
 
     // Resize cache (clears existing entries)
     void resize(size_t max_pages);
 
 private:
-    struct CacheEntry {
-        int64_t key;
-        std::vector<uint8_t> data;  // 8KB page
+    struct Slot {
+        int64_t              key  = 0;
+        bool                 used = false;
+        CachePriority        priority = CachePriority::Normal;
+        std::atomic<uint8_t> referenced{0};   // CLOCK bit, set on every hit
     };
 
-    using ListIterator = std::list<CacheEntry>::iterator;
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<int64_t, uint32_t> lookup;   // key -> slot in this shard
+        size_t   first_slot = 0;                        // Slab index of slot 0
+        uint32_t slot_count = 0;
+        uint32_t hand       = 0;                        // Next eviction candidate
+        std::vector<uint32_t> free_slots;
+
+        uint32_t pinned     = 0;                        // Slots holding Pinned pages
+        uint32_t pinned_cap = 0;
+        uint32_t probation_cap = 0;
+        std::deque<std::pair<uint32_t, int64_t>> probation;  // (slot, key), oldest first
+
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+    };
 
-    mutable std::mutex mutex_;
-    size_t max_pages_;
-    std::list<CacheEntry> lru_list_;  // Front = most recent, back = least recent
-    std::unordered_map<int64_t, ListIterator> lookup_;
+    // Allocate the slab and split it into shards (no entries)
+    void build(size_t max_pages);
 
-    // Statistics
-    mutable uint64_t hits_ = 0;
-    mutable uint64_t misses_ = 0;
+    Shard& shard_of(int64_t key) const;
+    uint8_t* page(const Shard& shard, uint32_t slot) const {
+        return slab_.get() + (shard.first_slot + slot) * PAGE_SIZE;
+    }
+
+    // Slot to reuse in a full shard (caller holds the shard exclusively)
+    uint32_t evict_locked(Shard& shard);
+
+    // Oldest unpromoted probation slot, evicted; false if there is none
+    bool recycle_probation_locked(Shard& shard, uint32_t& slot);
+
+    // Drop the entry in `slot` (caller holds the shard exclusively)
+    void release_locked(Shard& shard, uint32_t slot);
 
-    void evict_if_needed();
+    size_t max_pages_ = 0;
+    size_t shard_bits_ = 0;
+    std::unique_ptr<uint8_t[]> slab_;         // max_pages_ * PAGE_SIZE bytes
+    std::unique_ptr<Slot[]>    slots_;        // max_pages_ entries, by slab index
+    std::unique_ptr<Shard[]>   shards_;
+    size_t                     shard_count_ = 0;
 };
 
 }  // namespace bakread
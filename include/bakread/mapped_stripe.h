@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace bakread {
+
+// -------------------------------------------------------------------------
+// MappedStripe -- read-only memory mapping of a backup stripe file
+//
+// Maps the whole file once (mmap on POSIX, MapViewOfFile on Windows) and
+// hands out const pointers straight into the mapping. Page consumers
+// (scan loops, RowDecoder, CatalogReader) can then work on the OS page
+// cache directly instead of copying through an ifstream buffer.
+//
+// The mapping is immutable after construction, so concurrent readers need
+// no locking. Views stay valid for the lifetime of the MappedStripe.
+// -------------------------------------------------------------------------
+class MappedStripe {
+public:
+    // Access pattern hints (madvise on POSIX, no-op where unsupported)
+    enum class Access {
+        Normal,
+        Sequential,
+        Random,
+    };
+
+    // Throws FileIOError if the file cannot be opened or mapped.
+    explicit MappedStripe(const std::string& path);
+    ~MappedStripe();
+
+    MappedStripe(const MappedStripe&) = delete;
+    MappedStripe& operator=(const MappedStripe&) = delete;
+
+    const uint8_t*     data() const { return data_; }
+    uint64_t           size() const { return size_; }
+    const std::string& path() const { return path_; }
+
+    // Pointer to [offset, offset + length) or nullptr if out of range
+    const uint8_t* view(uint64_t offset, size_t length) const {
+        if (offset > size_ || length > size_ - offset) return nullptr;
+        return data_ + offset;
+    }
+
+    // Pointer to the 8KB page at the given byte offset, or nullptr
+    const uint8_t* page_at(uint64_t offset) const;
+
+    // Hint the kernel about the expected access pattern for the whole mapping
+    void advise(Access access) const;
+
+    // Hint that [offset, offset + length) will be needed soon
+    void prefetch(uint64_t offset, size_t length) const;
+
+private:
+    std::string    path_;
+    const uint8_t* data_ = nullptr;
+    uint64_t       size_ = 0;
+
+#ifdef _WIN32
+    void* file_handle_    = nullptr;
+    void* mapping_handle_ = nullptr;
+#else
+    int   fd_ = -1;
+#endif
+};
+
+}  // namespace bakread
@@ -120,6 +120,15 @@ inline PageId get_next_page(const PageHeader& hdr) {
              static_cast<int32_t>(hdr.next_page) };
 }
 
+// True if page version a was last modified after version b: compares the
+// page LSNs (VLF sequence, log block offset, slot) of two copies of the
+// same page, e.g. from a full and a differential backup
+inline bool page_lsn_newer(const PageHeader& a, const PageHeader& b) {
+    if (a.lsn_file != b.lsn_file)     return a.lsn_file > b.lsn_file;
+    if (a.lsn_offset != b.lsn_offset) return a.lsn_offset > b.lsn_offset;
+    return a.lsn_slot > b.lsn_slot;
+}
+
 // Get the slot array entry (2-byte record offset) at index i.
 // The slot array grows backward from the end of the page.
 inline uint16_t get_slot_offset(const uint8_t* page_data, int slot_index) {
@@ -152,31 +161,50 @@ namespace RecordStatus {
 
 // -------------------------------------------------------------------------
 // IAM page structure (for tracking allocations)
+//
+// Slot 0 is the IAM header record, slot 1 the extent bitmap:
+//   Bytes 96-99:   record header
+//   Bytes 100-103: sequence number (position in the IAM chain)
+//   Bytes 136-141: start page of the GAM interval this page maps
+//                  (4-byte page + 2-byte file)
+//   Bytes 142-189: 8 single-page allocation slots (6 bytes each)
+//   Bytes 194-:    extent bitmap, one bit per 8-page extent from start page
+// IAM pages of one allocation unit are linked through next_page.
 // -------------------------------------------------------------------------
 struct IamPageHeader {
     PageHeader base;
-    // After the standard header, the IAM page contains:
-    //   Bytes 96-99: Sequence number
-    //   Bytes 100-103: status
-    //   Bytes 104-109: start page (6 bytes: 4-byte page + 2-byte file)
-    //   ... allocation bitmap follows
 };
 
-// Get the start page referenced by an IAM page
-inline PageId iam_start_page(const uint8_t* page) {
+static constexpr size_t IAM_START_PAGE_OFFSET  = 136;
+static constexpr size_t IAM_SINGLE_PAGE_OFFSET = 142;
+static constexpr int    IAM_SINGLE_PAGE_SLOTS  = 8;
+static constexpr size_t IAM_BITMAP_OFFSET      = 194;
+static constexpr int    IAM_EXTENTS_PER_PAGE   = 63904;   // One GAM interval
+static constexpr int    PAGES_PER_EXTENT       = 8;
+
+inline PageId read_page_pointer(const uint8_t* p) {
     uint32_t pg;
     uint16_t fi;
-    std::memcpy(&pg, page + 104, 4);
-    std::memcpy(&fi, page + 108, 2);
+    std::memcpy(&pg, p, 4);
+    std::memcpy(&fi, p + 4, 2);
     return { static_cast<int32_t>(fi), static_cast<int32_t>(pg) };
 }
 
+// Get the start page referenced by an IAM page
+inline PageId iam_start_page(const uint8_t* page) {
+    return read_page_pointer(page + IAM_START_PAGE_OFFSET);
+}
+
+// Single-page allocation `slot` of an IAM page (null if unused)
+inline PageId iam_single_page(const uint8_t* page, int slot) {
+    return read_page_pointer(page + IAM_SINGLE_PAGE_OFFSET + slot * 6);
+}
+
 // Check if a specific extent (relative to start_page) is allocated in the IAM bitmap
 inline bool iam_extent_allocated(const uint8_t* page, int extent_index) {
-    // IAM bitmap starts at offset 194 (after single-page allocations at 110-193)
-    int byte_offset = 194 + (extent_index / 8);
-    int bit_offset  = extent_index % 8;
-    if (byte_offset >= static_cast<int>(PAGE_SIZE)) return false;
+    if (extent_index < 0 || extent_index >= IAM_EXTENTS_PER_PAGE) return false;
+    size_t byte_offset = IAM_BITMAP_OFFSET + (extent_index / 8);
+    int    bit_offset  = extent_index % 8;
     return (page[byte_offset] & (1 << bit_offset)) != 0;
 }
 
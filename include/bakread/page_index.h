@@ -1,6 +1,13 @@
 #pragma once
 
+#include "bakread/mapped_stripe.h"
+
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -28,9 +35,11 @@ enum class IndexedPageType : uint8_t {
 struct PageIndexEntry {
     uint8_t  stripe_index;    // Which stripe file (0-255)
     uint8_t  page_type;       // IndexedPageType
-    uint8_t  reserved[2];     // Alignment padding
+    uint16_t block_offset;    // Compressed stripes: page offset inside the
+                              // decompressed block, in 512-byte units
     uint32_t object_id;       // Page header m_objId (for filtering)
-    uint64_t file_offset;     // Byte offset within the stripe file
+    uint64_t file_offset;     // Byte offset within the stripe file (compressed
+                              // stripes: offset of the containing block)
 };
 
 // Compact key for page lookup
@@ -43,16 +52,92 @@ inline void split_page_key(int64_t key, int32_t& file_id, int32_t& page_id) {
     page_id = static_cast<int32_t>(key & 0xFFFFFFFF);
 }
 
-// In-memory page index
-// Maps (file_id, page_id) -> location in stripe file
+// One (key, entry) pair of the sorted index; also the v2 on-disk record
+struct PageIndexRecord {
+    int64_t        key;
+    PageIndexEntry entry;
+};
+
+// Object -> page-range table of the sorted index. The keys of object_id's
+// pages are object_keys[first, first + count), in key order.
+struct ObjectPageRange {
+    uint32_t object_id;
+    uint32_t count;
+    uint64_t first;
+};
+
+// Data pages of one object and the slot counts in their headers, summed
+// while scanning: a row estimate (ghost and forwarded records included)
+// that needs no decoding. Sorted by object_id once sealed.
+struct ObjectRowStats {
+    uint32_t object_id;
+    uint32_t data_pages;
+    uint64_t slot_count;
+};
+
+// One compressed block of a compressed stripe: where it is and which pages
+// start in it. Sorted by (stripe_index, block_offset) once sealed.
+struct CompressedBlockRange {
+    uint8_t  stripe_index;
+    uint8_t  reserved[3];
+    uint32_t page_count;          // Indexed pages that start in this block
+    uint64_t block_offset;        // Stripe offset of the CompressedBlockHeader
+    uint32_t stored_size;         // Header + compressed payload
+    uint32_t uncompressed_size;   // Decompressed length
+    int64_t  first_key;           // Lowest page key starting in the block
+    int64_t  last_key;            // Highest page key starting in the block
+};
+
+// -------------------------------------------------------------------------
+// PageIndex -- maps (file_id, page_id) -> location in stripe file
+//
+// Two states:
+//   building  add_entry() inserts into one of 16 hash maps picked by a hash
+//             of the key, each with its own mutex, so concurrent writers
+//             rarely meet; add_shard() queues a scan thread's local shard
+//   sealed    seal() or load_from_file() turns the index into flat arrays
+//             sorted by key, plus an object_id -> page-range table. Lookups
+//             are lock-free binary searches and get_pages_by_object() is a
+//             search plus a copy of one contiguous range.
+//
+// Indexes of compressed backups also hold a block table, one
+// CompressedBlockRange per compressed block, so a reader knows how much it
+// will decompress to serve a page. Scans also hand over ObjectRowStats, so
+// table sizes can be estimated from the index alone.
+//
+// A v2 index file is exactly the sealed arrays, so loading one maps the
+// file and points the arrays into the mapping -- no per-entry work at all.
+// Calling add_entry() on a sealed index moves it back to the building state;
+// that must not race with readers.
+// -------------------------------------------------------------------------
 class PageIndex {
 public:
     PageIndex() = default;
     ~PageIndex() = default;
 
-    // Add a page entry (thread-safe)
+    PageIndex(const PageIndex&) = delete;
+    PageIndex& operator=(const PageIndex&) = delete;
+
+    // Add a page entry (thread-safe; locks only the key's map)
     void add_entry(int32_t file_id, int32_t page_id, const PageIndexEntry& entry);
 
+    // Hand over a scan thread's local entries in one locked append. Shards
+    // are merged at seal() and are not visible to lookups before that. A
+    // key seen more than once keeps the entry with the highest
+    // (stripe_index, file_offset), matching a sequential scan's last write.
+    void add_shard(std::vector<PageIndexRecord>&& shard);
+
+    // Hand over a compressed stripe's block table (sorted at seal())
+    void add_blocks(std::vector<CompressedBlockRange>&& blocks);
+
+    // Hand over a scan thread's per-object data page totals (merged by
+    // object at seal())
+    void add_row_stats(std::vector<ObjectRowStats>&& stats);
+
+    // Freeze the building map into the sorted, read-only form
+    void seal();
+    bool is_sealed() const { return sealed_.load(std::memory_order_acquire); }
+
     // Lookup a page entry (thread-safe)
     bool lookup(int32_t file_id, int32_t page_id, PageIndexEntry& entry) const;
 
@@ -62,14 +147,32 @@ public:
     // Get all pages of a specific type
     std::vector<int64_t> get_pages_by_type(IndexedPageType type) const;
 
-    // Get all pages for a specific object_id
+    // Get all pages for a specific object_id (in key order once sealed)
     std::vector<int64_t> get_pages_by_object(uint32_t object_id) const;
 
+    // Number of pages indexed under object_id, without copying their keys
+    size_t count_pages_by_object(uint32_t object_id) const;
+
+    // Data page totals of object_id (zeroes if it has no data pages).
+    // Returns false if the index has no row statistics (files written
+    // before v3).
+    bool row_stats(uint32_t object_id, ObjectRowStats& out) const;
+
+    // Reorder page keys by where the pages sit in the backup (file offset,
+    // then in-block offset, then stripe), so reading them in order sweeps
+    // every stripe front to back. Keys not in the index are dropped.
+    void sort_by_location(std::vector<int64_t>& keys) const;
+
+    // Compressed block table (sealed index only; empty for raw backups)
+    const CompressedBlockRange* blocks() const { return blocks_; }
+    size_t block_count() const { return block_count_; }
+    const CompressedBlockRange* find_block(uint8_t stripe_index, uint64_t block_offset) const;
+
     // Statistics
     size_t size() const;
     size_t memory_usage_bytes() const;
 
-    // Serialization to/from index file
+    // Serialization to/from index file. Always writes v3; reads v1 to v3.
     bool save_to_file(const std::string& path) const;
     bool load_from_file(const std::string& path);
 
@@ -80,22 +183,99 @@ public:
     std::vector<int64_t> get_system_pages() const;
 
 private:
+    // Sorted arrays built from unsorted records
+    struct SortedIndex {
+        std::vector<PageIndexRecord> records;
+        std::vector<ObjectPageRange> objects;
+        std::vector<int64_t>         object_keys;
+        std::vector<CompressedBlockRange> blocks;
+        std::vector<ObjectRowStats>  row_stats;
+    };
+    static SortedIndex build_sorted(std::vector<PageIndexRecord> records);
+    static std::vector<CompressedBlockRange> sorted_blocks(std::vector<CompressedBlockRange> blocks);
+    static std::vector<ObjectRowStats> merged_row_stats(std::vector<ObjectRowStats> stats);
+
+    static constexpr size_t MAP_SHARDS = 16;
+
+    struct BuildMap {
+        mutable std::mutex mutex;
+        std::unordered_map<int64_t, PageIndexEntry> entries;
+    };
+
+    static size_t map_of(int64_t key);
+
+    // Visit / count / drop every building-map entry, one map lock at a time
+    void visit_maps(const std::function<void(int64_t, const PageIndexEntry&)>& fn) const;
+    size_t map_entries() const;
+    void clear_maps();
+
+    // Building maps plus pending shards as one record list (caller holds mutex_)
+    std::vector<PageIndexRecord> collect_locked() const;
+    void adopt_locked(SortedIndex sorted);
+
+    const PageIndexRecord* find(int64_t key) const;
+
+    // Copy sealed arrays back into the map (caller holds mutex_)
+    void unseal_locked();
+    void reset_sealed();
+
+    bool load_v1(std::ifstream& file, uint32_t entry_count, const std::string& path);
+    bool load_v2(const std::string& path, uint32_t version);
+
+    // Building state. mutex_ guards shards_ and state changes (seal, load,
+    // clear); each map has its own lock for add_entry and unsealed lookups.
     mutable std::mutex mutex_;
-    std::unordered_map<int64_t, PageIndexEntry> entries_;
+    std::array<BuildMap, MAP_SHARDS>          maps_;
+    std::vector<std::vector<PageIndexRecord>> shards_;
+    std::vector<CompressedBlockRange>         pending_blocks_;
+    std::vector<ObjectRowStats>               pending_row_stats_;
+    bool                                      has_row_stats_ = true;   // False after loading v1/v2
+
+    // Sealed state: views into either owned_ or mapping_
+    std::atomic<bool>      sealed_{false};
+    const PageIndexRecord* records_      = nullptr;
+    size_t                 record_count_ = 0;
+    const ObjectPageRange* objects_      = nullptr;
+    size_t                 object_count_ = 0;
+    const int64_t*         object_keys_  = nullptr;
+    const CompressedBlockRange* blocks_  = nullptr;
+    size_t                 block_count_  = 0;
+    const ObjectRowStats*  row_stats_    = nullptr;
+    size_t                 row_stat_count_ = 0;
+
+    SortedIndex                   owned_;
+    std::unique_ptr<MappedStripe> mapping_;
 };
 
 // Index file header (for persistence)
+//
+// v1: header, then entry_count unsorted (int64 key, PageIndexEntry) pairs.
+// v2: header, then
+//       PageIndexRecord[entry_count]   sorted by key, at offset 64
+//       ObjectPageRange[object_count]  sorted by object_id, at objects_offset
+//       int64_t[entry_count]           keys grouped by object, at object_keys_offset
+//       CompressedBlockRange[block_count]  right after the keys (files written
+//                                      before the block table have block_count 0)
+// v3: v2, then uint64_t row_stat_count and ObjectRowStats[row_stat_count]
+//     right after the block table
 struct IndexFileHeader {
-    char     magic[8];        // "BAKRIDX\0"
-    uint32_t version;         // Format version
-    uint32_t entry_count;     // Number of entries
-    uint64_t total_pages;     // Total pages scanned
-    uint64_t data_pages;      // Data pages found
-    uint64_t system_pages;    // System pages found
-    char     reserved[24];    // Future use (adjusted for 64-byte alignment)
+    char     magic[8];            // "BAKRIDX\0"
+    uint32_t version;             // Format version
+    uint32_t entry_count;         // Number of entries
+    uint64_t total_pages;         // Total pages scanned
+    uint64_t data_pages;          // Data pages found
+    uint64_t system_pages;        // System pages found
+    uint32_t object_count;        // v2: object range table length
+    uint32_t block_count;         // v2: compressed block table length (0 = none)
+    uint64_t objects_offset;      // v2: byte offset of the object range table
+    uint64_t object_keys_offset;  // v2: byte offset of the per-object key array
 };
 
 static_assert(sizeof(IndexFileHeader) == 64, "IndexFileHeader must be 64 bytes");
 static_assert(sizeof(PageIndexEntry) == 16, "PageIndexEntry should be 16 bytes");
+static_assert(sizeof(PageIndexRecord) == 24, "PageIndexRecord should be 24 bytes");
+static_assert(sizeof(ObjectPageRange) == 16, "ObjectPageRange should be 16 bytes");
+static_assert(sizeof(CompressedBlockRange) == 40, "CompressedBlockRange should be 40 bytes");
+static_assert(sizeof(ObjectRowStats) == 16, "ObjectRowStats should be 16 bytes");
 
 }  // namespace bakread
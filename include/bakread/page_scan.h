@@ -0,0 +1,67 @@
+#pragma once
+
+#include "bakread/page.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace bakread {
+
+// -------------------------------------------------------------------------
+// Batch page-header classification for backup scans
+//
+// A scan looks for page headers at every `stride` bytes of a chunk (8KB
+// normally, 512 bytes in the fallback scan). Rather than copy and test one
+// PageHeader at a time, classify_page_headers tests the candidates of a
+// whole chunk together -- 8 at a time with AVX2 gathers where available --
+// and returns a bitmask of the plausible ones. Callers then read type,
+// obj_id and page id straight from the headers in the chunk.
+//
+// A header is plausible when header_version == 1, type is 1..17,
+// this_file is 1..32, slot_count <= 1000 and free_count <= PAGE_SIZE.
+// -------------------------------------------------------------------------
+
+// The plausibility test for a single header (compressed scans, which see
+// one decompressed page at a time)
+inline bool page_header_plausible(const uint8_t* page) {
+    uint32_t w0, w_slots, w_free, w_file;
+    std::memcpy(&w0,      page + 0x00, 4);   // version, type, ...
+    std::memcpy(&w_slots, page + 0x14, 4);   // next_file, slot_count
+    std::memcpy(&w_free,  page + 0x1C, 4);   // free_count, free_data
+    std::memcpy(&w_file,  page + 0x24, 4);   // this_file, reserved_count
+    const uint32_t type = (w0 >> 8) & 0xFF;
+    const uint32_t file = w_file & 0xFFFF;
+    return ((w0 & 0xFF) == 1) & (type - 1u < 17u) & (file - 1u < 32u) &
+           ((w_slots >> 16) <= 1000u) & ((w_free & 0xFFFF) <= PAGE_SIZE);
+}
+
+// Test the header at chunk + i * stride for every i whose whole page lies
+// inside [chunk, chunk + len). Bit i of mask (word i / 64) is set for a
+// plausible header; mask is resized to fit. Returns the candidate count.
+size_t classify_page_headers(const uint8_t* chunk, size_t len, size_t stride,
+                             std::vector<uint64_t>& mask);
+
+// Call fn(i) for every set bit i of a classify_page_headers mask
+template <class Fn>
+inline void for_each_set_bit(const std::vector<uint64_t>& mask, Fn&& fn) {
+    for (size_t w = 0; w < mask.size(); ++w) {
+        uint64_t bits = mask[w];
+        while (bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long bit;
+            _BitScanForward64(&bit, bits);
+#else
+            unsigned bit = static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+            fn(w * 64 + bit);
+            bits &= bits - 1;
+        }
+    }
+}
+
+}  // namespace bakread
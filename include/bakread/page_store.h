@@ -0,0 +1,164 @@
+#pragma once
+
+#include "bakread/mapped_stripe.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace bakread {
+
+// -------------------------------------------------------------------------
+// PageStore -- bounded in-memory page store for direct (non-indexed) mode
+//
+// Pages are copied into fixed 8KB slots carved out of large contiguous
+// slabs, and located through an open-addressing hash table keyed by
+// (file_id << 32) | page_id. Nothing is allocated per page.
+//
+// Once the memory budget is used up, further pages are not copied:
+//   - pages with a known stripe location are kept as offset-only
+//     references and re-read from the (memory-mapped) stripe on access
+//   - other pages are appended to a temporary spill file
+// Every page offered to put() remains retrievable, whatever the backup size.
+//
+// put() must not run concurrently with readers; lookups are safe to call
+// from several threads once loading is finished.
+// -------------------------------------------------------------------------
+
+struct PageStoreConfig {
+    size_t      memory_budget_mb = 512;   // Resident page budget
+    size_t      slab_pages = 8192;        // Pages per slab (64MB)
+    bool        allow_offset_only = true; // Re-read from stripe instead of spilling
+    std::string spill_dir;                // Spill file directory (empty = system temp)
+    bool        use_mmap = true;          // Map stripes for offset-only reads
+};
+
+// Where a page lives in the stripe files (for offset-only references)
+struct PageLocation {
+    int      stripe_index = -1;   // -1 = not re-readable from a stripe
+    uint64_t file_offset  = 0;
+};
+
+// Header fields kept per page so callers can filter without touching data
+struct PageMeta {
+    uint32_t obj_id     = 0;
+    uint8_t  page_type  = 0;
+    uint16_t slot_count = 0;
+};
+
+class PageStore {
+public:
+    explicit PageStore(const PageStoreConfig& config = {});
+    ~PageStore();
+
+    PageStore(const PageStore&) = delete;
+    PageStore& operator=(const PageStore&) = delete;
+
+    // Stripe files used to resolve offset-only references
+    void set_stripe_paths(const std::vector<std::string>& paths);
+
+    // Add a page. Returns false if the key is already present (first copy wins).
+    bool put(int64_t key, const uint8_t* page_data,
+             const PageLocation& location = {});
+
+    // Add a page, or replace the stored copy when page_data carries a newer
+    // page LSN (differential backups layered over a full one). Returns
+    // false if the stored copy is as new or newer and was kept.
+    bool put_newest(int64_t key, const uint8_t* page_data,
+                    const PageLocation& location = {});
+
+    bool contains(int64_t key) const;
+
+    // Copy a page into out_page. Returns false if unknown or unreadable.
+    bool get(int64_t key, uint8_t* out_page) const;
+
+    // Zero-copy access: resident pages and references into mapped stripes.
+    // Returns nullptr when the page would need a copy (or is unknown).
+    const uint8_t* view(int64_t key) const;
+
+    // Header metadata recorded at put() time
+    bool meta(int64_t key, PageMeta& out) const;
+
+    // Visit every stored page: fn(key, const PageMeta&)
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& e : table_) {
+            if (e.key != EMPTY_KEY) fn(e.key, PageMeta{e.obj_id, e.page_type, e.slot_count});
+        }
+    }
+
+    // Statistics
+    size_t size() const { return count_; }
+    size_t resident_pages() const { return resident_count_; }
+    size_t referenced_pages() const { return reference_count_; }
+    size_t spilled_pages() const { return spill_count_; }
+    size_t memory_usage_bytes() const;
+
+    void clear();
+
+private:
+    enum class Where : uint8_t { Resident = 0, Reference = 1, Spilled = 2 };
+
+    struct Entry {
+        int64_t  key;
+        uint64_t loc;          // slot index / (stripe << 56 | offset) / spill offset
+        uint32_t obj_id;
+        uint8_t  page_type;
+        Where    where;
+        uint16_t slot_count;
+    };
+    static_assert(sizeof(Entry) == 24, "PageStore::Entry should be 24 bytes");
+
+    static constexpr int64_t  EMPTY_KEY = -1;
+    static constexpr uint64_t REF_OFFSET_MASK = (1ULL << 56) - 1;
+
+    const Entry* find(int64_t key) const;
+    Entry* insert_slot(int64_t key);
+
+    // Store page_data in a slot, as a stripe reference or in the spill
+    // file, and set entry.where / entry.loc (and the per-kind counters)
+    void place(Entry& entry, const uint8_t* page_data, const PageLocation& location);
+    void grow();
+
+    uint8_t* allocate_slot(uint64_t& out_slot);
+    uint8_t* slot_ptr(uint64_t slot);
+    const uint8_t* slot_ptr(uint64_t slot) const;
+
+    bool read_reference(const Entry& e, uint8_t* out_page) const;
+    const uint8_t* reference_view(const Entry& e) const;
+    const MappedStripe* stripe_map(int stripe_index) const;
+    bool spill(const uint8_t* page_data, uint64_t& out_offset);
+
+    PageStoreConfig config_;
+    size_t budget_pages_ = 0;
+
+    // Slab storage
+    std::vector<std::unique_ptr<uint8_t[]>> slabs_;
+    size_t slab_pages_ = 0;
+    size_t used_slots_ = 0;
+
+    // Open-addressing index (linear probing, power-of-two capacity)
+    std::vector<Entry> table_;
+    size_t count_ = 0;
+    size_t resident_count_ = 0;
+    size_t reference_count_ = 0;
+    size_t spill_count_ = 0;
+
+    // Offset-only reference sources
+    std::vector<std::string> stripe_paths_;
+    mutable std::vector<std::unique_ptr<MappedStripe>> stripe_maps_;
+    mutable std::vector<bool> stripe_map_failed_;
+    mutable std::vector<std::unique_ptr<std::ifstream>> stripe_files_;
+    mutable std::mutex source_mutex_;
+
+    // Spill file
+    std::string spill_path_;
+    mutable std::fstream spill_file_;
+    uint64_t spill_size_ = 0;
+    mutable std::mutex spill_mutex_;
+};
+
+}  // namespace bakread
@@ -4,6 +4,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #ifdef BAKREAD_HAS_PARQUET
 namespace arrow { class Schema; class ArrayBuilder; class RecordBatch; }
@@ -13,14 +14,29 @@ namespace parquet::arrow { class FileWriter; }
 
 namespace bakread {
 
+// -------------------------------------------------------------------------
+// ParquetWriter -- Apache Arrow Parquet output
+//
+// Decimals are written as decimal128(p, s), GUIDs as fixed_size_binary(16)
+// (RFC 4122 byte order), DATE as date32, TIME as time64(us) and the
+// datetime types as timestamp(us) (datetimeoffset normalised to UTC).
+// Row-group size, codec, dictionary encoding and column-parallel encoding
+// come from ParquetOptions.
+// -------------------------------------------------------------------------
 class ParquetWriter : public IExportWriter {
 public:
-    ParquetWriter();
+    explicit ParquetWriter(const ParquetOptions& options = {});
     ~ParquetWriter() override;
 
     bool open(const std::string& path, const TableSchema& schema) override;
     bool write_row(const Row& row) override;
     bool close() override;
+
+#ifdef BAKREAD_HAS_PARQUET
+    bool accepts_columns() const override { return true; }
+    bool write_columns(const ColumnBatch& batch) override;
+    ColumnLayout column_layout() const override { return ColumnLayout::Typed; }
+#endif
     uint64_t rows_written() const override { return rows_written_; }
 
 private:
@@ -30,15 +46,21 @@ private:
     // Map SQL types to Arrow types
     std::shared_ptr<arrow::Schema> build_arrow_schema(const TableSchema& schema);
 
+    // Bulk-append one column buffer to its builder
+    bool append_column(arrow::ArrayBuilder* builder, const ColumnBuffer& col,
+                       size_t first, size_t count);
+
     std::shared_ptr<arrow::io::FileOutputStream> output_stream_;
     std::unique_ptr<parquet::arrow::FileWriter>  writer_;
     std::vector<std::shared_ptr<arrow::ArrayBuilder>> builders_;
     std::shared_ptr<arrow::Schema> arrow_schema_;
+    std::vector<ColumnKind> kinds_;              // Typed-layout kind per column
 
-    static constexpr int BATCH_SIZE = 65536;
-    int current_batch_size_ = 0;
+    int64_t batch_rows_ = 65536;                 // Rows per flush = row group
+    int64_t current_batch_size_ = 0;
 #endif
 
+    ParquetOptions options_;
     TableSchema schema_;
     uint64_t    rows_written_ = 0;
     bool        open_ = false;
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "bakread/export_writer.h"
+#include "bakread/types.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace bakread {
+
+// -------------------------------------------------------------------------
+// PartitionedOutput -- the part files of a partitioned export
+//
+// A partitioned export (--writers N / --split-rows N) writes a directory of
+// part-00000.<ext>, part-00001.<ext>, ... plus a _manifest.json listing
+// every part with its row count. Writer threads open parts here as they
+// need them; part numbers are handed out in opening order.
+// -------------------------------------------------------------------------
+class PartitionedOutput {
+public:
+    PartitionedOutput(const std::string& dir, OutputFormat format,
+                      const std::string& delimiter, uint64_t split_rows,
+                      const ParquetOptions& parquet = {});
+
+    // Create the directory and delete part files and the manifest left by
+    // an earlier export into it (other files are untouched)
+    void prepare();
+
+    // Open the next part file. Thread-safe.
+    std::unique_ptr<IExportWriter> open_part(const TableSchema& schema, size_t& part);
+
+    // Close a part opened by open_part and record its row count. Thread-safe.
+    void close_part(size_t part, IExportWriter& writer);
+
+    // True once a part has reached --split-rows (never without it)
+    bool part_full(const IExportWriter& writer) const {
+        return split_rows_ > 0 && writer.rows_written() >= split_rows_;
+    }
+
+    // Write _manifest.json (table, format, columns, parts, total rows)
+    bool write_manifest(const std::string& table, const TableSchema& schema) const;
+
+    size_t part_count() const;
+
+    // Total size of the closed part files
+    uint64_t bytes_written() const;
+    const std::string& dir() const { return dir_; }
+
+private:
+    struct Part {
+        std::string file;        // File name within dir_
+        uint64_t    rows = 0;
+    };
+
+    std::string part_name(size_t part) const;
+
+    std::string    dir_;
+    OutputFormat   format_;
+    std::string    delimiter_;
+    uint64_t       split_rows_;
+    ParquetOptions parquet_;
+
+    mutable std::mutex mu_;
+    std::vector<Part>  parts_;
+};
+
+}  // namespace bakread
@@ -2,58 +2,111 @@
 
 #include "bakread/cli.h"
 #include "bakread/export_writer.h"
+#include "bakread/logging.h"
+#include "bakread/row_batch.h"
+#include "bakread/run_stats.h"
 #include "bakread/types.h"
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <string>
 #include <thread>
 #include <vector>
 
 namespace bakread {
 
+class DirectExtractor;
+class PartitionedOutput;
+struct DirectExtractResult;
+
 // -------------------------------------------------------------------------
-// Thread-safe bounded row queue for producer-consumer pipeline
+// Thread-safe bounded queue of batches for producer-consumer pipeline
+//
+// Synchronisation happens once per batch rather than once per row. Batches
+// circulate between a free list and the full queue: the producer acquire()s
+// an empty batch, fills it and push()es it; a consumer pop()s it, writes
+// it and release()s it back. After warm-up no batch is ever allocated.
+// Any number of consumers may pop from one queue (partitioned output).
 // -------------------------------------------------------------------------
-class RowQueue {
+template <typename Batch>
+class BatchQueue {
 public:
-    explicit RowQueue(size_t capacity = 10000);
+    // capacity: max batches in flight (queued + being filled/written)
+    // batch_rows: capacity of each RowBatch (ignored for ColumnBatch)
+    explicit BatchQueue(size_t capacity = 8,
+                        size_t batch_rows = RowBatch::DEFAULT_CAPACITY);
+
+    // Get an empty batch. Blocks while all batches are in use.
+    // Returns nullptr if the queue is finished.
+    std::unique_ptr<Batch> acquire();
+
+    // Queue a filled batch. Returns false if done.
+    bool push(std::unique_ptr<Batch> batch);
 
-    // Push a row. Blocks if queue is full. Returns false if done.
-    bool push(Row row);
+    // Pop a batch. Blocks if queue is empty. Returns false if done and empty.
+    bool pop(std::unique_ptr<Batch>& batch);
 
-    // Pop a row. Blocks if queue is empty. Returns false if done and empty.
-    bool pop(Row& row);
+    // Return a consumed batch to the free list
+    void release(std::unique_ptr<Batch> batch);
 
-    // Signal that no more rows will be pushed
+    // Signal that no more batches will be pushed
     void finish();
 
-    // Get approximate queue size
+    // Stop both sides immediately (pending batches are dropped)
+    void abort();
+
+    // Get approximate number of queued batches
     size_t size() const;
 
+    // High-water mark, batch count and time either side spent blocked
+    QueueStats stats() const;
+
 private:
-    std::queue<Row>         queue_;
+    std::deque<std::unique_ptr<Batch>>  queue_;
+    std::vector<std::unique_ptr<Batch>> free_;
     size_t                  capacity_;
+    size_t                  batch_rows_;
+    size_t                  allocated_ = 0;
     mutable std::mutex      mu_;
-    std::condition_variable not_full_;
+    std::condition_variable batch_free_;
     std::condition_variable not_empty_;
     bool                    finished_ = false;
+    bool                    aborted_  = false;
+
+    // Telemetry (waits are timed only when a call actually blocks)
+    size_t                  high_water_ = 0;
+    uint64_t                batches_    = 0;
+    double                  producer_wait_ = 0.0;
+    double                  consumer_wait_ = 0.0;
 };
 
+using RowQueue    = BatchQueue<RowBatch>;
+using ColumnQueue = BatchQueue<ColumnBatch>;
+
 // -------------------------------------------------------------------------
 // Pipeline -- orchestrates the full extraction pipeline
 //
-//   [Reader Thread] --> [RowQueue] --> [Writer Thread]
+//   [Reader Thread] --> [RowQueue of RowBatches] --> [Writer Thread]
 //
 // The reader thread can be either:
 //   - DirectExtractor (Mode A)
 //   - RestoreAdapter (Mode B)
 //
-// The writer thread writes to CSV/Parquet/JSONL.
+// The writer thread writes to CSV/Parquet/JSONL. With --tables, one
+// DirectExtractor loads every table in a single pass over the backup and
+// each table then gets its own writer and output file.
+//
+// Partitioned output (--writers / --split-rows) replaces the single writer
+// thread with N of them popping from the same queue, each writing its own
+// part files; Parquet parts are fed column batches, so encoding runs on
+// all N threads.
+//
+// Stage timings, queue stalls and writer throughput are collected in a
+// RunStats (see run_stats.h) and written to --stats-json.
 // -------------------------------------------------------------------------
 
 struct PipelineResult {
@@ -72,23 +125,72 @@ public:
     // Run the full pipeline
     PipelineResult run();
 
+    // Export an already configured extractor (table, columns, filter,
+    // progress callback) to opts.output_path in opts.format -- the writer
+    // half of direct mode, for callers that own the extractor
+    PipelineResult export_direct(DirectExtractor& extractor);
+
+    // Report into stats instead of the pipeline's own RunStats (the C API
+    // keeps one per handle). stats must outlive the pipeline.
+    void set_stats(RunStats* stats) { stats_ = stats; }
+
+    // Telemetry of the run so far; written to opts.stats_json by run()
+    const RunStats& stats() const { return *stats_; }
+
 private:
+    // Multi-table run (opts.tables): headers, catalog and data pages are
+    // read once, then each table is exported to its own file. In auto mode
+    // tables that fail direct mode fall back to restore mode one by one.
+    PipelineResult run_tables();
+
+    // Options for exporting one table of a multi-table run
+    Options table_options(const std::string& schema, const std::string& table) const;
+
     // Mode A attempt
     PipelineResult try_direct_mode();
 
     // Mode B attempt
     PipelineResult try_restore_mode();
 
-    // Writer thread entry point
+    // Writer thread entry point: drains batches from the queue
     void writer_thread_func(IExportWriter* writer,
                             RowQueue& queue,
                             std::atomic<uint64_t>& written,
                             std::atomic<bool>& error_flag);
 
-    // Progress reporting
+    // Run an extraction whose row callback feeds a writer thread through
+    // a RowQueue. open_writer is called with the first row, before the
+    // writer thread starts. Returns false on write error.
+    using RowSink      = std::function<bool(const Row&)>;
+    using ExtractFn    = std::function<void(const RowSink&)>;
+    bool run_batched(IExportWriter& writer, const std::function<void()>& open_writer,
+                     const ExtractFn& extract);
+
+    // Partitioned counterparts of run_batched: opts.writers threads drain
+    // one queue into part files of `parts`. schema is called with the first
+    // row (or batch), before the writer threads start.
+    bool run_partitioned(PartitionedOutput& parts,
+                         const std::function<TableSchema()>& schema,
+                         const ExtractFn& extract);
+    bool run_partitioned_columns(PartitionedOutput& parts, DirectExtractor& extractor,
+                                 DirectExtractResult& result, ColumnLayout layout);
+
+    // Writer thread of a partitioned export: opens a part on its first
+    // batch and moves to a new one whenever the current part is full
+    template <typename Batch>
+    void part_writer_func(BatchQueue<Batch>& queue,
+                          PartitionedOutput& parts,
+                          const TableSchema& schema,
+                          std::atomic<uint64_t>& written,
+                          std::atomic<bool>& error_flag);
+
+    // Progress reporting (at most one line per second; 100% always shown)
     void report_progress(uint64_t rows, double pct);
 
-    Options opts_;
+    Options   opts_;
+    RunStats  own_stats_;
+    RunStats* stats_ = &own_stats_;
+    LogRateLimiter progress_limit_{std::chrono::seconds(1)};
 };
 
 }  // namespace bakread
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bakread {
+
+struct ReadAheadConfig {
+    size_t depth       = 4;                  // Buffers in flight
+    size_t buffer_size = 4 * 1024 * 1024;    // Bytes per read (rounded to 8KB)
+    bool   unbuffered  = false;              // Bypass the OS page cache
+};
+
+// -------------------------------------------------------------------------
+// ReadAhead -- sequential reader that keeps the disk busy while the caller
+// parses
+//
+// Streams [begin, end) of a file through a ring of `depth` buffers. A
+// dedicated I/O thread issues positional reads (pread / ReadFile at an
+// OVERLAPPED offset) into free buffers, so up to depth - 1 reads are in
+// flight while the consumer works on a completed one.
+//
+// With `unbuffered` the file is opened O_DIRECT (F_NOCACHE on macOS,
+// FILE_FLAG_NO_BUFFERING on Windows) so a one-shot scan does not fill the
+// page cache. Buffers are 4KB aligned and reads are issued in whole 4KB
+// units; `begin` must be 4KB aligned (page scans start on 8KB boundaries).
+// If the file system refuses unbuffered access the reader falls back to
+// cached reads.
+//
+// Used by the unmapped scan paths; mapped stripes get the equivalent from
+// MappedStripe::prefetch() a window ahead of the cursor.
+// -------------------------------------------------------------------------
+class ReadAhead {
+public:
+    // Throws FileIOError if the file cannot be opened.
+    ReadAhead(const std::string& path, uint64_t begin, uint64_t end,
+              const ReadAheadConfig& config = {});
+    ~ReadAhead();
+
+    ReadAhead(const ReadAhead&) = delete;
+    ReadAhead& operator=(const ReadAhead&) = delete;
+
+    // Next buffer in file order. Returns false at the end of the range or
+    // after a read error (see failed()). The buffer stays valid until the
+    // next call.
+    bool next(const uint8_t*& data, size_t& length, uint64_t& offset);
+
+    bool failed() const;
+
+    // True when reads bypass the page cache
+    bool unbuffered() const { return unbuffered_; }
+
+private:
+    struct Slot {
+        uint8_t* data   = nullptr;
+        size_t   length = 0;
+        uint64_t offset = 0;
+    };
+
+    void io_loop();
+
+    // Positional read; false on I/O error, got < count only at end of file
+    bool read_at(uint8_t* dest, size_t count, uint64_t offset, size_t& got);
+
+    std::string path_;
+    uint64_t    begin_;
+    uint64_t    end_;
+    size_t      buffer_size_;
+    bool        unbuffered_ = false;
+
+    std::vector<uint8_t> storage_;
+    std::vector<Slot>    slots_;
+
+    mutable std::mutex      mutex_;
+    std::condition_variable space_cv_;   // consumer released a buffer
+    std::condition_variable data_cv_;    // I/O thread completed a buffer
+    uint64_t produced_ = 0;
+    uint64_t consumed_ = 0;
+    bool     holding_  = false;          // consumer owns slots_[consumed_ % depth]
+    bool     done_     = false;
+    bool     failed_   = false;
+    bool     stop_     = false;
+
+#ifdef _WIN32
+    void* handle_ = nullptr;
+#else
+    int   fd_ = -1;
+#endif
+
+    std::thread io_thread_;
+};
+
+}  // namespace bakread
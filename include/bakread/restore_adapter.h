@@ -51,9 +51,31 @@ struct RestoreOptions {
     std::string master_key_password;
     bool        cleanup_keys = false;
 
-    // Restore file relocation
-    std::string data_file_path;   // If empty, uses SQL Server default
-    std::string log_file_path;
+    // Restore file relocation. Data files go round-robin across
+    // data_dirs (one per volume spreads the restore writes); empty uses
+    // the instance default paths.
+    std::vector<std::string> data_dirs;
+    std::string log_dir;
+
+    // RESTORE throughput (0 = server default). max_transfer_size is in
+    // bytes: a multiple of 64KB, at most 4MB.
+    int         buffer_count      = 0;
+    int         max_transfer_size = 0;
+
+    // Keep the restored database after extraction. Without an explicit
+    // target_database it is named after a fingerprint of the backup set,
+    // and later runs on the same backup set reuse it instead of restoring.
+    bool        keep_database = false;
+
+    // Use the fingerprint name and reuse a database restored from the same
+    // backup set, but drop it afterwards unless keep_database is set (the
+    // last of several tables served by one restore). Implied by
+    // keep_database.
+    bool        reuse_database = false;
+
+    // Concurrent range queries over the restored table, one connection
+    // each (1 = a single SELECT). Row order across ranges is not kept.
+    int         parallel_queries = 1;
 };
 
 using RowCallback = std::function<bool(const Row& row)>;
@@ -71,6 +93,9 @@ struct RestoreListTablesResult {
     std::string error_message;
 };
 
+// True for columns fetched with SQLGetData rather than bound buffers
+bool is_lob_column(const ColumnDef& col);
+
 class OdbcConnection {
 public:
     OdbcConnection();
@@ -93,12 +118,23 @@ public:
     // Execute and fetch scalar int result
     bool query_scalar_int(const std::string& sql, int64_t& result);
 
-    // Execute a query and process rows via callback
-    // The callback receives column values as strings
+    // Execute a query and process rows via callback. `schema` describes
+    // the select list in order. Result columns are bound column-wise and
+    // fetched FETCH_ROWS rows at a time; LOB columns (MAX types, text,
+    // image, xml, sql_variant) are read with SQLGetData and must come after
+    // every other column in the select list. Select column i lands in
+    // row[positions[i]] (identity when positions is empty).
     bool query_rows(const std::string& sql,
                     const std::vector<ColumnDef>& schema,
                     RowCallback callback,
-                    int64_t max_rows = -1);
+                    int64_t max_rows = -1,
+                    const std::vector<size_t>& positions = {});
+
+    // Rows per block fetch, and the cap on bound buffer memory that lowers
+    // it for wide rows. With LOB columns each fetch returns one row (the
+    // driver does not support SQLGetData on block cursors).
+    static constexpr size_t FETCH_ROWS         = 4096;
+    static constexpr size_t FETCH_BUFFER_BYTES = 16 * 1024 * 1024;
 
     // Get last error message
     std::string last_error() const;
@@ -114,10 +150,13 @@ private:
     void free_handles();
     std::string get_diag(SQLSMALLINT handle_type, SQLHANDLE handle);
 
-    // Convert ODBC SQL type to a RowValue
+    // Convert ODBC SQL type to a RowValue (one SQLGetData call)
     RowValue fetch_column_value(SQLHSTMT stmt, int col_index,
                                 const ColumnDef& col_def);
 
+    // Put the statement back to one row per fetch with nothing bound
+    void reset_fetch_attrs();
+
     SQLHENV  env_  = SQL_NULL_HENV;
     SQLHDBC  dbc_  = SQL_NULL_HDBC;
     SQLHSTMT stmt_ = SQL_NULL_HSTMT;
@@ -155,18 +194,42 @@ private:
     // Step 5: Read table schema from restored DB
     bool step_read_schema();
 
+    // Step 4 with keep_database: use an existing database restored from
+    // this backup set (recorded in its bakread_fingerprint property)
+    bool reuse_database();
+
     // Step 6: Extract rows
     uint64_t step_extract_rows(RowCallback& callback);
 
+    // Split the table into up to n disjoint WHERE predicates that cover
+    // every row: partition-number ranges for a partitioned table, key
+    // ranges on an integer leading clustered key, otherwise page id modulo
+    // n from %%physloc%%. Empty when the table cannot be split.
+    std::vector<std::string> plan_ranges(size_t n);
+
+    // Run one query per range on its own connection and hand the rows to
+    // callback from one thread at a time
+    uint64_t extract_ranges(const std::vector<std::string>& ranges,
+                            RowCallback& callback);
+
     // Step 7: Cleanup (drop DB, remove certs)
     void step_cleanup();
 
-    // Build the SELECT query
-    std::string build_select_query() const;
+    // Schema indices in select-list order: LOB columns last, so they can
+    // be read with SQLGetData after the bound ones
+    std::vector<size_t> select_order() const;
+
+    // Build the SELECT query (columns in select_order()), restricted to
+    // `range` when given
+    std::string build_select_query(const std::string& range = "") const;
 
     // Build the FROM DISK = N'...' clause for multi-file restores
     std::string build_from_disk_clause() const;
 
+    // Hash of the backup set being restored (HEADERONLY identity fields
+    // and stripe sizes), as 16 hex digits
+    std::string backup_set_fingerprint() const;
+
     // Generate a unique temp database name
     static std::string generate_temp_db_name();
 
@@ -176,6 +239,7 @@ private:
 
     std::unique_ptr<OdbcConnection> conn_;
     std::string temp_db_name_;
+    std::string fingerprint_;
     bool        db_restored_ = false;
     bool        cert_imported_ = false;
     bool        master_key_created_ = false;
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "bakread/types.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace bakread {
+
+// -------------------------------------------------------------------------
+// RowBatch -- fixed-capacity, reusable block of rows
+//
+// The row slots are allocated once. clear() only resets the fill count, so
+// the per-row vectors (and string values inside them) keep their capacity
+// and a recycled batch is refilled without touching the allocator.
+// -------------------------------------------------------------------------
+class RowBatch {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+    explicit RowBatch(size_t capacity = DEFAULT_CAPACITY)
+        : rows_(capacity)
+    {
+    }
+
+    size_t capacity() const { return rows_.size(); }
+    size_t size() const     { return count_; }
+    bool   empty() const    { return count_ == 0; }
+    bool   full() const     { return count_ >= rows_.size(); }
+
+    // Reset the fill count; row storage is kept for reuse
+    void clear() { count_ = 0; }
+
+    // Copy a row into the next slot. Returns false if the batch is full.
+    bool add(const Row& row) {
+        if (full()) return false;
+        rows_[count_++] = row;
+        return true;
+    }
+
+    bool add(Row&& row) {
+        if (full()) return false;
+        rows_[count_++] = std::move(row);
+        return true;
+    }
+
+    const Row& operator[](size_t i) const { return rows_[i]; }
+    Row&       operator[](size_t i)       { return rows_[i]; }
+
+    const Row* begin() const { return rows_.data(); }
+    const Row* end() const   { return rows_.data() + count_; }
+
+private:
+    std::vector<Row> rows_;
+    size_t           count_ = 0;
+};
+
+}  // namespace bakread
@@ -1,14 +1,19 @@
 #pragma once
 
+#include "bakread/column_batch.h"
 #include "bakread/page.h"
 #include "bakread/types.h"
 
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
 namespace bakread {
 
+class LobReader;
+class RowFilter;
+
 // -------------------------------------------------------------------------
 // RowDecoder -- parses SQL Server FixedVar row format from data pages
 //
@@ -27,11 +32,32 @@ namespace bakread {
 //     2 bytes : Number of variable-length columns
 //     2*V bytes : End offset for each variable-length column
 //     Variable-length column data follows
+//
+// Values stored off-row (row-overflow, MAX types, TEXT/NTEXT/IMAGE) leave
+// a pointer in the record. With a LobReader set, the decoder follows it and
+// streams the value's fragments into the output cell; without one (or when
+// the chain cannot be read) the cell holds the "[LOB data]" placeholder.
 // -------------------------------------------------------------------------
 class RowDecoder {
 public:
     explicit RowDecoder(const TableSchema& schema);
 
+    // Projecting decoder. `schema` is the full physical schema (it defines
+    // the record geometry); `projection` lists the schema indices to output,
+    // in output order. Rows and column batches then hold only those columns,
+    // and the bytes of every other column are never looked at. An empty
+    // projection means all columns.
+    //
+    // With a filter, decode_page / decode_page_columnar test each record on
+    // its raw bytes first and skip the ones that do not match (the filter
+    // may reference unprojected columns). The filter must outlive the decoder.
+    RowDecoder(const TableSchema& schema, const std::vector<int>& projection,
+               const RowFilter* filter = nullptr);
+
+    // Resolve off-row values through lob (nullptr = placeholders). The
+    // reader must outlive the decoder; it may be shared between decoders.
+    void set_lob_reader(const LobReader* lob) { lob_ = lob; }
+
     // Decode a single row from a page at the given record offset.
     // page_data: pointer to the full 8KB page
     // record_offset: offset within the page where the record starts
@@ -39,29 +65,129 @@ public:
     bool decode_row(const uint8_t* page_data, uint16_t record_offset,
                     Row& out_row) const;
 
+    // Reference decoder that re-dispatches on ColumnDef::type for every
+    // cell instead of using the decode plan. Produces the same row as
+    // decode_row(); kept for verification and the decoder benchmark.
+    bool decode_row_dynamic(const uint8_t* page_data, uint16_t record_offset,
+                            Row& out_row) const;
+
     // Decode all rows from a data page.
     // Returns the number of rows decoded.
     int decode_page(const uint8_t* page_data, std::vector<Row>& out_rows) const;
 
-    // Get the schema used for decoding
-    const TableSchema& schema() const { return schema_; }
+    // Columnar variant: append every row of a data page straight into the
+    // column buffers of out (which must have been reset() for this schema).
+    // No Row or per-cell std::string is built. Returns rows decoded.
+    int decode_page_columnar(const uint8_t* page_data, ColumnBatch& out) const;
 
-private:
-    // Type-specific value extraction from the fixed-data region
-    RowValue decode_fixed_column(const uint8_t* data, size_t data_len,
-                                 const ColumnDef& col) const;
+    // Physical schema the records are parsed with
+    const TableSchema& schema() const { return schema_; }
 
-    // Type-specific value extraction from the variable-data region
-    RowValue decode_variable_column(const uint8_t* data, size_t data_len,
-                                    const ColumnDef& col) const;
+    // Columns produced by decode_row / decode_page_columnar
+    const TableSchema& output_schema() const { return output_schema_; }
 
-    // Convert raw bytes to a typed RowValue
+private:
+    // Geometry of one record (null bitmap, variable-column offset array),
+    // parsed once and shared by the row and columnar paths
+    struct RecordView {
+        const uint8_t* rec = nullptr;
+        size_t         max_len = 0;
+        uint16_t       fixed_end = 0;
+        const uint8_t* null_bitmap = nullptr;
+        uint16_t       null_cols = 0;
+        const uint8_t* var_offsets = nullptr;
+        uint16_t       var_count = 0;
+        uint16_t       var_data_start = 0;
+
+        bool is_null(size_t col) const {
+            return null_bitmap && col < null_cols &&
+                   (null_bitmap[col >> 3] & (1u << (col & 7))) != 0;
+        }
+        uint16_t var_end(size_t vi) const {
+            uint16_t v;
+            std::memcpy(&v, var_offsets + vi * 2, 2);
+            return v;
+        }
+    };
+
+    enum class Cell { Null, Value, Lob };
+
+    // How an off-row value is assembled: raw bytes (std::vector / binary
+    // column), single-byte text, or UTF-16LE text converted to UTF-8
+    enum class LobText : uint8_t { Bytes, Chars, Utf16 };
+
+    using ValueFn  = RowValue (*)(const uint8_t* data, size_t len, const ColumnDef& col);
+    using AppendFn = void (*)(ColumnBuffer& out, const uint8_t* data, size_t len,
+                              const ColumnDef& col);
+
+    // One step of the decode plan: everything about a column that does not
+    // depend on the row, resolved once in the constructor. Per-row work is a
+    // loop over these with no switch on the column type.
+    struct ColumnPlan {
+        ValueFn          value  = nullptr;   // type-specialized RowValue decoder
+        AppendFn         append = nullptr;   // type-specialized columnar decoder
+        const ColumnDef* def    = nullptr;
+        uint16_t         physical  = 0;      // schema index == null bitmap bit
+        uint16_t         column    = 0;      // position in the output row
+        uint16_t         var_index = 0;      // variable columns: slot in offset array
+        uint16_t         null_byte = 0;
+        uint8_t          null_mask = 0;
+        uint16_t         offset = 0;         // fixed columns: byte offset in record
+        uint16_t         length = 0;         // fixed columns: declared width
+        bool             fixed  = false;
+        bool             text_ptr = false;   // TEXT/NTEXT/IMAGE: 16-byte text pointer
+        LobText          lob = LobText::Bytes;
+
+        bool is_null(const RecordView& view) const {
+            return view.null_bitmap && physical < view.null_cols &&
+                   (view.null_bitmap[null_byte] & null_mask) != 0;
+        }
+    };
+
+    bool parse_record(const uint8_t* page_data, uint16_t record_offset,
+                      RecordView& view) const;
+
+    // Build the projected columns of a parsed record
+    void materialize(const RecordView& view, Row& out_row) const;
+
+    // Row filter test on the raw record
+    bool passes(const RecordView& view) const;
+
+    // Off-row value behind the pointer of a Cell::Lob, read through lob_;
+    // the placeholder when it cannot be resolved
+    RowValue lob_value(const ColumnPlan& plan, const uint8_t* pointer, size_t len) const;
+    void append_lob(ColumnBuffer& out, const ColumnPlan& plan, const uint8_t* pointer,
+                    size_t len) const;
+
+    // Locate a column's bytes inside a parsed record (for Cell::Lob, the
+    // off-row pointer)
+    static Cell fixed_cell(const RecordView& view, const ColumnPlan& plan,
+                           const uint8_t*& data, size_t& len);
+    static Cell var_cell(const RecordView& view, const ColumnPlan& plan,
+                         const uint8_t*& data, size_t& len);
+
+    // Type-specialized decoders the plan points at; one instantiation per
+    // physical representation
+    template <SqlType T>
+    static RowValue value_as(const uint8_t* data, size_t len, const ColumnDef& col);
+    template <SqlType T>
+    static void append_as(ColumnBuffer& out, const uint8_t* data, size_t len,
+                          const ColumnDef& col);
+
+    static ValueFn  value_fn_for(SqlType t);
+    static AppendFn append_fn_for(SqlType t);
+
+    // Convert raw bytes to a typed RowValue (dynamic dispatch on col.type)
     RowValue bytes_to_value(const uint8_t* data, size_t len,
                             const ColumnDef& col) const;
 
     // UTF-16LE to UTF-8 conversion
     static std::string utf16le_to_utf8(const uint8_t* data, size_t byte_len);
 
+    // Same, into a caller buffer of at least byte_len * 3 / 2 + 4 bytes.
+    // Returns the number of bytes written.
+    static size_t utf16le_to_utf8(const uint8_t* data, size_t byte_len, char* out);
+
     // DECIMAL/NUMERIC conversion
     static SqlDecimal decode_decimal(const uint8_t* data, size_t len,
                                      uint8_t precision, uint8_t scale);
@@ -78,12 +204,30 @@ private:
     static std::string decode_datetimeoffset(const uint8_t* data, size_t len,
                                               uint8_t scale);
 
-    const TableSchema& schema_;
+    // Buffer-based formatters behind the decode_* helpers above. `out` must
+    // hold FORMAT_BUF_SIZE bytes; the return value is the text length.
+    static constexpr size_t FORMAT_BUF_SIZE = 64;
+    static size_t format_datetime(const uint8_t* data, char* out);
+    static size_t format_datetime2(const uint8_t* data, uint8_t scale, char* out);
+    static size_t format_smalldatetime(const uint8_t* data, char* out);
+    static size_t format_date(const uint8_t* data, char* out);
+    static size_t format_time(const uint8_t* data, size_t len, uint8_t scale, char* out);
+    static size_t format_datetimeoffset(const uint8_t* data, size_t len,
+                                        uint8_t scale, char* out);
 
-    // Pre-computed: which columns are fixed vs variable
-    std::vector<int> fixed_col_indices_;
-    std::vector<int> var_col_indices_;
-    std::vector<int> fixed_col_offsets_;  // byte offset within record for each fixed col
+    const TableSchema& schema_;
+    TableSchema        output_schema_;
+
+    // Decode plan for the projected columns: fixed-length columns, then the
+    // variable-length ones. Geometry (offsets, null bits, var slots) comes
+    // from the full schema, so unprojected columns simply have no entry.
+    std::vector<ColumnPlan> fixed_plan_;
+    std::vector<ColumnPlan> var_plan_;
+
+    // Geometry of every physical column (for the row filter)
+    std::vector<ColumnPlan> layout_;
+    const RowFilter*        filter_ = nullptr;
+    const LobReader*        lob_ = nullptr;
     int null_bitmap_bytes_ = 0;
 };
 
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "bakread/types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bakread {
+
+// -------------------------------------------------------------------------
+// RowFilter -- direct-mode pushdown of a --where condition
+//
+// Supported subset of T-SQL search conditions:
+//   col { = | <> | != | < | <= | > | >= } literal
+//   col [NOT] IN (literal, ...)
+//   col [NOT] BETWEEN literal AND literal
+//   col IS [NOT] NULL
+// combined with AND, OR, NOT and parentheses.
+//
+// Comparisons are limited to fixed-length numeric (integer, bit, float,
+// money, decimal) and temporal (date, time, datetime, smalldatetime,
+// datetime2) columns; IS NULL works on any column. Literals are converted to
+// the column's on-disk representation once, so the test runs on the raw
+// record bytes before any RowValue is built. NULLs follow SQL three-valued
+// logic: a row is kept only when the condition is TRUE.
+//
+// Anything outside this subset throws ConfigError from the constructor.
+// -------------------------------------------------------------------------
+class RowFilter {
+public:
+    // `schema` is the full physical schema; column names are matched
+    // case-insensitively and may be written as [name] or "name"
+    RowFilter(const std::string& condition, const TableSchema& schema);
+
+    // Physical column indices the condition reads (deduplicated)
+    const std::vector<int>& columns() const { return columns_; }
+
+    const std::string& text() const { return text_; }
+
+    // Evaluate against one record. cell(physical_index, data, len) must
+    // locate the column's bytes and return false when the column is NULL.
+    template <typename CellFn>
+    bool matches(CellFn&& cell) const {
+        return root_ < 0 || eval(root_, cell) == Truth::True;
+    }
+
+private:
+    enum class Truth : uint8_t { False, True, Unknown };
+    enum class Op : uint8_t { Eq, Ne, Lt, Le, Gt, Ge, In, Between, IsNull, IsNotNull };
+
+    // Comparable form of a value: exact integers for integer and temporal
+    // columns, long double for float/money/decimal
+    struct Key {
+        int64_t     i = 0;
+        long double r = 0;
+    };
+
+    struct Leaf {
+        int              column = 0;
+        SqlType          type   = SqlType::Unknown;
+        uint8_t          scale  = 0;
+        Op               op     = Op::Eq;
+        bool             negate = false;   // NOT IN / NOT BETWEEN
+        bool             real   = false;   // compare Key::r instead of Key::i
+        std::vector<Key> keys;
+    };
+
+    struct Node {
+        enum Kind : uint8_t { Pred, And, Or, Not } kind = Pred;
+        int left  = -1;     // And/Or/Not operand
+        int right = -1;     // And/Or second operand
+        int leaf  = -1;     // Pred: index into leaves_
+    };
+
+    template <typename CellFn>
+    Truth eval(int n, CellFn& cell) const {
+        const Node& node = nodes_[n];
+        switch (node.kind) {
+        case Node::Pred: {
+            const Leaf& leaf = leaves_[node.leaf];
+            const uint8_t* data = nullptr;
+            size_t len = 0;
+            bool present = cell(leaf.column, data, len);
+            return eval_leaf(leaf, present ? data : nullptr, len);
+        }
+        case Node::And: {
+            Truth a = eval(node.left, cell);
+            if (a == Truth::False) return a;
+            Truth b = eval(node.right, cell);
+            if (b == Truth::False) return b;
+            return (a == Truth::True && b == Truth::True) ? Truth::True : Truth::Unknown;
+        }
+        case Node::Or: {
+            Truth a = eval(node.left, cell);
+            if (a == Truth::True) return a;
+            Truth b = eval(node.right, cell);
+            if (b == Truth::True) return b;
+            return (a == Truth::False && b == Truth::False) ? Truth::False : Truth::Unknown;
+        }
+        case Node::Not: {
+            Truth a = eval(node.left, cell);
+            if (a == Truth::Unknown) return a;
+            return a == Truth::True ? Truth::False : Truth::True;
+        }
+        }
+        return Truth::Unknown;
+    }
+
+    // data == nullptr means the column is NULL in this record
+    Truth eval_leaf(const Leaf& leaf, const uint8_t* data, size_t len) const;
+
+    class Parser;
+
+    std::string       text_;
+    std::vector<Node> nodes_;
+    int               root_ = -1;
+    std::vector<Leaf> leaves_;
+    std::vector<int>  columns_;
+};
+
+}  // namespace bakread
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace bakread {
+
+// -------------------------------------------------------------------------
+// RunStats -- per-stage telemetry of one extraction
+//
+// The extractor and the pipeline report into a RunStats as they go:
+//   - stages:     wall and CPU time, rows, bytes and pages per phase
+//                 (headers, catalog_scan, catalog, resolve, page_scan,
+//                 decode, write, restore), accumulated by name
+//   - scan:       bytes read, header slots tested, pages validated,
+//                 rejected and kept by the backup scans
+//   - caches:     hit/miss counters of the page and block caches
+//   - page_store: where the in-memory store keeps its pages
+//   - queues:     high-water mark and producer/consumer stall time of the
+//                 decode pool and the writer queues
+//
+// to_json() renders everything as one JSON document (--stats-json,
+// bakread_get_stats). All methods are thread-safe; reporting is a handful
+// of counter updates per phase or per batch, never per row.
+// -------------------------------------------------------------------------
+
+// CPU time consumed so far by the whole process / the calling thread
+double process_cpu_seconds();
+double thread_cpu_seconds();
+
+struct StageStats {
+    double   wall_seconds = 0.0;
+    double   cpu_seconds  = 0.0;
+    uint64_t calls = 0;      // Times the stage ran (e.g. once per table)
+    uint64_t rows  = 0;
+    uint64_t bytes = 0;
+    uint64_t pages = 0;
+};
+
+struct ScanStats {
+    uint64_t bytes_read   = 0;
+    uint64_t slots_tested = 0;   // Header positions examined
+    uint64_t pages_valid  = 0;   // Plausible page headers
+    uint64_t pages_kept   = 0;   // Valid pages the scan's filter kept
+};
+
+struct CacheStats {
+    std::string name;
+    uint64_t    hits   = 0;
+    uint64_t    misses = 0;
+};
+
+struct PageStoreStats {
+    uint64_t pages            = 0;
+    uint64_t resident_pages   = 0;
+    uint64_t referenced_pages = 0;   // Re-read from the backup on demand
+    uint64_t spilled_pages    = 0;
+    uint64_t memory_bytes     = 0;
+};
+
+struct QueueStats {
+    size_t   capacity   = 0;     // Batches in flight at most
+    size_t   high_water = 0;     // Most batches waiting for the consumer at once
+    uint64_t batches    = 0;     // Batches handed over
+    double   producer_wait_seconds = 0.0;   // Producer blocked on a full queue
+    double   consumer_wait_seconds = 0.0;   // Consumer blocked on an empty queue
+};
+
+class RunStats {
+public:
+    // Scoped stage measurement (wall time, and process CPU time so decode
+    // workers are included), added to the stage when destroyed. A null
+    // RunStats makes every call a no-op, so callers need no checks.
+    class Timer {
+    public:
+        Timer(RunStats* stats, const char* stage);
+        ~Timer();
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        void add_rows(uint64_t n)  { s_.rows += n; }
+        void add_bytes(uint64_t n) { s_.bytes += n; }
+        void add_pages(uint64_t n) { s_.pages += n; }
+
+    private:
+        RunStats*   stats_;
+        const char* stage_;
+        StageStats  s_;
+        std::chrono::steady_clock::time_point start_;
+        double      cpu_start_ = 0.0;
+    };
+
+    // Accumulate into a stage (created in first-report order)
+    void add_stage(const std::string& name, const StageStats& s);
+
+    void add_scan(const ScanStats& s);
+
+    // Cumulative counters of a cache or store; replace the previous report
+    void set_cache(const std::string& name, uint64_t hits, uint64_t misses);
+    void set_page_store(const PageStoreStats& s);
+
+    // Accumulate a queue's counters (waits add up, high-water is the max)
+    void add_queue(const std::string& name, const QueueStats& q);
+
+    // Outcome of the run, for the report header
+    void set_result(bool success, const std::string& mode, const std::string& error,
+                    uint64_t rows, double elapsed_seconds);
+
+    // Forget everything (the C API reuses one RunStats per handle)
+    void reset();
+
+    std::string to_json() const;
+
+    // Write to_json() to path. Returns false (and logs) on I/O failure.
+    bool write_json(const std::string& path) const;
+
+private:
+    struct Stage {
+        std::string name;
+        StageStats  s;
+    };
+    struct Queue {
+        std::string name;
+        QueueStats  q;
+    };
+
+    mutable std::mutex mu_;
+    std::vector<Stage>      stages_;
+    ScanStats               scan_;
+    std::vector<CacheStats> caches_;
+    PageStoreStats          page_store_;
+    bool                    has_page_store_ = false;
+    std::vector<Queue>      queues_;
+
+    bool        success_ = false;
+    std::string mode_;
+    std::string error_;
+    uint64_t    rows_ = 0;
+    double      elapsed_seconds_ = 0.0;
+    double      cpu_seconds_ = 0.0;
+    double      cpu_start_ = process_cpu_seconds();
+};
+
+}  // namespace bakread
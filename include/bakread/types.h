@@ -117,11 +117,27 @@ struct SqlDecimal {
 
     double to_double() const;
     std::string to_string() const;
+
+    // Write the exact text form (e.g. "-1234.5600", no terminator) into
+    // out: sign, up to 39 digits, point, and a leading zero when |v| < 1
+    static constexpr size_t FORMAT_SIZE = 41;
+    size_t format(char* out) const;
+
+    // Signed unscaled value as 16 bytes of little-endian two's complement
+    // (the Arrow / Parquet Decimal128 layout)
+    void unscaled_le(uint8_t out[16]) const;
 };
 
 struct SqlGuid {
     uint8_t bytes[16] = {};
     std::string to_string() const;
+
+    // Write the 36-character text form plus a terminator into out
+    static constexpr size_t FORMAT_SIZE = 36;
+    size_t format(char* out) const;
+
+    // The 16 bytes in RFC 4122 order, i.e. the order of the text form
+    void rfc4122(uint8_t out[16]) const;
 };
 
 using RowValue = std::variant<
@@ -167,6 +183,15 @@ enum class BackupType : uint8_t {
     Log           = 3,
 };
 
+inline const char* backup_type_name(BackupType t) {
+    switch (t) {
+        case BackupType::Full:         return "full";
+        case BackupType::Differential: return "differential";
+        case BackupType::Log:          return "log";
+        default:                       return "unknown";
+    }
+}
+
 struct BackupSetInfo {
     int32_t     position         = 0;
     std::string database_name;
@@ -182,6 +207,7 @@ struct BackupSetInfo {
     std::string backup_finish_date;
     int32_t     software_major   = 0;
     int32_t     software_minor   = 0;
+    std::string backup_set_guid;          // RESTORE HEADERONLY BackupSetGUID
 };
 
 struct BackupFileInfo {
@@ -229,6 +255,16 @@ enum class OutputFormat {
     JSONL,
 };
 
+// Parquet file settings; the other formats ignore them
+struct ParquetOptions {
+    int64_t     row_group_rows = 65536;   // Rows per row group
+    std::string codec = "snappy";         // snappy | zstd | lz4 | gzip | brotli | none
+    int         codec_level = 0;          // 0 = codec default
+    bool        dictionary = true;        // Dictionary-encode columns
+    std::vector<std::string> dictionary_columns;  // Non-empty: only these columns
+    bool        use_threads = false;      // Encode columns in parallel (Arrow thread pool)
+};
+
 // -------------------------------------------------------------------------
 // Progress callback
 // -------------------------------------------------------------------------
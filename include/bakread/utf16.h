@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakread {
+
+// -------------------------------------------------------------------------
+// UTF-16LE -> UTF-8 transcoding for NCHAR / NVARCHAR / NTEXT values
+//
+// Runs of ASCII are converted 32 code units at a time with AVX2, 16 with
+// SSE2 or NEON; anything else (multi-byte characters, surrogate pairs)
+// goes through the scalar converter. The SIMD kernel is picked once per
+// process from the CPU's features. Conversion stops at the first NUL code
+// unit, and an unpaired surrogate is encoded as a 3-byte sequence.
+// -------------------------------------------------------------------------
+
+// Worst-case UTF-8 size of byte_len bytes of UTF-16LE: each code unit
+// yields at most 3 bytes (a surrogate pair, 4 input bytes, yields 4)
+inline size_t utf8_capacity_for_utf16(size_t byte_len) {
+    return byte_len * 3 / 2 + 4;
+}
+
+// Convert into out (at least utf8_capacity_for_utf16(byte_len) bytes);
+// returns the number of bytes written
+size_t utf16le_to_utf8(const uint8_t* data, size_t byte_len, char* out);
+
+// Scalar reference converter (the fallback of utf16le_to_utf8)
+size_t utf16le_to_utf8_scalar(const uint8_t* data, size_t byte_len, char* out);
+
+// Name of the kernel utf16le_to_utf8 dispatches to ("avx2", "sse2",
+// "neon" or "scalar")
+const char* utf16_kernel_name();
+
+}  // namespace bakread
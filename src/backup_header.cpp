@@ -170,8 +170,9 @@ bool BackupHeaderParser::parse() {
 
     for (size_t i = 0; i < info_.backup_sets.size(); ++i) {
         auto& bs = info_.backup_sets[i];
-        LOG_INFO("  Set %zu: DB='%s' Server='%s' Compressed=%s TDE=%s Encrypted=%s",
+        LOG_INFO("  Set %zu: DB='%s' Server='%s' Type=%s Compressed=%s TDE=%s Encrypted=%s",
                  i, bs.database_name.c_str(), bs.server_name.c_str(),
+                 backup_type_name(bs.backup_type),
                  bs.is_compressed ? "yes" : "no",
                  bs.is_tde ? "yes" : "no",
                  bs.is_encrypted ? "yes" : "no");
@@ -243,10 +244,13 @@ static bool is_plausible_db_name(const uint8_t* utf16_data, size_t byte_len) {
 //   "{DatabaseName}-Full Database Backup"
 //   "{DatabaseName}-Differential Database Backup"
 //   "{DatabaseName}-Transaction Log Backup"
-static const char* const BACKUP_DESC_SUFFIXES[] = {
-    "-Full Database Backup",
-    "-Differential Database Backup",
-    "-Transaction Log Backup",
+static const struct {
+    const char* suffix;
+    BackupType  type;
+} BACKUP_DESC_SUFFIXES[] = {
+    { "-Full Database Backup",         BackupType::Full },
+    { "-Differential Database Backup", BackupType::Differential },
+    { "-Transaction Log Backup",       BackupType::Log },
 };
 
 void BackupHeaderParser::parse_sset_block(const std::vector<uint8_t>& data) {
@@ -292,10 +296,11 @@ void BackupHeaderParser::parse_sset_block(const std::vector<uint8_t>& data) {
         if (candidate.empty()) continue;
 
         // Try to extract the DB name from the backup description pattern.
-        for (auto suffix : BACKUP_DESC_SUFFIXES) {
-            auto pos = candidate.find(suffix);
+        for (const auto& desc : BACKUP_DESC_SUFFIXES) {
+            auto pos = candidate.find(desc.suffix);
             if (pos != std::string::npos && pos > 0) {
                 bsi.database_name = candidate.substr(0, pos);
+                bsi.backup_type   = desc.type;
                 LOG_DEBUG("Extracted DB name '%s' from backup description at "
                           "SSET offset %zu",
                           bsi.database_name.c_str(), off);
@@ -316,8 +321,10 @@ void BackupHeaderParser::parse_sset_block(const std::vector<uint8_t>& data) {
 
     if (info_.backup_sets.empty() || info_.backup_sets.back().position != bsi.position)
         info_.backup_sets.push_back(bsi);
-    else if (!bsi.database_name.empty() && info_.backup_sets.back().database_name.empty())
+    else if (!bsi.database_name.empty() && info_.backup_sets.back().database_name.empty()) {
         info_.backup_sets.back().database_name = bsi.database_name;
+        info_.backup_sets.back().backup_type   = bsi.backup_type;
+    }
 }
 
 bool BackupHeaderParser::parse_sql_media_header(const std::vector<uint8_t>& data) {
@@ -8,8 +8,8 @@
 
 namespace bakread {
 
-BackupStream::BackupStream(const std::string& path, size_t buffer_size)
-    : buffer_(buffer_size)
+BackupStream::BackupStream(const std::string& path, size_t buffer_size,
+                           bool use_mmap)
 {
     namespace fs = std::filesystem;
 
@@ -20,9 +20,22 @@ BackupStream::BackupStream(const std::string& path, size_t buffer_size)
     if (file_size_ == 0)
         throw FileIOError("File is empty: " + path);
 
-    file_.open(path, std::ios::binary);
-    if (!file_.is_open())
-        throw FileIOError("Cannot open file: " + path);
+    if (use_mmap) {
+        try {
+            map_ = std::make_unique<MappedStripe>(path);
+            map_->advise(MappedStripe::Access::Sequential);
+        } catch (const FileIOError& e) {
+            LOG_DEBUG("Memory mapping unavailable, using buffered reads: %s", e.what());
+            map_.reset();
+        }
+    }
+
+    if (!map_) {
+        buffer_.resize(buffer_size);
+        file_.open(path, std::ios::binary);
+        if (!file_.is_open())
+            throw FileIOError("Cannot open file: " + path);
+    }
 
     LOG_INFO("Opened backup file: %s (%.2f GB)",
              path.c_str(), file_size_ / (1024.0 * 1024.0 * 1024.0));
@@ -51,6 +64,14 @@ void BackupStream::refill() {
 }
 
 size_t BackupStream::read(void* dest, size_t count) {
+    if (map_) {
+        size_t got = static_cast<size_t>(
+            std::min<uint64_t>(count, file_size_ - std::min(logical_pos_, file_size_)));
+        if (got > 0) std::memcpy(dest, map_->data() + logical_pos_, got);
+        logical_pos_ += got;
+        return got;
+    }
+
     auto out = static_cast<uint8_t*>(dest);
     size_t total = 0;
 
@@ -74,6 +95,11 @@ bool BackupStream::read_exact(void* dest, size_t count) {
 }
 
 bool BackupStream::skip(uint64_t count) {
+    if (map_) {
+        logical_pos_ += count;
+        return logical_pos_ <= file_size_;
+    }
+
     // Use buffer where possible, then seek
     while (count > 0) {
         if (buf_pos_ < buf_len_) {
@@ -94,6 +120,11 @@ bool BackupStream::skip(uint64_t count) {
 }
 
 bool BackupStream::seek(uint64_t offset) {
+    if (map_) {
+        logical_pos_ = offset;
+        return offset <= file_size_;
+    }
+
     file_.clear();
     file_.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
     logical_pos_ = offset;
@@ -102,9 +133,15 @@ bool BackupStream::seek(uint64_t offset) {
 }
 
 bool BackupStream::peek(void* dest, size_t count) {
+    if (map_) {
+        const uint8_t* src = map_->view(logical_pos_, count);
+        if (!src) return false;
+        std::memcpy(dest, src, count);
+        return true;
+    }
+
     uint64_t saved = logical_pos_;
     size_t saved_buf_pos = buf_pos_;
-    size_t saved_buf_len = buf_len_;
 
     bool ok = read_exact(dest, count);
 
@@ -132,4 +169,16 @@ std::vector<uint8_t> BackupStream::read_bytes(size_t count) {
     return data;
 }
 
+const uint8_t* BackupStream::read_view(size_t count, size_t& got, uint8_t* scratch) {
+    if (map_) {
+        uint64_t pos = std::min(logical_pos_, file_size_);
+        got = static_cast<size_t>(std::min<uint64_t>(count, file_size_ - pos));
+        logical_pos_ = pos + got;
+        return map_->data() + pos;
+    }
+
+    got = read(scratch, count);
+    return scratch;
+}
+
 }  // namespace bakread
@@ -1,18 +1,114 @@
 #include "bakread/bakread_api.h"
+#include "bakread/column_batch.h"
 #include "bakread/direct_extractor.h"
+#include "bakread/pipeline.h"
+#include "bakread/run_stats.h"
 #include "bakread/backup_header.h"
 #include "bakread/backup_stream.h"
 #include "bakread/types.h"
 
+#include <array>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
 
+// Rows of one cursor batch as NUL-terminated strings in a single arena
+struct StringBatch {
+    std::string arena;
+    std::vector<size_t> offsets;      // Start of each value, row-major
+    std::vector<const char*> ptrs;    // Resolved by the consumer
+    size_t rows = 0;
+};
+
+// -------------------------------------------------------------------------
+// RowCursor -- pull-mode extraction for bakread_next_row / _next_batch
+//
+// One producer thread runs DirectExtractor::extract() once and converts
+// rows to strings into batches of BATCH_ROWS, handing them over through a
+// queue of at most MAX_QUEUED batches (it blocks when the consumer falls
+// behind). The consumer touches the lock only once per batch.
+// -------------------------------------------------------------------------
+struct RowCursor {
+    static constexpr size_t BATCH_ROWS  = 1024;
+    static constexpr size_t MAX_QUEUED  = 8;
+
+    std::thread producer;
+    std::mutex mutex;
+    std::condition_variable cv_ready;
+    std::condition_variable cv_space;
+    std::deque<StringBatch> queue;
+    bool done = false;                // Producer finished (or failed)
+    bool cancelled = false;           // Consumer ended the extraction
+    BakReadResult status = BAKREAD_OK;
+    std::string error;
+
+    // Consumer side
+    StringBatch current;
+    size_t next_row = 0;
+    int column_count = 0;
+
+    ~RowCursor() { stop(); }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cancelled = true;
+        }
+        cv_space.notify_all();
+        if (producer.joinable()) producer.join();
+    }
+
+    // Hand a full batch to the consumer; false once cancelled
+    bool push(StringBatch&& batch) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv_space.wait(lock, [&] { return queue.size() < MAX_QUEUED || cancelled; });
+        if (cancelled) return false;
+        queue.push_back(std::move(batch));
+        lock.unlock();
+        cv_ready.notify_one();
+        return true;
+    }
+
+    void finish(BakReadResult result, std::string message) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+            status = result;
+            error = std::move(message);
+        }
+        cv_ready.notify_all();
+    }
+
+    // Make `current` a batch with unread rows; false at the end of the
+    // data (status says whether the extraction succeeded)
+    bool advance() {
+        if (next_row < current.rows) return true;
+        std::unique_lock<std::mutex> lock(mutex);
+        cv_ready.wait(lock, [&] { return !queue.empty() || done; });
+        if (queue.empty()) return false;
+        current = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+        cv_space.notify_one();
+
+        current.ptrs.resize(current.offsets.size());
+        for (size_t i = 0; i < current.offsets.size(); ++i) {
+            current.ptrs[i] = current.arena.data() + current.offsets[i];
+        }
+        next_row = 0;
+        return true;
+    }
+};
+
 struct ReaderState {
     std::vector<std::string> bak_paths;
     std::unique_ptr<bakread::DirectExtractor> extractor;
@@ -41,13 +137,19 @@ struct ReaderState {
     BakProgressCallback progress_cb = nullptr;
     void* progress_user_data = nullptr;
     
-    bool extracting = false;
-    std::queue<bakread::Row> row_queue;
-    std::vector<std::string> current_row_strings;
-    std::vector<const char*> current_row_ptrs;
-    std::mutex queue_mutex;
-    bool extract_done = false;
-    uint64_t rows_extracted = 0;
+    // Streaming extraction (bakread_begin_extract .. bakread_end_extract)
+    std::unique_ptr<RowCursor> cursor;
+
+    // Rows written by the last bakread_export_* call
+    uint64_t rows_exported = 0;
+
+    // bakread_set_parquet_options
+    bakread::ParquetOptions parquet;
+
+    // Telemetry of the last extraction or export, and its JSON rendering
+    // handed out by bakread_get_stats
+    bakread::RunStats stats;
+    std::string stats_json;
     
     BakBackupInfo api_info;
     std::string db_name_buf;
@@ -105,6 +207,195 @@ std::string row_value_to_string(const bakread::RowValue& val) {
     }, val);
 }
 
+// -------------------------------------------------------------------------
+// ArrowBatchExport -- a ColumnBatch seen through the Arrow C Data Interface
+//
+// Fixed-width values, string offsets and string bytes are handed out in
+// place; only validity (one byte per row in ColumnBuffer) and booleans are
+// bit-packed per batch. Everything lives until the next export() call.
+// -------------------------------------------------------------------------
+void release_borrowed_schema(ArrowSchema* schema) { schema->release = nullptr; }
+void release_borrowed_array(ArrowArray* array) { array->release = nullptr; }
+
+const char* arrow_format(bakread::ColumnKind kind) {
+    switch (kind) {
+        case bakread::ColumnKind::Bool:    return "b";
+        case bakread::ColumnKind::Int8:    return "c";
+        case bakread::ColumnKind::Int16:   return "s";
+        case bakread::ColumnKind::Int32:   return "i";
+        case bakread::ColumnKind::Int64:   return "l";
+        case bakread::ColumnKind::Float32: return "f";
+        case bakread::ColumnKind::Float64: return "g";
+        case bakread::ColumnKind::Binary:  return "z";
+        default:                           return "u";
+    }
+}
+
+// Pack one byte per row into an LSB-first bitmap; returns the zero count
+int64_t pack_bits(const uint8_t* bytes, size_t n, std::vector<uint8_t>& out) {
+    out.assign((n + 7) / 8, 0);
+    int64_t zeros = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (bytes[i]) out[i >> 3] |= static_cast<uint8_t>(1u << (i & 7));
+        else ++zeros;
+    }
+    return zeros;
+}
+
+class ArrowBatchExport {
+public:
+    explicit ArrowBatchExport(const bakread::TableSchema& schema) {
+        const size_t n = schema.columns.size();
+        names_.reserve(n);
+        child_schemas_.resize(n);
+        child_schema_ptrs_.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            names_.push_back(schema.columns[i].name);
+            ArrowSchema& c = child_schemas_[i];
+            c = ArrowSchema{};
+            c.format = arrow_format(bakread::column_kind_for(schema.columns[i].type));
+            c.name = names_.back().c_str();
+            c.flags = ARROW_FLAG_NULLABLE;
+            c.release = release_borrowed_schema;
+            child_schema_ptrs_[i] = &c;
+        }
+        schema_ = ArrowSchema{};
+        schema_.format = "+s";
+        schema_.name = "";
+        schema_.n_children = static_cast<int64_t>(n);
+        schema_.children = child_schema_ptrs_.data();
+        schema_.release = release_borrowed_schema;
+
+        child_arrays_.resize(n);
+        child_array_ptrs_.resize(n);
+        buffers_.resize(n);
+        validity_.resize(n);
+        bools_.resize(n);
+    }
+
+    const ArrowSchema* schema() {
+        // A consumer may have "released" the previous batch's copy
+        schema_.release = release_borrowed_schema;
+        for (auto& c : child_schemas_) c.release = release_borrowed_schema;
+        return &schema_;
+    }
+
+    const ArrowArray* export_batch(const bakread::ColumnBatch& batch) {
+        static const uint8_t empty = 0;
+        const int64_t rows = static_cast<int64_t>(batch.num_rows());
+
+        for (size_t i = 0; i < child_arrays_.size(); ++i) {
+            const bakread::ColumnBuffer& col = batch.column(i);
+            ArrowArray& a = child_arrays_[i];
+            a = ArrowArray{};
+            a.length = rows;
+            a.null_count = pack_bits(col.validity.data(), col.validity.size(), validity_[i]);
+            a.release = release_borrowed_array;
+
+            auto& buf = buffers_[i];
+            buf[0] = a.null_count > 0 ? validity_[i].data() : nullptr;
+            if (col.is_variable()) {
+                a.n_buffers = 3;
+                buf[1] = col.offsets.data();
+                buf[2] = col.data.empty() ? static_cast<const void*>(&empty) : col.data.data();
+            } else if (col.kind == bakread::ColumnKind::Bool) {
+                a.n_buffers = 2;
+                pack_bits(col.values.data(), col.values.size(), bools_[i]);
+                buf[1] = bools_[i].empty() ? &empty : bools_[i].data();
+            } else {
+                a.n_buffers = 2;
+                buf[1] = col.values.empty() ? static_cast<const void*>(&empty) : col.values.data();
+            }
+            a.buffers = buf.data();
+            child_array_ptrs_[i] = &a;
+        }
+
+        array_ = ArrowArray{};
+        array_.length = rows;
+        array_.n_buffers = 1;
+        array_.buffers = struct_buffers_;
+        array_.n_children = static_cast<int64_t>(child_arrays_.size());
+        array_.children = child_array_ptrs_.data();
+        array_.release = release_borrowed_array;
+        return &array_;
+    }
+
+private:
+    std::vector<std::string> names_;
+    std::vector<ArrowSchema> child_schemas_;
+    std::vector<ArrowSchema*> child_schema_ptrs_;
+    ArrowSchema schema_{};
+
+    std::vector<ArrowArray> child_arrays_;
+    std::vector<ArrowArray*> child_array_ptrs_;
+    std::vector<std::array<const void*, 3>> buffers_;
+    std::vector<std::vector<uint8_t>> validity_;
+    std::vector<std::vector<uint8_t>> bools_;
+    const void* struct_buffers_[1] = { nullptr };
+    ArrowArray array_{};
+};
+
+// Map a failed extraction onto the API's result codes
+BakReadResult extract_error_code(const bakread::DirectExtractResult& result) {
+    if (result.tde_detected) return BAKREAD_ERROR_TDE_DETECTED;
+    if (result.encryption_detected) return BAKREAD_ERROR_ENCRYPTION_DETECTED;
+    return BAKREAD_ERROR_INTERNAL;
+}
+
+// Start a fresh report for an extraction or export on the handle
+std::chrono::steady_clock::time_point begin_stats(ReaderState* state) {
+    state->stats.reset();
+    return std::chrono::steady_clock::now();
+}
+
+// Record the outcome of an extraction or export in the handle's report
+void end_stats(bakread::RunStats& stats, const bakread::DirectExtractor& extractor,
+               std::chrono::steady_clock::time_point start, bool success,
+               const std::string& error, uint64_t rows) {
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    stats.set_result(success, extractor.is_indexed_mode() ? "direct (indexed)" : "direct",
+                     error, rows, elapsed);
+}
+
+// Producer thread body: one extraction, rows batched into the cursor
+void run_cursor(bakread::DirectExtractor* extractor, RowCursor* cursor,
+                bakread::RunStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    try {
+        StringBatch batch;
+        size_t columns = 0;
+        bool first = true;
+
+        auto result = extractor->extract([&](const bakread::Row& row) -> bool {
+            if (first) {
+                columns = row.size();
+                cursor->column_count = static_cast<int>(columns);
+                first = false;
+            }
+            // Short rows are padded so every row has `columns` values
+            for (size_t c = 0; c < columns; ++c) {
+                batch.offsets.push_back(batch.arena.size());
+                if (c < row.size()) batch.arena += row_value_to_string(row[c]);
+                batch.arena.push_back('\0');
+            }
+            if (++batch.rows < RowCursor::BATCH_ROWS) return true;
+            bool more = cursor->push(std::move(batch));
+            batch = StringBatch();
+            return more;
+        });
+
+        if (batch.rows > 0) cursor->push(std::move(batch));
+        end_stats(*stats, *extractor, start, result.success, result.error_message,
+                  result.rows_read);
+        if (result.success) cursor->finish(BAKREAD_OK, "");
+        else cursor->finish(extract_error_code(result), result.error_message);
+    } catch (const std::exception& e) {
+        end_stats(*stats, *extractor, start, false, e.what(), 0);
+        cursor->finish(BAKREAD_ERROR_INTERNAL, e.what());
+    }
+}
+
 }  // namespace
 
 extern "C" {
@@ -128,6 +419,7 @@ BAKREAD_API BakReadResult bakread_open(const char** bak_paths, int path_count, H
     
     try {
         state->extractor = std::make_unique<bakread::DirectExtractor>(state->bak_paths, state->config);
+        state->extractor->set_stats(&state->stats);
     } catch (const std::exception& e) {
         state->last_error = e.what();
         *out_handle = nullptr;
@@ -140,7 +432,9 @@ BAKREAD_API BakReadResult bakread_open(const char** bak_paths, int path_count, H
 
 BAKREAD_API void bakread_close(HBakReader handle) {
     if (handle) {
-        delete reinterpret_cast<ReaderState*>(handle);
+        auto* state = reinterpret_cast<ReaderState*>(handle);
+        state->cursor.reset();   // Joins a running producer before the extractor goes
+        delete state;
     }
 }
 
@@ -150,6 +444,14 @@ BAKREAD_API const char* bakread_get_error(HBakReader handle) {
     return state->last_error.c_str();
 }
 
+BAKREAD_API BakReadResult bakread_get_stats(HBakReader handle, const char** out_json) {
+    if (!handle || !out_json) return BAKREAD_ERROR_INVALID_HANDLE;
+    auto* state = reinterpret_cast<ReaderState*>(handle);
+    state->stats_json = state->stats.to_json();
+    *out_json = state->stats_json.c_str();
+    return BAKREAD_OK;
+}
+
 BAKREAD_API BakReadResult bakread_get_info(HBakReader handle, BakBackupInfo* out_info) {
     if (!handle || !out_info) return BAKREAD_ERROR_INVALID_HANDLE;
     auto* state = reinterpret_cast<ReaderState*>(handle);
@@ -280,6 +582,15 @@ BAKREAD_API BakReadResult bakread_set_columns(HBakReader handle, const char** co
     return BAKREAD_OK;
 }
 
+BAKREAD_API BakReadResult bakread_set_where(HBakReader handle, const char* condition) {
+    if (!handle) return BAKREAD_ERROR_INVALID_HANDLE;
+    auto* state = reinterpret_cast<ReaderState*>(handle);
+    
+    state->extractor->set_where(condition ? condition : "");
+    
+    return BAKREAD_OK;
+}
+
 BAKREAD_API BakReadResult bakread_set_max_rows(HBakReader handle, int64_t max_rows) {
     if (!handle) return BAKREAD_ERROR_INVALID_HANDLE;
     auto* state = reinterpret_cast<ReaderState*>(handle);
@@ -299,6 +610,7 @@ BAKREAD_API BakReadResult bakread_set_indexed_mode(HBakReader handle, int enable
     
     try {
         state->extractor = std::make_unique<bakread::DirectExtractor>(state->bak_paths, state->config);
+        state->extractor->set_stats(&state->stats);
     } catch (const std::exception& e) {
         state->last_error = e.what();
         return BAKREAD_ERROR_INTERNAL;
@@ -307,6 +619,45 @@ BAKREAD_API BakReadResult bakread_set_indexed_mode(HBakReader handle, int enable
     return BAKREAD_OK;
 }
 
+BAKREAD_API BakReadResult bakread_set_decode_workers(HBakReader handle, int workers, int preserve_order) {
+    if (!handle) return BAKREAD_ERROR_INVALID_HANDLE;
+    auto* state = reinterpret_cast<ReaderState*>(handle);
+    if (workers < 0) workers = 0;  // auto
+
+    state->config.decode_workers = workers;
+    state->config.preserve_order = preserve_order != 0;
+    state->extractor->set_decode_workers(workers, preserve_order != 0);
+
+    return BAKREAD_OK;
+}
+
+BAKREAD_API BakReadResult bakread_set_parquet_options(HBakReader handle, int64_t row_group_rows,
+                                                      const char* codec, int codec_level,
+                                                      const char* dictionary, int use_threads) {
+    if (!handle) return BAKREAD_ERROR_INVALID_HANDLE;
+    auto* state = reinterpret_cast<ReaderState*>(handle);
+    auto& p = state->parquet;
+
+    if (row_group_rows > 0) p.row_group_rows = row_group_rows;
+    if (codec && *codec) p.codec = codec;
+    p.codec_level = codec_level > 0 ? codec_level : 0;
+    if (dictionary && *dictionary) {
+        std::string d = dictionary;
+        p.dictionary = d != "none";
+        p.dictionary_columns.clear();
+        if (d != "all" && d != "none") {
+            std::istringstream ss(d);
+            std::string col;
+            while (std::getline(ss, col, ',')) {
+                if (!col.empty()) p.dictionary_columns.push_back(col);
+            }
+        }
+    }
+    p.use_threads = use_threads != 0;
+
+    return BAKREAD_OK;
+}
+
 BAKREAD_API BakReadResult bakread_set_progress_callback(HBakReader handle, BakProgressCallback cb, void* user_data) {
     if (!handle) return BAKREAD_ERROR_INVALID_HANDLE;
     auto* state = reinterpret_cast<ReaderState*>(handle);
@@ -375,6 +726,7 @@ BAKREAD_API BakReadResult bakread_extract(HBakReader handle, BakRowCallback call
     
     // Store the callback and user_data so we can also update schema info during extraction
     bool first_row = true;
+    auto start = begin_stats(state);
     
     try {
         std::vector<std::string> row_strings;
@@ -395,6 +747,8 @@ BAKREAD_API BakReadResult bakread_extract(HBakReader handle, BakRowCallback call
             
             return callback(row_ptrs.data(), static_cast<int>(row_ptrs.size()), user_data) == 0;
         });
+        end_stats(state->stats, *state->extractor, start, result.success,
+                  result.error_message, result.rows_read);
         
         if (out_row_count) {
             *out_row_count = result.rows_read;
@@ -402,14 +756,50 @@ BAKREAD_API BakReadResult bakread_extract(HBakReader handle, BakRowCallback call
         
         if (!result.success) {
             state->last_error = result.error_message;
-            if (result.tde_detected) return BAKREAD_ERROR_TDE_DETECTED;
-            if (result.encryption_detected) return BAKREAD_ERROR_ENCRYPTION_DETECTED;
-            return BAKREAD_ERROR_INTERNAL;
+            return extract_error_code(result);
         }
         
         return BAKREAD_OK;
         
     } catch (const std::exception& e) {
+        end_stats(state->stats, *state->extractor, start, false, e.what(), 0);
+        state->last_error = e.what();
+        return BAKREAD_ERROR_INTERNAL;
+    }
+}
+
+BAKREAD_API BakReadResult bakread_extract_batches(HBakReader handle, BakBatchCallback callback, void* user_data, uint64_t* out_row_count) {
+    if (!handle || !callback) return BAKREAD_ERROR_INVALID_HANDLE;
+    auto* state = reinterpret_cast<ReaderState*>(handle);
+
+    auto start = begin_stats(state);
+    try {
+        // The output schema is resolved by the time the first batch arrives
+        std::unique_ptr<ArrowBatchExport> exporter;
+
+        auto result = state->extractor->extract_columns([&](const bakread::ColumnBatch& batch) -> bool {
+            if (!exporter) {
+                exporter = std::make_unique<ArrowBatchExport>(state->extractor->resolved_schema());
+            }
+            const ArrowArray* array = exporter->export_batch(batch);
+            return callback(exporter->schema(), array, user_data) == 0;
+        });
+        end_stats(state->stats, *state->extractor, start, result.success,
+                  result.error_message, result.rows_read);
+
+        if (out_row_count) {
+            *out_row_count = result.rows_read;
+        }
+
+        if (!result.success) {
+            state->last_error = result.error_message;
+            return extract_error_code(result);
+        }
+
+        return BAKREAD_OK;
+
+    } catch (const std::exception& e) {
+        end_stats(state->stats, *state->extractor, start, false, e.what(), 0);
         state->last_error = e.what();
         return BAKREAD_ERROR_INTERNAL;
     }
@@ -418,89 +808,127 @@ BAKREAD_API BakReadResult bakread_extract(HBakReader handle, BakRowCallback call
 BAKREAD_API BakReadResult bakread_begin_extract(HBakReader handle) {
     if (!handle) return BAKREAD_ERROR_INVALID_HANDLE;
     auto* state = reinterpret_cast<ReaderState*>(handle);
-    
-    state->extracting = true;
-    state->extract_done = false;
-    state->rows_extracted = 0;
-    
-    while (!state->row_queue.empty()) {
-        state->row_queue.pop();
+
+    try {
+        state->cursor.reset();
+        begin_stats(state);
+        state->cursor = std::make_unique<RowCursor>();
+        state->cursor->producer = std::thread(run_cursor, state->extractor.get(),
+                                              state->cursor.get(), &state->stats);
+    } catch (const std::exception& e) {
+        state->cursor.reset();
+        state->last_error = e.what();
+        return BAKREAD_ERROR_INTERNAL;
     }
-    
+
     return BAKREAD_OK;
 }
 
-BAKREAD_API BakReadResult bakread_next_row(HBakReader handle, const char*** out_values, int* out_column_count) {
-    if (!handle || !out_values || !out_column_count) return BAKREAD_ERROR_INVALID_HANDLE;
-    auto* state = reinterpret_cast<ReaderState*>(handle);
-    
-    if (!state->extracting) {
+// Position the cursor on unread rows, or say why there are none
+static BakReadResult cursor_advance(ReaderState* state) {
+    RowCursor* cursor = state->cursor.get();
+    if (!cursor) {
         state->last_error = "Extraction not started. Call bakread_begin_extract first.";
         return BAKREAD_ERROR_INTERNAL;
     }
-    
-    if (state->extract_done) {
-        return BAKREAD_ERROR_NO_MORE_ROWS;
+    if (cursor->advance()) return BAKREAD_OK;
+    if (cursor->status != BAKREAD_OK) {
+        state->last_error = cursor->error;
+        return cursor->status;
     }
-    
+    return BAKREAD_ERROR_NO_MORE_ROWS;
+}
+
+BAKREAD_API BakReadResult bakread_next_row(HBakReader handle, const char*** out_values, int* out_column_count) {
+    if (!handle || !out_values || !out_column_count) return BAKREAD_ERROR_INVALID_HANDLE;
+    auto* state = reinterpret_cast<ReaderState*>(handle);
+
+    BakReadResult rc = cursor_advance(state);
+    if (rc != BAKREAD_OK) return rc;
+
+    RowCursor& cursor = *state->cursor;
+    *out_values = cursor.current.ptrs.data() + cursor.next_row * cursor.column_count;
+    *out_column_count = cursor.column_count;
+    ++cursor.next_row;
+    return BAKREAD_OK;
+}
+
+BAKREAD_API BakReadResult bakread_next_batch(HBakReader handle, const char*** out_values,
+                                             int* out_row_count, int* out_column_count) {
+    if (!handle || !out_values || !out_row_count || !out_column_count) return BAKREAD_ERROR_INVALID_HANDLE;
+    auto* state = reinterpret_cast<ReaderState*>(handle);
+
+    BakReadResult rc = cursor_advance(state);
+    if (rc != BAKREAD_OK) return rc;
+
+    RowCursor& cursor = *state->cursor;
+    *out_values = cursor.current.ptrs.data() + cursor.next_row * cursor.column_count;
+    *out_row_count = static_cast<int>(cursor.current.rows - cursor.next_row);
+    *out_column_count = cursor.column_count;
+    cursor.next_row = cursor.current.rows;
+    return BAKREAD_OK;
+}
+
+BAKREAD_API void bakread_end_extract(HBakReader handle) {
+    if (!handle) return;
+    auto* state = reinterpret_cast<ReaderState*>(handle);
+    state->cursor.reset();
+}
+
+// Write the configured table to a file with the CLI's writer pipeline
+static BakReadResult run_export(ReaderState* state, const char* output_path,
+                                bakread::OutputFormat format, const char* delimiter) {
     try {
-        bool got_row = false;
-        
-        auto result = state->extractor->extract([&](const bakread::Row& row) -> bool {
-            state->current_row_strings.clear();
-            state->current_row_ptrs.clear();
-            state->current_row_strings.reserve(row.size());
-            state->current_row_ptrs.reserve(row.size());
-            
-            for (const auto& val : row) {
-                state->current_row_strings.push_back(row_value_to_string(val));
-            }
-            for (const auto& s : state->current_row_strings) {
-                state->current_row_ptrs.push_back(s.c_str());
-            }
-            
-            state->rows_extracted++;
-            got_row = true;
-            return false;  // Stop after first row for streaming mode
-        });
-        
-        if (got_row) {
-            *out_values = state->current_row_ptrs.data();
-            *out_column_count = static_cast<int>(state->current_row_ptrs.size());
-            return BAKREAD_OK;
-        } else {
-            state->extract_done = true;
-            return BAKREAD_ERROR_NO_MORE_ROWS;
+        bakread::Options opts;
+        opts.bak_paths = state->bak_paths;
+        opts.output_path = output_path;
+        opts.format = format;
+        if (delimiter && *delimiter) opts.delimiter = delimiter;
+        opts.schema_name = state->target_schema;
+        opts.table_name = state->target_table;
+        opts.parquet = state->parquet;
+
+        auto start = begin_stats(state);
+        bakread::Pipeline pipeline(opts);
+        pipeline.set_stats(&state->stats);
+        auto result = pipeline.export_direct(*state->extractor);
+        state->rows_exported = result.rows_exported;
+        end_stats(state->stats, *state->extractor, start, result.success,
+                  result.error_message, result.rows_exported);
+
+        if (!result.success) {
+            state->last_error = result.error_message;
+            return BAKREAD_ERROR_INTERNAL;
         }
-        
+        return BAKREAD_OK;
+
     } catch (const std::exception& e) {
         state->last_error = e.what();
         return BAKREAD_ERROR_INTERNAL;
     }
 }
 
-BAKREAD_API void bakread_end_extract(HBakReader handle) {
-    if (!handle) return;
+BAKREAD_API BakReadResult bakread_export_csv(HBakReader handle, const char* output_path, const char* delimiter) {
+    if (!handle || !output_path) return BAKREAD_ERROR_INVALID_HANDLE;
     auto* state = reinterpret_cast<ReaderState*>(handle);
-    state->extracting = false;
-    state->extract_done = true;
+    return run_export(state, output_path, bakread::OutputFormat::CSV, delimiter);
 }
 
-BAKREAD_API BakReadResult bakread_export_csv(HBakReader handle, const char* output_path, const char* delimiter) {
+BAKREAD_API BakReadResult bakread_export_json(HBakReader handle, const char* output_path) {
     if (!handle || !output_path) return BAKREAD_ERROR_INVALID_HANDLE;
     auto* state = reinterpret_cast<ReaderState*>(handle);
-    
-    (void)delimiter;
-    state->last_error = "Direct CSV export not yet implemented. Use bakread_extract with callback.";
-    return BAKREAD_ERROR_INTERNAL;
+    return run_export(state, output_path, bakread::OutputFormat::JSONL, nullptr);
 }
 
-BAKREAD_API BakReadResult bakread_export_json(HBakReader handle, const char* output_path) {
+BAKREAD_API BakReadResult bakread_export_parquet(HBakReader handle, const char* output_path) {
     if (!handle || !output_path) return BAKREAD_ERROR_INVALID_HANDLE;
     auto* state = reinterpret_cast<ReaderState*>(handle);
-    
-    state->last_error = "Direct JSON export not yet implemented. Use bakread_extract with callback.";
-    return BAKREAD_ERROR_INTERNAL;
+    return run_export(state, output_path, bakread::OutputFormat::Parquet, nullptr);
+}
+
+BAKREAD_API uint64_t bakread_get_export_row_count(HBakReader handle) {
+    if (!handle) return 0;
+    return reinterpret_cast<ReaderState*>(handle)->rows_exported;
 }
 
 // -------------------------------------------------------------------------
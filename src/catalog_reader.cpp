@@ -3,7 +3,11 @@
 #include "bakread/logging.h"
 
 #include <algorithm>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
 
 namespace bakread {
 
@@ -24,8 +28,12 @@ static constexpr int32_t OBJ_SYSMEMBERS    = 20;   // sys.sysmembers (role membe
 static constexpr int32_t BOOT_PAGE_ID = 9;
 static constexpr int32_t PRIMARY_FILE_ID = 1;
 
-CatalogReader::CatalogReader(PageProvider provider)
+CatalogReader::CatalogReader(PageProvider provider,
+                             PageViewProvider view_provider,
+                             PageMetaProvider meta_provider)
     : page_provider_(std::move(provider))
+    , view_provider_(std::move(view_provider))
+    , meta_provider_(std::move(meta_provider))
 {
     // Initialize well-known schema names
     schema_names_[1] = "dbo";
@@ -42,29 +50,105 @@ bool CatalogReader::scan_catalog() {
         return false;
     }
 
-    // Scan system tables in dependency order
-    scan_system_objects();
-    scan_system_columns();
+    // One sweep over the catalog pages, then the system tables are parsed
+    // from it in dependency order
+    SystemPages pages = sweep_catalog_pages();
+
+    scan_system_objects(pages);
+    scan_system_columns(pages);
     scan_system_indexes();
-    scan_system_allocation_units();
-    scan_rowset_allocunit_mapping();
+    scan_rowset_allocunit_mapping(pages);
 
     // Scan for module definitions (stored procedures, functions, views)
-    scan_module_definitions();
+    scan_module_definitions(pages);
 
     // Scan security metadata
-    scan_principals();
-    scan_role_members();
-    scan_permissions();
+    scan_principals(pages);
+    scan_role_members(pages);
+    scan_permissions(pages);
 
     LOG_INFO("Catalog scan complete: %zu objects, %zu column sets, %zu modules, %zu principals",
              objects_.size(), columns_.size(), modules_.size(), principals_.size());
     return true;
 }
 
+void CatalogReader::SystemPages::add(uint32_t obj_id, const uint8_t* page) {
+    auto& buf = pages_[obj_id];
+    buf.insert(buf.end(), page, page + PAGE_SIZE);
+    ++count_;
+}
+
+std::vector<const uint8_t*> CatalogReader::SystemPages::of(uint32_t obj_id) const {
+    std::vector<const uint8_t*> out;
+    auto it = pages_.find(obj_id);
+    if (it == pages_.end()) return out;
+    for (size_t off = 0; off < it->second.size(); off += PAGE_SIZE)
+        out.push_back(it->second.data() + off);
+    return out;
+}
+
+CatalogReader::SystemPages CatalogReader::sweep_catalog_pages() {
+    // System tables whose data pages are parsed, and how far into file 1
+    // each is looked for
+    static constexpr struct { uint32_t obj_id; int32_t limit; } SYSTEM_TABLES[] = {
+        { OBJ_SYSSCHOBJS,    CATALOG_PAGE_LIMIT },
+        { OBJ_SYSCOLPARS,    CATALOG_PAGE_LIMIT },
+        { OBJ_SYSROWSETS,    CATALOG_PAGE_LIMIT },
+        { OBJ_SYSALLOCUNITS, CATALOG_PAGE_LIMIT },
+        { OBJ_SYSOBJVALUES,  MODULE_PAGE_LIMIT },
+        { OBJ_SYSPRINPALS,   CATALOG_PAGE_LIMIT },
+        { OBJ_SYSMEMBERS,    CATALOG_PAGE_LIMIT },
+        { OBJ_SYSPERMS,      CATALOG_PAGE_LIMIT },
+    };
+    auto wanted = [](uint32_t obj_id, int32_t pg) {
+        for (const auto& t : SYSTEM_TABLES)
+            if (t.obj_id == obj_id) return pg < t.limit;
+        return false;
+    };
+
+    SystemPages pages;
+    uint8_t scratch[PAGE_SIZE];
+    int fetched = 0;
+
+    for (int32_t pg = 1; pg < MODULE_PAGE_LIMIT; ++pg) {
+        // Rule pages out on metadata alone when the source has it
+        if (meta_provider_) {
+            PageMeta meta;
+            if (!meta_provider_(PRIMARY_FILE_ID, pg, meta)) continue;
+            bool iam = meta.page_type == static_cast<uint8_t>(PageType::IAM) &&
+                       pg < CATALOG_PAGE_LIMIT;
+            bool data = meta.page_type == static_cast<uint8_t>(PageType::Data) &&
+                        meta.slot_count > 0 && wanted(meta.obj_id, pg);
+            if (!iam && !data) continue;
+        }
+
+        const uint8_t* page = fetch_page(PRIMARY_FILE_ID, pg, scratch);
+        if (!page) continue;
+        ++fetched;
+
+        PageHeader hdr;
+        std::memcpy(&hdr, page, sizeof(hdr));
+
+        if (hdr.type == static_cast<uint8_t>(PageType::IAM)) {
+            if (pg < CATALOG_PAGE_LIMIT) add_iam_page(pg, page);
+            continue;
+        }
+        if (hdr.type != static_cast<uint8_t>(PageType::Data)) continue;
+        if (hdr.slot_count == 0) continue;
+        if (!wanted(hdr.obj_id, pg)) continue;
+
+        pages.add(hdr.obj_id, page);
+    }
+
+    LOG_INFO("Catalog sweep: %d pages fetched, %zu system table pages, %zu allocation units via IAM scan",
+             fetched, pages.size(), alloc_units_.size());
+    return pages;
+}
+
 bool CatalogReader::read_boot_page() {
-    uint8_t page[PAGE_SIZE];
-    if (!page_provider_(PRIMARY_FILE_ID, BOOT_PAGE_ID, page)) {
+    uint8_t scratch[PAGE_SIZE];
+    const uint8_t* page = fetch_page(PRIMARY_FILE_ID, BOOT_PAGE_ID, scratch);
+    if (!page) {
         LOG_WARN("Cannot read boot page (1:%d)", BOOT_PAGE_ID);
         return false;
     }
@@ -99,24 +183,17 @@ bool CatalogReader::read_boot_page() {
     return true;
 }
 
-bool CatalogReader::scan_system_objects() {
+bool CatalogReader::scan_system_objects(const SystemPages& pages) {
     LOG_DEBUG("Scanning for system objects (sysschobjs)...");
 
-    uint8_t page[PAGE_SIZE];
     int found_count = 0;
 
-    // Scan early pages of file 1 looking for data pages that contain
-    // system object definitions. System tables are typically on pages 1-300.
-    for (int32_t pg = 1; pg < 1000; ++pg) {
-        if (!page_provider_(PRIMARY_FILE_ID, pg, page)) continue;
-
+    // Data pages of file 1 that contain system object definitions. System
+    // tables are typically on pages 1-300.
+    for (const uint8_t* page : pages.of(OBJ_SYSSCHOBJS)) {
         PageHeader hdr;
         std::memcpy(&hdr, page, sizeof(hdr));
 
-        if (hdr.type != static_cast<uint8_t>(PageType::Data)) continue;
-        if (hdr.slot_count == 0) continue;
-        if (hdr.obj_id != OBJ_SYSSCHOBJS) continue;
-
         for (int slot = 0; slot < hdr.slot_count; ++slot) {
             uint16_t offset = get_slot_offset(page, slot);
             if (offset < PAGE_HEADER_SIZE || offset >= PAGE_SIZE - 10) continue;
@@ -217,7 +294,7 @@ bool CatalogReader::scan_system_objects() {
             objects_[obj_id] = obj;
             ++found_count;
 
-            LOG_DEBUG("  Found object: id=%d schema=%d type='%s' name='%s'",
+            LOG_DEBUG_HOT("  Found object: id=%d schema=%d type='%s' name='%s'",
                       obj_id, schema_id, type_code, name.c_str());
         }
     }
@@ -226,22 +303,15 @@ bool CatalogReader::scan_system_objects() {
     return found_count > 0;
 }
 
-bool CatalogReader::scan_system_columns() {
+bool CatalogReader::scan_system_columns(const SystemPages& pages) {
     LOG_DEBUG("Scanning for system columns (syscolpars)...");
 
-    uint8_t page[PAGE_SIZE];
     int found_count = 0;
 
-    for (int32_t pg = 1; pg < 1000; ++pg) {
-        if (!page_provider_(PRIMARY_FILE_ID, pg, page)) continue;
-
+    for (const uint8_t* page : pages.of(OBJ_SYSCOLPARS)) {
         PageHeader hdr;
         std::memcpy(&hdr, page, sizeof(hdr));
 
-        if (hdr.type != static_cast<uint8_t>(PageType::Data)) continue;
-        if (hdr.slot_count == 0) continue;
-        if (hdr.obj_id != OBJ_SYSCOLPARS) continue;
-
         for (int slot = 0; slot < hdr.slot_count; ++slot) {
             uint16_t offset = get_slot_offset(page, slot);
             if (offset < PAGE_HEADER_SIZE || offset >= PAGE_SIZE - 10) continue;
@@ -344,56 +414,40 @@ bool CatalogReader::scan_system_indexes() {
     return true;
 }
 
-bool CatalogReader::scan_system_allocation_units() {
-    LOG_DEBUG("Scanning for allocation units...");
-
-    uint8_t page[PAGE_SIZE];
-
-    // Scan IAM pages to build allocation information
-    for (int32_t pg = 1; pg < 1000; ++pg) {
-        if (!page_provider_(PRIMARY_FILE_ID, pg, page)) continue;
+void CatalogReader::add_iam_page(int32_t page_id, const uint8_t* page) {
+    PageHeader hdr;
+    std::memcpy(&hdr, page, sizeof(hdr));
 
-        PageHeader hdr;
-        std::memcpy(&hdr, page, sizeof(hdr));
+    // Only the head of a chain (sequence 0) starts an allocation unit
+    uint32_t sequence;
+    std::memcpy(&sequence, page + 100, 4);
+    if (sequence != 0) return;
 
-        if (hdr.type == static_cast<uint8_t>(PageType::IAM)) {
-            SystemAllocationUnit au;
-            au.first_iam_page = { PRIMARY_FILE_ID, pg };
-            au.first_page = iam_start_page(page);
-
-            // The IAM page header area contains the allocation unit ID
-            // which links back to a specific hobt/partition
-            if (pg + 96 + 8 < static_cast<int32_t>(PAGE_SIZE)) {
-                std::memcpy(&au.allocation_unit_id, page + 96 + 8, 8);
-            }
+    SystemAllocationUnit au;
+    au.first_iam_page = { PRIMARY_FILE_ID, page_id };
+    au.first_page = iam_start_page(page);
 
-            alloc_units_.push_back(au);
-            LOG_DEBUG("  IAM page %d: start=(%d:%d) auid=%lld",
-                      pg, au.first_page.file_id, au.first_page.page_id,
-                      (long long)au.allocation_unit_id);
-        }
-    }
+    // An IAM page carries its allocation unit in the header, like
+    // the pages it maps: auid = index_id << 48 | obj_id << 16
+    au.allocation_unit_id = (static_cast<int64_t>(hdr.index_id) << 48) |
+                            (static_cast<int64_t>(hdr.obj_id) << 16);
 
-    LOG_INFO("Found %zu allocation units via IAM scan", alloc_units_.size());
-    return true;
+    alloc_units_.push_back(au);
+    LOG_DEBUG_HOT("  IAM page %d: start=(%d:%d) auid=%lld",
+              page_id, au.first_page.file_id, au.first_page.page_id,
+              (long long)au.allocation_unit_id);
 }
 
-bool CatalogReader::scan_rowset_allocunit_mapping() {
+bool CatalogReader::scan_rowset_allocunit_mapping(const SystemPages& pages) {
     LOG_DEBUG("Building object_id -> page header obj_id mapping...");
 
     // Step 1: Scan sysrowsets (page header obj_id=5) to build
     //         rowsetid (hobt_id) -> object_id mapping
     std::unordered_map<int64_t, int32_t> hobt_to_objid;
 
-    uint8_t page[PAGE_SIZE];
-    for (int32_t pg = 1; pg < 1000; ++pg) {
-        if (!page_provider_(PRIMARY_FILE_ID, pg, page)) continue;
-
+    for (const uint8_t* page : pages.of(OBJ_SYSROWSETS)) {
         PageHeader hdr;
         std::memcpy(&hdr, page, sizeof(hdr));
-        if (hdr.type != static_cast<uint8_t>(PageType::Data)) continue;
-        if (hdr.obj_id != OBJ_SYSROWSETS) continue;
-        if (hdr.slot_count == 0) continue;
 
         for (int slot = 0; slot < hdr.slot_count; ++slot) {
             uint16_t offset = get_slot_offset(page, slot);
@@ -429,14 +483,9 @@ bool CatalogReader::scan_rowset_allocunit_mapping() {
 
     // Step 2: Scan sysallocunits (page header obj_id=7) to build
     //         the final object_id -> page header m_objId mapping
-    for (int32_t pg = 1; pg < 1000; ++pg) {
-        if (!page_provider_(PRIMARY_FILE_ID, pg, page)) continue;
-
+    for (const uint8_t* page : pages.of(OBJ_SYSALLOCUNITS)) {
         PageHeader hdr;
         std::memcpy(&hdr, page, sizeof(hdr));
-        if (hdr.type != static_cast<uint8_t>(PageType::Data)) continue;
-        if (hdr.obj_id != OBJ_SYSALLOCUNITS) continue;
-        if (hdr.slot_count == 0) continue;
 
         for (int slot = 0; slot < hdr.slot_count; ++slot) {
             uint16_t offset = get_slot_offset(page, slot);
@@ -459,6 +508,22 @@ bool CatalogReader::scan_rowset_allocunit_mapping() {
             int64_t container_id;
             std::memcpy(&container_id, rec + 13, 8);
 
+            // Every allocation unit of the table (in-row, LOB, row-overflow)
+            //   offset 27: pgfirst, 33: pgroot, 39: pgfirstiam (6 bytes each)
+            auto owner = hobt_to_objid.find(container_id);
+            if (owner != hobt_to_objid.end()) {
+                SystemAllocationUnit au;
+                au.allocation_unit_id = auid;
+                au.container_id = container_id;
+                au.type = au_type;
+                if (fixed_end >= 45) {
+                    au.first_page     = read_page_pointer(rec + 27);
+                    au.root_page      = read_page_pointer(rec + 33);
+                    au.first_iam_page = read_page_pointer(rec + 39);
+                }
+                object_alloc_units_[owner->second].push_back(au);
+            }
+
             // Only care about IN_ROW_DATA allocation units
             if (au_type != 1) continue;
 
@@ -477,7 +542,7 @@ bool CatalogReader::scan_rowset_allocunit_mapping() {
     for (auto& [oid, pobjid] : obj_to_page_objid_) {
         auto obj_it = objects_.find(oid);
         if (obj_it != objects_.end() && obj_it->second.type[0] == 'U') {
-            LOG_DEBUG("  %s (object_id=%d) -> page_obj_id=%u",
+            LOG_DEBUG_HOT("  %s (object_id=%d) -> page_obj_id=%u",
                       obj_it->second.name.c_str(), oid, pobjid);
         }
     }
@@ -490,6 +555,17 @@ uint32_t CatalogReader::get_page_obj_id(int32_t object_id) const {
     return (it != obj_to_page_objid_.end()) ? it->second : 0;
 }
 
+std::vector<uint32_t> CatalogReader::get_lob_page_obj_ids(int32_t object_id) const {
+    std::vector<uint32_t> result;
+    for (const auto& au : get_allocation_units(object_id)) {
+        if (au.type != 2 && au.type != 3) continue;   // LOB_DATA, ROW_OVERFLOW_DATA
+        // auid = index_id << 48 | m_objId << 16
+        uint32_t page_objid = static_cast<uint32_t>(au.allocation_unit_id >> 16);
+        if (page_objid != 0) result.push_back(page_objid);
+    }
+    return result;
+}
+
 bool CatalogReader::resolve_table(const std::string& schema_name,
                                    const std::string& table_name,
                                    TableSchema& out) const {
@@ -530,7 +606,8 @@ bool CatalogReader::resolve_table(const std::string& schema_name,
         out.schema_name = obj_schema.empty() ? schema_name : obj_schema;
         out.table_name  = obj.name;
 
-        // Populate columns
+        // Populate columns (out may hold a previous resolve's schema)
+        out.columns.clear();
         auto col_it = columns_.find(id);
         if (col_it != columns_.end()) {
             for (auto& sc : col_it->second) {
@@ -581,24 +658,53 @@ std::vector<SystemObject> CatalogReader::list_user_tables() const {
 
 std::vector<SystemAllocationUnit>
 CatalogReader::get_allocation_units(int32_t object_id) const {
-    // Match allocation units by looking for container_id associations
-    // In a full implementation, we'd join sysrowsets to map object_id
-    // to hobt_id to allocation_unit. Here we return all AUs for now
-    // and let the caller filter by page content.
-    (void)object_id;
-    return alloc_units_;
+    std::vector<SystemAllocationUnit> result;
+
+    // sysallocunits rows joined to sysrowsets by container (hobt) id; IAM
+    // pages found by the catalog scan fill in a missing first IAM
+    auto it = object_alloc_units_.find(object_id);
+    if (it != object_alloc_units_.end()) {
+        result = it->second;
+        for (auto& au : result) {
+            if (!au.first_iam_page.is_null()) continue;
+            for (const auto& iam : alloc_units_) {
+                if (iam.allocation_unit_id == au.allocation_unit_id) {
+                    au.first_iam_page = iam.first_iam_page;
+                    break;
+                }
+            }
+        }
+        return result;
+    }
+
+    // No sysallocunits row: match scanned IAM chains on the page header id.
+    // The header index_id is 0 on system allocation units and 256 on user
+    // ones; page_objid names the in-row unit, so a match is in-row data.
+    uint32_t page_objid = get_page_obj_id(object_id);
+    if (page_objid == 0) return result;
+    for (const auto& iam : alloc_units_) {
+        const int64_t header_index_id = iam.allocation_unit_id >> 48;
+        if (static_cast<uint32_t>((iam.allocation_unit_id >> 16) & 0xFFFF) == page_objid &&
+            (header_index_id == 0 || header_index_id == 256)) {
+            SystemAllocationUnit au = iam;
+            au.type = 1;
+            result.push_back(au);
+        }
+    }
+    return result;
 }
 
 std::vector<PageId> CatalogReader::get_iam_chain(const PageId& first_iam) const {
     std::vector<PageId> chain;
     chain.push_back(first_iam);
 
-    uint8_t page[PAGE_SIZE];
+    uint8_t scratch[PAGE_SIZE];
     PageId current = first_iam;
     int max_follow = 10000;
 
     while (--max_follow > 0) {
-        if (!page_provider_(current.file_id, current.page_id, page)) break;
+        const uint8_t* page = fetch_page(current.file_id, current.page_id, scratch);
+        if (!page) break;
 
         PageHeader hdr;
         std::memcpy(&hdr, page, sizeof(hdr));
@@ -613,13 +719,65 @@ std::vector<PageId> CatalogReader::get_iam_chain(const PageId& first_iam) const
     return chain;
 }
 
+std::vector<PageId>
+CatalogReader::get_allocated_pages(const SystemAllocationUnit& au) const {
+    std::vector<PageId> pages;
+    if (au.first_iam_page.is_null()) return pages;
+
+    uint8_t scratch[PAGE_SIZE];
+    for (const PageId& iam : get_iam_chain(au.first_iam_page)) {
+        const uint8_t* page = fetch_page(iam.file_id, iam.page_id, scratch);
+        if (!page) continue;
+
+        PageHeader hdr;
+        std::memcpy(&hdr, page, sizeof(hdr));
+        if (hdr.type != static_cast<uint8_t>(PageType::IAM)) continue;
+
+        // Mixed-extent pages the unit got before its first uniform extent
+        for (int slot = 0; slot < IAM_SINGLE_PAGE_SLOTS; ++slot) {
+            PageId single = iam_single_page(page, slot);
+            if (!single.is_null()) pages.push_back(single);
+        }
+
+        // Uniform extents, eight pages each, relative to the interval start;
+        // the bitmap is mostly zero bytes, so skip those whole
+        PageId start = iam_start_page(page);
+        for (int byte = 0; byte < IAM_EXTENTS_PER_PAGE / 8; ++byte) {
+            if (page[IAM_BITMAP_OFFSET + byte] == 0) continue;
+            for (int bit = 0; bit < 8; ++bit) {
+                int extent = byte * 8 + bit;
+                if (!iam_extent_allocated(page, extent)) continue;
+                int32_t first = start.page_id + extent * PAGES_PER_EXTENT;
+                for (int i = 0; i < PAGES_PER_EXTENT; ++i) {
+                    pages.push_back({ start.file_id, first + i });
+                }
+            }
+        }
+    }
+
+    // Allocation order: by file, then page
+    std::sort(pages.begin(), pages.end(), [](const PageId& a, const PageId& b) {
+        return a.file_id != b.file_id ? a.file_id < b.file_id : a.page_id < b.page_id;
+    });
+    pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+    return pages;
+}
+
+const uint8_t* CatalogReader::fetch_page(int32_t file_id, int32_t page_id,
+                                         uint8_t* scratch) const {
+    if (view_provider_) {
+        if (const uint8_t* view = view_provider_(file_id, page_id)) return view;
+    }
+    return page_provider_(file_id, page_id, scratch) ? scratch : nullptr;
+}
+
 std::string CatalogReader::schema_name_for_id(int32_t schema_id) const {
     auto it = schema_names_.find(schema_id);
     if (it != schema_names_.end()) return it->second;
     return "dbo";
 }
 
-bool CatalogReader::scan_module_definitions() {
+bool CatalogReader::scan_module_definitions(const SystemPages& pages) {
     LOG_DEBUG("Scanning for module definitions (sysobjvalues)...");
 
     // First, identify all module objects (procedures, functions, views) from objects_
@@ -648,19 +806,12 @@ bool CatalogReader::scan_module_definitions() {
     // Now scan sysobjvalues to get the actual definition text
     // sysobjvalues stores various object properties including SQL definitions
     // The definition is stored with valclass = 1 (definition), valnum = 0
-    uint8_t page[PAGE_SIZE];
     int found_count = 0;
 
-    for (int32_t pg = 1; pg < 2000; ++pg) {
-        if (!page_provider_(PRIMARY_FILE_ID, pg, page)) continue;
-
+    for (const uint8_t* page : pages.of(OBJ_SYSOBJVALUES)) {
         PageHeader hdr;
         std::memcpy(&hdr, page, sizeof(hdr));
 
-        if (hdr.type != static_cast<uint8_t>(PageType::Data)) continue;
-        if (hdr.slot_count == 0) continue;
-        if (hdr.obj_id != OBJ_SYSOBJVALUES) continue;
-
         for (int slot = 0; slot < hdr.slot_count; ++slot) {
             uint16_t offset = get_slot_offset(page, slot);
             if (offset < PAGE_HEADER_SIZE || offset >= PAGE_SIZE - 20) continue;
@@ -755,7 +906,7 @@ bool CatalogReader::scan_module_definitions() {
     return true;
 }
 
-bool CatalogReader::scan_principals() {
+bool CatalogReader::scan_principals(const SystemPages& pages) {
     LOG_DEBUG("Scanning for database principals (sysprincipals)...");
 
     // Add well-known principals
@@ -763,19 +914,12 @@ bool CatalogReader::scan_principals() {
     principals_[1] = { 1, "dbo", "S", 1, "dbo", false };
     principals_[2] = { 2, "guest", "S", 2, "guest", false };
 
-    uint8_t page[PAGE_SIZE];
     int found_count = 0;
 
-    for (int32_t pg = 1; pg < 1000; ++pg) {
-        if (!page_provider_(PRIMARY_FILE_ID, pg, page)) continue;
-
+    for (const uint8_t* page : pages.of(OBJ_SYSPRINPALS)) {
         PageHeader hdr;
         std::memcpy(&hdr, page, sizeof(hdr));
 
-        if (hdr.type != static_cast<uint8_t>(PageType::Data)) continue;
-        if (hdr.slot_count == 0) continue;
-        if (hdr.obj_id != OBJ_SYSPRINPALS) continue;
-
         for (int slot = 0; slot < hdr.slot_count; ++slot) {
             uint16_t offset = get_slot_offset(page, slot);
             if (offset < PAGE_HEADER_SIZE || offset >= PAGE_SIZE - 20) continue;
@@ -858,22 +1002,15 @@ bool CatalogReader::scan_principals() {
     return true;
 }
 
-bool CatalogReader::scan_role_members() {
+bool CatalogReader::scan_role_members(const SystemPages& pages) {
     LOG_DEBUG("Scanning for role memberships (sysmembers)...");
 
-    uint8_t page[PAGE_SIZE];
     int found_count = 0;
 
-    for (int32_t pg = 1; pg < 1000; ++pg) {
-        if (!page_provider_(PRIMARY_FILE_ID, pg, page)) continue;
-
+    for (const uint8_t* page : pages.of(OBJ_SYSMEMBERS)) {
         PageHeader hdr;
         std::memcpy(&hdr, page, sizeof(hdr));
 
-        if (hdr.type != static_cast<uint8_t>(PageType::Data)) continue;
-        if (hdr.slot_count == 0) continue;
-        if (hdr.obj_id != OBJ_SYSMEMBERS) continue;
-
         for (int slot = 0; slot < hdr.slot_count; ++slot) {
             uint16_t offset = get_slot_offset(page, slot);
             if (offset < PAGE_HEADER_SIZE || offset >= PAGE_SIZE - 12) continue;
@@ -919,22 +1056,15 @@ bool CatalogReader::scan_role_members() {
     return true;
 }
 
-bool CatalogReader::scan_permissions() {
+bool CatalogReader::scan_permissions(const SystemPages& pages) {
     LOG_DEBUG("Scanning for database permissions (sysperms)...");
 
-    uint8_t page[PAGE_SIZE];
     int found_count = 0;
 
-    for (int32_t pg = 1; pg < 1000; ++pg) {
-        if (!page_provider_(PRIMARY_FILE_ID, pg, page)) continue;
-
+    for (const uint8_t* page : pages.of(OBJ_SYSPERMS)) {
         PageHeader hdr;
         std::memcpy(&hdr, page, sizeof(hdr));
 
-        if (hdr.type != static_cast<uint8_t>(PageType::Data)) continue;
-        if (hdr.slot_count == 0) continue;
-        if (hdr.obj_id != OBJ_SYSPERMS) continue;
-
         for (int slot = 0; slot < hdr.slot_count; ++slot) {
             uint16_t offset = get_slot_offset(page, slot);
             if (offset < PAGE_HEADER_SIZE || offset >= PAGE_SIZE - 20) continue;
@@ -1058,4 +1188,252 @@ std::vector<SystemPermission> CatalogReader::list_permissions() const {
     return permissions_;
 }
 
+// -------------------------------------------------------------------------
+// Persistence
+//
+// File layout: CatalogFileHeader, then every member in persist_members()
+// order. Integers are written in host byte order (like the page index),
+// strings and containers as a uint32 count followed by their elements.
+// -------------------------------------------------------------------------
+
+static constexpr uint32_t CATALOG_FILE_VERSION = 1;
+
+struct CatalogFileHeader {
+    char     magic[8];        // "BAKRCAT\0"
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t identity;        // Backup the catalog was read from
+    uint64_t payload_size;    // Bytes following the header
+};
+
+static_assert(sizeof(CatalogFileHeader) == 32, "CatalogFileHeader must be 32 bytes");
+
+namespace {
+
+// Field lists shared by the writer and the reader (T may be const)
+template <typename IO, typename T> std::enable_if_t<std::is_same_v<std::remove_const_t<T>, PageId>>
+fields(IO& io, T& p) { io(p.file_id); io(p.page_id); }
+
+template <typename IO, typename T> std::enable_if_t<std::is_same_v<std::remove_const_t<T>, SystemObject>>
+fields(IO& io, T& o) { io(o.object_id); io(o.schema_id); io(o.name); io(o.type); }
+
+template <typename IO, typename T> std::enable_if_t<std::is_same_v<std::remove_const_t<T>, SystemColumn>>
+fields(IO& io, T& c) {
+    io(c.object_id); io(c.column_id); io(c.name); io(c.system_type_id); io(c.max_length);
+    io(c.precision); io(c.scale); io(c.is_nullable); io(c.is_identity); io(c.leaf_offset);
+}
+
+template <typename IO, typename T> std::enable_if_t<std::is_same_v<std::remove_const_t<T>, SystemIndex>>
+fields(IO& io, T& x) { io(x.object_id); io(x.index_id); io(x.name); io(x.type); }
+
+template <typename IO, typename T> std::enable_if_t<std::is_same_v<std::remove_const_t<T>, SystemAllocationUnit>>
+fields(IO& io, T& au) {
+    io(au.allocation_unit_id); io(au.container_id); io(au.type);
+    io(au.first_page); io(au.root_page); io(au.first_iam_page);
+}
+
+template <typename IO, typename T> std::enable_if_t<std::is_same_v<std::remove_const_t<T>, SystemModule>>
+fields(IO& io, T& m) {
+    io(m.object_id); io(m.schema_id); io(m.schema_name); io(m.name); io(m.type); io(m.definition);
+}
+
+template <typename IO, typename T> std::enable_if_t<std::is_same_v<std::remove_const_t<T>, SystemPrincipal>>
+fields(IO& io, T& p) {
+    io(p.principal_id); io(p.name); io(p.type); io(p.owning_principal_id);
+    io(p.default_schema); io(p.is_fixed_role);
+}
+
+template <typename IO, typename T> std::enable_if_t<std::is_same_v<std::remove_const_t<T>, SystemRoleMember>>
+fields(IO& io, T& r) { io(r.role_principal_id); io(r.member_principal_id); io(r.role_name); io(r.member_name); }
+
+template <typename IO, typename T> std::enable_if_t<std::is_same_v<std::remove_const_t<T>, SystemPermission>>
+fields(IO& io, T& p) {
+    io(p.class_type); io(p.major_id); io(p.minor_id); io(p.grantee_id); io(p.grantor_id);
+    io(p.type); io(p.permission_name); io(p.state); io(p.grantee_name); io(p.grantor_name);
+    io(p.object_name); io(p.schema_name);
+}
+
+class CatalogWriter {
+public:
+    std::string out;
+
+    void operator()(bool v) { (*this)(static_cast<uint8_t>(v ? 1 : 0)); }
+    void operator()(const std::string& s) {
+        (*this)(static_cast<uint32_t>(s.size()));
+        out.append(s);
+    }
+    template <typename T> void operator()(const std::vector<T>& v) {
+        (*this)(static_cast<uint32_t>(v.size()));
+        for (const auto& e : v) (*this)(e);
+    }
+    template <typename K, typename V> void operator()(const std::unordered_map<K, V>& m) {
+        (*this)(static_cast<uint32_t>(m.size()));
+        for (const auto& [k, v] : m) { (*this)(k); (*this)(v); }
+    }
+    template <typename T> void operator()(const T& v) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            out.append(reinterpret_cast<const char*>(&v), sizeof(T));
+        } else {
+            fields(*this, v);
+        }
+    }
+};
+
+class CatalogFileReader {
+public:
+    CatalogFileReader(const char* data, size_t size) : p_(data), end_(data + size) {}
+
+    bool ok() const { return ok_; }
+    bool at_end() const { return p_ == end_; }
+
+    void operator()(bool& v) { uint8_t b = 0; (*this)(b); v = b != 0; }
+    void operator()(std::string& s) {
+        uint32_t n = 0;
+        (*this)(n);
+        if (!take(n)) return;
+        s.assign(p_ - n, n);
+    }
+    template <typename T> void operator()(std::vector<T>& v) {
+        uint32_t n = 0;
+        (*this)(n);
+        if (!plausible(n)) return;
+        v.clear();
+        v.resize(n);
+        for (auto& e : v) (*this)(e);
+    }
+    template <typename K, typename V> void operator()(std::unordered_map<K, V>& m) {
+        uint32_t n = 0;
+        (*this)(n);
+        if (!plausible(n)) return;
+        m.clear();
+        m.reserve(n);
+        for (uint32_t i = 0; i < n && ok_; ++i) {
+            K k{};
+            V v{};
+            (*this)(k);
+            (*this)(v);
+            m.emplace(std::move(k), std::move(v));
+        }
+    }
+    template <typename T> void operator()(T& v) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            if (take(sizeof(T))) std::memcpy(&v, p_ - sizeof(T), sizeof(T));
+        } else {
+            fields(*this, v);
+        }
+    }
+
+private:
+    // Consume n bytes; false (and sticky failure) past the end
+    bool take(size_t n) {
+        if (!ok_ || static_cast<size_t>(end_ - p_) < n) { ok_ = false; return false; }
+        p_ += n;
+        return true;
+    }
+    // Every element takes at least a byte, so a count beyond that is corrupt
+    bool plausible(uint32_t n) {
+        if (ok_ && n > static_cast<size_t>(end_ - p_)) ok_ = false;
+        return ok_;
+    }
+
+    const char* p_;
+    const char* end_;
+    bool        ok_ = true;
+};
+
+}  // namespace
+
+template <typename IO, typename Self>
+void CatalogReader::persist_members(IO& io, Self& self) {
+    io(self.objects_);
+    io(self.columns_);
+    io(self.indexes_);
+    io(self.alloc_units_);
+    io(self.object_alloc_units_);
+    io(self.schema_names_);
+    io(self.modules_);
+    io(self.principals_);
+    io(self.role_members_);
+    io(self.permissions_);
+    io(self.obj_to_page_objid_);
+    io(self.sysschobjs_root_page_);
+    io(self.syscolpars_root_page_);
+    io(self.sysidxstats_root_page_);
+    io(self.sysallocunits_root_page_);
+    io(self.sysrowsets_root_page_);
+}
+
+bool CatalogReader::save_to_file(const std::string& path, uint64_t identity) const {
+    CatalogWriter writer;
+    persist_members(writer, *this);
+
+    CatalogFileHeader header{};
+    std::memcpy(header.magic, "BAKRCAT", 8);
+    header.version      = CATALOG_FILE_VERSION;
+    header.identity     = identity;
+    header.payload_size = writer.out.size();
+
+    // Written under a temporary name and renamed, so a concurrent reader
+    // never sees a partial file
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            LOG_WARN("Failed to create catalog cache: %s", path.c_str());
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(writer.out.data(), static_cast<std::streamsize>(writer.out.size()));
+        if (!file) {
+            LOG_WARN("Failed to write catalog cache: %s", path.c_str());
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        LOG_WARN("Failed to write catalog cache: %s", path.c_str());
+        return false;
+    }
+
+    LOG_INFO("Saved catalog cache: %zu objects, %zu modules, %zu bytes to %s",
+             objects_.size(), modules_.size(), writer.out.size(), path.c_str());
+    return true;
+}
+
+bool CatalogReader::load_from_file(const std::string& path, uint64_t identity) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        LOG_DEBUG("Catalog cache not found: %s", path.c_str());
+        return false;
+    }
+
+    CatalogFileHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, "BAKRCAT", 7) != 0 ||
+        header.version != CATALOG_FILE_VERSION) {
+        LOG_WARN("Ignoring catalog cache with unknown format: %s", path.c_str());
+        return false;
+    }
+    if (header.identity != identity) {
+        LOG_INFO("Catalog cache %s belongs to a different backup; rescanning", path.c_str());
+        return false;
+    }
+
+    std::string payload((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CatalogFileReader reader(payload.data(), payload.size());
+    if (payload.size() == header.payload_size) persist_members(reader, *this);
+
+    if (payload.size() != header.payload_size || !reader.ok() || !reader.at_end()) {
+        LOG_WARN("Catalog cache is truncated or corrupt: %s", path.c_str());
+        *this = CatalogReader(std::move(page_provider_), std::move(view_provider_),
+                              std::move(meta_provider_));
+        return false;
+    }
+
+    LOG_INFO("Loaded catalog cache: %zu objects, %zu column sets, %zu modules, %zu principals",
+             objects_.size(), columns_.size(), modules_.size(), principals_.size());
+    return true;
+}
+
 }  // namespace bakread
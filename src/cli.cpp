@@ -27,6 +27,79 @@ static void split_columns(const std::string& csv, std::vector<std::string>& out)
     }
 }
 
+// Row count with an optional K / M / G suffix (thousands, millions, billions)
+static uint64_t parse_row_count(const std::string& v, const char* flag) {
+    size_t end = 0;
+    uint64_t n = 0;
+    try {
+        n = std::stoull(v, &end);
+    } catch (const std::exception&) {
+        throw ConfigError(std::string("Invalid row count for ") + flag + ": " + v);
+    }
+    std::string suffix = v.substr(end);
+    std::transform(suffix.begin(), suffix.end(), suffix.begin(), ::toupper);
+    if (suffix == "K")      n *= 1000ull;
+    else if (suffix == "M") n *= 1000000ull;
+    else if (suffix == "G") n *= 1000000000ull;
+    else if (!suffix.empty())
+        throw ConfigError(std::string("Invalid row count for ") + flag + ": " + v);
+    return n;
+}
+
+// Byte size with an optional K / M suffix (KB, MB)
+static uint64_t parse_byte_size(const std::string& v, const char* flag) {
+    size_t end = 0;
+    uint64_t n = 0;
+    try {
+        n = std::stoull(v, &end);
+    } catch (const std::exception&) {
+        throw ConfigError(std::string("Invalid size for ") + flag + ": " + v);
+    }
+    std::string suffix = v.substr(end);
+    std::transform(suffix.begin(), suffix.end(), suffix.begin(), ::toupper);
+    if (suffix == "K" || suffix == "KB")      n *= 1024ull;
+    else if (suffix == "M" || suffix == "MB") n *= 1024ull * 1024ull;
+    else if (!suffix.empty())
+        throw ConfigError(std::string("Invalid size for ") + flag + ": " + v);
+    return n;
+}
+
+// --compression codec[:level]
+static void parse_compression(const std::string& v, ParquetOptions& out) {
+    std::string codec = v;
+    out.codec_level = 0;
+    auto colon = v.find(':');
+    if (colon != std::string::npos) {
+        codec = v.substr(0, colon);
+        try {
+            out.codec_level = std::stoi(v.substr(colon + 1));
+        } catch (const std::exception&) {
+            throw ConfigError("Invalid compression level: " + v);
+        }
+    }
+    std::transform(codec.begin(), codec.end(), codec.begin(), ::tolower);
+    if (codec != "snappy" && codec != "zstd" && codec != "lz4" && codec != "gzip" &&
+        codec != "brotli" && codec != "none" && codec != "uncompressed")
+        throw ConfigError("Unknown compression codec: " + codec +
+                          " (use snappy, zstd, lz4, gzip, brotli or none)");
+    out.codec = codec;
+}
+
+// --dictionary all|none|c1,c2
+static void parse_dictionary(const std::string& v, ParquetOptions& out) {
+    out.dictionary_columns.clear();
+    if (v == "all") {
+        out.dictionary = true;
+    } else if (v == "none") {
+        out.dictionary = false;
+    } else {
+        out.dictionary = true;
+        split_columns(v, out.dictionary_columns);
+        if (out.dictionary_columns.empty())
+            throw ConfigError("--dictionary needs all, none or a column list");
+    }
+}
+
 Options parse_args(int argc, char* argv[]) {
     Options opts;
 
@@ -38,7 +111,9 @@ Options parse_args(int argc, char* argv[]) {
             std::exit(0);
         }
         else if (arg == "--bak")                opts.bak_paths.push_back(next_arg(i, argc, argv, "--bak"));
+        else if (arg == "--diff")               opts.diff_paths.push_back(next_arg(i, argc, argv, "--diff"));
         else if (arg == "--table")              opts.table_qualified    = next_arg(i, argc, argv, "--table");
+        else if (arg == "--tables")             split_columns(next_arg(i, argc, argv, "--tables"), opts.tables_qualified);
         else if (arg == "--out")                opts.output_path        = next_arg(i, argc, argv, "--out");
         else if (arg == "--format") {
             auto v = next_arg(i, argc, argv, "--format");
@@ -63,6 +138,7 @@ Options parse_args(int argc, char* argv[]) {
         else if (arg == "--delimiter")          opts.delimiter          = next_arg(i, argc, argv, "--delimiter");
         else if (arg == "--verbose" || arg == "-v") opts.verbose = true;
         else if (arg == "--log")                opts.log_file           = next_arg(i, argc, argv, "--log");
+        else if (arg == "--stats-json")         opts.stats_json         = next_arg(i, argc, argv, "--stats-json");
         else if (arg == "--print-data-offset")  opts.print_data_offset  = true;
         else if (arg == "--list-tables")        opts.list_tables        = true;
         else if (arg == "--allocation-hint")    opts.allocation_hint_path = next_arg(i, argc, argv, "--allocation-hint");
@@ -72,6 +148,38 @@ Options parse_args(int argc, char* argv[]) {
         else if (arg == "--cache-size")         opts.cache_size_mb = std::stoull(next_arg(i, argc, argv, "--cache-size"));
         else if (arg == "--index-dir")          opts.index_dir = next_arg(i, argc, argv, "--index-dir");
         else if (arg == "--force-rescan")       opts.force_rescan = true;
+        else if (arg == "--no-catalog-cache")   opts.catalog_cache = false;
+
+        // I/O
+        else if (arg == "--no-mmap")            opts.use_mmap = false;
+        else if (arg == "--readahead-depth")    opts.readahead_depth = std::stoull(next_arg(i, argc, argv, "--readahead-depth"));
+        else if (arg == "--readahead-mb")       opts.readahead_mb = std::stoull(next_arg(i, argc, argv, "--readahead-mb"));
+        else if (arg == "--direct-io")          opts.direct_io = true;
+        else if (arg == "--memory-budget")      opts.memory_budget_mb = std::stoull(next_arg(i, argc, argv, "--memory-budget"));
+        else if (arg == "--spill-dir")          opts.spill_dir = next_arg(i, argc, argv, "--spill-dir");
+        else if (arg == "--lob-cache-mb")       opts.lob_cache_mb = std::stoull(next_arg(i, argc, argv, "--lob-cache-mb"));
+
+        // Parallel decode
+        else if (arg == "--workers")            opts.workers = std::stoi(next_arg(i, argc, argv, "--workers"));
+        else if (arg == "--unordered")          opts.preserve_order = false;
+
+        // Partitioned output
+        else if (arg == "--writers")            opts.writers = std::stoull(next_arg(i, argc, argv, "--writers"));
+        else if (arg == "--split-rows")         opts.split_rows = parse_row_count(next_arg(i, argc, argv, "--split-rows"), "--split-rows");
+
+        // Parquet tuning
+        else if (arg == "--row-group-rows")     opts.parquet.row_group_rows = static_cast<int64_t>(parse_row_count(next_arg(i, argc, argv, "--row-group-rows"), "--row-group-rows"));
+        else if (arg == "--compression")        parse_compression(next_arg(i, argc, argv, "--compression"), opts.parquet);
+        else if (arg == "--dictionary")         parse_dictionary(next_arg(i, argc, argv, "--dictionary"), opts.parquet);
+        else if (arg == "--parquet-threads")    opts.parquet.use_threads = true;
+
+        // Restore mode
+        else if (arg == "--restore-queries")    opts.restore_queries = std::stoi(next_arg(i, argc, argv, "--restore-queries"));
+        else if (arg == "--buffercount")        opts.restore_buffer_count = std::stoi(next_arg(i, argc, argv, "--buffercount"));
+        else if (arg == "--maxtransfersize")    opts.restore_max_transfer = static_cast<int>(parse_byte_size(next_arg(i, argc, argv, "--maxtransfersize"), "--maxtransfersize"));
+        else if (arg == "--restore-data-dir")   opts.restore_data_dirs.push_back(next_arg(i, argc, argv, "--restore-data-dir"));
+        else if (arg == "--restore-log-dir")    opts.restore_log_dir = next_arg(i, argc, argv, "--restore-log-dir");
+        else if (arg == "--keep-restored-db")   opts.keep_restored_db = true;
 
         // SQL Server Authentication
         else if (arg == "--sql-user" || arg == "-U")
@@ -102,16 +210,16 @@ Options parse_args(int argc, char* argv[]) {
     return opts;
 }
 
-void Options::resolve_table_name() {
-    if (table_qualified.empty()) return;
-
-    auto dot = table_qualified.find('.');
+// schema.table -> (schema, table); schema defaults to dbo
+static void split_qualified(const std::string& qualified,
+                            std::string& schema, std::string& table) {
+    auto dot = qualified.find('.');
     if (dot != std::string::npos) {
-        schema_name = table_qualified.substr(0, dot);
-        table_name  = table_qualified.substr(dot + 1);
+        schema = qualified.substr(0, dot);
+        table  = qualified.substr(dot + 1);
     } else {
-        schema_name = "dbo";
-        table_name  = table_qualified;
+        schema = "dbo";
+        table  = qualified;
     }
 
     // Strip bracket notation: [dbo].[Orders] -> dbo.Orders
@@ -120,8 +228,40 @@ void Options::resolve_table_name() {
             s = s.substr(1, s.size() - 2);
         }
     };
-    strip(schema_name);
-    strip(table_name);
+    strip(schema);
+    strip(table);
+}
+
+void Options::resolve_table_name() {
+    tables.clear();
+    for (const auto& q : tables_qualified) {
+        std::string schema, table;
+        split_qualified(q, schema, table);
+        tables.emplace_back(schema, table);
+    }
+
+    if (table_qualified.empty()) return;
+    split_qualified(table_qualified, schema_name, table_name);
+}
+
+std::string Options::table_output_path(const std::string& schema,
+                                       const std::string& table) const {
+    const std::string name = schema + "." + table;
+
+    static const std::string placeholder = "{table}";
+    auto pos = output_path.find(placeholder);
+    if (pos != std::string::npos) {
+        std::string path = output_path;
+        path.replace(pos, placeholder.size(), name);
+        return path;
+    }
+
+    const char* ext = format == OutputFormat::Parquet ? ".parquet" :
+                      format == OutputFormat::JSONL   ? ".jsonl" : ".csv";
+    std::string dir = output_path;
+    if (!dir.empty() && dir.back() != '/' && dir.back() != '\\') dir += '/';
+    // Partitioned: each table gets a directory of parts
+    return dir + name + (partitioned() ? "" : ext);
 }
 
 void Options::validate() const {
@@ -129,10 +269,25 @@ void Options::validate() const {
         throw ConfigError("--bak is required (specify one or more backup files)");
     if (print_data_offset)
         return;
-    if (table_name.empty())
+    if (!table_qualified.empty() && !tables.empty())
+        throw ConfigError("--table and --tables cannot be combined");
+    if (table_name.empty() && tables.empty())
         throw ConfigError("--table is required (use schema.table format)");
     if (output_path.empty())
         throw ConfigError("--out is required");
+    if (writers == 0)
+        throw ConfigError("--writers must be at least 1");
+    if (restore_queries < 1)
+        throw ConfigError("--restore-queries must be at least 1");
+    if (restore_buffer_count < 0)
+        throw ConfigError("--buffercount must not be negative");
+    if (restore_max_transfer < 0 || restore_max_transfer > 4 * 1024 * 1024 ||
+        restore_max_transfer % (64 * 1024) != 0)
+        throw ConfigError("--maxtransfersize must be a multiple of 64K, at most 4M");
+    if (parquet.row_group_rows <= 0)
+        throw ConfigError("--row-group-rows must be at least 1");
+    if (!diff_paths.empty() && mode == ExecMode::Restore)
+        throw ConfigError("--diff is only supported in direct mode");
     if (mode == ExecMode::Restore && target_server.empty()) {
         // Default target will be set later if needed
     }
@@ -147,8 +302,14 @@ USAGE:
 
 REQUIRED:
     --bak PATH              Path to a .bak backup file (repeat for striped backups)
+    --diff PATH             Differential backup to layer over the full backup
+                            (repeatable; direct mode; newest page LSN wins)
     --table schema.table    Schema-qualified table name (e.g. dbo.Orders)
     --out PATH              Output file path
+    --tables "t1,t2,..."    Instead of --table: export several tables in one
+                            pass over the backup. --out is then a directory
+                            (files named schema.table.<ext>) or a template
+                            containing {table}
     --format csv|parquet|jsonl  Output format
 
 MODE:
@@ -160,7 +321,10 @@ MODE:
 FILTERING:
     --backupset N           Select backup set by position (default: first full)
     --columns "c1,c2,c3"    Comma-separated list of columns to export
-    --where "condition"     SQL WHERE clause for filtering (restore mode only)
+    --where "condition"     SQL WHERE clause for filtering. Direct mode evaluates
+                            comparisons / IN / BETWEEN on numeric and date/time
+                            columns and IS [NOT] NULL, joined by AND/OR/NOT;
+                            other conditions need restore mode
     --max-rows N            Maximum number of rows to export
     --delimiter ","         CSV delimiter (default: comma)
     --allocation-hint FILE  CSV file with (file_id,page_id) to filter pages (direct mode)
@@ -168,11 +332,25 @@ FILTERING:
 LOGGING:
     --verbose, -v           Enable verbose output
     --log FILE              Write log to file
+    --stats-json FILE       Write a JSON report of per-stage timings, scan and
+                            cache counters and queue stalls
 
 SQL SERVER CONNECTION:
     --target-server SERVER        Target SQL Server for restore mode
     --sql-user, -U USER           SQL Server login (default: Windows Auth)
     --sql-password, -P PASS       SQL Server password (or set BAKREAD_SQL_PASSWORD env)
+    --restore-queries N           Restore mode: read the table with N concurrent range
+                                  queries, one connection each (default: 1). Splits by
+                                  partition, integer clustered key, or page id; row
+                                  order is not kept. Ignored with --max-rows
+    --buffercount N               RESTORE ... WITH BUFFERCOUNT = N (I/O buffers)
+    --maxtransfersize SIZE        RESTORE ... WITH MAXTRANSFERSIZE (64K multiple up to 4M,
+                                  e.g. 4M)
+    --restore-data-dir DIR        Put restored data files here; repeat to spread them
+                                  round-robin across volumes (default: instance path)
+    --restore-log-dir DIR         Put the restored log file here
+    --keep-restored-db            Keep the restored database and reuse it on later runs
+                                  of the same backup set instead of restoring again
 
 TDE / ENCRYPTION:
     --tde-cert-pfx PATH           Certificate file (.cer or .pfx)
@@ -188,7 +366,45 @@ LARGE BACKUP MODE (indexed):
     --indexed               Use indexed page store (recommended for >1GB backups)
     --cache-size MB         LRU cache size in MB (default: 256)
     --index-dir PATH        Directory for index files (default: next to backup)
-    --force-rescan          Ignore existing index files and rescan
+    --force-rescan          Ignore existing index and catalog cache files and rescan
+    --no-catalog-cache      Neither read nor write the catalog sidecar
+                            (<backup>_bakread.cat, next to the index)
+
+I/O:
+    --no-mmap               Read through buffered file I/O instead of memory-mapping
+    --readahead-depth N     Scan reads kept in flight ahead of the parser (default: 4)
+    --readahead-mb MB       Size of each scan read-ahead buffer (default: 4)
+    --direct-io             Scan with unbuffered reads (O_DIRECT / FILE_FLAG_NO_BUFFERING)
+                            so the backup does not evict other data from the OS cache
+    --memory-budget MB      Pages kept in memory in direct mode (default: 512);
+                            the rest are re-read from the backup on demand
+    --spill-dir PATH        Directory for the page spill file (default: system temp)
+    --lob-cache-mb MB       Page cache for off-row values (MAX types, TEXT/NTEXT/IMAGE,
+                            row-overflow) in direct mode (default: 64; 0 = write
+                            "[LOB data]" placeholders instead)
+
+PARALLEL DECODE (direct mode):
+    --workers N             Row decode threads (default: 0 = all hardware threads,
+                            1 = single-threaded)
+    --unordered             Emit rows as pages finish decoding instead of in page order
+
+PARTITIONED OUTPUT:
+    --writers N             Writer threads (default: 1). With N > 1, --out is a
+                            directory; each writer fills its own part-NNNNN.<ext>
+                            files and _manifest.json lists them
+    --split-rows N          Start a new part file after N rows (suffix K/M/G,
+                            e.g. 10M); parts close at the first batch boundary
+                            at or past N. Also makes --out a directory
+
+PARQUET TUNING (--format parquet):
+    --row-group-rows N      Rows per row group (default: 64K = 65536; suffix K/M/G
+                            means thousands/millions). Larger groups compress
+                            better, smaller ones let readers skip more
+    --compression C[:L]     snappy (default), zstd, lz4, gzip, brotli or none,
+                            with an optional level (e.g. zstd:3)
+    --dictionary D          Dictionary encoding: all (default), none, or a
+                            comma-separated list of columns to encode
+    --parquet-threads       Encode the columns of a row group in parallel
 
 EXAMPLES:
     bakread --bak backup.bak --table dbo.Orders --out orders.csv --format csv
@@ -198,6 +414,15 @@ EXAMPLES:
     # Striped backup (multiple files):
     bakread --bak stripe1.bak --bak stripe2.bak --bak stripe3.bak --table dbo.Orders --out orders.csv --format csv
 
+    # Several tables, one pass over the backup (writes exports/dbo.Orders.csv, ...):
+    bakread --bak backup.bak --tables "dbo.Orders,dbo.Customers,Sales.Invoices" --out exports --format csv
+
+    # Parquet parts of at most ~10M rows, encoded on 8 threads (writes orders/part-00000.parquet, ...):
+    bakread --bak backup.bak --table dbo.Orders --out orders --format parquet --writers 8 --split-rows 10M
+
+    # Parquet with zstd level 3 and 1M-row groups, dictionary only on low-cardinality columns:
+    bakread --bak backup.bak --table dbo.Orders --out orders.parquet --format parquet --compression zstd:3 --row-group-rows 1M --dictionary "Status,Region"
+
     # Large backup with indexed mode (50GB StackOverflow):
     bakread --bak StackOverflow_1of4.bak --bak StackOverflow_2of4.bak --bak StackOverflow_3of4.bak --bak StackOverflow_4of4.bak \
             --table dbo.Users --out users.csv --format csv --indexed --cache-size 512
@@ -0,0 +1,403 @@
+#include "bakread/compressed_stripe.h"
+#include "bakread/error.h"
+#include "bakread/logging.h"
+#include "bakread/page.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+namespace bakread {
+
+static constexpr uint16_t BLOCK_MAGIC = 0xDAC0;
+static constexpr uint16_t MAX_HEADER_SIZE = 4096;
+
+// -------------------------------------------------------------------------
+// CompressedBlockCache
+// -------------------------------------------------------------------------
+
+CompressedBlockCache::CompressedBlockCache(size_t capacity_bytes)
+    : capacity_bytes_(capacity_bytes)
+{
+}
+
+CompressedBlockCache::BlockPtr CompressedBlockCache::get(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = lookup_.find(key);
+    if (it == lookup_.end()) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return it->second->block;
+}
+
+void CompressedBlockCache::put(uint64_t key, BlockPtr block) {
+    if (!block) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = lookup_.find(key);
+    if (it != lookup_.end()) {
+        // Another reader decoded the same block first; keep one copy
+        bytes_ -= it->second->block->data.size();
+        lru_list_.erase(it->second);
+        lookup_.erase(it);
+    }
+    bytes_ += block->data.size();
+    lru_list_.push_front({key, std::move(block)});
+    lookup_[key] = lru_list_.begin();
+    evict_locked();
+}
+
+void CompressedBlockCache::evict_locked() {
+    // Always keep the newest block, even if it alone exceeds the budget
+    while (bytes_ > capacity_bytes_ && lru_list_.size() > 1) {
+        Entry& victim = lru_list_.back();
+        bytes_ -= victim.block->data.size();
+        lookup_.erase(victim.key);
+        lru_list_.pop_back();
+    }
+}
+
+void CompressedBlockCache::reserve(size_t capacity_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_bytes_ = std::max(capacity_bytes_, capacity_bytes);
+}
+
+void CompressedBlockCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_list_.clear();
+    lookup_.clear();
+    bytes_ = 0;
+}
+
+size_t CompressedBlockCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_list_.size();
+}
+
+size_t CompressedBlockCache::memory_usage_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+size_t CompressedBlockCache::capacity_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_bytes_;
+}
+
+// -------------------------------------------------------------------------
+// CompressedStripe
+// -------------------------------------------------------------------------
+
+CompressedStripe::CompressedStripe(const std::string& path, const MappedStripe* map)
+    : path_(path)
+    , map_(map)
+{
+    static std::atomic<uint64_t> next_id{1};
+    id_ = next_id.fetch_add(1);
+
+    if (map_) {
+        size_ = map_->size();
+        return;
+    }
+
+    std::error_code ec;
+    size_ = std::filesystem::file_size(path, ec);
+    file_.open(path, std::ios::binary);
+    if (ec || !file_.is_open())
+        throw FileIOError("Cannot open compressed stripe: " + path);
+}
+
+// -------------------------------------------------------------------------
+// Block chain
+// -------------------------------------------------------------------------
+
+const uint8_t* CompressedStripe::bytes(uint64_t offset, size_t len,
+                                       std::vector<uint8_t>& scratch) {
+    if (map_) return map_->view(offset, len);
+
+    if (offset > size_ || len > size_ - offset) return nullptr;
+    scratch.resize(len);
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(offset));
+    file_.read(reinterpret_cast<char*>(scratch.data()), static_cast<std::streamsize>(len));
+    if (static_cast<size_t>(file_.gcount()) != len) return nullptr;
+    return scratch.data();
+}
+
+bool CompressedStripe::block_at(uint64_t offset, Block& out) {
+    std::vector<uint8_t> scratch;
+    const uint8_t* p = bytes(offset, sizeof(CompressedBlockHeader), scratch);
+    if (!p) return false;
+
+    CompressedBlockHeader hdr;
+    std::memcpy(&hdr, p, sizeof(hdr));
+    if (hdr.magic != BLOCK_MAGIC) return false;
+    if (hdr.header_size < sizeof(CompressedBlockHeader) || hdr.header_size > MAX_HEADER_SIZE)
+        return false;
+    if (hdr.compressed_size == 0 || hdr.compressed_size > MAX_BLOCK_SIZE) return false;
+    if (hdr.uncompressed_size == 0 || hdr.uncompressed_size > MAX_BLOCK_SIZE) return false;
+
+    out.offset            = offset;
+    out.header_size       = hdr.header_size;
+    out.compressed_size   = hdr.compressed_size;
+    out.uncompressed_size = hdr.uncompressed_size;
+    return out.end() <= size_;
+}
+
+bool CompressedStripe::find_block(uint64_t from, Block& out) {
+    constexpr size_t WINDOW = 1024 * 1024;
+    std::vector<uint8_t> scratch;
+
+    for (uint64_t base = from; base + sizeof(CompressedBlockHeader) <= size_; ) {
+        size_t len = static_cast<size_t>(std::min<uint64_t>(WINDOW, size_ - base));
+        const uint8_t* p = bytes(base, len, scratch);
+        if (!p) return false;
+
+        // Magic is little-endian C0 DA
+        for (size_t i = 0; i + 1 < len; ++i) {
+            if (p[i] == 0xC0 && p[i + 1] == 0xDA && block_at(base + i, out)) return true;
+        }
+        if (len < WINDOW) break;
+        base += len - 1;   // Keep a magic split across windows
+    }
+    return false;
+}
+
+bool CompressedStripe::decode(const Block& blk, const uint8_t* stored, Decompressor& decomp,
+                              std::vector<uint8_t>& out) const {
+    out.resize(blk.uncompressed_size);
+    size_t n = decomp.decompress_into(stored, static_cast<size_t>(blk.stored_size()),
+                                      out.data(), out.size());
+    if (n == 0) {
+        LOG_WARN("Failed to decompress block at offset %llu in %s",
+                 (unsigned long long)blk.offset, path_.c_str());
+        out.clear();
+        return false;
+    }
+    if (n != blk.uncompressed_size) {
+        LOG_DEBUG_HOT("Block at %llu decoded to %zu bytes, header says %u",
+                  (unsigned long long)blk.offset, n, blk.uncompressed_size);
+    }
+    out.resize(n);
+    return true;
+}
+
+// -------------------------------------------------------------------------
+// Sequential scan with parallel decompression
+// -------------------------------------------------------------------------
+
+size_t CompressedStripe::scan_pages(uint64_t begin, size_t threads, const PageFn& fn,
+                                    const BlockFn& on_block) {
+    struct Job {
+        Block                blk;
+        std::vector<uint8_t> scratch;               // Stored bytes when unmapped
+        const uint8_t*       stored = nullptr;
+        std::vector<uint8_t> data;                  // Decompressed block
+        bool                 ready  = false;
+    };
+
+    // Stream reassembly: pages may straddle block boundaries
+    std::vector<uint8_t> carry;
+    carry.reserve(PAGE_SIZE);
+    CompressedPageRef carry_ref;
+    uint64_t prev_end = 0;
+    size_t decoded = 0;
+
+    auto emit = [&](const Job& job) {
+        if (job.blk.offset != prev_end) carry.clear();   // Chain break: drop partial page
+        prev_end = job.blk.end();
+        if (job.data.empty()) { carry.clear(); return; }
+        ++decoded;
+        if (on_block) {
+            on_block(job.blk.offset, static_cast<uint32_t>(job.blk.stored_size()),
+                     static_cast<uint32_t>(job.data.size()));
+        }
+
+        const uint8_t* data = job.data.data();
+        size_t len = job.data.size();
+        size_t pos = 0;
+
+        if (!carry.empty()) {
+            size_t take = std::min(PAGE_SIZE - carry.size(), len);
+            carry.insert(carry.end(), data, data + take);
+            pos = take;
+            if (carry.size() == PAGE_SIZE) {
+                fn(carry.data(), carry_ref);
+                carry.clear();
+            }
+        }
+        for (; pos + PAGE_SIZE <= len; pos += PAGE_SIZE) {
+            fn(data + pos, CompressedPageRef{job.blk.offset, static_cast<uint32_t>(pos)});
+        }
+        if (pos < len) {
+            carry.assign(data + pos, data + len);
+            carry_ref = CompressedPageRef{job.blk.offset, static_cast<uint32_t>(pos)};
+        }
+    };
+
+    Block next;
+    bool have = block_at(begin, next) || find_block(begin, next);
+    auto advance = [&](const Block& cur) {
+        have = block_at(cur.end(), next) || find_block(cur.end(), next);
+    };
+    auto load = [&](Job& job) {
+        job.blk    = next;
+        job.stored = bytes(next.offset, static_cast<size_t>(next.stored_size()), job.scratch);
+        advance(job.blk);
+    };
+
+    if (threads <= 1) {
+        Decompressor decomp;
+        Job job;
+        while (have) {
+            load(job);
+            job.data.clear();
+            if (job.stored) decode(job.blk, job.stored, decomp, job.data);
+            emit(job);
+        }
+        return decoded;
+    }
+
+    // Ordered window: the caller reads blocks and emits them in order,
+    // workers decompress whichever dispatched block is next
+    const size_t window_cap = threads * 4;
+    std::deque<std::shared_ptr<Job>> window;
+    size_t next_work = 0;        // Index in window of the first undispatched job
+    bool   finished  = false;
+    std::mutex mutex;
+    std::condition_variable work_cv, done_cv;
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            Decompressor decomp;
+            for (;;) {
+                std::shared_ptr<Job> job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    work_cv.wait(lock, [&] { return finished || next_work < window.size(); });
+                    if (next_work >= window.size()) return;
+                    job = window[next_work++];
+                }
+                if (job->stored) decode(job->blk, job->stored, decomp, job->data);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    job->ready = true;
+                }
+                done_cv.notify_all();
+            }
+        });
+    }
+
+    // load() and emit() may throw (a page store out of room): the workers
+    // are still stopped and joined before the exception leaves
+    std::exception_ptr caller_error;
+    try {
+        for (;;) {
+            while (have) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (window.size() >= window_cap) break;
+                }
+                auto job = std::make_shared<Job>();
+                load(*job);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    window.push_back(std::move(job));
+                }
+                work_cv.notify_one();
+            }
+
+            std::shared_ptr<Job> front;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (window.empty()) break;
+                done_cv.wait(lock, [&] { return window.front()->ready; });
+                front = window.front();
+                window.pop_front();
+                --next_work;
+            }
+            emit(*front);
+        }
+    } catch (...) {
+        caller_error = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    work_cv.notify_all();
+    for (auto& w : workers) w.join();
+    if (caller_error) std::rethrow_exception(caller_error);
+    return decoded;
+}
+
+// -------------------------------------------------------------------------
+// Random access
+// -------------------------------------------------------------------------
+
+CompressedBlockCache::BlockPtr CompressedStripe::load_block(uint64_t offset,
+                                                           CompressedBlockCache& cache,
+                                                           const BlockSizeFn& block_size) {
+    // Block offsets stay far below 2^48; the instance id keeps stripes apart
+    const uint64_t key = (id_ << 48) ^ offset;
+    if (auto hit = cache.get(key)) return hit;
+
+    // Sizes known from the index skip the separate header read and parse
+    Block blk;
+    uint32_t stored_size = 0, uncompressed_size = 0;
+    if (block_size && block_size(offset, stored_size, uncompressed_size) &&
+        stored_size > sizeof(CompressedBlockHeader) &&
+        uncompressed_size != 0 && uncompressed_size <= MAX_BLOCK_SIZE &&
+        offset <= size_ && stored_size <= size_ - offset) {
+        blk.offset            = offset;
+        blk.compressed_size   = stored_size;   // header_size stays 0: stored_size() is exact
+        blk.uncompressed_size = uncompressed_size;
+    } else if (!block_at(offset, blk)) {
+        return nullptr;
+    }
+
+    thread_local Decompressor decomp;
+    std::vector<uint8_t> scratch;
+    const uint8_t* stored = bytes(blk.offset, static_cast<size_t>(blk.stored_size()), scratch);
+
+    auto decoded = std::make_shared<DecodedBlock>();
+    decoded->end = blk.end();
+    if (!stored || !decode(blk, stored, decomp, decoded->data)) return nullptr;
+
+    cache.put(key, decoded);
+    return decoded;
+}
+
+bool CompressedStripe::read_page(const CompressedPageRef& ref, uint8_t* out,
+                                 CompressedBlockCache& cache, const BlockSizeFn& block_size) {
+    size_t filled = 0;
+    size_t pos = ref.intra_offset;
+    uint64_t offset = ref.block_offset;
+    while (filled < PAGE_SIZE) {
+        CompressedBlockCache::BlockPtr blk = load_block(offset, cache, block_size);
+        if (!blk || pos > blk->data.size()) return false;
+
+        size_t take = std::min(PAGE_SIZE - filled, blk->data.size() - pos);
+        std::memcpy(out + filled, blk->data.data() + pos, take);
+        filled += take;
+
+        // A page that straddles blocks continues in the next one of the chain
+        offset = blk->end;
+        pos = 0;
+    }
+    return true;
+}
+
+}  // namespace bakread
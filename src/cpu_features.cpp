@@ -0,0 +1,38 @@
+#include "bakread/cpu_features.h"
+
+#if defined(BAKREAD_HAS_AVX2_KERNELS) && defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace bakread {
+
+#ifdef BAKREAD_HAS_AVX2_KERNELS
+static bool detect_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) return false;
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx     = (regs[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;   // OS saves YMM
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+bool cpu_has_avx2() {
+#ifdef BAKREAD_HAS_AVX2_KERNELS
+    static const bool has = detect_avx2();
+    return has;
+#else
+    return false;
+#endif
+}
+
+}  // namespace bakread
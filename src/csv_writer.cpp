@@ -2,11 +2,50 @@
 #include "bakread/error.h"
 #include "bakread/logging.h"
 
-#include <iomanip>
-#include <sstream>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BAKREAD_CSV_SSE2 1
+#endif
 
 namespace bakread {
 
+// Longest text to_chars/snprintf can produce for one number
+static constexpr size_t NUMBER_CHARS = 32;
+
+// -------------------------------------------------------------------------
+// Quoting scan
+// -------------------------------------------------------------------------
+
+// True if s contains a quote, CR, LF or the delimiter -- 16 bytes per step
+static bool needs_quoting(const char* s, size_t len, char delim) {
+    size_t i = 0;
+#ifdef BAKREAD_CSV_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i cr    = _mm_set1_epi8('\r');
+    const __m128i lf    = _mm_set1_epi8('\n');
+    const __m128i dl    = _mm_set1_epi8(delim);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, cr)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, dl)));
+        if (_mm_movemask_epi8(hit) != 0) return true;
+    }
+#endif
+    for (; i < len; ++i) {
+        char c = s[i];
+        if (c == '"' || c == '\n' || c == '\r' || c == delim) return true;
+    }
+    return false;
+}
+
+// -------------------------------------------------------------------------
+// CsvWriter
+// -------------------------------------------------------------------------
+
 CsvWriter::CsvWriter(const std::string& delimiter)
     : delimiter_(delimiter)
 {
@@ -24,15 +63,20 @@ bool CsvWriter::open(const std::string& path, const TableSchema& schema) {
         throw ExportError("Cannot open output file: " + path);
     }
 
+    // Reserve a little past the threshold so a full batch row rarely grows it
+    buffer_.resize(BUFFER_SIZE + (BUFFER_SIZE >> 2));
+    used_ = 0;
+
     // Write UTF-8 BOM for Excel compatibility
-    file_.write("\xEF\xBB\xBF", 3);
+    append("\xEF\xBB\xBF", 3);
 
     // Write header row
     for (size_t i = 0; i < schema.columns.size(); ++i) {
-        if (i > 0) file_ << delimiter_;
-        file_ << escape_csv(schema.columns[i].name);
+        if (i > 0) append(delimiter_.data(), delimiter_.size());
+        const std::string& name = schema.columns[i].name;
+        append_escaped(name.data(), name.size());
     }
-    file_ << "\r\n";
+    append("\r\n", 2);
 
     open_ = true;
     LOG_INFO("CSV writer opened: %s (%zu columns)", path.c_str(),
@@ -43,108 +87,151 @@ bool CsvWriter::open(const std::string& path, const TableSchema& schema) {
 bool CsvWriter::write_row(const Row& row) {
     if (!open_) return false;
 
-    for (size_t i = 0; i < row.size() && i < schema_.columns.size(); ++i) {
-        if (i > 0) file_ << delimiter_;
-        file_ << format_value(row[i]);
-    }
-    file_ << "\r\n";
+    append_row(row);
+    if (used_ >= BUFFER_SIZE) return spill();
+    return true;
+}
 
-    ++rows_written_;
+bool CsvWriter::write_batch(const RowBatch& batch) {
+    if (!open_) return false;
 
-    // Periodic flush for crash safety on large exports
-    if (rows_written_ % 50000 == 0) {
-        file_.flush();
+    for (const auto& row : batch) {
+        append_row(row);
+        if (used_ >= BUFFER_SIZE && !spill()) return false;
     }
-
-    return file_.good();
+    return true;
 }
 
 bool CsvWriter::close() {
     if (!open_) return true;
 
+    bool ok = spill();
     file_.flush();
+    ok = ok && file_.good();
     file_.close();
+    ok = ok && !file_.fail();
     open_ = false;
+    std::vector<char>().swap(buffer_);
 
+    if (!ok) {
+        LOG_ERROR("Failed to flush CSV output after %llu rows",
+                  (unsigned long long)rows_written_);
+        return false;
+    }
     LOG_INFO("CSV writer closed: %llu rows written",
              (unsigned long long)rows_written_);
     return true;
 }
 
-std::string CsvWriter::format_value(const RowValue& val) const {
-    return std::visit([this](auto&& arg) -> std::string {
+void CsvWriter::append_row(const Row& row) {
+    for (size_t i = 0; i < row.size() && i < schema_.columns.size(); ++i) {
+        if (i > 0) append(delimiter_.data(), delimiter_.size());
+        append_value(row[i]);
+    }
+    append("\r\n", 2);
+    ++rows_written_;
+}
+
+void CsvWriter::append_value(const RowValue& val) {
+    std::visit([this](auto&& arg) {
         using T = std::decay_t<decltype(arg)>;
 
         if constexpr (std::is_same_v<T, NullValue>) {
-            return "";
+            // Empty field
         }
         else if constexpr (std::is_same_v<T, bool>) {
-            return arg ? "1" : "0";
-        }
-        else if constexpr (std::is_same_v<T, int8_t>) {
-            return std::to_string(static_cast<int>(arg));
+            append(arg ? "1" : "0", 1);
         }
-        else if constexpr (std::is_same_v<T, int16_t>) {
-            return std::to_string(arg);
+        else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> ||
+                           std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>) {
+            char* out = reserve(NUMBER_CHARS);
+            used_ += std::to_chars(out, out + NUMBER_CHARS, static_cast<int64_t>(arg)).ptr - out;
         }
-        else if constexpr (std::is_same_v<T, int32_t>) {
-            return std::to_string(arg);
-        }
-        else if constexpr (std::is_same_v<T, int64_t>) {
-            return std::to_string(arg);
-        }
-        else if constexpr (std::is_same_v<T, float>) {
-            std::ostringstream oss;
-            oss << std::setprecision(7) << arg;
-            return oss.str();
-        }
-        else if constexpr (std::is_same_v<T, double>) {
-            std::ostringstream oss;
-            oss << std::setprecision(15) << arg;
-            return oss.str();
+        else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+            // Same text as ostream << setprecision(7 / 15), i.e. %.7g / %.15g
+            constexpr int precision = std::is_same_v<T, float> ? 7 : 15;
+            char* out = reserve(NUMBER_CHARS);
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            used_ += std::to_chars(out, out + NUMBER_CHARS, arg,
+                                   std::chars_format::general, precision).ptr - out;
+#else
+            int n = std::snprintf(out, NUMBER_CHARS, "%.*g", precision, static_cast<double>(arg));
+            if (n > 0) used_ += static_cast<size_t>(n);
+#endif
         }
         else if constexpr (std::is_same_v<T, std::string>) {
-            return escape_csv(arg);
+            append_escaped(arg.data(), arg.size());
         }
         else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
             // Binary data as hex string
-            std::ostringstream oss;
-            oss << "0x";
-            for (auto b : arg)
-                oss << std::hex << std::setw(2) << std::setfill('0')
-                    << static_cast<int>(b);
-            return oss.str();
+            static const char HEX[] = "0123456789abcdef";
+            char* out = reserve(2 + arg.size() * 2);
+            *out++ = '0';
+            *out++ = 'x';
+            for (uint8_t b : arg) {
+                *out++ = HEX[b >> 4];
+                *out++ = HEX[b & 0x0F];
+            }
+            used_ += 2 + arg.size() * 2;
         }
         else if constexpr (std::is_same_v<T, SqlDecimal>) {
-            return arg.to_string();
+            char* out = reserve(SqlDecimal::FORMAT_SIZE);
+            used_ += arg.format(out);
         }
         else if constexpr (std::is_same_v<T, SqlGuid>) {
-            return arg.to_string();
-        }
-        else {
-            return "";
+            char* out = reserve(SqlGuid::FORMAT_SIZE + 1);
+            used_ += arg.format(out);
         }
     }, val);
 }
 
-std::string CsvWriter::escape_csv(const std::string& s) const {
-    bool needs_quoting = false;
-    for (char c : s) {
-        if (c == '"' || c == '\n' || c == '\r' || c == delimiter_[0]) {
-            needs_quoting = true;
-            break;
+void CsvWriter::append_escaped(const char* s, size_t len) {
+    const char delim = delimiter_.empty() ? '\0' : delimiter_[0];
+    if (!needs_quoting(s, len, delim)) {
+        append(s, len);
+        return;
+    }
+
+    // Worst case every character is a quote
+    char* out = reserve(len * 2 + 2);
+    char* start = out;
+    *out++ = '"';
+    const char* end = s + len;
+    while (s < end) {
+        const char* q = static_cast<const char*>(std::memchr(s, '"', end - s));
+        size_t run = (q ? q : end) - s;
+        std::memcpy(out, s, run);
+        out += run;
+        s += run;
+        if (q) {
+            *out++ = '"';
+            *out++ = '"';
+            ++s;
         }
     }
+    *out++ = '"';
+    used_ += out - start;
+}
+
+char* CsvWriter::reserve(size_t n) {
+    if (used_ + n > buffer_.size()) {
+        spill();
+        if (n > buffer_.size()) buffer_.resize(n);
+    }
+    return buffer_.data() + used_;
+}
 
-    if (!needs_quoting) return s;
+void CsvWriter::append(const char* s, size_t len) {
+    std::memcpy(reserve(len), s, len);
+    used_ += len;
+}
 
-    std::string result = "\"";
-    for (char c : s) {
-        if (c == '"') result += "\"\"";
-        else result += c;
+bool CsvWriter::spill() {
+    if (used_ > 0) {
+        file_.write(buffer_.data(), static_cast<std::streamsize>(used_));
+        used_ = 0;
     }
-    result += "\"";
-    return result;
+    return file_.good();
 }
 
 }  // namespace bakread
@@ -5,6 +5,10 @@
 #include <algorithm>
 #include <cstring>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #ifdef BAKREAD_HAS_ZLIB
 #include <zlib.h>
 #endif
@@ -13,6 +17,56 @@ namespace bakread {
 
 static constexpr uint16_t SQL_COMPRESS_MAGIC = 0xDAC0;
 
+static inline int trailing_zeros(uint32_t v) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, v);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctz(v);
+#endif
+}
+
+// Copy an LZ match of `len` bytes from `offset` back; returns the new output
+// position. The source may overlap the destination (offset < len). Offsets
+// of 16 and up move 16 bytes per step -- past the end of the match when at
+// least 16 bytes of capacity are left, since later output overwrites the
+// excess. Shorter offsets first repeat the pattern until it is 64 bytes long
+// (a byte run becomes 1, 2, 4, ..., 64), so every step after that is a
+// non-overlapping wide copy that does not read the bytes just stored. The
+// tail is copied byte by byte.
+static inline size_t copy_match(uint8_t* dst, size_t di, size_t cap,
+                                size_t offset, size_t len) {
+    uint8_t* out = dst + di;
+    uint8_t* end = out + len;
+
+    if (offset >= 16 && cap - di - len >= 16) {
+        do {
+            std::memcpy(out, out - offset, 16);
+            out += 16;
+        } while (out < end);
+        return di + len;
+    }
+
+    size_t dist = offset;
+    while (dist < 64 && static_cast<size_t>(end - out) >= dist) {
+        std::memcpy(out, out - dist, dist);
+        out  += dist;
+        dist *= 2;   // Still a whole number of pattern periods back
+    }
+    if (dist >= 16) {
+        while (end - out >= 16) {
+            std::memcpy(out, out - dist, 16);
+            out += 16;
+        }
+    }
+    while (out < end) {
+        *out = *(out - offset);
+        ++out;
+    }
+    return di + len;
+}
+
 Decompressor::Decompressor()
     : work_buffer_(256 * 1024)
 {
@@ -115,55 +169,68 @@ size_t Decompressor::decompress_sqlserver_lz(const uint8_t* src, size_t src_len,
         std::memcpy(&flags, src + si, 4);
         si += 4;
 
-        for (int bit = 0; bit < 32 && si < src_len && di < dst_capacity; ++bit) {
+        int bit = 0;
+        while (bit < 32 && si < src_len && di < dst_capacity) {
             if (!(flags & (1u << bit))) {
-                // Literal byte
-                dst[di++] = src[si++];
-            } else {
-                // Match reference
-                if (si + 2 > src_len) return di;
-
-                uint16_t match_info;
-                std::memcpy(&match_info, src + si, 2);
-                si += 2;
-
-                uint32_t match_offset = (match_info >> 3) + 1;
-                uint32_t match_length = (match_info & 0x07) + 3;
-
-                // Extended length encoding
-                if ((match_info & 0x07) == 0x07) {
-                    if (si >= src_len) return di;
-                    uint8_t extra = src[si++];
-                    match_length = extra + 10;
-
-                    if (extra == 0xFF) {
-                        if (si + 2 > src_len) return di;
-                        uint16_t ext16;
-                        std::memcpy(&ext16, src + si, 2);
-                        si += 2;
-                        match_length = ext16;
-                        if (match_length == 0) {
-                            if (si + 4 > src_len) return di;
-                            uint32_t ext32;
-                            std::memcpy(&ext32, src + si, 4);
-                            si += 4;
-                            match_length = ext32;
-                        }
-                    }
+                // Run of literal bytes up to the next match bit
+                uint32_t rest = flags >> bit;
+                size_t run = rest ? static_cast<size_t>(trailing_zeros(rest))
+                                  : static_cast<size_t>(32 - bit);
+                run = std::min({run, src_len - si, dst_capacity - di});
+                if (run >= 8) {
+                    std::memcpy(dst + di, src + si, run);
+                } else if (src_len - si >= 8 && dst_capacity - di >= 8) {
+                    std::memcpy(dst + di, src + si, 8);   // Excess is overwritten
+                } else {
+                    for (size_t j = 0; j < run; ++j) dst[di + j] = src[si + j];
                 }
-
-                if (match_offset > di) {
-                    LOG_DEBUG("LZ match offset %u exceeds output position %zu",
-                              match_offset, di);
-                    return 0;
+                si  += run;
+                di  += run;
+                bit += static_cast<int>(run);
+                continue;
+            }
+            ++bit;
+
+            // Match reference
+            if (si + 2 > src_len) return di;
+
+            uint16_t match_info;
+            std::memcpy(&match_info, src + si, 2);
+            si += 2;
+
+            uint32_t match_offset = (match_info >> 3) + 1;
+            uint32_t match_length = (match_info & 0x07) + 3;
+
+            // Extended length encoding
+            if ((match_info & 0x07) == 0x07) {
+                if (si >= src_len) return di;
+                uint8_t extra = src[si++];
+                match_length = extra + 10;
+
+                if (extra == 0xFF) {
+                    if (si + 2 > src_len) return di;
+                    uint16_t ext16;
+                    std::memcpy(&ext16, src + si, 2);
+                    si += 2;
+                    match_length = ext16;
+                    if (match_length == 0) {
+                        if (si + 4 > src_len) return di;
+                        uint32_t ext32;
+                        std::memcpy(&ext32, src + si, 4);
+                        si += 4;
+                        match_length = ext32;
+                    }
                 }
+            }
 
-                // Copy match (byte-by-byte to handle overlapping copies)
-                for (uint32_t j = 0; j < match_length && di < dst_capacity; ++j) {
-                    dst[di] = dst[di - match_offset];
-                    ++di;
-                }
+            if (match_offset > di) {
+                LOG_DEBUG_HOT("LZ match offset %u exceeds output position %zu",
+                          match_offset, di);
+                return 0;
             }
+
+            di = copy_match(dst, di, dst_capacity, match_offset,
+                            std::min<size_t>(match_length, dst_capacity - di));
         }
     }
 
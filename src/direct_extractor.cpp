@@ -1,9 +1,19 @@
 #include "bakread/direct_extractor.h"
+#include "bakread/compressed_stripe.h"
 #include "bakread/error.h"
 #include "bakread/logging.h"
+#include "bakread/page_scan.h"
+#include "bakread/read_ahead.h"
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <thread>
 
 namespace bakread {
 
@@ -12,6 +22,15 @@ DirectExtractor::DirectExtractor(const std::vector<std::string>& bak_paths,
     : bak_paths_(bak_paths)
     , config_(config)
 {
+    for (const auto& path : bak_paths_) sources_.push_back({path, 0, false, false});
+    for (const auto& path : config_.diff_paths) sources_.push_back({path, 0, false, true});
+
+    if (config_.use_indexed_mode && !config_.diff_paths.empty()) {
+        LOG_WARN("Differential backups are layered in the in-memory page store; "
+                 "indexed mode is off for this extraction");
+        config_.use_indexed_mode = false;
+    }
+
     if (config_.use_indexed_mode) {
         LOG_INFO("Using indexed page store mode (cache: %zu MB)", config_.cache_size_mb);
         
@@ -19,8 +38,23 @@ DirectExtractor::DirectExtractor(const std::vector<std::string>& bak_paths,
         store_config.cache_pages = (config_.cache_size_mb * 1024 * 1024) / 8192;  // MB to pages
         store_config.index_dir = config_.index_dir;
         store_config.force_rescan = config_.force_rescan;
+        store_config.use_mmap = config_.use_mmap;
+        store_config.readahead_depth = config_.readahead_depth;
+        store_config.readahead_bytes = config_.readahead_mb * 1024 * 1024;
+        store_config.direct_io = config_.direct_io;
         
         indexed_store_ = std::make_unique<IndexedPageStore>(bak_paths_, store_config);
+    } else {
+        PageStoreConfig store_config;
+        store_config.memory_budget_mb = config_.memory_budget_mb;
+        store_config.spill_dir = config_.spill_dir;
+        store_config.use_mmap = config_.use_mmap;
+
+        std::vector<std::string> stripe_paths;
+        for (const auto& src : sources_) stripe_paths.push_back(src.path);
+
+        page_store_ = std::make_unique<PageStore>(store_config);
+        page_store_->set_stripe_paths(stripe_paths);
     }
 }
 
@@ -35,10 +69,19 @@ void DirectExtractor::set_columns(const std::vector<std::string>& columns) {
     target_columns_ = columns;
 }
 
+void DirectExtractor::set_where(const std::string& condition) {
+    where_clause_ = condition;
+}
+
 void DirectExtractor::set_max_rows(int64_t max_rows) {
     max_rows_ = max_rows;
 }
 
+void DirectExtractor::set_decode_workers(int workers, bool preserve_order) {
+    config_.decode_workers = workers;
+    config_.preserve_order = preserve_order;
+}
+
 void DirectExtractor::set_allocation_hints(std::unordered_set<int64_t> hints) {
     allocation_hints_ = std::move(hints);
 }
@@ -47,6 +90,10 @@ void DirectExtractor::set_progress_callback(ProgressCallback cb) {
     progress_cb_ = cb;
 }
 
+void DirectExtractor::set_stats(RunStats* stats) {
+    stats_ = stats;
+}
+
 const BackupInfo& DirectExtractor::backup_info() const {
     static BackupInfo empty;
     return header_parser_ ? header_parser_->info() : empty;
@@ -56,47 +103,22 @@ ListTablesResult DirectExtractor::list_tables() {
     ListTablesResult result;
 
     try {
-        // Phase 1: Headers
         LOG_INFO("=== Direct Extract Mode - List Tables ===");
-        if (!phase_parse_headers()) {
-            result.error_message = "Failed to parse backup headers";
-            return result;
-        }
-
-        // Check for TDE / encryption (warn but continue)
-        if (header_parser_->is_tde_enabled()) {
-            result.error_message = "TDE detected. Cannot list tables directly.";
-            LOG_WARN("%s", result.error_message.c_str());
-            return result;
-        }
-
-        if (header_parser_->is_backup_encrypted()) {
-            result.error_message = "Backup encryption detected. Cannot list tables directly.";
-            LOG_WARN("%s", result.error_message.c_str());
-            return result;
-        }
-
-        // Phase 2: Load pages
-        if (!phase_load_pages()) {
-            result.error_message = "Failed to read pages from backup stream";
-            return result;
-        }
-
-        // Phase 3: Build catalog
-        LOG_INFO("Building system catalog...");
-        catalog_ = std::make_unique<CatalogReader>(
-            [this](int32_t file_id, int32_t page_id, uint8_t* buf) {
-                return this->provide_page(file_id, page_id, buf);
-            });
-
-        if (!catalog_->scan_catalog()) {
-            result.error_message = "Failed to scan system catalog";
+        DirectExtractResult prepared;
+        if (!prepare_catalog(prepared)) {
+            result.error_message =
+                prepared.tde_detected ? "TDE detected. Cannot list tables directly." :
+                prepared.encryption_detected ? "Backup encryption detected. Cannot list tables directly." :
+                prepared.error_message;
             return result;
         }
 
         // Get all user tables
         auto user_tables = catalog_->list_user_tables();
         LOG_INFO("Found %zu user tables in catalog", user_tables.size());
+        if (!indexed_store_) {
+            LOG_INFO("Row and page estimates need a page index (--indexed)");
+        }
 
         for (const auto& obj : user_tables) {
             TableInfo info;
@@ -110,18 +132,8 @@ ListTablesResult DirectExtractor::list_tables() {
             // This is simplified - the actual schema name resolution is in catalog
             info.full_name = schema + "." + obj.name;
             info.schema_name = schema;
-            
-            // Try to get row/page estimates from allocation units
-            auto allocs = catalog_->get_allocation_units(obj.object_id);
-            if (!allocs.empty()) {
-                info.page_count = 0;
-                for (const auto& au : allocs) {
-                    if (au.type == 1) {  // IN_ROW_DATA
-                        // Estimate based on first/root page info
-                    }
-                }
-            }
 
+            estimate_table_size(info);
             result.tables.push_back(std::move(info));
         }
 
@@ -142,53 +154,72 @@ ListTablesResult DirectExtractor::list_tables() {
 }
 
 DirectExtractResult DirectExtractor::extract(RowCallback row_callback) {
+    return run_extract([&] { return phase_extract_rows(row_callback); });
+}
+
+DirectExtractResult DirectExtractor::extract_columns(ColumnBatchCallback batch_callback,
+                                                     ColumnLayout layout) {
+    return run_extract([&] { return phase_extract_columns(batch_callback, layout); });
+}
+
+DirectExtractResult DirectExtractor::run_extract(const std::function<uint64_t()>& extract_phase) {
     DirectExtractResult result;
 
     try {
-        // Phase 1: Headers
-        LOG_INFO("=== Direct Extract Mode (Mode A) ===");
-        if (!phase_parse_headers()) {
-            result.error_message = "Failed to parse backup headers";
-            return result;
-        }
+        // Phases 1-2: headers, encryption checks, catalog pages
+        if (!prepare_catalog(result)) return result;
 
-        // Check for TDE / encryption
-        if (header_parser_->is_tde_enabled()) {
-            result.tde_detected = true;
-            result.error_message =
-                "TDE detected. Direct parsing not supported. "
-                "Provide certificate or use restore mode (--mode restore).";
-            LOG_ERROR("%s", result.error_message.c_str());
-            return result;
+        // Phase 3: Resolve table
+        bool resolved;
+        {
+            RunStats::Timer timer(stats_, "resolve");
+            resolved = phase_resolve_table();
         }
-
-        if (header_parser_->is_backup_encrypted()) {
-            result.encryption_detected = true;
-            result.error_message =
-                "Backup encryption detected. Direct parsing not supported. "
-                "Use restore mode with appropriate certificates.";
-            LOG_ERROR("%s", result.error_message.c_str());
+        if (!resolved) {
+            result.error_message = "Failed to resolve table '" +
+                target_schema_ + "." + target_table_ +
+                "' from system catalog";
             return result;
         }
 
-        // Phase 2: Load pages
-        if (!phase_load_pages()) {
-            result.error_message = "Failed to read pages from backup stream";
+        // Phase 3b: Pull in the target table's data pages
+        if (!phase_load_table_pages()) {
+            result.error_message = "Failed to read table pages from backup stream";
             return result;
         }
 
-        // Phase 3: Resolve table
-        if (!phase_resolve_table()) {
-            result.error_message = "Failed to resolve table '" +
-                target_schema_ + "." + target_table_ +
-                "' from system catalog";
-            return result;
+        // Off-row values are read through a page cache of their own
+        if (!lob_reader_ && config_.lob_cache_mb > 0 && projects_var_columns()) {
+            lob_reader_ = std::make_unique<LobReader>(
+                [this](int32_t fid, int32_t pid, uint8_t* scratch) {
+                    return this->fetch_page(fid, pid, scratch);
+                },
+                config_.lob_cache_mb * 1024 * 1024 / PAGE_SIZE);
         }
+        const uint64_t lob_before    = lob_reader_ ? lob_reader_->values_read() : 0;
+        const uint64_t missed_before = lob_reader_ ? lob_reader_->unresolved() : 0;
 
         // Phase 4: Extract rows
-        result.rows_read = phase_extract_rows(row_callback);
+        result.rows_read = extract_phase();
         result.success = true;
 
+        if (lob_reader_) {
+            uint64_t values = lob_reader_->values_read() - lob_before;
+            uint64_t missed = lob_reader_->unresolved() - missed_before;
+            if (values > 0) {
+                uint64_t lookups = lob_reader_->cache_hits() + lob_reader_->cache_misses();
+                LOG_INFO("Off-row values: %llu read (LOB cache hit rate %.1f%%)",
+                         (unsigned long long)values,
+                         lookups > 0 ? lob_reader_->cache_hits() * 100.0 / lookups : 0.0);
+            }
+            if (missed > 0) {
+                LOG_WARN("%llu off-row values could not be followed (LOB pages missing "
+                         "from the backup); written as placeholders",
+                         (unsigned long long)missed);
+            }
+        }
+        report_store_stats();
+
         LOG_INFO("Direct extraction complete: %llu rows",
                  (unsigned long long)result.rows_read);
 
@@ -203,15 +234,212 @@ DirectExtractResult DirectExtractor::extract(RowCallback row_callback) {
     return result;
 }
 
+DirectExtractResult DirectExtractor::load_tables(
+        const std::vector<std::pair<std::string, std::string>>& tables) {
+    DirectExtractResult result;
+
+    try {
+        if (!prepare_catalog(result)) return result;
+
+        // Page header obj_ids of every requested table not loaded yet, and
+        // of their LOB / row-overflow allocation units
+        std::unordered_set<uint32_t> objids;
+        std::unordered_set<uint32_t> lob_objids;
+        for (const auto& [schema, table] : tables) {
+            TableSchema ts;
+            if (!catalog_->resolve_table(schema, table, ts)) {
+                LOG_WARN("Table '%s.%s' not found in catalog; skipped",
+                         schema.c_str(), table.c_str());
+                continue;
+            }
+            uint32_t objid = catalog_->get_page_obj_id(ts.object_id);
+            if (objid != 0 && loaded_objids_.count(objid) == 0) objids.insert(objid);
+            if (config_.lob_cache_mb == 0) continue;
+            for (uint32_t lob : catalog_->get_lob_page_obj_ids(ts.object_id)) {
+                if (loaded_objids_.count(lob) == 0) lob_objids.insert(lob);
+            }
+        }
+
+        if (!indexed_store_ && (!objids.empty() || !lob_objids.empty())) {
+            LOG_INFO("Phase 3b: Reading data pages for %zu tables in one pass...",
+                     objids.size());
+
+            uint64_t kept = scan_stripes("page_scan", [&](const PageHeader& hdr) {
+                if (lob_objids.count(hdr.obj_id)) return true;
+                if (objids.count(hdr.obj_id) == 0) return false;
+                if (hdr.type == static_cast<uint8_t>(PageType::IAM)) return true;   // As in phase_load_table_pages
+                return allocation_hints_.empty() ||
+                       allocation_hints_.count(page_key(hdr.this_file, hdr.this_page)) > 0;
+            });
+
+            LOG_INFO("Table scan complete: %llu pages kept (%zu unique in store)",
+                     (unsigned long long)kept, page_store_->size());
+            LOG_INFO("Page store: %zu resident (%zu MB), %zu re-read from backup, %zu spilled",
+                     page_store_->resident_pages(),
+                     page_store_->memory_usage_bytes() / (1024 * 1024),
+                     page_store_->referenced_pages(), page_store_->spilled_pages());
+
+            if (allocation_hints_.empty())
+                loaded_objids_.insert(objids.begin(), objids.end());
+            loaded_objids_.insert(lob_objids.begin(), lob_objids.end());
+        }
+
+        result.success = true;
+        report_store_stats();
+
+    } catch (const BakReadError& e) {
+        result.error_message = e.what();
+        LOG_ERROR("Loading tables failed: %s", e.what());
+    } catch (const std::exception& e) {
+        result.error_message = std::string("Unexpected error: ") + e.what();
+        LOG_ERROR("Loading tables failed: %s", e.what());
+    }
+
+    return result;
+}
+
+bool DirectExtractor::prepare_catalog(DirectExtractResult& result) {
+    if (catalog_loaded_) return true;
+
+    // Phase 1: Headers
+    LOG_INFO("=== Direct Extract Mode (Mode A) ===");
+    bool parsed;
+    {
+        RunStats::Timer timer(stats_, "headers");
+        parsed = phase_parse_headers();
+    }
+    if (!parsed) {
+        result.error_message = "Failed to parse backup headers";
+        return false;
+    }
+
+    // Check for TDE / encryption
+    if (header_parser_->is_tde_enabled()) {
+        result.tde_detected = true;
+        result.error_message =
+            "TDE detected. Direct parsing not supported. "
+            "Provide certificate or use restore mode (--mode restore).";
+        LOG_ERROR("%s", result.error_message.c_str());
+        return false;
+    }
+
+    if (header_parser_->is_backup_encrypted()) {
+        result.encryption_detected = true;
+        result.error_message =
+            "Backup encryption detected. Direct parsing not supported. "
+            "Use restore mode with appropriate certificates.";
+        LOG_ERROR("%s", result.error_message.c_str());
+        return false;
+    }
+
+    // A catalog cached by an earlier run replaces the catalog page pass
+    // (indexed mode still needs its page index for the data pages)
+    catalog_ = make_catalog_reader();
+    const std::string cache_path = config_.catalog_cache ? catalog_cache_path() : "";
+    const uint64_t identity = cache_path.empty() ? 0 : backup_identity();
+    bool cached = false;
+    if (!cache_path.empty() && !config_.force_rescan) {
+        RunStats::Timer timer(stats_, "catalog");
+        cached = catalog_->load_from_file(cache_path, identity);
+    }
+    if (cached) {
+        LOG_INFO("Phase 2: Catalog loaded from %s", cache_path.c_str());
+    }
+
+    // Phase 2: Load pages
+    if ((indexed_store_ || !cached) && !phase_load_pages()) {
+        result.error_message = "Failed to read pages from backup stream";
+        return false;
+    }
+
+    if (!cached) {
+        LOG_INFO("Building system catalog...");
+        RunStats::Timer timer(stats_, "catalog");
+        if (!catalog_->scan_catalog()) {
+            LOG_ERROR("System catalog scan failed");
+            result.error_message = "Failed to scan system catalog";
+            return false;
+        }
+        if (!cache_path.empty()) catalog_->save_to_file(cache_path, identity);
+    }
+
+    // List discovered tables
+    auto tables = catalog_->list_user_tables();
+    if (!tables.empty()) {
+        LOG_INFO("Discovered user tables:");
+        for (auto& t : tables) {
+            LOG_INFO("  %s (object_id=%d)", t.name.c_str(), t.object_id);
+        }
+    }
+
+    catalog_loaded_ = true;
+    return true;
+}
+
 bool DirectExtractor::phase_parse_headers() {
     LOG_INFO("Phase 1: Parsing backup headers from %zu file(s)...",
              bak_paths_.size());
 
-    stream_ = std::make_unique<BackupStream>(bak_paths_[0]);
+    stream_ = std::make_unique<BackupStream>(bak_paths_[0], 4 * 1024 * 1024,
+                                             config_.use_mmap);
     header_parser_ = std::make_unique<BackupHeaderParser>(*stream_);
-    decompressor_ = std::make_unique<Decompressor>();
 
-    return header_parser_->parse();
+    if (!header_parser_->parse()) return false;
+
+    // Stripes of one backup share its header layout
+    const auto& sets = header_parser_->backup_sets();
+    for (auto& src : sources_) {
+        if (src.overlay) continue;
+        src.data_start = header_parser_->data_start_offset();
+        src.compressed = !sets.empty() && sets[0].is_compressed;
+    }
+
+    return parse_differential_headers();
+}
+
+bool DirectExtractor::parse_differential_headers() {
+    if (config_.diff_paths.empty()) return true;
+
+    const auto& base_sets = header_parser_->backup_sets();
+    const std::string base_db = base_sets.empty() ? "" : base_sets[0].database_name;
+    if (!base_sets.empty() && base_sets[0].backup_type == BackupType::Differential) {
+        LOG_WARN("%s is a differential backup; pass the full backup with --bak "
+                 "and differentials with --diff", bak_paths_[0].c_str());
+    }
+
+    for (auto& src : sources_) {
+        if (!src.overlay) continue;
+        LOG_INFO("Phase 1b: Parsing differential backup header: %s", src.path.c_str());
+
+        BackupStream stream(src.path, 4 * 1024 * 1024, config_.use_mmap);
+        BackupHeaderParser parser(stream);
+        if (!parser.parse()) {
+            LOG_ERROR("Cannot parse differential backup header: %s", src.path.c_str());
+            return false;
+        }
+        if (parser.is_tde_enabled() || parser.is_backup_encrypted()) {
+            LOG_ERROR("Differential backup %s is encrypted; direct mode cannot read it",
+                      src.path.c_str());
+            return false;
+        }
+
+        const BackupSetInfo* set = parser.backup_sets().empty() ? nullptr
+                                                                : &parser.backup_sets()[0];
+        if (set && !base_db.empty() && !set->database_name.empty() &&
+            set->database_name != base_db) {
+            LOG_ERROR("Differential backup %s is of database '%s', the full backup of '%s'",
+                      src.path.c_str(), set->database_name.c_str(), base_db.c_str());
+            return false;
+        }
+        if (set && set->backup_type != BackupType::Differential) {
+            LOG_WARN("%s is a %s backup, not a differential; its pages are still "
+                     "layered by LSN", src.path.c_str(), backup_type_name(set->backup_type));
+        }
+
+        src.data_start = parser.data_start_offset();
+        src.compressed = set && set->is_compressed;
+    }
+    return true;
 }
 
 bool DirectExtractor::phase_load_pages() {
@@ -234,7 +462,21 @@ bool DirectExtractor::phase_load_pages() {
             }
         };
         
+        RunStats::Timer timer(stats_, "index_scan");
+        const uint64_t bytes_before = indexed_store_->bytes_read();
+        const uint64_t slots_before = indexed_store_->pages_scanned();
+        const uint64_t valid_before = indexed_store_->pages_valid();
         bool ok = indexed_store_->scan(progress);
+        if (stats_) {
+            ScanStats scan;
+            scan.bytes_read   = indexed_store_->bytes_read() - bytes_before;
+            scan.slots_tested = indexed_store_->pages_scanned() - slots_before;
+            scan.pages_valid  = indexed_store_->pages_valid() - valid_before;
+            scan.pages_kept   = indexed_store_->index().size();
+            stats_->add_scan(scan);
+            timer.add_bytes(scan.bytes_read);
+            timer.add_pages(scan.pages_kept);
+        }
         if (ok) {
             LOG_INFO("Index built: %zu pages, cache hit rate: %.1f%%",
                      indexed_store_->index().size(),
@@ -243,62 +485,219 @@ bool DirectExtractor::phase_load_pages() {
         return ok;
     }
 
-    LOG_INFO("Phase 2: Reading pages from %zu backup file(s)...",
-             bak_paths_.size());
+    LOG_INFO("Phase 2: Reading catalog pages from %zu backup file(s)...",
+             sources_.size());
+
+    // Stage one: only the low pages of the primary file are needed to
+    // resolve the catalog; data pages are picked up once the target
+    // allocation unit is known (phase_load_table_pages). The bound is the
+    // furthest any catalog sweep reaches (module text goes past the rest).
+    const int32_t page_limit = std::max(CatalogReader::CATALOG_PAGE_LIMIT,
+                                        CatalogReader::MODULE_PAGE_LIMIT);
+    uint64_t kept = scan_stripes("catalog_scan", [page_limit](const PageHeader& hdr) {
+        return hdr.this_file == CatalogReader::CATALOG_FILE_ID &&
+               hdr.this_page < page_limit;
+    });
+
+    LOG_INFO("Catalog scan complete: %llu pages kept (%zu unique) from %zu file(s)",
+             (unsigned long long)kept, page_store_->size(), sources_.size());
+
+    return kept > 0;
+}
+
+bool DirectExtractor::phase_load_table_pages() {
+    if (indexed_store_) return true;
+
+    uint32_t target_page_objid = catalog_->get_page_obj_id(schema_.object_id);
+    if (target_page_objid == 0) return true;  // Reported by phase_extract_rows
+
+    // Off-row values of the extracted columns live in the table's LOB and
+    // row-overflow allocation units; their pages are loaded in full (hints
+    // name data pages only)
+    std::unordered_set<uint32_t> lob_objids;
+    if (config_.lob_cache_mb > 0 && projects_var_columns()) {
+        for (uint32_t objid : catalog_->get_lob_page_obj_ids(schema_.object_id)) {
+            if (loaded_objids_.count(objid) == 0) lob_objids.insert(objid);
+        }
+    }
+    const bool data_loaded = loaded_objids_.count(target_page_objid) > 0;
+
+    if (data_loaded && lob_objids.empty()) {
+        LOG_INFO("Phase 3b: Data pages for %s already loaded",
+                 schema_.qualified_name().c_str());
+        return true;
+    }
+
+    LOG_INFO("Phase 3b: Reading %s for %s (page obj_id=%u, %zu LOB allocation unit(s))...",
+             data_loaded ? "LOB pages" : "data pages",
+             schema_.qualified_name().c_str(), target_page_objid, lob_objids.size());
 
     if (!allocation_hints_.empty()) {
         LOG_INFO("Allocation hint active: filtering to %zu target pages",
                  allocation_hints_.size());
     }
 
-    uint64_t scan_start = header_parser_->data_start_offset();
-    scan_start = (scan_start + PAGE_SIZE - 1) & ~(static_cast<uint64_t>(PAGE_SIZE) - 1);
-    if (scan_start == 0) scan_start = PAGE_SIZE;
+    // Stage two: stream the backup again and keep only the target's pages.
+    // Its IAM pages come along (they carry the same header obj_id): stage
+    // one only has the low ones, and none when the catalog came from cache,
+    // and collect_candidate_pages() walks the chain for allocation order.
+    uint64_t kept = scan_stripes("page_scan", [&](const PageHeader& hdr) {
+        if (lob_objids.count(hdr.obj_id)) return true;
+        if (hdr.obj_id != target_page_objid || data_loaded) return false;
+        if (hdr.type == static_cast<uint8_t>(PageType::IAM)) return true;
+        return allocation_hints_.empty() ||
+               allocation_hints_.count(page_key(hdr.this_file, hdr.this_page)) > 0;
+    });
+
+    LOG_INFO("Table scan complete: %llu pages kept (%zu unique in store)",
+             (unsigned long long)kept, page_store_->size());
+    LOG_INFO("Page store: %zu resident (%zu MB), %zu re-read from backup, %zu spilled",
+             page_store_->resident_pages(),
+             page_store_->memory_usage_bytes() / (1024 * 1024),
+             page_store_->referenced_pages(), page_store_->spilled_pages());
+
+    // A hint-filtered load is partial; a later extraction scans again
+    if (allocation_hints_.empty()) loaded_objids_.insert(target_page_objid);
+    loaded_objids_.insert(lob_objids.begin(), lob_objids.end());
+    return true;
+}
 
+uint64_t DirectExtractor::scan_stripes(const char* stage,
+                                       const std::function<bool(const PageHeader&)>& keep) {
     constexpr size_t CHUNK_PAGES = 128;
     constexpr size_t CHUNK_SIZE  = PAGE_SIZE * CHUNK_PAGES;
-    std::vector<uint8_t> buf(CHUNK_SIZE);
-
-    uint64_t total_pages_found = 0;
-    uint64_t total_bytes = 0;
-    for (auto& p : bak_paths_) {
-        BackupStream probe(p);
-        total_bytes += probe.file_size();
-    }
 
-    for (size_t fi = 0; fi < bak_paths_.size(); ++fi) {
-        auto& path = bak_paths_[fi];
-        LOG_INFO("Scanning stripe %zu/%zu: %s",
-                 fi + 1, bak_paths_.size(), path.c_str());
+    // Plausible-header bitmask of the chunk being classified
+    std::vector<uint64_t> header_mask;
+
+    ReadAheadConfig ra_config;
+    ra_config.depth       = config_.readahead_depth;
+    ra_config.buffer_size = config_.readahead_mb * 1024 * 1024;
+    ra_config.unbuffered  = config_.direct_io;
+
+    // Compressed stripes are a chain of compressed blocks, decoded on a
+    // worker pool; the pages come back in stream order
+    size_t decomp_threads = config_.decode_workers > 0
+        ? static_cast<size_t>(config_.decode_workers)
+        : std::max(1u, std::thread::hardware_concurrency());
+
+    uint64_t total_kept = 0;
+    const uint64_t replaced_before = overlay_replaced_;
+    RunStats::Timer timer(stats_, stage);
+    ScanStats scan;
+
+    for (size_t fi = 0; fi < sources_.size(); ++fi) {
+        const ScanSource& src = sources_[fi];
+        const std::string& path = src.path;
+        LOG_INFO("Scanning %s %zu/%zu: %s", src.overlay ? "differential" : "stripe",
+                 fi + 1, sources_.size(), path.c_str());
+
+        uint64_t scan_start = (src.data_start + PAGE_SIZE - 1) &
+                              ~(static_cast<uint64_t>(PAGE_SIZE) - 1);
+        if (scan_start == 0) scan_start = PAGE_SIZE;
+
+        // A differential's copy of a page already in the store must be
+        // considered even when keep() rejects it: the page may have moved
+        // to another object since the full backup
+        auto wanted = [&](const PageHeader& hdr) {
+            return keep(hdr) ||
+                   (src.overlay && page_store_->contains(page_key(hdr.this_file, hdr.this_page)));
+        };
 
         auto stripe_stream = (fi == 0)
             ? std::move(stream_)
-            : std::make_unique<BackupStream>(path);
+            : std::make_unique<BackupStream>(path, 4 * 1024 * 1024, config_.use_mmap);
 
         uint64_t stripe_size = stripe_stream->file_size();
-        uint64_t pages_found = 0;
-
-        stripe_stream->seek(scan_start);
+        uint64_t pages_found = 0;   // Valid page headers seen
+        uint64_t pages_kept  = 0;   // Pages that passed the keep filter
+
+        if (src.compressed) {
+            CompressedStripe stripe(path, stripe_stream->mapping());
+            size_t blocks = stripe.scan_pages(src.data_start, decomp_threads,
+                [&](const uint8_t* page, const CompressedPageRef& ref) {
+                    ++scan.slots_tested;
+                    if (!page_header_plausible(page)) return;
+                    const auto& hdr = *reinterpret_cast<const PageHeader*>(page);
+                    ++pages_found;
+                    if (!wanted(hdr)) return;
 
-        while (!stripe_stream->eof()) {
-            uint64_t chunk_file_off = stripe_stream->position();
-            size_t got = stripe_stream->read(buf.data(), buf.size());
-            if (got < PAGE_SIZE) break;
+                    // No raw page to re-read: the store keeps (or spills) a copy
+                    cache_page(hdr.this_file, hdr.this_page, page);
+                    ++pages_kept;
+
+                    if (progress_cb_ && pages_kept % 2048 == 0) {
+                        Progress p;
+                        p.bytes_processed = ref.block_offset;
+                        p.bytes_total     = stripe_size;
+                        p.pct             = static_cast<double>(ref.block_offset) /
+                                            static_cast<double>(stripe_size) * 100.0;
+                        progress_cb_(p);
+                    }
+                });
+
+            LOG_INFO("Stripe %zu: %zu compressed blocks, %llu pages found, %llu kept", fi + 1,
+                     blocks, (unsigned long long)pages_found, (unsigned long long)pages_kept);
+            total_kept += pages_kept;
+            scan.bytes_read  += stripe_size - src.data_start;
+            scan.pages_valid += pages_found;
+            if (fi == 0) stream_ = std::move(stripe_stream);
+            continue;
+        }
 
-            for (size_t off = 0; off + PAGE_SIZE <= got; off += PAGE_SIZE) {
-                const uint8_t* page = buf.data() + off;
-                PageHeader hdr;
-                std::memcpy(&hdr, page, sizeof(hdr));
+        // Feed [scan_start, stripe_size) to fn chunk by chunk. Mapped stripes
+        // hand out views and ask the kernel for the next window ahead of the
+        // cursor; unmapped ones (and every stripe under --direct-io, which
+        // must not go through the page cache) read through a ReadAhead ring.
+        // Either way the disk is busy while the chunk is being classified.
+        auto for_each_chunk = [&](const std::function<void(const uint8_t*, size_t, uint64_t)>& fn) {
+            const MappedStripe* map = config_.direct_io ? nullptr : stripe_stream->mapping();
+            if (map) {
+                const size_t   step   = std::max(CHUNK_SIZE, ra_config.buffer_size / CHUNK_SIZE * CHUNK_SIZE);
+                const uint64_t window = std::max<size_t>(1, ra_config.depth) * step;
+                map->prefetch(scan_start, static_cast<size_t>(window));
+                for (uint64_t off = scan_start; off + PAGE_SIZE <= stripe_size; off += CHUNK_SIZE) {
+                    if ((off - scan_start) % step == 0)
+                        map->prefetch(off + window, step);
+                    size_t got = static_cast<size_t>(std::min<uint64_t>(CHUNK_SIZE, stripe_size - off));
+                    fn(map->data() + off, got, off);
+                }
+                return;
+            }
 
-                if (hdr.header_version != 1) continue;
-                if (hdr.type < 1 || hdr.type > 17) continue;
-                if (hdr.this_file < 1 || hdr.this_file > 32) continue;
-                if (hdr.slot_count > 1000) continue;
-                if (hdr.free_count > PAGE_SIZE) continue;
+            ReadAhead reader(path, scan_start, stripe_size, ra_config);
+            const uint8_t* data = nullptr;
+            size_t len = 0;
+            uint64_t base = 0;
+            while (reader.next(data, len, base)) {
+                for (size_t off = 0; off + PAGE_SIZE <= len; off += CHUNK_SIZE) {
+                    fn(data + off, std::min(CHUNK_SIZE, len - off), base + off);
+                }
+            }
+            // next() also stops on a read error; the rest of the stripe is unseen
+            if (reader.failed()) throw FileIOError("Read error while scanning " + path);
+        };
 
-                cache_page(hdr.this_file, hdr.this_page, page);
+        // Classify a chunk's candidate headers in one batch, then hand the
+        // plausible ones to keep() in place
+        auto scan_chunk = [&](const uint8_t* chunk, size_t got, uint64_t chunk_file_off,
+                              size_t stride) {
+            scan.slots_tested += classify_page_headers(chunk, got, stride, header_mask);
+            for_each_set_bit(header_mask, [&](size_t i) {
+                const uint8_t* page = chunk + i * stride;
+                const auto& hdr = *reinterpret_cast<const PageHeader*>(page);
                 ++pages_found;
-            }
+                if (!wanted(hdr)) return;
+
+                cache_page(hdr.this_file, hdr.this_page, page,
+                           static_cast<int>(fi), chunk_file_off + i * stride);
+                ++pages_kept;
+            });
+        };
+
+        for_each_chunk([&](const uint8_t* chunk, size_t got, uint64_t chunk_file_off) {
+            scan.bytes_read += got;
+            scan_chunk(chunk, got, chunk_file_off, PAGE_SIZE);
 
             if (progress_cb_) {
                 uint64_t pos = chunk_file_off + got;
@@ -306,92 +705,55 @@ bool DirectExtractor::phase_load_pages() {
                     Progress p;
                     p.bytes_processed = pos;
                     p.bytes_total     = stripe_size;
-                    p.pct             = stripe_stream->progress_pct();
+                    p.pct             = static_cast<double>(pos) / static_cast<double>(stripe_size) * 100.0;
                     progress_cb_(p);
                 }
             }
-
-            if (page_cache_.size() * PAGE_SIZE > 512ULL * 1024 * 1024) {
-                LOG_WARN("Page cache limit reached (%zu pages, ~%zu MB).",
-                         page_cache_.size(),
-                         page_cache_.size() * PAGE_SIZE / (1024 * 1024));
-                break;
-            }
-        }
+        });
 
         if (pages_found == 0) {
             LOG_WARN("No pages at 8KB boundaries in stripe %zu; trying 512-byte scan...",
                      fi + 1);
-            stripe_stream->seek(scan_start);
-
-            while (!stripe_stream->eof()) {
-                size_t got = stripe_stream->read(buf.data(), buf.size());
-                if (got < PAGE_SIZE) break;
-
-                for (size_t off = 0; off + PAGE_SIZE <= got; off += 512) {
-                    const uint8_t* page = buf.data() + off;
-                    PageHeader hdr;
-                    std::memcpy(&hdr, page, sizeof(hdr));
 
-                    if (hdr.header_version != 1) continue;
-                    if (hdr.type < 1 || hdr.type > 17) continue;
-                    if (hdr.this_file < 1 || hdr.this_file > 32) continue;
-                    if (hdr.slot_count > 1000) continue;
-                    if (hdr.free_count > PAGE_SIZE) continue;
-
-                    cache_page(hdr.this_file, hdr.this_page, page);
-                    ++pages_found;
-                }
-
-                if (page_cache_.size() * PAGE_SIZE > 512ULL * 1024 * 1024) break;
-            }
+            for_each_chunk([&](const uint8_t* chunk, size_t got, uint64_t chunk_file_off) {
+                scan.bytes_read += got;
+                scan_chunk(chunk, got, chunk_file_off, 512);
+            });
         }
 
-        LOG_INFO("Stripe %zu: %llu pages found", fi + 1,
-                 (unsigned long long)pages_found);
-        total_pages_found += pages_found;
+        LOG_INFO("Stripe %zu: %llu pages found, %llu kept", fi + 1,
+                 (unsigned long long)pages_found, (unsigned long long)pages_kept);
+        total_kept += pages_kept;
+        scan.pages_valid += pages_found;
 
         if (fi == 0) {
             stream_ = std::move(stripe_stream);
         }
     }
 
-    LOG_INFO("Page scan complete: %llu pages cached (%zu MB) from %zu file(s)",
-             (unsigned long long)total_pages_found,
-             page_cache_.size() * PAGE_SIZE / (1024 * 1024),
-             bak_paths_.size());
+    if (overlay_replaced_ > replaced_before) {
+        LOG_INFO("Differential overlay: %llu pages replaced by newer copies",
+                 (unsigned long long)(overlay_replaced_ - replaced_before));
+    }
 
-    return total_pages_found > 0;
+    if (stats_) {
+        scan.pages_kept = total_kept;
+        stats_->add_scan(scan);
+        timer.add_bytes(scan.bytes_read);
+        timer.add_pages(total_kept);
+    }
+    return total_kept;
 }
 
 bool DirectExtractor::phase_resolve_table() {
     LOG_INFO("Phase 3: Resolving table '%s.%s' from system catalog...",
              target_schema_.c_str(), target_table_.c_str());
 
-    auto provider = [this](int32_t fid, int32_t pid, uint8_t* buf) -> bool {
-        return this->provide_page(fid, pid, buf);
-    };
-
-    catalog_ = std::make_unique<CatalogReader>(provider);
-
-    if (!catalog_->scan_catalog()) {
-        LOG_ERROR("System catalog scan failed");
-        return false;
-    }
-
-    // List discovered tables
-    auto tables = catalog_->list_user_tables();
-    if (!tables.empty()) {
-        LOG_INFO("Discovered user tables:");
-        for (auto& t : tables) {
-            LOG_INFO("  %s (object_id=%d)", t.name.c_str(), t.object_id);
-        }
-    }
-
-    if (!catalog_->resolve_table(target_schema_, target_table_, schema_)) {
+    if (!catalog_->resolve_table(target_schema_, target_table_, physical_schema_)) {
         LOG_ERROR("Table '%s.%s' not found in catalog",
                   target_schema_.c_str(), target_table_.c_str());
 
+        auto tables = catalog_->list_user_tables();
         if (!tables.empty()) {
             LOG_INFO("Available tables:");
             for (auto& t : tables)
@@ -400,28 +762,40 @@ bool DirectExtractor::phase_resolve_table() {
         return false;
     }
 
-    // Apply column filter if specified
-    if (!target_columns_.empty()) {
-        std::vector<ColumnDef> filtered;
-        for (auto& req_col : target_columns_) {
-            bool found = false;
-            for (auto& col : schema_.columns) {
-                if (col.name == req_col) {
-                    filtered.push_back(col);
-                    found = true;
-                    break;
-                }
-            }
-            if (!found) {
-                LOG_WARN("Requested column '%s' not found in table schema",
-                         req_col.c_str());
+    // Apply column filter if specified. The decoder keeps the full physical
+    // schema for record geometry and only materializes the projected columns.
+    projection_.clear();
+    for (auto& req_col : target_columns_) {
+        bool found = false;
+        for (size_t i = 0; i < physical_schema_.columns.size(); ++i) {
+            if (physical_schema_.columns[i].name == req_col) {
+                projection_.push_back(static_cast<int>(i));
+                found = true;
+                break;
             }
         }
-        if (!filtered.empty()) {
-            schema_.columns = std::move(filtered);
+        if (!found) {
+            LOG_WARN("Requested column '%s' not found in table schema",
+                     req_col.c_str());
         }
     }
 
+    schema_ = physical_schema_;
+    if (!projection_.empty()) {
+        schema_.columns.clear();
+        for (int i : projection_) schema_.columns.push_back(physical_schema_.columns[i]);
+        LOG_INFO("Projecting %zu of %zu columns", projection_.size(),
+                 physical_schema_.columns.size());
+    }
+
+    // Compile the row filter against the physical schema (throws
+    // ConfigError for conditions outside the supported subset)
+    filter_.reset();
+    if (!where_clause_.empty()) {
+        filter_ = std::make_unique<RowFilter>(where_clause_, physical_schema_);
+        LOG_INFO("Row filter pushed down: %s", where_clause_.c_str());
+    }
+
     LOG_INFO("Table schema resolved: %zu columns", schema_.columns.size());
     for (auto& col : schema_.columns) {
         LOG_DEBUG("  Column: %s (type=%d, len=%d, nullable=%d)",
@@ -432,11 +806,8 @@ bool DirectExtractor::phase_resolve_table() {
     return true;
 }
 
-uint64_t DirectExtractor::phase_extract_rows(RowCallback& callback) {
-    LOG_INFO("Phase 4: Extracting rows...");
-
-    RowDecoder decoder(schema_);
-    uint64_t total_rows = 0;
+std::vector<int64_t> DirectExtractor::collect_candidate_pages() {
+    std::vector<int64_t> candidate_pages;
 
     uint32_t target_page_objid = catalog_->get_page_obj_id(schema_.object_id);
     LOG_INFO("Table %s (object_id=%d) maps to page header obj_id=%u",
@@ -445,26 +816,68 @@ uint64_t DirectExtractor::phase_extract_rows(RowCallback& callback) {
     if (target_page_objid == 0) {
         LOG_ERROR("Could not resolve page header obj_id for table %s",
                   schema_.qualified_name().c_str());
-        return 0;
+        return candidate_pages;
     }
 
-    std::vector<int64_t> candidate_pages;
-
-    for (auto& [key, page_data] : page_cache_) {
-        PageHeader hdr;
-        std::memcpy(&hdr, page_data.data(), sizeof(hdr));
-
-        if (hdr.type != static_cast<uint8_t>(PageType::Data)) continue;
-        if (hdr.slot_count == 0) continue;
-        if (hdr.obj_id != target_page_objid) continue;
+    auto consider = [&](int64_t key, uint8_t type, uint16_t slot_count, uint32_t obj_id) {
+        if (type != static_cast<uint8_t>(PageType::Data)) return;
+        if (slot_count == 0) return;
+        if (obj_id != target_page_objid) return;
 
         // If allocation hints are provided, only include pages in the hint set
         if (!allocation_hints_.empty() &&
             allocation_hints_.find(key) == allocation_hints_.end()) {
-            continue;
+            return;
         }
 
         candidate_pages.push_back(key);
+    };
+
+    // Allocation order: enumerate the in-row allocation unit from its IAM
+    // chain instead of filtering every page of the backup
+    std::vector<PageId> allocated;
+    for (const auto& au : catalog_->get_allocation_units(schema_.object_id)) {
+        if (au.type != 1) continue;   // IN_ROW_DATA
+        auto pages = catalog_->get_allocated_pages(au);
+        allocated.insert(allocated.end(), pages.begin(), pages.end());
+    }
+
+    if (!allocated.empty()) {
+        // IAM pages map whole extents; keep only present data pages of the
+        // table (index pages and other allocation units fall out here)
+        for (const PageId& p : allocated) {
+            int64_t key = page_key(p.file_id, p.page_id);
+            if (indexed_store_) {
+                PageIndexEntry entry;
+                if (!indexed_store_->index().lookup(p.file_id, p.page_id, entry)) continue;
+                consider(key, entry.page_type, 1, entry.object_id);
+            } else {
+                PageMeta m;
+                if (!page_store_->meta(key, m)) continue;
+                consider(key, m.page_type, m.slot_count, m.obj_id);
+            }
+        }
+        LOG_INFO("IAM chain allocates %zu pages to %s; %zu are data pages in the backup",
+                 allocated.size(), schema_.qualified_name().c_str(), candidate_pages.size());
+    } else if (indexed_store_) {
+        // The index records obj_id per page; type and slot count are
+        // re-checked on the page itself when decoding
+        for (int64_t key : indexed_store_->index().get_pages_by_object(target_page_objid)) {
+            consider(key, static_cast<uint8_t>(PageType::Data), 1, target_page_objid);
+        }
+    } else {
+        // Filter on header metadata recorded at load time; no page is touched
+        page_store_->for_each([&](int64_t key, const PageMeta& m) {
+            consider(key, m.page_type, m.slot_count, m.obj_id);
+        });
+    }
+
+    if (indexed_store_) {
+        // Read in stripe order, so a cold extraction is a forward sweep
+        indexed_store_->index().sort_by_location(candidate_pages);
+    } else {
+        // Hash order is arbitrary; walk pages in (file, page) order instead
+        std::sort(candidate_pages.begin(), candidate_pages.end());
     }
 
     if (!allocation_hints_.empty()) {
@@ -473,33 +886,339 @@ uint64_t DirectExtractor::phase_extract_rows(RowCallback& callback) {
     }
     LOG_INFO("Scanning %zu candidate data pages...", candidate_pages.size());
 
-    for (auto key : candidate_pages) {
-        auto& page_data = page_cache_[key];
-        std::vector<Row> rows;
+    return candidate_pages;
+}
 
-        int decoded = decoder.decode_page(page_data.data(), rows);
-        if (decoded <= 0) continue;
+uint64_t DirectExtractor::phase_extract_rows(RowCallback& callback) {
+    LOG_INFO("Phase 4: Extracting rows...");
 
-        for (auto& row : rows) {
-            if (max_rows_ >= 0 && total_rows >= static_cast<uint64_t>(max_rows_))
-                break;
+    RunStats::Timer timer(stats_, "decode");
+    std::vector<int64_t> candidate_pages = collect_candidate_pages();
+    if (candidate_pages.empty()) return 0;
+
+    uint64_t total_rows = 0;
+    uint64_t next_progress = 10000;
+
+    run_decode_pool<std::vector<Row>>(candidate_pages,
+        [&](const RowDecoder& decoder, size_t first, size_t last, std::vector<Row>& rows) {
+            rows.clear();
+            for (size_t i = first; i < last; ++i) {
+                int32_t fid = 0, pid = 0;
+                split_page_key(candidate_pages[i], fid, pid);
+                uint8_t page_buf[PAGE_SIZE];
+                const uint8_t* page = fetch_data_page(fid, pid, page_buf);
+                if (page) decoder.decode_page(page, rows);
+            }
+        },
+        [&](std::vector<Row>& rows) {
+            for (auto& row : rows) {
+                if (max_rows_ >= 0 && total_rows >= static_cast<uint64_t>(max_rows_))
+                    return false;
+                if (!callback(row)) return false;
+                ++total_rows;
+            }
+
+            // Progress reporting
+            if (progress_cb_ && total_rows >= next_progress) {
+                Progress p;
+                p.rows_exported = total_rows;
+                progress_cb_(p);
+                next_progress = total_rows + 10000;
+            }
+            return !(max_rows_ >= 0 && total_rows >= static_cast<uint64_t>(max_rows_));
+        });
+
+    timer.add_rows(total_rows);
+    timer.add_pages(candidate_pages.size());
+    timer.add_bytes(candidate_pages.size() * PAGE_SIZE);
+    return total_rows;
+}
+
+uint64_t DirectExtractor::phase_extract_columns(ColumnBatchCallback& callback,
+                                                ColumnLayout layout) {
+    LOG_INFO("Phase 4: Extracting rows (columnar)...");
+
+    RunStats::Timer timer(stats_, "decode");
+    std::vector<int64_t> candidate_pages = collect_candidate_pages();
+    if (candidate_pages.empty()) return 0;
+
+    uint64_t total_rows = 0;
+    uint64_t next_progress = 10000;
 
-            if (!callback(row)) break;
-            ++total_rows;
+    run_decode_pool<ColumnBatch>(candidate_pages,
+        [&](const RowDecoder& decoder, size_t first, size_t last, ColumnBatch& batch) {
+            if (batch.num_columns() != schema_.columns.size() || batch.layout() != layout) {
+                batch.reset(schema_, layout);
+            }
+            batch.clear();
+            for (size_t i = first; i < last; ++i) {
+                int32_t fid = 0, pid = 0;
+                split_page_key(candidate_pages[i], fid, pid);
+                uint8_t page_buf[PAGE_SIZE];
+                const uint8_t* page = fetch_data_page(fid, pid, page_buf);
+                if (page) decoder.decode_page_columnar(page, batch);
+            }
+        },
+        [&](ColumnBatch& batch) {
+            if (max_rows_ >= 0) {
+                uint64_t room = static_cast<uint64_t>(max_rows_) - total_rows;
+                if (batch.num_rows() > room) batch.truncate(static_cast<size_t>(room));
+            }
+            if (batch.num_rows() > 0) {
+                if (!callback(batch)) return false;
+                total_rows += batch.num_rows();
+            }
+
+            if (progress_cb_ && total_rows >= next_progress) {
+                Progress p;
+                p.rows_exported = total_rows;
+                progress_cb_(p);
+                next_progress = total_rows + 10000;
+            }
+            return !(max_rows_ >= 0 && total_rows >= static_cast<uint64_t>(max_rows_));
+        });
+
+    timer.add_rows(total_rows);
+    timer.add_pages(candidate_pages.size());
+    timer.add_bytes(candidate_pages.size() * PAGE_SIZE);
+    return total_rows;
+}
+
+void DirectExtractor::estimate_table_size(TableInfo& info) const {
+    if (!indexed_store_ || !indexed_store_->is_indexed()) return;
+
+    uint32_t data_objid = catalog_->get_page_obj_id(info.object_id);
+    if (data_objid == 0) return;
+
+    // Page counts are the index's per-object ranges; rows are the slot
+    // counts summed over data page headers while the index was built
+    const PageIndex& index = indexed_store_->index();
+    size_t pages = index.count_pages_by_object(data_objid);
+    for (uint32_t objid : catalog_->get_lob_page_obj_ids(info.object_id)) {
+        pages += index.count_pages_by_object(objid);
+    }
+    info.page_count = static_cast<int64_t>(pages);
+
+    ObjectRowStats stats;
+    if (index.row_stats(data_objid, stats)) {
+        info.row_count = static_cast<int64_t>(stats.slot_count);
+    }
+}
+
+bool DirectExtractor::projects_var_columns() const {
+    for (const auto& col : schema_.columns) {
+        if (!is_fixed_length(col.type) || is_lob(col.type)) return true;
+    }
+    return false;
+}
+
+int DirectExtractor::decode_worker_count(size_t candidate_count) const {
+    int workers = config_.decode_workers;
+    if (workers <= 0) {
+        workers = static_cast<int>(std::thread::hardware_concurrency());
+        if (workers <= 0) workers = 1;
+    }
+    // Not worth spinning up threads for a handful of pages
+    size_t max_useful = (candidate_count + DECODE_BATCH_PAGES - 1) / DECODE_BATCH_PAGES;
+    if (static_cast<size_t>(workers) > max_useful) workers = static_cast<int>(max_useful);
+    return std::max(workers, 1);
+}
+
+const uint8_t* DirectExtractor::fetch_page(int32_t file_id, int32_t page_id,
+                                           uint8_t* scratch) {
+    const uint8_t* page = provide_page_view(file_id, page_id);
+    if (page) return page;
+
+    // Scan pages are read once (and LOB pages are cached by the LobReader);
+    // keep them from flushing catalog pages
+    bool ok = indexed_store_
+        ? indexed_store_->get_page(file_id, page_id, scratch, PageAccess::ReadOnce)
+        : provide_page(file_id, page_id, scratch);
+    return ok ? scratch : nullptr;
+}
+
+const uint8_t* DirectExtractor::fetch_data_page(int32_t file_id, int32_t page_id,
+                                                uint8_t* scratch) {
+    const uint8_t* page = fetch_page(file_id, page_id, scratch);
+    if (!page) return nullptr;
+
+    PageHeader hdr;
+    std::memcpy(&hdr, page, sizeof(hdr));
+    if (hdr.type != static_cast<uint8_t>(PageType::Data) || hdr.slot_count == 0)
+        return nullptr;
+    return page;
+}
+
+template <typename Batch, typename DecodeFn, typename EmitFn>
+void DirectExtractor::run_decode_pool(const std::vector<int64_t>& pages,
+                                      DecodeFn decode, EmitFn emit) {
+    // Pages are decoded in DECODE_BATCH_PAGES units. decode(decoder, first,
+    // last, batch) fills a batch; emit(batch) hands it to the consumer on
+    // the calling thread and returns false to stop.
+    const size_t batch_count = (pages.size() + DECODE_BATCH_PAGES - 1) / DECODE_BATCH_PAGES;
+    const int workers = decode_worker_count(pages.size());
+
+    if (workers <= 1) {
+        RowDecoder decoder(physical_schema_, projection_, filter_.get());
+        decoder.set_lob_reader(lob_reader_.get());
+        Batch batch;
+        for (size_t b = 0; b < batch_count; ++b) {
+            size_t first = b * DECODE_BATCH_PAGES;
+            decode(decoder, first, std::min(first + DECODE_BATCH_PAGES, pages.size()), batch);
+            if (!emit(batch)) break;
+        }
+        return;
+    }
+
+    LOG_INFO("Decoding with %d worker threads (%s page order)",
+             workers, config_.preserve_order ? "preserving" : "ignoring");
+
+    // Batches are claimed from a shared cursor, so a worker that finishes
+    // early simply takes the next one. At most `window` batches are in
+    // flight, which bounds memory when the consumer (the export writer) is
+    // slower than decoding. Consumed batches go back to a free list.
+    const size_t window = static_cast<size_t>(workers) * 4;
+    const bool ordered = config_.preserve_order;
+
+    struct Slot {
+        Batch  data;
+        size_t batch = 0;
+        bool   ready = false;
+    };
+    std::vector<Slot> slots(window);          // ordered: slot = batch % window
+    std::deque<Batch> completed;              // unordered: finish order
+    std::vector<Batch> spare;                 // recycled batch storage
+
+    std::mutex mu;
+    std::condition_variable cv_ready;
+    std::condition_variable cv_space;
+    size_t next_batch = 0;   // next batch to claim
+    size_t consumed   = 0;   // batches handed to the consumer
+    bool   stop       = false;
+    std::exception_ptr error;
+
+    // Telemetry: decoded batches not yet consumed, and time either side
+    // spent blocked (workers summed)
+    QueueStats qstats;
+    qstats.capacity = window;
+    size_t ready_count = 0;
+    auto blocked_since = [](std::chrono::steady_clock::time_point t0) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+
+    auto worker = [&]() {
+        RowDecoder decoder(physical_schema_, projection_, filter_.get());
+        decoder.set_lob_reader(lob_reader_.get());
+        try {
+            while (true) {
+                size_t b;
+                Batch data;
+                {
+                    std::unique_lock<std::mutex> lock(mu);
+                    auto can_claim = [&] {
+                        return stop || next_batch >= batch_count ||
+                               next_batch < consumed + window;
+                    };
+                    if (!can_claim()) {
+                        auto t0 = std::chrono::steady_clock::now();
+                        cv_space.wait(lock, can_claim);
+                        qstats.producer_wait_seconds += blocked_since(t0);
+                    }
+                    if (stop || next_batch >= batch_count) return;
+                    b = next_batch++;
+                    if (!spare.empty()) {
+                        data = std::move(spare.back());
+                        spare.pop_back();
+                    }
+                }
+
+                size_t first = b * DECODE_BATCH_PAGES;
+                decode(decoder, first, std::min(first + DECODE_BATCH_PAGES, pages.size()), data);
+
+                {
+                    std::lock_guard<std::mutex> lock(mu);
+                    if (ordered) {
+                        Slot& slot = slots[b % window];
+                        slot.data  = std::move(data);
+                        slot.batch = b;
+                        slot.ready = true;
+                    } else {
+                        completed.push_back(std::move(data));
+                    }
+                    qstats.high_water = std::max(qstats.high_water, ++ready_count);
+                }
+                cv_ready.notify_all();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mu);
+            if (!error) error = std::current_exception();
+            stop = true;
+            cv_ready.notify_all();
+            cv_space.notify_all();
         }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (int i = 0; i < workers; ++i) threads.emplace_back(worker);
 
-        if (max_rows_ >= 0 && total_rows >= static_cast<uint64_t>(max_rows_))
-            break;
+    // The sink may throw (a writer failing to open its output): the workers
+    // are still stopped and joined before the exception leaves
+    std::exception_ptr sink_error;
+    try {
+        while (consumed < batch_count) {
+            Batch data;
+            {
+                std::unique_lock<std::mutex> lock(mu);
+                Slot& slot = slots[consumed % window];
+                auto can_take = [&] {
+                    return stop || (ordered ? slot.ready && slot.batch == consumed
+                                            : !completed.empty());
+                };
+                if (!can_take()) {
+                    auto t0 = std::chrono::steady_clock::now();
+                    cv_ready.wait(lock, can_take);
+                    qstats.consumer_wait_seconds += blocked_since(t0);
+                }
+                if (stop) break;
+                if (ordered) {
+                    data = std::move(slot.data);
+                    slot.ready = false;
+                } else {
+                    data = std::move(completed.front());
+                    completed.pop_front();
+                }
+                --ready_count;
+                ++consumed;
+            }
+            cv_space.notify_all();
 
-        // Progress reporting
-        if (progress_cb_ && total_rows % 10000 == 0) {
-            Progress p;
-            p.rows_exported = total_rows;
-            progress_cb_(p);
+            bool keep_going = emit(data);
+
+            {
+                std::lock_guard<std::mutex> lock(mu);
+                spare.push_back(std::move(data));
+            }
+            if (!keep_going) break;
         }
+    } catch (...) {
+        sink_error = std::current_exception();
     }
 
-    return total_rows;
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        stop = true;
+    }
+    cv_space.notify_all();
+    cv_ready.notify_all();
+    for (auto& t : threads) t.join();
+
+    if (stats_) {
+        qstats.batches = consumed;
+        stats_->add_queue("decode", qstats);
+    }
+    if (sink_error) std::rethrow_exception(sink_error);
+    if (error) std::rethrow_exception(error);
 }
 
 bool DirectExtractor::provide_page(int32_t file_id, int32_t page_id, uint8_t* buf) {
@@ -508,23 +1227,125 @@ bool DirectExtractor::provide_page(int32_t file_id, int32_t page_id, uint8_t* bu
         return indexed_store_->get_page(file_id, page_id, buf);
     }
 
-    // Fall back to in-memory cache
-    auto it = page_cache_.find(page_key(file_id, page_id));
-    if (it == page_cache_.end()) return false;
+    return page_store_->get(page_key(file_id, page_id), buf);
+}
 
-    std::memcpy(buf, it->second.data(), PAGE_SIZE);
-    return true;
+const uint8_t* DirectExtractor::provide_page_view(int32_t file_id, int32_t page_id) {
+    if (indexed_store_) {
+        return indexed_store_->get_page_view(file_id, page_id);
+    }
+
+    return page_store_->view(page_key(file_id, page_id));
+}
+
+void DirectExtractor::report_store_stats() {
+    if (!stats_) return;
+    if (lob_reader_) {
+        stats_->set_cache("lob_cache", lob_reader_->cache_hits(), lob_reader_->cache_misses());
+    }
+    if (indexed_store_) {
+        stats_->set_cache("page_cache", indexed_store_->cache_hits(),
+                          indexed_store_->cache_misses());
+        const CompressedBlockCache& blocks = indexed_store_->block_cache();
+        if (blocks.hits() + blocks.misses() > 0) {
+            stats_->set_cache("block_cache", blocks.hits(), blocks.misses());
+        }
+        return;
+    }
+    PageStoreStats ps;
+    ps.pages            = page_store_->size();
+    ps.resident_pages   = page_store_->resident_pages();
+    ps.referenced_pages = page_store_->referenced_pages();
+    ps.spilled_pages    = page_store_->spilled_pages();
+    ps.memory_bytes     = page_store_->memory_usage_bytes();
+    stats_->set_page_store(ps);
+}
+
+std::unique_ptr<CatalogReader> DirectExtractor::make_catalog_reader() {
+    return std::make_unique<CatalogReader>(
+        [this](int32_t fid, int32_t pid, uint8_t* buf) {
+            return this->provide_page(fid, pid, buf);
+        },
+        [this](int32_t fid, int32_t pid) {
+            return this->provide_page_view(fid, pid);
+        },
+        [this](int32_t fid, int32_t pid, PageMeta& meta) {
+            // Header fields from the index / store, so the catalog sweep
+            // only fetches catalog pages
+            if (indexed_store_) {
+                PageIndexEntry entry;
+                if (!indexed_store_->index().lookup(fid, pid, entry)) return false;
+                meta.obj_id     = entry.object_id;
+                meta.page_type  = entry.page_type;   // Data and IAM share PageType's values
+                meta.slot_count = 1;                 // Not indexed
+                return true;
+            }
+            return page_store_->meta(page_key(fid, pid), meta);
+        });
+}
+
+std::string DirectExtractor::catalog_cache_path() const {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+
+    // Same place as the page index (IndexedPageStore::index_file_path)
+    if (!config_.index_dir.empty()) {
+        fs::path dir(config_.index_dir);
+        fs::create_directories(dir, ec);
+        return (dir / "bakread_catalog.cat").string();
+    }
+
+    fs::path bak_path(bak_paths_[0]);
+    return (bak_path.parent_path() / (bak_path.stem().string() + "_bakread.cat")).string();
+}
+
+uint64_t DirectExtractor::backup_identity() const {
+    namespace fs = std::filesystem;
+
+    // FNV-1a over everything that changes when the backup file is replaced
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const void* data, size_t len) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < len; ++i) h = (h ^ p[i]) * 1099511628211ull;
+    };
+    auto mix_u64 = [&mix](uint64_t v) { mix(&v, sizeof(v)); };
+
+    for (const auto& src : sources_) {
+        std::error_code ec;
+        mix_u64(static_cast<uint64_t>(fs::file_size(src.path, ec)));
+        auto mtime = fs::last_write_time(src.path, ec);
+        mix_u64(ec ? 0 : static_cast<uint64_t>(mtime.time_since_epoch().count()));
+    }
+
+    if (header_parser_) {
+        mix_u64(header_parser_->data_start_offset());
+        if (!header_parser_->backup_sets().empty()) {
+            const BackupSetInfo& set = header_parser_->backup_sets()[0];
+            mix(set.database_name.data(), set.database_name.size());
+            mix(set.backup_start_date.data(), set.backup_start_date.size());
+        }
+    }
+    return h;
 }
 
 void DirectExtractor::cache_page(int32_t file_id, int32_t page_id,
-                                  const uint8_t* data) {
+                                  const uint8_t* data,
+                                  int stripe_index, uint64_t file_offset) {
     // In indexed mode, pages are managed by IndexedPageStore
     if (indexed_store_) return;
 
-    auto key = page_key(file_id, page_id);
-    if (page_cache_.find(key) != page_cache_.end()) return;
+    PageLocation loc;
+    loc.stripe_index = stripe_index;
+    loc.file_offset  = file_offset;
+    const int64_t key = page_key(file_id, page_id);
+    if (config_.diff_paths.empty()) {
+        page_store_->put(key, data, loc);  // first copy wins
+        return;
+    }
 
-    page_cache_[key].assign(data, data + PAGE_SIZE);
+    // Differential overlay: the copy with the newest page LSN wins
+    const bool had = page_store_->contains(key);
+    if (page_store_->put_newest(key, data, loc) && had) ++overlay_replaced_;
 }
 
 std::vector<SystemModule> DirectExtractor::list_modules() {
@@ -4,24 +4,48 @@
 #include "bakread/error.h"
 #include "bakread/logging.h"
 #include "bakread/page.h"
+#include "bakread/page_scan.h"
+#include "bakread/read_ahead.h"
 
 #include <algorithm>
 #include <chrono>
 #include <cstring>
+#include <exception>
 #include <filesystem>
 
 namespace bakread {
 
 namespace fs = std::filesystem;
 
+// Count a data page and its header slot_count towards its object
+static void count_data_page(std::unordered_map<uint32_t, ObjectRowStats>& stats,
+                            const PageHeader& hdr) {
+    if (hdr.type != static_cast<uint8_t>(PageType::Data)) return;
+    ObjectRowStats& s = stats.try_emplace(hdr.obj_id, ObjectRowStats{hdr.obj_id, 0, 0})
+                             .first->second;
+    s.data_pages++;
+    s.slot_count += hdr.slot_count;
+}
+
+static std::vector<ObjectRowStats> take_row_stats(
+        std::unordered_map<uint32_t, ObjectRowStats>& stats) {
+    std::vector<ObjectRowStats> out;
+    out.reserve(stats.size());
+    for (const auto& [obj_id, s] : stats) out.push_back(s);
+    stats.clear();
+    return out;
+}
+
 IndexedPageStore::IndexedPageStore(const std::vector<std::string>& bak_paths,
                                    const IndexedStoreConfig& config)
     : bak_paths_(bak_paths)
     , config_(config)
     , cache_(config.cache_pages)
     , stripe_mutexes_(bak_paths.size())
+    , block_cache_(config.block_cache_bytes)
 {
     stripe_files_.resize(bak_paths.size());
+    mapped_stripes_.resize(bak_paths.size());
 
     // Auto-detect thread count
     if (config_.num_threads == 0) {
@@ -54,26 +78,33 @@ std::string IndexedPageStore::index_file_path() const {
     return index_path.string();
 }
 
+void IndexedPageStore::open_mappings() {
+    if (!config_.use_mmap) return;
+
+    size_t mapped = 0;
+    for (size_t i = 0; i < bak_paths_.size(); ++i) {
+        if (mapped_stripes_[i]) { ++mapped; continue; }
+        try {
+            mapped_stripes_[i] = std::make_unique<MappedStripe>(bak_paths_[i]);
+            ++mapped;
+        } catch (const FileIOError& e) {
+            LOG_WARN("Stripe %zu not memory-mapped, using buffered reads: %s",
+                     i, e.what());
+        }
+    }
+    LOG_DEBUG("Memory-mapped %zu of %zu stripe(s)", mapped, bak_paths_.size());
+}
+
 bool IndexedPageStore::scan(ScanProgressCallback progress) {
     if (indexed_.load()) {
         LOG_DEBUG("Index already built, skipping scan");
         return true;
     }
 
-    // Try to load existing index
-    if (!config_.force_rescan) {
-        std::string idx_path = index_file_path();
-        if (index_.load_from_file(idx_path)) {
-            LOG_INFO("Loaded existing index from %s", idx_path.c_str());
-            indexed_.store(true);
-            return true;
-        }
-    }
-
-    LOG_INFO("Starting parallel scan of %zu stripe(s)...", bak_paths_.size());
-    auto start_time = std::chrono::steady_clock::now();
+    open_mappings();
 
-    // First, parse header from first stripe to get data start offset
+    // Parse the header from the first stripe first: compression decides how
+    // both a cached index and a fresh scan address pages
     {
         BackupStream stream(bak_paths_[0]);
         BackupHeaderParser parser(stream);
@@ -91,33 +122,110 @@ bool IndexedPageStore::scan(ScanProgressCallback progress) {
     }
 
     if (is_compressed_) {
-        decompressor_ = std::make_unique<Decompressor>();
+        compressed_stripes_.resize(bak_paths_.size());
+        for (size_t i = 0; i < bak_paths_.size(); ++i) {
+            try {
+                compressed_stripes_[i] = std::make_unique<CompressedStripe>(
+                    bak_paths_[i], mapped_stripes_[i].get());
+            } catch (const FileIOError& e) {
+                LOG_ERROR("Failed to open stripe %zu: %s", i, e.what());
+            }
+        }
     }
 
-    // Launch parallel scan threads
-    size_t stripes_per_thread = (bak_paths_.size() + config_.num_threads - 1) / config_.num_threads;
-    
-    // For striped backups, one thread per stripe is most efficient
-    size_t actual_threads = std::min(config_.num_threads, bak_paths_.size());
-    
-    std::atomic<int> completed_stripes{0};
-    std::vector<std::thread> threads;
-    threads.reserve(actual_threads);
-
-    for (size_t t = 0; t < actual_threads; ++t) {
-        threads.emplace_back([this, t, actual_threads, &progress, &completed_stripes]() {
-            for (size_t s = t; s < bak_paths_.size(); s += actual_threads) {
-                scan_stripe(static_cast<int>(s), progress);
-                ++completed_stripes;
-            }
-        });
+    // Try to load existing index
+    if (!config_.force_rescan) {
+        std::string idx_path = index_file_path();
+        if (index_.load_from_file(idx_path)) {
+            LOG_INFO("Loaded existing index from %s", idx_path.c_str());
+            size_block_cache();
+            indexed_.store(true);
+            return true;
+        }
+    }
+
+    LOG_INFO("Starting parallel scan of %zu stripe(s)...", bak_paths_.size());
+    auto start_time = std::chrono::steady_clock::now();
+
+    // First exception from a scan thread, rethrown once all have joined
+    std::exception_ptr scan_error;
+    std::mutex error_mutex;
+    auto record_error = [&] {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!scan_error) scan_error = std::current_exception();
+    };
+
+    if (is_compressed_) {
+        // Block chains are walked front to back, so parallelism comes from
+        // decompressing many blocks at once rather than from byte ranges
+        size_t per_stripe = std::max<size_t>(1, config_.num_threads / bak_paths_.size());
+        LOG_INFO("Scanning %zu compressed stripe(s), %zu decompression thread(s) each",
+                 bak_paths_.size(), per_stripe);
+
+        std::vector<std::thread> threads;
+        threads.reserve(bak_paths_.size());
+        for (size_t s = 0; s < bak_paths_.size(); ++s) {
+            threads.emplace_back([this, s, per_stripe, &progress, &record_error]() {
+                try {
+                    scan_compressed(static_cast<int>(s), per_stripe, progress);
+                } catch (...) {
+                    record_error();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    } else {
+        // Split every stripe into aligned ranges and let threads pull them
+        std::vector<ScanRange> ranges = plan_ranges();
+        size_t actual_threads = std::max<size_t>(1, std::min(config_.num_threads, ranges.size()));
+
+        LOG_INFO("Scanning %zu stripe(s) as %zu range(s) on %zu thread(s)",
+                 bak_paths_.size(), ranges.size(), actual_threads);
+
+        std::atomic<size_t> next_range{0};
+        std::vector<std::thread> threads;
+        threads.reserve(actual_threads);
+
+        for (size_t t = 0; t < actual_threads; ++t) {
+            threads.emplace_back([this, &ranges, &next_range, &progress, &record_error]() {
+                // Thread-local shard: no shared state touched per page
+                std::vector<PageIndexRecord> shard;
+                RowStatsShard row_stats;
+                try {
+                    for (size_t r = next_range.fetch_add(1); r < ranges.size();
+                         r = next_range.fetch_add(1)) {
+                        scan_range(ranges[r], shard, row_stats, progress);
+                    }
+                } catch (...) {
+                    record_error();
+                    next_range.store(ranges.size());   // Other threads stop after their range
+                    return;
+                }
+                index_.add_shard(std::move(shard));
+                index_.add_row_stats(take_row_stats(row_stats));
+            });
+        }
+
+        // Wait for all threads
+        for (auto& thread : threads) {
+            thread.join();
+        }
     }
 
-    // Wait for all threads
-    for (auto& thread : threads) {
-        thread.join();
+    // Nothing is sealed or saved from an incomplete scan
+    if (scan_error) std::rethrow_exception(scan_error);
+
+    for (auto& map : mapped_stripes_) {
+        // Extraction after the scan is point lookups
+        if (map) map->advise(MappedStripe::Access::Random);
     }
 
+    // Freeze into sorted arrays: lock-free lookups from here on
+    index_.seal();
+    size_block_cache();
+
     auto end_time = std::chrono::steady_clock::now();
     auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
 
@@ -139,103 +247,257 @@ bool IndexedPageStore::scan(ScanProgressCallback progress) {
     return true;
 }
 
-void IndexedPageStore::scan_stripe(int stripe_index, ScanProgressCallback progress) {
-    const std::string& path = bak_paths_[stripe_index];
-    LOG_INFO("Scanning stripe %d: %s", stripe_index, path.c_str());
+std::vector<IndexedPageStore::ScanRange> IndexedPageStore::plan_ranges() {
+    // Ranges start on the same chunk grid a whole-stripe scan would use
+    const uint64_t chunk = std::max<uint64_t>(PAGE_SIZE, config_.scan_chunk_size / PAGE_SIZE * PAGE_SIZE);
+    const uint64_t range_bytes = std::max<uint64_t>(
+        chunk, (config_.scan_range_bytes + chunk - 1) / chunk * chunk);
+
+    uint64_t start = data_start_offset_;
+    start = (start + PAGE_SIZE - 1) & ~(static_cast<uint64_t>(PAGE_SIZE) - 1);
+    if (start == 0) start = PAGE_SIZE;
+
+    std::vector<std::vector<ScanRange>> per_stripe(bak_paths_.size());
+    for (size_t s = 0; s < bak_paths_.size(); ++s) {
+        uint64_t file_size = 0;
+        if (const MappedStripe* map = mapped_stripes_[s].get()) {
+            map->advise(MappedStripe::Access::Sequential);
+            file_size = map->size();
+        } else {
+            std::error_code ec;
+            file_size = fs::file_size(bak_paths_[s], ec);
+            if (ec) {
+                LOG_ERROR("Failed to open stripe %zu: %s", s, bak_paths_[s].c_str());
+                continue;
+            }
+        }
 
-    std::ifstream file(path, std::ios::binary);
-    if (!file.is_open()) {
-        LOG_ERROR("Failed to open stripe %d: %s", stripe_index, path.c_str());
-        return;
+        for (uint64_t begin = start; begin < file_size; begin += range_bytes) {
+            per_stripe[s].push_back({static_cast<int>(s), begin,
+                                     std::min(file_size, begin + range_bytes)});
+        }
+        LOG_DEBUG("Stripe %zu: %s, %zu range(s)", s, bak_paths_[s].c_str(), per_stripe[s].size());
     }
 
-    // Get file size
-    file.seekg(0, std::ios::end);
-    uint64_t file_size = file.tellg();
+    // Interleave stripes so concurrent threads spread across files (and disks)
+    std::vector<ScanRange> ranges;
+    for (size_t i = 0;; ++i) {
+        bool any = false;
+        for (auto& stripe : per_stripe) {
+            if (i < stripe.size()) { ranges.push_back(stripe[i]); any = true; }
+        }
+        if (!any) break;
+    }
+    return ranges;
+}
 
-    // Start after MTF header (use data_start_offset from first stripe as approximation)
-    uint64_t offset = data_start_offset_;
-    offset = (offset + PAGE_SIZE - 1) & ~(static_cast<uint64_t>(PAGE_SIZE) - 1);
-    if (offset == 0) offset = PAGE_SIZE;
+void IndexedPageStore::scan_range(const ScanRange& range, std::vector<PageIndexRecord>& shard,
+                                  RowStatsShard& row_stats, ScanProgressCallback& progress) {
+    const int stripe_index = range.stripe_index;
+    const std::string& path = bak_paths_[stripe_index];
 
-    file.seekg(static_cast<std::streamoff>(offset));
+    // Mapped stripes are scanned in place; others through a ReadAhead ring.
+    // Direct I/O always takes the ring so the scan bypasses the page cache.
+    const MappedStripe* map = config_.direct_io ? nullptr : mapped_stripes_[stripe_index].get();
 
-    // Read buffer for chunk scanning
     const size_t chunk_size = config_.scan_chunk_size;
-    const size_t pages_per_chunk = chunk_size / PAGE_SIZE;
-    std::vector<uint8_t> chunk_buffer(chunk_size);
-    std::vector<uint8_t> decomp_buffer;
-    
-    if (is_compressed_) {
-        decomp_buffer.resize(chunk_size * 4);  // Decompressed can be larger
+
+    shard.reserve(shard.size() + (range.end - range.begin) / PAGE_SIZE);
+    uint64_t range_pages = 0;
+
+    // Classify the pages of one chunk that starts at stripe offset `offset`:
+    // all headers are validated in one batch, then the plausible ones indexed
+    std::vector<uint64_t> header_mask;
+    auto process_chunk = [&](const uint8_t* page_data, size_t bytes_read, uint64_t offset) {
+        const size_t tested = classify_page_headers(page_data, bytes_read, PAGE_SIZE, header_mask);
+        const uint64_t pages_before = range_pages;
+        for_each_set_bit(header_mask, [&](size_t i) {
+            const uint8_t* page_ptr = page_data + i * PAGE_SIZE;
+            const auto* hdr = reinterpret_cast<const PageHeader*>(page_ptr);
+
+            uint32_t obj_id = 0;
+            IndexedPageType page_type = classify_page(page_ptr, obj_id);
+
+            PageIndexRecord rec{};
+            rec.key = make_page_key(static_cast<int32_t>(hdr->this_file),
+                                    static_cast<int32_t>(hdr->this_page));
+            rec.entry.stripe_index = static_cast<uint8_t>(stripe_index);
+            rec.entry.page_type = static_cast<uint8_t>(page_type);
+            rec.entry.object_id = obj_id;
+            rec.entry.file_offset = offset + i * PAGE_SIZE;
+            shard.push_back(rec);
+            count_data_page(row_stats, *hdr);
+            ++range_pages;
+        });
+
+        pages_scanned_.fetch_add(tested);
+        pages_valid_.fetch_add(range_pages - pages_before);
+        bytes_read_.fetch_add(bytes_read);
+
+        if (progress) {
+            progress(pages_scanned_.load(), bytes_read_.load(), stripe_index);
+        }
+    };
+
+    // Read-ahead blocks are whole chunks, so chunk boundaries are the same
+    // as a plain chunked read
+    const size_t block = std::max(chunk_size, config_.readahead_bytes / chunk_size * chunk_size);
+    const uint64_t window = std::max<size_t>(1, config_.readahead_depth) * block;
+
+    if (map) {
+        map->prefetch(range.begin, static_cast<size_t>(window));
+        for (uint64_t offset = range.begin; offset < range.end; offset += chunk_size) {
+            if ((offset - range.begin) % block == 0) map->prefetch(offset + window, block);
+            size_t n = static_cast<size_t>(std::min<uint64_t>(chunk_size, range.end - offset));
+            process_chunk(map->data() + offset, n, offset);
+        }
+    } else {
+        bool read_failed = false;
+        try {
+            ReadAheadConfig ra_config;
+            ra_config.depth       = config_.readahead_depth;
+            ra_config.buffer_size = block;
+            ra_config.unbuffered  = config_.direct_io;
+            ReadAhead reader(path, range.begin, range.end, ra_config);
+
+            const uint8_t* data = nullptr;
+            size_t len = 0;
+            uint64_t base = 0;
+            while (reader.next(data, len, base)) {
+                for (size_t off = 0; off < len; off += chunk_size) {
+                    process_chunk(data + off, std::min(chunk_size, len - off), base + off);
+                }
+            }
+            read_failed = reader.failed();
+        } catch (const FileIOError& e) {
+            LOG_ERROR("Failed to open stripe %d: %s", stripe_index, e.what());
+            return;
+        }
+
+        // A short index would be saved and reused as if complete
+        if (read_failed) {
+            throw FileIOError("Read error in " + path + " while indexing [" +
+                              std::to_string(range.begin) + ", " +
+                              std::to_string(range.end) + ")");
+        }
     }
 
+    LOG_DEBUG("Stripe %d range [%llu, %llu): %llu pages",
+              stripe_index, (unsigned long long)range.begin,
+              (unsigned long long)range.end, (unsigned long long)range_pages);
+}
+
+void IndexedPageStore::scan_compressed(int stripe_index, size_t threads,
+                                       ScanProgressCallback& progress) {
+    CompressedStripe* stripe = compressed_stripes_[stripe_index].get();
+    if (!stripe) return;
+
+    if (const MappedStripe* map = mapped_stripes_[stripe_index].get()) {
+        map->advise(MappedStripe::Access::Sequential);
+    }
+
+    std::vector<PageIndexRecord> shard;
+    std::vector<CompressedBlockRange> blocks;
+    RowStatsShard row_stats;
     uint64_t stripe_pages = 0;
-    uint64_t stripe_bytes = 0;
-
-    while (offset < file_size) {
-        // Read chunk
-        size_t to_read = std::min(chunk_size, static_cast<size_t>(file_size - offset));
-        file.read(reinterpret_cast<char*>(chunk_buffer.data()), static_cast<std::streamsize>(to_read));
-        size_t bytes_read = static_cast<size_t>(file.gcount());
-
-        if (bytes_read == 0) break;
-
-        const uint8_t* page_data = chunk_buffer.data();
-        size_t available = bytes_read;
-
-        // Handle decompression if needed
-        if (is_compressed_ && decompressor_) {
-            size_t decomp_size = decompressor_->decompress_into(
-                chunk_buffer.data(), bytes_read,
-                decomp_buffer.data(), decomp_buffer.size());
-            if (decomp_size > 0) {
-                page_data = decomp_buffer.data();
-                available = decomp_size;
-            }
+    uint64_t skipped = 0;
+
+    auto on_block = [&](uint64_t block_offset, uint32_t stored_size, uint32_t uncompressed_size) {
+        CompressedBlockRange blk{};
+        blk.stripe_index = static_cast<uint8_t>(stripe_index);
+        blk.block_offset = block_offset;
+        blk.stored_size = stored_size;
+        blk.uncompressed_size = uncompressed_size;
+        blk.first_key = INT64_MAX;
+        blk.last_key = INT64_MIN;
+        blocks.push_back(blk);
+        if (progress) progress(pages_scanned_.load(), bytes_read_.load(), stripe_index);
+    };
+
+    // A page that straddles two blocks arrives after the second block was
+    // announced, so it belongs to the one before the last
+    auto block_of = [&](uint64_t block_offset) -> CompressedBlockRange* {
+        for (size_t n = 0; n < 2 && n < blocks.size(); ++n) {
+            CompressedBlockRange& blk = blocks[blocks.size() - 1 - n];
+            if (blk.block_offset == block_offset) return &blk;
         }
+        return nullptr;
+    };
 
-        // Process pages in chunk
-        size_t page_offset = 0;
-        while (page_offset + PAGE_SIZE <= available) {
-            const uint8_t* page_ptr = page_data + page_offset;
+    size_t decoded = stripe->scan_pages(data_start_offset_, threads,
+        [&](const uint8_t* page, const CompressedPageRef& ref) {
+            pages_scanned_.fetch_add(1);
 
-            // Validate page header
-            const auto* hdr = reinterpret_cast<const PageHeader*>(page_ptr);
-            
-            // Basic validity checks - page has valid file/page IDs
-            if (hdr->this_page != 0 || hdr->this_file != 0) {
-                // Looks like a valid page
-                uint32_t obj_id = 0;
-                IndexedPageType page_type = classify_page(page_ptr, obj_id);
-
-                PageIndexEntry entry{};
-                entry.stripe_index = static_cast<uint8_t>(stripe_index);
-                entry.page_type = static_cast<uint8_t>(page_type);
-                entry.object_id = obj_id;
-                entry.file_offset = offset + page_offset;
-
-                index_.add_entry(static_cast<int32_t>(hdr->this_file), 
-                                static_cast<int32_t>(hdr->this_page), entry);
-                ++stripe_pages;
+            if (!page_header_plausible(page)) return;
+            const auto* hdr = reinterpret_cast<const PageHeader*>(page);
+
+            // The entry stores the in-block offset in 512-byte units
+            if (ref.intra_offset % 512 != 0 || ref.intra_offset / 512 > UINT16_MAX) {
+                ++skipped;
+                return;
             }
 
-            page_offset += PAGE_SIZE;
-        }
+            uint32_t obj_id = 0;
+            IndexedPageType page_type = classify_page(page, obj_id);
+
+            PageIndexRecord rec{};
+            rec.key = make_page_key(static_cast<int32_t>(hdr->this_file),
+                                    static_cast<int32_t>(hdr->this_page));
+            rec.entry.stripe_index = static_cast<uint8_t>(stripe_index);
+            rec.entry.page_type = static_cast<uint8_t>(page_type);
+            rec.entry.block_offset = static_cast<uint16_t>(ref.intra_offset / 512);
+            rec.entry.object_id = obj_id;
+            rec.entry.file_offset = ref.block_offset;
+            shard.push_back(rec);
+            count_data_page(row_stats, *hdr);
+            ++stripe_pages;
+
+            if (CompressedBlockRange* blk = block_of(ref.block_offset)) {
+                blk->page_count++;
+                blk->first_key = std::min(blk->first_key, rec.key);
+                blk->last_key = std::max(blk->last_key, rec.key);
+            }
+        }, on_block);
+
+    pages_valid_.fetch_add(stripe_pages + skipped);
+    if (const MappedStripe* map = mapped_stripes_[stripe_index].get()) {
+        bytes_read_.fetch_add(map->size());
+    } else {
+        std::error_code ec;
+        bytes_read_.fetch_add(fs::file_size(bak_paths_[stripe_index], ec));
+    }
 
-        stripe_bytes += bytes_read;
-        offset += bytes_read;
-        pages_scanned_.fetch_add(pages_per_chunk);
-        bytes_read_.fetch_add(bytes_read);
+    if (skipped > 0) {
+        LOG_WARN("Stripe %d: %llu page(s) not 512-byte aligned in their block were not indexed",
+                 stripe_index, (unsigned long long)skipped);
+    }
+    LOG_DEBUG("Stripe %d: %zu compressed block(s), %llu pages",
+              stripe_index, decoded, (unsigned long long)stripe_pages);
+
+    // Blocks holding no page start are never looked up
+    blocks.erase(std::remove_if(blocks.begin(), blocks.end(),
+                                [](const CompressedBlockRange& b) { return b.page_count == 0; }),
+                 blocks.end());
+    index_.add_shard(std::move(shard));
+    index_.add_blocks(std::move(blocks));
+    index_.add_row_stats(take_row_stats(row_stats));
+}
 
-        if (progress) {
-            progress(pages_scanned_.load(), bytes_read_.load(), stripe_index);
-        }
+void IndexedPageStore::size_block_cache() {
+    if (!is_compressed_ || index_.block_count() == 0) return;
+
+    uint64_t largest = 0, pages = 0;
+    for (size_t i = 0; i < index_.block_count(); ++i) {
+        largest = std::max<uint64_t>(largest, index_.blocks()[i].uncompressed_size);
+        pages += index_.blocks()[i].page_count;
     }
+    // Room for a block per thread plus its successor (pages that straddle)
+    block_cache_.reserve(static_cast<size_t>(largest) * 2 * config_.num_threads);
 
-    LOG_INFO("Stripe %d: %llu pages, %llu bytes",
-             stripe_index, (unsigned long long)stripe_pages,
-             (unsigned long long)stripe_bytes);
+    LOG_INFO("Compressed block table: %zu blocks, %.1f pages/block, largest %llu KB, "
+             "block cache %zu MB",
+             index_.block_count(), static_cast<double>(pages) / index_.block_count(),
+             (unsigned long long)(largest / 1024), block_cache_.capacity_bytes() >> 20);
 }
 
 IndexedPageType IndexedPageStore::classify_page(const uint8_t* page_data, uint32_t& out_object_id) {
@@ -263,7 +525,8 @@ IndexedPageType IndexedPageStore::classify_page(const uint8_t* page_data, uint32
     }
 }
 
-bool IndexedPageStore::get_page(int32_t file_id, int32_t page_id, uint8_t* out_buffer) {
+bool IndexedPageStore::get_page(int32_t file_id, int32_t page_id, uint8_t* out_buffer,
+                                PageAccess access) {
     // Ensure index is built
     if (!indexed_.load()) {
         if (!scan(nullptr)) {
@@ -289,11 +552,43 @@ bool IndexedPageStore::get_page(int32_t file_id, int32_t page_id, uint8_t* out_b
         return false;
     }
 
-    // Add to cache
-    cache_.put(key, out_buffer);
+    // Add to cache: metadata pages are revisited by every catalog lookup and
+    // allocation walk, so they outrank anything a table scan brings in
+    CachePriority priority = CachePriority::Normal;
+    switch (static_cast<IndexedPageType>(entry.page_type)) {
+        case IndexedPageType::System:
+        case IndexedPageType::Boot:
+        case IndexedPageType::IAM:
+            priority = CachePriority::Pinned;
+            break;
+        default:
+            if (access == PageAccess::ReadOnce) priority = CachePriority::Probation;
+            break;
+    }
+    cache_.put(key, out_buffer, priority);
     return true;
 }
 
+const uint8_t* IndexedPageStore::get_page_view(int32_t file_id, int32_t page_id) {
+    if (!indexed_.load()) {
+        if (!scan(nullptr)) {
+            return nullptr;
+        }
+    }
+
+    // Compressed stripes hold no raw pages to point into
+    if (is_compressed_) return nullptr;
+
+    PageIndexEntry entry;
+    if (!index_.lookup(file_id, page_id, entry)) {
+        return nullptr;
+    }
+
+    if (entry.stripe_index >= mapped_stripes_.size()) return nullptr;
+    const MappedStripe* map = mapped_stripes_[entry.stripe_index].get();
+    return map ? map->page_at(entry.file_offset) : nullptr;
+}
+
 bool IndexedPageStore::read_page_from_stripe(const PageIndexEntry& entry, uint8_t* out_buffer) {
     int stripe_idx = entry.stripe_index;
     
@@ -302,44 +597,66 @@ bool IndexedPageStore::read_page_from_stripe(const PageIndexEntry& entry, uint8_
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(stripe_mutexes_[stripe_idx]);
-
-    // Open file if not already open
-    if (!stripe_files_[stripe_idx]) {
-        stripe_files_[stripe_idx] = std::make_unique<std::ifstream>(
-            bak_paths_[stripe_idx], std::ios::binary);
-        
-        if (!stripe_files_[stripe_idx]->is_open()) {
-            LOG_ERROR("Failed to open stripe for reading: %s", bak_paths_[stripe_idx].c_str());
+    if (is_compressed_) {
+        CompressedStripe* stripe = compressed_stripes_[stripe_idx].get();
+        CompressedPageRef ref{entry.file_offset, uint32_t(entry.block_offset) * 512};
+
+        // The sealed index has every decoded block's sizes, including the
+        // next one of the chain for a page that straddles blocks
+        auto block_size = [&](uint64_t offset, uint32_t& stored, uint32_t& uncompressed) {
+            const CompressedBlockRange* blk =
+                index_.find_block(static_cast<uint8_t>(stripe_idx), offset);
+            if (!blk) return false;
+            stored = blk->stored_size;
+            uncompressed = blk->uncompressed_size;
+            return true;
+        };
+        if (!stripe || !stripe->read_page(ref, out_buffer, block_cache_, block_size)) {
+            LOG_ERROR("Failed to read compressed page (block %llu, offset %u) from stripe %d",
+                      (unsigned long long)ref.block_offset, ref.intra_offset, stripe_idx);
             return false;
         }
+        return true;
     }
 
-    auto& file = *stripe_files_[stripe_idx];
+    if (const MappedStripe* map = mapped_stripes_[stripe_idx].get()) {
+        const uint8_t* src = map->page_at(entry.file_offset);
+        if (!src) {
+            LOG_ERROR("Page offset %llu beyond end of stripe %d",
+                      (unsigned long long)entry.file_offset, stripe_idx);
+            return false;
+        }
+        std::memcpy(out_buffer, src, PAGE_SIZE);
+    } else {
+        std::lock_guard<std::mutex> lock(stripe_mutexes_[stripe_idx]);
+
+        // Open file if not already open
+        if (!stripe_files_[stripe_idx]) {
+            stripe_files_[stripe_idx] = std::make_unique<std::ifstream>(
+                bak_paths_[stripe_idx], std::ios::binary);
+        
+            if (!stripe_files_[stripe_idx]->is_open()) {
+                LOG_ERROR("Failed to open stripe for reading: %s", bak_paths_[stripe_idx].c_str());
+                return false;
+            }
+        }
 
-    // Seek to page offset
-    file.seekg(static_cast<std::streamoff>(entry.file_offset));
-    if (!file) {
-        LOG_ERROR("Failed to seek to offset %llu in stripe %d",
-                  (unsigned long long)entry.file_offset, stripe_idx);
-        return false;
-    }
+        auto& file = *stripe_files_[stripe_idx];
 
-    // Read page
-    file.read(reinterpret_cast<char*>(out_buffer), PAGE_SIZE);
-    if (file.gcount() != PAGE_SIZE) {
-        LOG_ERROR("Short read at offset %llu: got %lld bytes",
-                  (unsigned long long)entry.file_offset, (long long)file.gcount());
-        return false;
-    }
+        // Seek to page offset
+        file.seekg(static_cast<std::streamoff>(entry.file_offset));
+        if (!file) {
+            LOG_ERROR("Failed to seek to offset %llu in stripe %d",
+                      (unsigned long long)entry.file_offset, stripe_idx);
+            return false;
+        }
 
-    // Handle decompression if needed
-    if (is_compressed_ && decompressor_) {
-        std::vector<uint8_t> decomp_buf(PAGE_SIZE * 2);
-        size_t decomp_size = decompressor_->decompress_into(
-            out_buffer, PAGE_SIZE, decomp_buf.data(), decomp_buf.size());
-        if (decomp_size >= PAGE_SIZE) {
-            std::memcpy(out_buffer, decomp_buf.data(), PAGE_SIZE);
+        // Read page
+        file.read(reinterpret_cast<char*>(out_buffer), PAGE_SIZE);
+        if (file.gcount() != PAGE_SIZE) {
+            LOG_ERROR("Short read at offset %llu: got %lld bytes",
+                      (unsigned long long)entry.file_offset, (long long)file.gcount());
+            return false;
         }
     }
 
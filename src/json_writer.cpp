@@ -147,12 +147,13 @@ std::string JsonWriter::escape_json(const std::string& s) {
 // =========================================================================
 
 std::unique_ptr<IExportWriter> create_writer(OutputFormat format,
-                                              const std::string& delimiter) {
+                                              const std::string& delimiter,
+                                              const ParquetOptions& parquet) {
     switch (format) {
     case OutputFormat::CSV:
         return std::make_unique<CsvWriter>(delimiter);
     case OutputFormat::Parquet:
-        return std::make_unique<ParquetWriter>();
+        return std::make_unique<ParquetWriter>(parquet);
     case OutputFormat::JSONL:
         return std::make_unique<JsonWriter>();
     default:
@@ -0,0 +1,156 @@
+#include "bakread/lob_reader.h"
+#include "bakread/logging.h"
+#include "bakread/page.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bakread {
+
+// LOB record types (the 2-byte type after the blob id)
+namespace LobRecord {
+    static constexpr uint16_t SmallRoot      = 0;
+    static constexpr uint16_t Internal       = 2;
+    static constexpr uint16_t Data           = 3;
+    static constexpr uint16_t LargeRootYukon = 5;
+}
+
+static constexpr size_t LOB_RECORD_HEADER = 14;   // Record header, blob id, type
+static constexpr size_t INLINE_ROOT_HEADER = 12;
+static constexpr size_t INLINE_ROOT_LINK   = 12;
+
+// Row id {page (4), file (2), slot (2)}
+static void read_row_id(const uint8_t* p, int32_t& file_id, int32_t& page_id, uint16_t& slot) {
+    PageId id = read_page_pointer(p);
+    file_id = id.file_id;
+    page_id = id.page_id;
+    std::memcpy(&slot, p + 6, 2);
+}
+
+LobReader::LobReader(LobPageSource source, size_t cache_pages)
+    : source_(std::move(source))
+    , cache_(std::max<size_t>(cache_pages, 64))
+{
+}
+
+uint64_t LobReader::declared_size(const uint8_t* pointer, size_t len, bool text_pointer) {
+    if (text_pointer || !is_inline_root(len)) return 0;
+
+    // Link sizes are cumulative offsets in MAX roots and a single size in
+    // row-overflow pointers; either way the last one is the value's size
+    uint32_t size;
+    std::memcpy(&size, pointer + len - INLINE_ROOT_LINK, 4);
+    return size;
+}
+
+bool LobReader::read(const uint8_t* pointer, size_t len, bool text_pointer,
+                     const LobChunkSink& sink) const {
+    bool ok = false;
+    int32_t file_id, page_id;
+    uint16_t slot;
+
+    if (text_pointer) {
+        if (is_text_pointer(len)) {
+            read_row_id(pointer + 8, file_id, page_id, slot);
+            ok = read_record(file_id, page_id, slot, 0, sink);
+        }
+    } else if (is_inline_root(len)) {
+        ok = true;
+        for (size_t off = INLINE_ROOT_HEADER; ok && off + INLINE_ROOT_LINK <= len;
+             off += INLINE_ROOT_LINK) {
+            read_row_id(pointer + off + 4, file_id, page_id, slot);
+            ok = read_record(file_id, page_id, slot, 1, sink);
+        }
+    }
+
+    (ok ? values_read_ : unresolved_).fetch_add(1, std::memory_order_relaxed);
+    return ok;
+}
+
+bool LobReader::read_record(int32_t file_id, int32_t page_id, uint16_t slot, int depth,
+                            const LobChunkSink& sink) const {
+    if (depth > MAX_DEPTH) return false;
+
+    // One buffer per tree level: a root's links stay readable while its
+    // children are fetched
+    uint8_t scratch[PAGE_SIZE];
+    const uint8_t* page = fetch(file_id, page_id, scratch);
+    if (!page) return false;
+
+    PageHeader hdr;
+    std::memcpy(&hdr, page, sizeof(hdr));
+    if (slot >= hdr.slot_count) return false;
+
+    uint16_t offset = get_slot_offset(page, slot);
+    if (offset < PAGE_HEADER_SIZE || offset + LOB_RECORD_HEADER > PAGE_SIZE) return false;
+
+    const uint8_t* rec = page + offset;
+    uint16_t rec_len;
+    std::memcpy(&rec_len, rec + 2, 2);
+    if (rec_len < LOB_RECORD_HEADER || offset + rec_len > PAGE_SIZE) return false;
+
+    uint16_t type;
+    std::memcpy(&type, rec + 12, 2);
+
+    switch (type) {
+    case LobRecord::Data:
+        sink(rec + LOB_RECORD_HEADER, rec_len - LOB_RECORD_HEADER);
+        return true;
+
+    case LobRecord::SmallRoot: {
+        if (rec_len < 20) return false;
+        uint16_t size;
+        std::memcpy(&size, rec + 14, 2);
+        sink(rec + 20, std::min<size_t>(size, rec_len - 20u));
+        return true;
+    }
+
+    case LobRecord::Internal:
+    case LobRecord::LargeRootYukon: {
+        const size_t first = (type == LobRecord::Internal) ? 20 : 24;
+        const size_t link  = (type == LobRecord::Internal) ? 16 : 12;
+        if (rec_len < first) return false;
+        uint16_t links;
+        std::memcpy(&links, rec + 16, 2);
+
+        for (size_t i = 0; i < links; ++i) {
+            size_t at = first + i * link;
+            if (at + link > rec_len) return false;
+            int32_t child_file, child_page;
+            uint16_t child_slot;
+            read_row_id(rec + at + link - 8, child_file, child_page, child_slot);
+            if (!read_record(child_file, child_page, child_slot, depth + 1, sink)) return false;
+        }
+        return true;
+    }
+
+    default:
+        LOG_DEBUG_HOT("Unsupported LOB record type %u at (%d:%d:%u)",
+                      type, file_id, page_id, slot);
+        return false;
+    }
+}
+
+const uint8_t* LobReader::fetch(int32_t file_id, int32_t page_id, uint8_t* scratch) const {
+    const int64_t key = (static_cast<int64_t>(file_id) << 32) | static_cast<uint32_t>(page_id);
+
+    const uint8_t* page = nullptr;
+    if (cache_.get(key, scratch)) {
+        page = scratch;
+    } else {
+        page = source_(file_id, page_id, scratch);
+        if (!page) return nullptr;
+        // Views (mapped stripes, resident store pages) cost nothing to
+        // fetch again; cache only pages that had to be read or decompressed
+        if (page == scratch) cache_.put(key, scratch);
+    }
+
+    uint8_t type = page[1];
+    if (type != static_cast<uint8_t>(PageType::TextMix) &&
+        type != static_cast<uint8_t>(PageType::TextTree)) {
+        return nullptr;
+    }
+    return page;
+}
+
+}  // namespace bakread
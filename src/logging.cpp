@@ -3,9 +3,7 @@
 #include <chrono>
 #include <cstdio>
 #include <cstring>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
 
 namespace bakread {
 
@@ -21,18 +19,58 @@ static const char* level_str(LogLevel l) {
     return "?????";
 }
 
+// "[YYYY-MM-DD HH:MM:SS.mmm] [LEVEL] message" into buf; returns the length
+// (clamped to cap - 1 when truncated)
+static size_t format_line(char* buf, size_t cap, LogLevel level,
+                          const char* fmt, va_list args) {
+    auto now   = std::chrono::system_clock::now();
+    auto tt    = std::chrono::system_clock::to_time_t(now);
+    auto ms    = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     now.time_since_epoch()) % 1000;
+    struct tm local_tm;
+#ifdef _WIN32
+    localtime_s(&local_tm, &tt);
+#else
+    localtime_r(&tt, &local_tm);
+#endif
+
+    int n = snprintf(buf, cap, "[%04d-%02d-%02d %02d:%02d:%02d.%03d] [%s] ",
+                     local_tm.tm_year + 1900, local_tm.tm_mon + 1, local_tm.tm_mday,
+                     local_tm.tm_hour, local_tm.tm_min, local_tm.tm_sec,
+                     static_cast<int>(ms.count()), level_str(level));
+    if (n < 0) return 0;
+    size_t len = static_cast<size_t>(n);
+    if (len >= cap) return cap - 1;
+
+    int m = vsnprintf(buf + len, cap - len, fmt, args);
+    if (m > 0) len += static_cast<size_t>(m);
+    return len < cap ? len : cap - 1;
+}
+
+static size_t format_line(char* buf, size_t cap, LogLevel level, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    size_t len = format_line(buf, cap, level, fmt, args);
+    va_end(args);
+    return len;
+}
+
 Logger& Logger::instance() {
     static Logger s;
     return s;
 }
 
-Logger::Logger()  = default;
-Logger::~Logger() = default;
+Logger::Logger() = default;
+
+Logger::~Logger() {
+    set_async(false);
+}
 
 void Logger::set_level(LogLevel level)   { level_ = level; }
 void Logger::set_verbose(bool v)         { verbose_ = v; if (v) level_ = LogLevel::Debug; }
 
 void Logger::set_log_file(const std::string& path) {
+    flush();
     std::lock_guard<std::mutex> lk(mu_);
     file_.open(path, std::ios::out | std::ios::trunc);
     if (!file_.is_open()) {
@@ -74,35 +112,206 @@ void Logger::fatal(const char* fmt, ...) {
 void Logger::log_impl(LogLevel level, const char* fmt, va_list args) {
     if (level < level_) return;
 
-    char buf[4096];
-    vsnprintf(buf, sizeof(buf), fmt, args);
+    char line[4096 + 64];
+    size_t len = format_line(line, sizeof(line), level, fmt, args);
 
-    auto now   = std::chrono::system_clock::now();
-    auto tt    = std::chrono::system_clock::to_time_t(now);
-    auto ms    = std::chrono::duration_cast<std::chrono::milliseconds>(
-                     now.time_since_epoch()) % 1000;
-    struct tm local_tm;
-#ifdef _WIN32
-    localtime_s(&local_tm, &tt);
-#else
-    localtime_r(&tt, &local_tm);
-#endif
+    // The producer count lets set_async(false) wait for callers that saw
+    // the ring enabled before tearing the flusher down
+    producers_.fetch_add(1);
+    if (!async_.load()) {
+        producers_.fetch_sub(1);
+        write_sync(level, line, len);
+        return;
+    }
 
-    char ts[64];
-    snprintf(ts, sizeof(ts), "%04d-%02d-%02d %02d:%02d:%02d.%03d",
-             local_tm.tm_year + 1900, local_tm.tm_mon + 1, local_tm.tm_mday,
-             local_tm.tm_hour, local_tm.tm_min, local_tm.tm_sec,
-             static_cast<int>(ms.count()));
+    if (len < SLOT_TEXT) {
+        enqueue(level, line, len);
+        producers_.fetch_sub(1);
+        if (level >= LogLevel::Fatal) flush();
+        return;
+    }
 
+    // Too long for a slot: write it in order behind what is queued
+    flush();
+    producers_.fetch_sub(1);
+    write_sync(level, line, len);
+}
+
+void Logger::enqueue(LogLevel level, const char* line, size_t len) {
+    if (try_enqueue(level, line, len)) {
+        if (level >= LogLevel::Warn) wake_flusher();
+        return;
+    }
+    if (level < LogLevel::Info) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // Ring full: INFO and above wait for the flusher to make room
+    do {
+        wake_flusher();
+        std::this_thread::yield();
+    } while (!try_enqueue(level, line, len));
+}
+
+bool Logger::try_enqueue(LogLevel level, const char* line, size_t len) {
+    uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &ring_[pos & (RING_SLOTS - 1)];
+        uint64_t seq = slot->seq.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return false;   // Full: the flusher has not released this slot yet
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+    slot->level = level;
+    slot->len   = static_cast<uint32_t>(len);
+    std::memcpy(slot->text, line, len);
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void Logger::write_sync(LogLevel level, const char* line, size_t len) {
     std::lock_guard<std::mutex> lk(mu_);
 
-    auto& out = (level >= LogLevel::Warn) ? std::cerr : std::cout;
-    out << "[" << ts << "] [" << level_str(level) << "] " << buf << std::endl;
+    FILE* out = (level >= LogLevel::Warn) ? stderr : stdout;
+    std::fwrite(line, 1, len, out);
+    std::fputc('\n', out);
+    std::fflush(out);
 
     if (file_.is_open()) {
-        file_ << "[" << ts << "] [" << level_str(level) << "] " << buf << "\n";
+        file_.write(line, static_cast<std::streamsize>(len));
+        file_.put('\n');
+        file_.flush();
+    }
+}
+
+// -------------------------------------------------------------------------
+// Background flusher
+// -------------------------------------------------------------------------
+
+void Logger::set_async(bool on) {
+    std::lock_guard<std::mutex> guard(async_mu_);
+    if (on == async_.load()) return;
+
+    if (on) {
+        if (!ring_) {
+            ring_.reset(new Slot[RING_SLOTS]);
+            for (size_t i = 0; i < RING_SLOTS; ++i)
+                ring_[i].seq.store(i, std::memory_order_relaxed);
+        }
+        stop_ = false;
+        flusher_running_.store(true);
+        flusher_ = std::thread(&Logger::flusher_main, this);
+        async_.store(true);
+        return;
+    }
+
+    async_.store(false);
+    while (producers_.load() > 0) std::this_thread::yield();
+    {
+        std::lock_guard<std::mutex> lk(wake_mu_);
+        stop_ = true;
+    }
+    wake_cv_.notify_one();
+    flusher_.join();
+}
+
+void Logger::flush() {
+    if (!async_.load()) return;
+    uint64_t target = enqueue_pos_.load();
+    wake_flusher();
+    std::unique_lock<std::mutex> lk(wake_mu_);
+    while (written_pos_.load() < target && flusher_running_.load())
+        written_cv_.wait_for(lk, std::chrono::milliseconds(20));
+}
+
+void Logger::wake_flusher() {
+    wake_cv_.notify_one();
+}
+
+void Logger::flusher_main() {
+    for (;;) {
+        if (drain() > 0) continue;
+        std::unique_lock<std::mutex> lk(wake_mu_);
+        if (stop_) {
+            // No producer is left (set_async waited for them): final drain
+            lk.unlock();
+            while (drain() > 0) {}
+            flusher_running_.store(false);
+            written_cv_.notify_all();
+            return;
+        }
+        wake_cv_.wait_for(lk, std::chrono::milliseconds(20));
+    }
+}
+
+// Write out everything published so far: console output in runs per
+// stream (keeping the order of stdout/stderr lines), the log file in one
+// write, each flushed once. Returns the number of lines taken.
+size_t Logger::drain() {
+    std::string console;
+    std::string file_batch;
+    bool console_err = false;
+    size_t n = 0;
+
+    std::lock_guard<std::mutex> lk(mu_);
+    const bool to_file = file_.is_open();
+
+    auto emit = [&](bool to_err) {
+        if (to_err != console_err && !console.empty()) {
+            std::fwrite(console.data(), 1, console.size(), console_err ? stderr : stdout);
+            console.clear();
+        }
+        console_err = to_err;
+    };
+
+    uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        char note[160];
+        size_t len = format_line(note, sizeof(note), LogLevel::Warn,
+                                 "%llu debug/trace log line(s) dropped (log buffer full)",
+                                 static_cast<unsigned long long>(dropped));
+        emit(true);
+        console.append(note, len).push_back('\n');
+        if (to_file) file_batch.append(note, len).push_back('\n');
+    }
+
+    while (n < RING_SLOTS) {
+        Slot& slot = ring_[dequeue_pos_ & (RING_SLOTS - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != dequeue_pos_ + 1) break;
+
+        emit(slot.level >= LogLevel::Warn);
+        console.append(slot.text, slot.len).push_back('\n');
+        if (to_file) file_batch.append(slot.text, slot.len).push_back('\n');
+
+        slot.seq.store(dequeue_pos_ + RING_SLOTS, std::memory_order_release);
+        ++dequeue_pos_;
+        ++n;
+    }
+
+    if (n == 0 && dropped == 0) return 0;
+
+    if (!console.empty())
+        std::fwrite(console.data(), 1, console.size(), console_err ? stderr : stdout);
+    std::fflush(stdout);
+    std::fflush(stderr);
+    if (to_file) {
+        file_.write(file_batch.data(), static_cast<std::streamsize>(file_batch.size()));
         file_.flush();
     }
+
+    {
+        std::lock_guard<std::mutex> wk(wake_mu_);
+        written_pos_.store(dequeue_pos_);
+    }
+    written_cv_.notify_all();
+    return n;
 }
 
 }  // namespace bakread
@@ -2,113 +2,255 @@
 
 #include <algorithm>
 #include <cstring>
+#include <mutex>
 
 namespace bakread {
 
-LRUPageCache::LRUPageCache(size_t max_pages)
-    : max_pages_(max_pages)
-{
+// Shards stay big enough for CLOCK to have a meaningful choice of victims
+static constexpr size_t MAX_SHARDS      = 64;
+static constexpr size_t MIN_SHARD_PAGES = 128;
+
+LRUPageCache::LRUPageCache(size_t max_pages) {
+    build(max_pages);
+}
+
+LRUPageCache::~LRUPageCache() = default;
+
+void LRUPageCache::build(size_t max_pages) {
+    max_pages_ = max_pages;
+
+    shard_bits_ = 0;
+    while ((size_t(1) << (shard_bits_ + 1)) <= MAX_SHARDS &&
+           (max_pages >> (shard_bits_ + 1)) >= MIN_SHARD_PAGES) {
+        ++shard_bits_;
+    }
+    shard_count_ = size_t(1) << shard_bits_;
+
+    // Left uninitialized: untouched slab pages cost address space only
+    slab_.reset(max_pages > 0 ? new uint8_t[max_pages * PAGE_SIZE] : nullptr);
+    slots_.reset(new Slot[max_pages]);
+    shards_.reset(new Shard[shard_count_]);
+
+    size_t first = 0;
+    for (size_t s = 0; s < shard_count_; ++s) {
+        Shard& shard = shards_[s];
+        // Spread the remainder over the first shards
+        size_t count = max_pages / shard_count_ + (s < max_pages % shard_count_ ? 1 : 0);
+        shard.first_slot = first;
+        shard.slot_count = static_cast<uint32_t>(count);
+        shard.pinned_cap = static_cast<uint32_t>(count / 4);
+        shard.probation_cap = static_cast<uint32_t>(count / 16);
+        shard.free_slots.reserve(count);
+        for (size_t i = count; i-- > 0;) shard.free_slots.push_back(static_cast<uint32_t>(i));
+        shard.lookup.reserve(count);
+        first += count;
+    }
+}
+
+LRUPageCache::Shard& LRUPageCache::shard_of(int64_t key) const {
+    // Fibonacci hash: neighbouring pages land in different shards
+    if (shard_bits_ == 0) return shards_[0];
+    return shards_[(static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> (64 - shard_bits_)];
 }
 
 bool LRUPageCache::get(int64_t key, uint8_t* out_page) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    Shard& shard = shard_of(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
 
-    auto it = lookup_.find(key);
-    if (it == lookup_.end()) {
-        ++misses_;
+    auto it = shard.lookup.find(key);
+    if (it == shard.lookup.end()) {
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
         return false;
     }
 
-    // Move to front (most recently used)
-    lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
-    std::memcpy(out_page, it->second->data.data(), PAGE_SIZE);
-    ++hits_;
+    slots_[shard.first_slot + it->second].referenced.store(1, std::memory_order_relaxed);
+    std::memcpy(out_page, page(shard, it->second), PAGE_SIZE);
+    shard.hits.fetch_add(1, std::memory_order_relaxed);
     return true;
 }
 
-void LRUPageCache::put(int64_t key, const uint8_t* page_data) {
-    std::lock_guard<std::mutex> lock(mutex_);
+void LRUPageCache::put(int64_t key, const uint8_t* page_data, CachePriority priority) {
+    Shard& shard = shard_of(key);
+    if (shard.slot_count == 0) return;
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
 
-    auto it = lookup_.find(key);
-    if (it != lookup_.end()) {
-        // Update existing entry and move to front
-        std::memcpy(it->second->data.data(), page_data, PAGE_SIZE);
-        lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+    auto it = shard.lookup.find(key);
+    if (it != shard.lookup.end()) {
+        // Update existing entry; a page can move up to Pinned, never down
+        Slot& s = slots_[shard.first_slot + it->second];
+        std::memcpy(page(shard, it->second), page_data, PAGE_SIZE);
+        s.referenced.store(1, std::memory_order_relaxed);
+        if (priority == CachePriority::Pinned && s.priority != CachePriority::Pinned &&
+            shard.pinned < shard.pinned_cap) {
+            s.priority = CachePriority::Pinned;
+            ++shard.pinned;
+        }
         return;
     }
 
-    // Evict if at capacity
-    evict_if_needed();
+    if (priority == CachePriority::Pinned && shard.pinned >= shard.pinned_cap) {
+        priority = CachePriority::Normal;
+    }
+
+    uint32_t slot = 0;
+    if (!shard.free_slots.empty()) {
+        slot = shard.free_slots.back();
+        shard.free_slots.pop_back();
+    } else if (priority != CachePriority::Probation ||
+               shard.probation.size() < shard.probation_cap ||
+               !recycle_probation_locked(shard, slot)) {
+        slot = evict_locked(shard);
+    }
 
-    // Add new entry at front
-    CacheEntry entry;
-    entry.key = key;
-    entry.data.resize(PAGE_SIZE);
-    std::memcpy(entry.data.data(), page_data, PAGE_SIZE);
+    Slot& s = slots_[shard.first_slot + slot];
+    s.key  = key;
+    s.used = true;
+    s.priority = priority;
+    // Read-once pages must earn their reference bit with a real hit
+    s.referenced.store(priority == CachePriority::Probation ? 0 : 1, std::memory_order_relaxed);
+    std::memcpy(page(shard, slot), page_data, PAGE_SIZE);
+    shard.lookup[key] = slot;
 
-    lru_list_.push_front(std::move(entry));
-    lookup_[key] = lru_list_.begin();
+    if (priority == CachePriority::Pinned) ++shard.pinned;
+    if (priority == CachePriority::Probation) {
+        if (shard.probation_cap > 0) shard.probation.emplace_back(slot, key);
+        else s.priority = CachePriority::Normal;   // Shard too small for a ring
+    }
+}
+
+uint32_t LRUPageCache::evict_locked(Shard& shard) {
+    // Second chance: referenced slots lose their bit and are passed over,
+    // pinned ones are skipped. Pinned slots are at most a quarter of the
+    // shard, so this terminates within two turns of the hand.
+    for (;;) {
+        uint32_t slot = shard.hand;
+        shard.hand = (shard.hand + 1 == shard.slot_count) ? 0 : shard.hand + 1;
+
+        Slot& s = slots_[shard.first_slot + slot];
+        if (s.priority == CachePriority::Pinned) continue;
+        if (s.referenced.exchange(0, std::memory_order_relaxed)) continue;
+
+        release_locked(shard, slot);
+        return slot;
+    }
+}
+
+bool LRUPageCache::recycle_probation_locked(Shard& shard, uint32_t& slot) {
+    while (!shard.probation.empty()) {
+        auto [candidate, key] = shard.probation.front();
+        shard.probation.pop_front();
+
+        // Entries go stale when CLOCK or remove() took the slot first
+        Slot& s = slots_[shard.first_slot + candidate];
+        if (!s.used || s.key != key || s.priority != CachePriority::Probation) continue;
+
+        // Hit since it was admitted: it is not a read-once page after all
+        if (s.referenced.load(std::memory_order_relaxed)) {
+            s.priority = CachePriority::Normal;
+            continue;
+        }
+
+        release_locked(shard, candidate);
+        slot = candidate;
+        return true;
+    }
+    return false;
+}
+
+void LRUPageCache::release_locked(Shard& shard, uint32_t slot) {
+    Slot& s = slots_[shard.first_slot + slot];
+    if (s.priority == CachePriority::Pinned) --shard.pinned;
+    shard.lookup.erase(s.key);
+    s.used = false;
+    s.priority = CachePriority::Normal;
+    s.referenced.store(0, std::memory_order_relaxed);
 }
 
 bool LRUPageCache::contains(int64_t key) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return lookup_.find(key) != lookup_.end();
+    Shard& shard = shard_of(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.lookup.find(key) != shard.lookup.end();
 }
 
 void LRUPageCache::remove(int64_t key) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    Shard& shard = shard_of(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
 
-    auto it = lookup_.find(key);
-    if (it != lookup_.end()) {
-        lru_list_.erase(it->second);
-        lookup_.erase(it);
+    auto it = shard.lookup.find(key);
+    if (it != shard.lookup.end()) {
+        uint32_t slot = it->second;
+        release_locked(shard, slot);
+        shard.free_slots.push_back(slot);
     }
 }
 
 void LRUPageCache::clear() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    lru_list_.clear();
-    lookup_.clear();
-    hits_ = 0;
-    misses_ = 0;
+    for (size_t i = 0; i < shard_count_; ++i) {
+        Shard& shard = shards_[i];
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        for (const auto& [key, slot] : shard.lookup) {
+            Slot& s = slots_[shard.first_slot + slot];
+            s.used = false;
+            s.priority = CachePriority::Normal;
+            s.referenced.store(0, std::memory_order_relaxed);
+        }
+        shard.lookup.clear();
+        shard.probation.clear();
+        shard.pinned = 0;
+        shard.free_slots.clear();
+        for (uint32_t j = shard.slot_count; j-- > 0;) shard.free_slots.push_back(j);
+        shard.hand = 0;
+        shard.hits.store(0);
+        shard.misses.store(0);
+    }
 }
 
 size_t LRUPageCache::size() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return lookup_.size();
+    size_t total = 0;
+    for (size_t i = 0; i < shard_count_; ++i) {
+        std::shared_lock<std::shared_mutex> lock(shards_[i].mutex);
+        total += shards_[i].lookup.size();
+    }
+    return total;
 }
 
 size_t LRUPageCache::memory_usage_bytes() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    // Each entry: 8KB data + key (8) + list node overhead (~48) + map entry (~40)
-    return lookup_.size() * (PAGE_SIZE + 96) + sizeof(LRUPageCache);
+    // Slab and slot table are fixed; map entries ~32 bytes each
+    return max_pages_ * (PAGE_SIZE + sizeof(Slot)) + size() * 32 +
+           shard_count_ * sizeof(Shard) + sizeof(LRUPageCache);
+}
+
+size_t LRUPageCache::pinned_pages() const {
+    size_t total = 0;
+    for (size_t i = 0; i < shard_count_; ++i) {
+        std::shared_lock<std::shared_mutex> lock(shards_[i].mutex);
+        total += shards_[i].pinned;
+    }
+    return total;
+}
+
+uint64_t LRUPageCache::hits() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < shard_count_; ++i) total += shards_[i].hits.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t LRUPageCache::misses() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < shard_count_; ++i) total += shards_[i].misses.load(std::memory_order_relaxed);
+    return total;
 }
 
 double LRUPageCache::hit_rate() const {
-    uint64_t total = hits_ + misses_;
+    uint64_t h = hits();
+    uint64_t total = h + misses();
     if (total == 0) return 0.0;
-    return static_cast<double>(hits_) / static_cast<double>(total);
+    return static_cast<double>(h) / static_cast<double>(total);
 }
 
 void LRUPageCache::resize(size_t max_pages) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    max_pages_ = max_pages;
-    
-    // Evict excess entries
-    while (lookup_.size() > max_pages_) {
-        auto& back = lru_list_.back();
-        lookup_.erase(back.key);
-        lru_list_.pop_back();
-    }
-}
-
-void LRUPageCache::evict_if_needed() {
-    // Called with lock held
-    while (lookup_.size() >= max_pages_ && !lru_list_.empty()) {
-        auto& back = lru_list_.back();
-        lookup_.erase(back.key);
-        lru_list_.pop_back();
-    }
+    // Not safe against concurrent access, like construction
+    build(max_pages);
 }
 
 }  // namespace bakread
@@ -53,8 +53,9 @@ int main(int argc, char* argv[]) {
                 return 1;
             }
             
-            // If target server is specified, use restore mode directly (more reliable)
-            if (!opts.target_server.empty()) {
+            // If target server is specified, use restore mode directly (more reliable);
+            // differentials are only layered in direct mode
+            if (!opts.target_server.empty() && opts.diff_paths.empty()) {
                 LOG_INFO("Using restore mode to list tables...");
                 
                 RestoreOptions ropts;
@@ -65,6 +66,11 @@ int main(int argc, char* argv[]) {
                 ropts.tde_cert_pfx = opts.tde_cert_pfx;
                 ropts.tde_cert_key = opts.tde_cert_key;
                 ropts.tde_cert_password = opts.tde_cert_password;
+                ropts.buffer_count = opts.restore_buffer_count;
+                ropts.max_transfer_size = opts.restore_max_transfer;
+                ropts.data_dirs = opts.restore_data_dirs;
+                ropts.log_dir = opts.restore_log_dir;
+                ropts.keep_database = opts.keep_restored_db;
                 
                 RestoreAdapter adapter(ropts);
                 auto restore_result = adapter.list_tables();
@@ -98,6 +104,17 @@ int main(int argc, char* argv[]) {
             config.cache_size_mb = opts.cache_size_mb;
             config.index_dir = opts.index_dir;
             config.force_rescan = opts.force_rescan;
+            config.use_mmap = opts.use_mmap;
+            config.readahead_depth = opts.readahead_depth;
+            config.readahead_mb = opts.readahead_mb;
+            config.direct_io = opts.direct_io;
+            config.memory_budget_mb = opts.memory_budget_mb;
+            config.spill_dir = opts.spill_dir;
+            config.lob_cache_mb = opts.lob_cache_mb;
+            config.decode_workers = opts.workers;
+            config.preserve_order = opts.preserve_order;
+            config.catalog_cache = opts.catalog_cache;
+            config.diff_paths = opts.diff_paths;
             
             DirectExtractor extractor(opts.bak_paths, config);
             auto result = extractor.list_tables();
@@ -106,7 +123,7 @@ int main(int argc, char* argv[]) {
                 std::cout << "\n";
                 std::cout << std::left << std::setw(30) << "TABLE NAME" 
                           << std::setw(12) << "ROWS (est)" 
-                          << std::setw(15) << "DATA PAGES" << "\n";
+                          << std::setw(15) << "PAGES" << "\n";
                 std::cout << std::string(57, '-') << "\n";
                 
                 for (const auto& tbl : result.tables) {
@@ -129,19 +146,26 @@ int main(int argc, char* argv[]) {
             return 1;
         }
 
+        // Extraction logs from many threads: hand them to the background
+        // flusher (drained when the logger shuts down at exit)
+        log.set_async(true);
+
         Pipeline pipeline(opts);
         auto result = pipeline.run();
 
         return result.success ? 0 : 1;
 
     } catch (const ConfigError& e) {
+        Logger::instance().flush();
         std::cerr << "Configuration error: " << e.what() << "\n";
         std::cerr << "Run 'bakread --help' for usage information.\n";
         return 2;
     } catch (const BakReadError& e) {
+        Logger::instance().flush();
         std::cerr << "Error: " << e.what() << "\n";
         return 1;
     } catch (const std::exception& e) {
+        Logger::instance().flush();
         std::cerr << "Fatal error: " << e.what() << "\n";
         return 3;
     }
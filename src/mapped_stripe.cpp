@@ -0,0 +1,147 @@
+#include "bakread/mapped_stripe.h"
+#include "bakread/error.h"
+#include "bakread/logging.h"
+#include "bakread/page.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <limits>
+
+namespace bakread {
+
+#ifdef _WIN32
+
+MappedStripe::MappedStripe(const std::string& path)
+    : path_(path)
+{
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw FileIOError("Cannot open file for mapping: " + path);
+
+    LARGE_INTEGER li;
+    if (!GetFileSizeEx(file, &li) || li.QuadPart <= 0) {
+        CloseHandle(file);
+        throw FileIOError("Cannot map empty file: " + path);
+    }
+    size_ = static_cast<uint64_t>(li.QuadPart);
+
+    if (size_ > static_cast<uint64_t>(std::numeric_limits<size_t>::max())) {
+        CloseHandle(file);
+        throw FileIOError("File too large to map in this address space: " + path);
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        throw FileIOError("CreateFileMapping failed for: " + path);
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw FileIOError("MapViewOfFile failed for: " + path);
+    }
+
+    file_handle_    = file;
+    mapping_handle_ = mapping;
+    data_           = static_cast<const uint8_t*>(view);
+
+    LOG_DEBUG("Mapped %s (%llu bytes)", path.c_str(), (unsigned long long)size_);
+}
+
+MappedStripe::~MappedStripe() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_handle_) CloseHandle(static_cast<HANDLE>(mapping_handle_));
+    if (file_handle_) CloseHandle(static_cast<HANDLE>(file_handle_));
+}
+
+void MappedStripe::advise(Access access) const {
+    // No portable per-mapping hint before Windows 8 (PrefetchVirtualMemory);
+    // the section object already reads ahead for sequential faults.
+    (void)access;
+}
+
+void MappedStripe::prefetch(uint64_t offset, size_t length) const {
+    (void)offset;
+    (void)length;
+}
+
+#else
+
+MappedStripe::MappedStripe(const std::string& path)
+    : path_(path)
+{
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0)
+        throw FileIOError("Cannot open file for mapping: " + path);
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0 || st.st_size <= 0) {
+        ::close(fd_);
+        fd_ = -1;
+        throw FileIOError("Cannot map empty file: " + path);
+    }
+    size_ = static_cast<uint64_t>(st.st_size);
+
+    if (size_ > static_cast<uint64_t>(std::numeric_limits<size_t>::max())) {
+        ::close(fd_);
+        fd_ = -1;
+        throw FileIOError("File too large to map in this address space: " + path);
+    }
+
+    void* addr = ::mmap(nullptr, static_cast<size_t>(size_), PROT_READ,
+                        MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        ::close(fd_);
+        fd_ = -1;
+        throw FileIOError("mmap failed for: " + path);
+    }
+    data_ = static_cast<const uint8_t*>(addr);
+
+    LOG_DEBUG("Mapped %s (%llu bytes)", path.c_str(), (unsigned long long)size_);
+}
+
+MappedStripe::~MappedStripe() {
+    if (data_) ::munmap(const_cast<uint8_t*>(data_), static_cast<size_t>(size_));
+    if (fd_ >= 0) ::close(fd_);
+}
+
+void MappedStripe::advise(Access access) const {
+    int advice = MADV_NORMAL;
+    switch (access) {
+        case Access::Sequential: advice = MADV_SEQUENTIAL; break;
+        case Access::Random:     advice = MADV_RANDOM;     break;
+        default: break;
+    }
+    ::madvise(const_cast<uint8_t*>(data_), static_cast<size_t>(size_), advice);
+}
+
+void MappedStripe::prefetch(uint64_t offset, size_t length) const {
+    if (offset >= size_) return;
+    if (length > size_ - offset) length = static_cast<size_t>(size_ - offset);
+
+    // madvise requires an address aligned to the OS page size
+    static const uint64_t os_page = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+    uint64_t aligned = offset & ~(os_page - 1);
+    ::madvise(const_cast<uint8_t*>(data_ + aligned),
+              static_cast<size_t>(length + (offset - aligned)), MADV_WILLNEED);
+}
+
+#endif
+
+const uint8_t* MappedStripe::page_at(uint64_t offset) const {
+    return view(offset, PAGE_SIZE);
+}
+
+}  // namespace bakread
@@ -1,22 +1,243 @@
 #include "bakread/page_index.h"
+#include "bakread/error.h"
 #include "bakread/logging.h"
 
+#include <algorithm>
 #include <fstream>
+#include <utility>
 #include <cstring>
 
 namespace bakread {
 
+static constexpr uint32_t INDEX_VERSION = 3;
+
+// -------------------------------------------------------------------------
+// Building
+// -------------------------------------------------------------------------
+
+size_t PageIndex::map_of(int64_t key) {
+    // Fibonacci hash: neighbouring pages land in different maps
+    return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> 60)
+           % MAP_SHARDS;
+}
+
 void PageIndex::add_entry(int32_t file_id, int32_t page_id, const PageIndexEntry& entry) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    if (sealed_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sealed_.load(std::memory_order_relaxed)) unseal_locked();
+    }
     int64_t key = make_page_key(file_id, page_id);
-    entries_[key] = entry;
+    BuildMap& map = maps_[map_of(key)];
+    std::lock_guard<std::mutex> lock(map.mutex);
+    map.entries[key] = entry;
 }
 
-bool PageIndex::lookup(int32_t file_id, int32_t page_id, PageIndexEntry& entry) const {
+void PageIndex::add_shard(std::vector<PageIndexRecord>&& shard) {
+    if (shard.empty()) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sealed_.load(std::memory_order_relaxed)) unseal_locked();
+    shards_.push_back(std::move(shard));
+}
+
+void PageIndex::add_blocks(std::vector<CompressedBlockRange>&& blocks) {
+    if (blocks.empty()) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sealed_.load(std::memory_order_relaxed)) unseal_locked();
+    pending_blocks_.insert(pending_blocks_.end(), blocks.begin(), blocks.end());
+}
+
+void PageIndex::add_row_stats(std::vector<ObjectRowStats>&& stats) {
+    if (stats.empty()) return;
     std::lock_guard<std::mutex> lock(mutex_);
+    if (sealed_.load(std::memory_order_relaxed)) unseal_locked();
+    pending_row_stats_.insert(pending_row_stats_.end(), stats.begin(), stats.end());
+}
+
+void PageIndex::visit_maps(const std::function<void(int64_t, const PageIndexEntry&)>& fn) const {
+    for (const auto& map : maps_) {
+        std::lock_guard<std::mutex> lock(map.mutex);
+        for (const auto& [key, entry] : map.entries) fn(key, entry);
+    }
+}
+
+size_t PageIndex::map_entries() const {
+    size_t total = 0;
+    for (const auto& map : maps_) {
+        std::lock_guard<std::mutex> lock(map.mutex);
+        total += map.entries.size();
+    }
+    return total;
+}
+
+void PageIndex::clear_maps() {
+    for (auto& map : maps_) {
+        std::lock_guard<std::mutex> lock(map.mutex);
+        map.entries.clear();
+        map.entries.rehash(0);
+    }
+}
+
+std::vector<PageIndexRecord> PageIndex::collect_locked() const {
+    size_t total = map_entries();
+    for (const auto& shard : shards_) total += shard.size();
+
+    std::vector<PageIndexRecord> records;
+    records.reserve(total);
+    visit_maps([&](int64_t key, const PageIndexEntry& entry) {
+        records.push_back({key, entry});
+    });
+    for (const auto& shard : shards_) {
+        records.insert(records.end(), shard.begin(), shard.end());
+    }
+    return records;
+}
+
+PageIndex::SortedIndex PageIndex::build_sorted(std::vector<PageIndexRecord> records) {
+    // Duplicates sort last-wins by (stripe, offset) so shard order never matters
+    std::sort(records.begin(), records.end(),
+              [](const PageIndexRecord& a, const PageIndexRecord& b) {
+                  if (a.key != b.key) return a.key < b.key;
+                  if (a.entry.stripe_index != b.entry.stripe_index)
+                      return a.entry.stripe_index < b.entry.stripe_index;
+                  return a.entry.file_offset < b.entry.file_offset;
+              });
+    auto last = std::unique(records.rbegin(), records.rend(),
+                            [](const PageIndexRecord& a, const PageIndexRecord& b) {
+                                return a.key == b.key;
+                            });
+    records.erase(records.begin(), last.base());
+
+    SortedIndex out;
+    out.records = std::move(records);
+
+    // Stable order by object keeps each object's keys sorted
+    std::vector<uint32_t> order(out.records.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<uint32_t>(i);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return out.records[a].entry.object_id < out.records[b].entry.object_id;
+    });
+
+    out.object_keys.reserve(order.size());
+    for (uint32_t i : order) {
+        const PageIndexRecord& rec = out.records[i];
+        if (out.objects.empty() || out.objects.back().object_id != rec.entry.object_id) {
+            out.objects.push_back({rec.entry.object_id, 0, out.object_keys.size()});
+        }
+        out.objects.back().count++;
+        out.object_keys.push_back(rec.key);
+    }
+    return out;
+}
+
+void PageIndex::seal() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sealed_.load(std::memory_order_relaxed)) return;
+
+    SortedIndex sorted = build_sorted(collect_locked());
+    sorted.blocks = sorted_blocks(std::move(pending_blocks_));
+    sorted.row_stats = merged_row_stats(std::move(pending_row_stats_));
+    clear_maps();
+    shards_.clear();
+    pending_blocks_.clear();
+    pending_row_stats_.clear();
+    adopt_locked(std::move(sorted));
+
+    LOG_DEBUG("Page index sealed: %zu entries, %zu objects, %zu compressed blocks",
+              record_count_, object_count_, block_count_);
+}
+
+void PageIndex::adopt_locked(SortedIndex sorted) {
+    reset_sealed();
+    owned_        = std::move(sorted);
+    records_      = owned_.records.data();
+    record_count_ = owned_.records.size();
+    objects_      = owned_.objects.data();
+    object_count_ = owned_.objects.size();
+    object_keys_  = owned_.object_keys.data();
+    blocks_       = owned_.blocks.data();
+    block_count_  = owned_.blocks.size();
+    row_stats_    = owned_.row_stats.data();
+    row_stat_count_ = owned_.row_stats.size();
+    sealed_.store(true, std::memory_order_release);
+}
+
+std::vector<CompressedBlockRange> PageIndex::sorted_blocks(std::vector<CompressedBlockRange> blocks) {
+    std::sort(blocks.begin(), blocks.end(),
+              [](const CompressedBlockRange& a, const CompressedBlockRange& b) {
+                  if (a.stripe_index != b.stripe_index) return a.stripe_index < b.stripe_index;
+                  return a.block_offset < b.block_offset;
+              });
+    return blocks;
+}
+
+std::vector<ObjectRowStats> PageIndex::merged_row_stats(std::vector<ObjectRowStats> stats) {
+    std::sort(stats.begin(), stats.end(),
+              [](const ObjectRowStats& a, const ObjectRowStats& b) {
+                  return a.object_id < b.object_id;
+              });
+    std::vector<ObjectRowStats> merged;
+    for (const ObjectRowStats& s : stats) {
+        if (merged.empty() || merged.back().object_id != s.object_id) {
+            merged.push_back(s);
+        } else {
+            merged.back().data_pages += s.data_pages;
+            merged.back().slot_count += s.slot_count;
+        }
+    }
+    return merged;
+}
+
+void PageIndex::unseal_locked() {
+    for (size_t i = 0; i < record_count_; ++i) {
+        BuildMap& map = maps_[map_of(records_[i].key)];
+        std::lock_guard<std::mutex> lock(map.mutex);
+        map.entries[records_[i].key] = records_[i].entry;
+    }
+    pending_blocks_.insert(pending_blocks_.end(), blocks_, blocks_ + block_count_);
+    pending_row_stats_.insert(pending_row_stats_.end(), row_stats_, row_stats_ + row_stat_count_);
+    reset_sealed();
+}
+
+void PageIndex::reset_sealed() {
+    sealed_.store(false, std::memory_order_release);
+    records_      = nullptr;
+    record_count_ = 0;
+    objects_      = nullptr;
+    object_count_ = 0;
+    object_keys_  = nullptr;
+    blocks_       = nullptr;
+    block_count_  = 0;
+    row_stats_    = nullptr;
+    row_stat_count_ = 0;
+    owned_        = SortedIndex{};
+    mapping_.reset();
+}
+
+// -------------------------------------------------------------------------
+// Queries
+// -------------------------------------------------------------------------
+
+const PageIndexRecord* PageIndex::find(int64_t key) const {
+    const PageIndexRecord* end = records_ + record_count_;
+    const PageIndexRecord* it = std::lower_bound(
+        records_, end, key,
+        [](const PageIndexRecord& r, int64_t k) { return r.key < k; });
+    return (it != end && it->key == key) ? it : nullptr;
+}
+
+bool PageIndex::lookup(int32_t file_id, int32_t page_id, PageIndexEntry& entry) const {
     int64_t key = make_page_key(file_id, page_id);
-    auto it = entries_.find(key);
-    if (it != entries_.end()) {
+    if (sealed_.load(std::memory_order_acquire)) {
+        const PageIndexRecord* rec = find(key);
+        if (!rec) return false;
+        entry = rec->entry;
+        return true;
+    }
+
+    const BuildMap& map = maps_[map_of(key)];
+    std::lock_guard<std::mutex> lock(map.mutex);
+    auto it = map.entries.find(key);
+    if (it != map.entries.end()) {
         entry = it->second;
         return true;
     }
@@ -24,66 +245,225 @@ bool PageIndex::lookup(int32_t file_id, int32_t page_id, PageIndexEntry& entry)
 }
 
 bool PageIndex::contains(int32_t file_id, int32_t page_id) const {
-    std::lock_guard<std::mutex> lock(mutex_);
     int64_t key = make_page_key(file_id, page_id);
-    return entries_.find(key) != entries_.end();
+    if (sealed_.load(std::memory_order_acquire)) return find(key) != nullptr;
+
+    const BuildMap& map = maps_[map_of(key)];
+    std::lock_guard<std::mutex> lock(map.mutex);
+    return map.entries.find(key) != map.entries.end();
+}
+
+const CompressedBlockRange* PageIndex::find_block(uint8_t stripe_index,
+                                                  uint64_t block_offset) const {
+    if (!sealed_.load(std::memory_order_acquire)) return nullptr;
+    const CompressedBlockRange* end = blocks_ + block_count_;
+    const CompressedBlockRange* it = std::lower_bound(
+        blocks_, end, std::make_pair(stripe_index, block_offset),
+        [](const CompressedBlockRange& b, const std::pair<uint8_t, uint64_t>& k) {
+            return b.stripe_index != k.first ? b.stripe_index < k.first
+                                             : b.block_offset < k.second;
+        });
+    return (it != end && it->stripe_index == stripe_index && it->block_offset == block_offset)
+        ? it : nullptr;
 }
 
 std::vector<int64_t> PageIndex::get_pages_by_type(IndexedPageType type) const {
-    std::lock_guard<std::mutex> lock(mutex_);
     std::vector<int64_t> result;
-    for (const auto& [key, entry] : entries_) {
-        if (entry.page_type == static_cast<uint8_t>(type)) {
-            result.push_back(key);
+    if (sealed_.load(std::memory_order_acquire)) {
+        for (size_t i = 0; i < record_count_; ++i) {
+            if (records_[i].entry.page_type == static_cast<uint8_t>(type)) {
+                result.push_back(records_[i].key);
+            }
         }
+        return result;
     }
+
+    visit_maps([&](int64_t key, const PageIndexEntry& entry) {
+        if (entry.page_type == static_cast<uint8_t>(type)) result.push_back(key);
+    });
     return result;
 }
 
 std::vector<int64_t> PageIndex::get_pages_by_object(uint32_t object_id) const {
-    std::lock_guard<std::mutex> lock(mutex_);
     std::vector<int64_t> result;
-    for (const auto& [key, entry] : entries_) {
-        if (entry.object_id == object_id) {
-            result.push_back(key);
+    if (sealed_.load(std::memory_order_acquire)) {
+        const ObjectPageRange* end = objects_ + object_count_;
+        const ObjectPageRange* it = std::lower_bound(
+            objects_, end, object_id,
+            [](const ObjectPageRange& r, uint32_t id) { return r.object_id < id; });
+        if (it != end && it->object_id == object_id) {
+            result.assign(object_keys_ + it->first, object_keys_ + it->first + it->count);
         }
+        return result;
     }
+
+    visit_maps([&](int64_t key, const PageIndexEntry& entry) {
+        if (entry.object_id == object_id) result.push_back(key);
+    });
     return result;
 }
 
+size_t PageIndex::count_pages_by_object(uint32_t object_id) const {
+    if (sealed_.load(std::memory_order_acquire)) {
+        const ObjectPageRange* end = objects_ + object_count_;
+        const ObjectPageRange* it = std::lower_bound(
+            objects_, end, object_id,
+            [](const ObjectPageRange& r, uint32_t id) { return r.object_id < id; });
+        return (it != end && it->object_id == object_id) ? it->count : 0;
+    }
+
+    size_t count = 0;
+    visit_maps([&](int64_t, const PageIndexEntry& entry) {
+        if (entry.object_id == object_id) ++count;
+    });
+    return count;
+}
+
+bool PageIndex::row_stats(uint32_t object_id, ObjectRowStats& out) const {
+    out = ObjectRowStats{object_id, 0, 0};
+    if (sealed_.load(std::memory_order_acquire)) {
+        if (!has_row_stats_) return false;
+        const ObjectRowStats* end = row_stats_ + row_stat_count_;
+        const ObjectRowStats* it = std::lower_bound(
+            row_stats_, end, object_id,
+            [](const ObjectRowStats& s, uint32_t id) { return s.object_id < id; });
+        if (it != end && it->object_id == object_id) out = *it;
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!has_row_stats_) return false;
+    for (const ObjectRowStats& s : pending_row_stats_) {
+        if (s.object_id != object_id) continue;
+        out.data_pages += s.data_pages;
+        out.slot_count += s.slot_count;
+    }
+    return true;
+}
+
+void PageIndex::sort_by_location(std::vector<int64_t>& keys) const {
+    struct Located {
+        uint64_t offset;
+        uint16_t block_offset;
+        uint8_t  stripe;
+        int64_t  key;
+    };
+    std::vector<Located> located;
+    located.reserve(keys.size());
+    for (int64_t key : keys) {
+        int32_t file_id, page_id;
+        split_page_key(key, file_id, page_id);
+        PageIndexEntry entry;
+        if (!lookup(file_id, page_id, entry)) continue;
+        located.push_back({ entry.file_offset, entry.block_offset, entry.stripe_index, key });
+    }
+
+    // Stripes of one backup are written in step, so equal offsets across
+    // stripes are close in time; interleaving them keeps all stripes busy
+    std::sort(located.begin(), located.end(), [](const Located& a, const Located& b) {
+        if (a.offset != b.offset) return a.offset < b.offset;
+        if (a.block_offset != b.block_offset) return a.block_offset < b.block_offset;
+        return a.stripe < b.stripe;
+    });
+
+    keys.clear();
+    for (const Located& l : located) keys.push_back(l.key);
+}
+
 size_t PageIndex::size() const {
+    if (sealed_.load(std::memory_order_acquire)) return record_count_;
     std::lock_guard<std::mutex> lock(mutex_);
-    return entries_.size();
+    // Unsealed shards may still hold duplicate keys; this is an upper bound
+    size_t total = map_entries();
+    for (const auto& shard : shards_) total += shard.size();
+    return total;
 }
 
 size_t PageIndex::memory_usage_bytes() const {
+    if (sealed_.load(std::memory_order_acquire)) {
+        // Mapped arrays are file-backed page cache, owned ones are heap
+        return record_count_ * sizeof(PageIndexRecord) +
+               object_count_ * sizeof(ObjectPageRange) +
+               record_count_ * sizeof(int64_t) +
+               block_count_ * sizeof(CompressedBlockRange) +
+               row_stat_count_ * sizeof(ObjectRowStats) + sizeof(PageIndex);
+    }
     std::lock_guard<std::mutex> lock(mutex_);
     // Estimate: key (8) + entry (16) + hash overhead (~16)
-    return entries_.size() * 40 + sizeof(PageIndex);
+    size_t bytes = map_entries() * 40 + sizeof(PageIndex) +
+                   pending_blocks_.capacity() * sizeof(CompressedBlockRange) +
+                   pending_row_stats_.capacity() * sizeof(ObjectRowStats);
+    for (const auto& shard : shards_) bytes += shard.capacity() * sizeof(PageIndexRecord);
+    return bytes;
 }
 
 void PageIndex::clear() {
     std::lock_guard<std::mutex> lock(mutex_);
-    entries_.clear();
+    reset_sealed();
+    clear_maps();
+    shards_.clear();
+    pending_blocks_.clear();
+    pending_row_stats_.clear();
+    has_row_stats_ = true;
 }
 
 std::vector<int64_t> PageIndex::get_system_pages() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto is_system = [](uint8_t page_type) {
+        auto type = static_cast<IndexedPageType>(page_type);
+        return type == IndexedPageType::System ||
+               type == IndexedPageType::Boot ||
+               type == IndexedPageType::FileHeader;
+    };
+
     std::vector<int64_t> result;
-    for (const auto& [key, entry] : entries_) {
-        auto type = static_cast<IndexedPageType>(entry.page_type);
-        if (type == IndexedPageType::System ||
-            type == IndexedPageType::Boot ||
-            type == IndexedPageType::FileHeader) {
-            result.push_back(key);
+    if (sealed_.load(std::memory_order_acquire)) {
+        for (size_t i = 0; i < record_count_; ++i) {
+            if (is_system(records_[i].entry.page_type)) {
+                result.push_back(records_[i].key);
+            }
         }
+        return result;
     }
+
+    visit_maps([&](int64_t key, const PageIndexEntry& entry) {
+        if (is_system(entry.page_type)) result.push_back(key);
+    });
     return result;
 }
 
+// -------------------------------------------------------------------------
+// Persistence
+// -------------------------------------------------------------------------
+
 bool PageIndex::save_to_file(const std::string& path) const {
     std::lock_guard<std::mutex> lock(mutex_);
 
+    // An unsealed index is sorted into temporaries just for the write
+    SortedIndex temp;
+    const PageIndexRecord* records = records_;
+    size_t                 count   = record_count_;
+    const ObjectPageRange* objects = objects_;
+    size_t                 nobj    = object_count_;
+    const int64_t*         okeys   = object_keys_;
+    const CompressedBlockRange* blocks = blocks_;
+    size_t                 nblk    = block_count_;
+    const ObjectRowStats*  stats   = row_stats_;
+    uint64_t               nstat   = row_stat_count_;
+    if (!sealed_.load(std::memory_order_relaxed)) {
+        temp    = build_sorted(collect_locked());
+        temp.blocks = sorted_blocks(pending_blocks_);
+        temp.row_stats = merged_row_stats(pending_row_stats_);
+        blocks  = temp.blocks.data();
+        nblk    = temp.blocks.size();
+        stats   = temp.row_stats.data();
+        nstat   = temp.row_stats.size();
+        records = temp.records.data();
+        count   = temp.records.size();
+        objects = temp.objects.data();
+        nobj    = temp.objects.size();
+        okeys   = temp.object_keys.data();
+    }
+
     std::ofstream file(path, std::ios::binary);
     if (!file.is_open()) {
         LOG_ERROR("Failed to create index file: %s", path.c_str());
@@ -93,29 +473,44 @@ bool PageIndex::save_to_file(const std::string& path) const {
     // Build header
     IndexFileHeader header{};
     std::memcpy(header.magic, "BAKRIDX", 8);
-    header.version = 1;
-    header.entry_count = static_cast<uint32_t>(entries_.size());
-    header.total_pages = entries_.size();
+    header.version = INDEX_VERSION;
+    header.entry_count = static_cast<uint32_t>(count);
+    header.total_pages = count;
+    header.object_count = static_cast<uint32_t>(nobj);
+    header.objects_offset = sizeof(IndexFileHeader) + count * sizeof(PageIndexRecord);
+    header.object_keys_offset = header.objects_offset + nobj * sizeof(ObjectPageRange);
+    header.block_count = static_cast<uint32_t>(nblk);
 
     // Count page types
-    for (const auto& [key, entry] : entries_) {
-        if (entry.page_type == static_cast<uint8_t>(IndexedPageType::Data)) {
+    for (size_t i = 0; i < count; ++i) {
+        if (records[i].entry.page_type == static_cast<uint8_t>(IndexedPageType::Data)) {
             header.data_pages++;
-        } else if (entry.page_type == static_cast<uint8_t>(IndexedPageType::System)) {
+        } else if (records[i].entry.page_type == static_cast<uint8_t>(IndexedPageType::System)) {
             header.system_pages++;
         }
     }
 
-    // Write header
+    // Header, then the sorted sections exactly as they are in memory
     file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records),
+               static_cast<std::streamsize>(count * sizeof(PageIndexRecord)));
+    file.write(reinterpret_cast<const char*>(objects),
+               static_cast<std::streamsize>(nobj * sizeof(ObjectPageRange)));
+    file.write(reinterpret_cast<const char*>(okeys),
+               static_cast<std::streamsize>(count * sizeof(int64_t)));
+    file.write(reinterpret_cast<const char*>(blocks),
+               static_cast<std::streamsize>(nblk * sizeof(CompressedBlockRange)));
+    file.write(reinterpret_cast<const char*>(&nstat), sizeof(nstat));
+    file.write(reinterpret_cast<const char*>(stats),
+               static_cast<std::streamsize>(nstat * sizeof(ObjectRowStats)));
 
-    // Write entries as (key, entry) pairs
-    for (const auto& [key, entry] : entries_) {
-        file.write(reinterpret_cast<const char*>(&key), sizeof(key));
-        file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    if (!file) {
+        LOG_ERROR("Failed to write index file: %s", path.c_str());
+        return false;
     }
 
-    LOG_INFO("Saved page index: %zu entries to %s", entries_.size(), path.c_str());
+    LOG_INFO("Saved page index: %zu entries, %zu objects, %zu compressed blocks to %s",
+             count, nobj, nblk, path.c_str());
     return true;
 }
 
@@ -137,24 +532,129 @@ bool PageIndex::load_from_file(const std::string& path) {
         return false;
     }
 
-    if (header.version != 1) {
-        LOG_ERROR("Unsupported index version %u: %s", header.version, path.c_str());
+    reset_sealed();
+    clear_maps();
+    shards_.clear();
+    pending_row_stats_.clear();
+
+    // Indexes written before v3 carry no row statistics
+    has_row_stats_ = header.version >= 3;
+
+    if (header.version == 1) {
+        return load_v1(file, header.entry_count, path);
+    }
+    if (header.version == 2 || header.version == 3) {
+        file.close();
+        return load_v2(path, header.version);
+    }
+
+    LOG_ERROR("Unsupported index version %u: %s", header.version, path.c_str());
+    return false;
+}
+
+bool PageIndex::load_v1(std::ifstream& file, uint32_t entry_count, const std::string& path) {
+    std::vector<PageIndexRecord> records(entry_count);
+
+    for (auto& rec : records) {
+        file.read(reinterpret_cast<char*>(&rec.key), sizeof(rec.key));
+        file.read(reinterpret_cast<char*>(&rec.entry), sizeof(rec.entry));
+        if (!file) {
+            LOG_ERROR("Truncated index file: %s", path.c_str());
+            return false;
+        }
+    }
+
+    // v1 entries are unsorted; sort once so lookups take the sealed path
+    adopt_locked(build_sorted(std::move(records)));
+
+    LOG_INFO("Loaded v1 page index: %zu entries from %s", record_count_, path.c_str());
+    return true;
+}
+
+// n elements of T at `offset` in the mapping, or nullptr if they do not fit
+// or are misaligned. n is checked against the file size before it is
+// multiplied, so a corrupt count cannot wrap the length.
+template <typename T>
+static const T* mapped_array(const MappedStripe& map, uint64_t offset, uint64_t n) {
+    if (n > map.size() / sizeof(T) || offset % alignof(T) != 0) return nullptr;
+    return reinterpret_cast<const T*>(map.view(offset, static_cast<size_t>(n * sizeof(T))));
+}
+
+bool PageIndex::load_v2(const std::string& path, uint32_t version) {
+    std::unique_ptr<MappedStripe> map;
+    try {
+        map = std::make_unique<MappedStripe>(path);
+    } catch (const FileIOError& e) {
+        LOG_WARN("Index file not mapped: %s", e.what());
         return false;
     }
 
-    // Read entries
-    entries_.clear();
-    entries_.reserve(header.entry_count);
+    const auto* header = reinterpret_cast<const IndexFileHeader*>(
+        map->view(0, sizeof(IndexFileHeader)));
+    if (!header) {
+        LOG_ERROR("Truncated index file: %s", path.c_str());
+        return false;
+    }
 
-    for (uint32_t i = 0; i < header.entry_count; ++i) {
-        int64_t key;
-        PageIndexEntry entry;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key));
-        file.read(reinterpret_cast<char*>(&entry), sizeof(entry));
-        entries_[key] = entry;
+    // Each table must lie inside the file; the block table (and in v3 the
+    // row statistics) follow the key array, so they are placed only once
+    // the array before them is known to fit
+    const uint64_t count = header->entry_count;
+    const uint64_t nobj  = header->object_count;
+    const uint64_t nblk  = header->block_count;
+    const auto* records = mapped_array<PageIndexRecord>(*map, sizeof(IndexFileHeader), count);
+    const auto* objects = mapped_array<ObjectPageRange>(*map, header->objects_offset, nobj);
+    const auto* okeys   = mapped_array<int64_t>(*map, header->object_keys_offset, count);
+    const CompressedBlockRange* blocks = nullptr;
+    if (okeys) {
+        blocks = mapped_array<CompressedBlockRange>(
+            *map, header->object_keys_offset + count * sizeof(int64_t), nblk);
+    }
+    if (!records || !objects || !okeys || !blocks) {
+        LOG_ERROR("Corrupt or truncated index file: %s", path.c_str());
+        return false;
     }
 
-    LOG_INFO("Loaded page index: %zu entries from %s", entries_.size(), path.c_str());
+    // Object ranges index the key array
+    for (uint64_t i = 0; i < nobj; ++i) {
+        if (objects[i].first > count || objects[i].count > count - objects[i].first) {
+            LOG_ERROR("Corrupt index file (object range out of bounds): %s", path.c_str());
+            return false;
+        }
+    }
+
+    // v3: row statistics behind the block table
+    uint64_t nstat = 0;
+    const ObjectRowStats* stats = nullptr;
+    if (version >= 3) {
+        const uint64_t stats_offset = header->object_keys_offset + count * sizeof(int64_t) +
+                                      nblk * sizeof(CompressedBlockRange);
+        const uint8_t* count_at = map->view(stats_offset, sizeof(uint64_t));
+        if (count_at) {
+            std::memcpy(&nstat, count_at, sizeof(nstat));
+            stats = mapped_array<ObjectRowStats>(*map, stats_offset + sizeof(uint64_t), nstat);
+        }
+        if (!stats) {
+            LOG_ERROR("Corrupt or truncated index file: %s", path.c_str());
+            return false;
+        }
+    }
+
+    records_      = records;
+    record_count_ = count;
+    objects_      = objects;
+    object_count_ = nobj;
+    object_keys_  = okeys;
+    blocks_       = nblk > 0 ? blocks : nullptr;
+    block_count_  = nblk;
+    row_stats_    = nstat > 0 ? stats : nullptr;
+    row_stat_count_ = nstat;
+    map->advise(MappedStripe::Access::Random);
+    mapping_      = std::move(map);
+    sealed_.store(true, std::memory_order_release);
+
+    LOG_INFO("Mapped page index: %zu entries, %zu objects, %zu compressed blocks from %s",
+             record_count_, object_count_, block_count_, path.c_str());
     return true;
 }
 
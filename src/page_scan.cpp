@@ -0,0 +1,85 @@
+#include "bakread/page_scan.h"
+#include "bakread/cpu_features.h"
+
+#ifdef BAKREAD_HAS_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace bakread {
+
+// -------------------------------------------------------------------------
+// Kernels: fill mask bits [first, last) for candidates at chunk + i * stride
+// -------------------------------------------------------------------------
+
+static void classify_scalar(const uint8_t* chunk, size_t stride, size_t first, size_t last,
+                            uint64_t* mask) {
+    for (size_t i = first; i < last; ++i) {
+        uint64_t ok = page_header_plausible(chunk + i * stride) ? 1 : 0;
+        mask[i / 64] |= ok << (i % 64);
+    }
+}
+
+#ifdef BAKREAD_HAS_AVX2_KERNELS
+// Eight candidates per step: each header field is gathered from eight
+// pages into one register and range-checked with signed compares (all
+// fields are at most 16 bits wide, so they never look negative)
+BAKREAD_TARGET_AVX2
+static size_t classify_avx2(const uint8_t* chunk, size_t stride, size_t count, uint64_t* mask) {
+    const int s = static_cast<int>(stride);
+    const __m256i index = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+    const __m256i byte  = _mm256_set1_epi32(0xFF);
+    const __m256i half  = _mm256_set1_epi32(0xFFFF);
+    const __m256i one   = _mm256_set1_epi32(1);
+    const __m256i zero  = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const int* base = reinterpret_cast<const int*>(chunk + i * stride);
+        __m256i w0    = _mm256_i32gather_epi32(base, index, 1);
+        __m256i slots = _mm256_i32gather_epi32(reinterpret_cast<const int*>(
+                            reinterpret_cast<const uint8_t*>(base) + 0x14), index, 1);
+        __m256i freec = _mm256_i32gather_epi32(reinterpret_cast<const int*>(
+                            reinterpret_cast<const uint8_t*>(base) + 0x1C), index, 1);
+        __m256i file  = _mm256_i32gather_epi32(reinterpret_cast<const int*>(
+                            reinterpret_cast<const uint8_t*>(base) + 0x24), index, 1);
+
+        __m256i version = _mm256_and_si256(w0, byte);
+        __m256i type    = _mm256_and_si256(_mm256_srli_epi32(w0, 8), byte);
+        slots = _mm256_srli_epi32(slots, 16);
+        freec = _mm256_and_si256(freec, half);
+        file  = _mm256_and_si256(file, half);
+
+        __m256i ok = _mm256_cmpeq_epi32(version, one);
+        ok = _mm256_and_si256(ok, _mm256_cmpgt_epi32(type, zero));
+        ok = _mm256_and_si256(ok, _mm256_cmpgt_epi32(_mm256_set1_epi32(18), type));
+        ok = _mm256_and_si256(ok, _mm256_cmpgt_epi32(file, zero));
+        ok = _mm256_and_si256(ok, _mm256_cmpgt_epi32(_mm256_set1_epi32(33), file));
+        ok = _mm256_and_si256(ok, _mm256_cmpgt_epi32(_mm256_set1_epi32(1001), slots));
+        ok = _mm256_and_si256(ok, _mm256_cmpgt_epi32(
+                 _mm256_set1_epi32(static_cast<int>(PAGE_SIZE) + 1), freec));
+
+        uint64_t bits = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(ok)));
+        mask[i / 64] |= bits << (i % 64);   // i % 64 is a multiple of 8
+    }
+    return i;
+}
+#endif
+
+size_t classify_page_headers(const uint8_t* chunk, size_t len, size_t stride,
+                             std::vector<uint64_t>& mask) {
+    const size_t count = len >= PAGE_SIZE ? (len - PAGE_SIZE) / stride + 1 : 0;
+    mask.assign((count + 63) / 64, 0);
+    if (count == 0) return 0;
+
+    size_t done = 0;
+#ifdef BAKREAD_HAS_AVX2_KERNELS
+    // Gather indices are 32-bit: 7 * stride must fit
+    if (stride <= PAGE_SIZE && cpu_has_avx2()) {
+        done = classify_avx2(chunk, stride, count, mask.data());
+    }
+#endif
+    classify_scalar(chunk, stride, done, count, mask.data());
+    return count;
+}
+
+}  // namespace bakread
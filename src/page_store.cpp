@@ -0,0 +1,370 @@
+#include "bakread/page_store.h"
+#include "bakread/error.h"
+#include "bakread/logging.h"
+#include "bakread/page.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace bakread {
+
+namespace {
+
+inline uint64_t hash_key(int64_t key) {
+    // splitmix64 finalizer: page ids are sequential, so spread them out
+    uint64_t x = static_cast<uint64_t>(key);
+    x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27; x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+constexpr size_t INITIAL_CAPACITY = 1024;
+
+}  // namespace
+
+PageStore::PageStore(const PageStoreConfig& config)
+    : config_(config)
+{
+    budget_pages_ = (config_.memory_budget_mb * 1024 * 1024) / PAGE_SIZE;
+    slab_pages_   = std::max<size_t>(1, config_.slab_pages);
+    // Don't reserve a 64MB slab for a budget smaller than that
+    if (budget_pages_ > 0) slab_pages_ = std::min(slab_pages_, budget_pages_);
+
+    table_.assign(INITIAL_CAPACITY, Entry{EMPTY_KEY, 0, 0, 0, Where::Resident, 0});
+}
+
+PageStore::~PageStore() {
+    clear();
+}
+
+void PageStore::set_stripe_paths(const std::vector<std::string>& paths) {
+    std::lock_guard<std::mutex> lock(source_mutex_);
+    stripe_paths_ = paths;
+    stripe_maps_.clear();
+    stripe_maps_.resize(paths.size());
+    stripe_map_failed_.assign(paths.size(), false);
+    stripe_files_.clear();
+    stripe_files_.resize(paths.size());
+}
+
+// -------------------------------------------------------------------------
+// Index
+// -------------------------------------------------------------------------
+
+const PageStore::Entry* PageStore::find(int64_t key) const {
+    size_t mask = table_.size() - 1;
+    size_t i = hash_key(key) & mask;
+    while (true) {
+        const Entry& e = table_[i];
+        if (e.key == key) return &e;
+        if (e.key == EMPTY_KEY) return nullptr;
+        i = (i + 1) & mask;
+    }
+}
+
+PageStore::Entry* PageStore::insert_slot(int64_t key) {
+    if ((count_ + 1) * 4 > table_.size() * 3) grow();
+
+    size_t mask = table_.size() - 1;
+    size_t i = hash_key(key) & mask;
+    while (true) {
+        Entry& e = table_[i];
+        if (e.key == key) return nullptr;
+        if (e.key == EMPTY_KEY) return &e;
+        i = (i + 1) & mask;
+    }
+}
+
+void PageStore::grow() {
+    std::vector<Entry> old;
+    old.swap(table_);
+    table_.assign(old.size() * 2, Entry{EMPTY_KEY, 0, 0, 0, Where::Resident, 0});
+
+    size_t mask = table_.size() - 1;
+    for (const auto& e : old) {
+        if (e.key == EMPTY_KEY) continue;
+        size_t i = hash_key(e.key) & mask;
+        while (table_[i].key != EMPTY_KEY) i = (i + 1) & mask;
+        table_[i] = e;
+    }
+}
+
+// -------------------------------------------------------------------------
+// Slabs
+// -------------------------------------------------------------------------
+
+uint8_t* PageStore::allocate_slot(uint64_t& out_slot) {
+    if (used_slots_ >= budget_pages_) return nullptr;
+
+    size_t slab = used_slots_ / slab_pages_;
+    if (slab >= slabs_.size()) {
+        size_t pages = std::min(slab_pages_, budget_pages_ - used_slots_);
+        slabs_.emplace_back(new uint8_t[pages * PAGE_SIZE]);
+    }
+
+    out_slot = used_slots_++;
+    return slabs_[slab].get() + (out_slot % slab_pages_) * PAGE_SIZE;
+}
+
+uint8_t* PageStore::slot_ptr(uint64_t slot) {
+    return slabs_[slot / slab_pages_].get() + (slot % slab_pages_) * PAGE_SIZE;
+}
+
+const uint8_t* PageStore::slot_ptr(uint64_t slot) const {
+    return slabs_[slot / slab_pages_].get() + (slot % slab_pages_) * PAGE_SIZE;
+}
+
+// -------------------------------------------------------------------------
+// Public API
+// -------------------------------------------------------------------------
+
+bool PageStore::put(int64_t key, const uint8_t* page_data,
+                    const PageLocation& location) {
+    Entry* e = insert_slot(key);
+    if (!e) return false;
+
+    PageHeader hdr;
+    std::memcpy(&hdr, page_data, sizeof(hdr));
+
+    Entry entry{key, 0, hdr.obj_id, hdr.type, Where::Resident, hdr.slot_count};
+    place(entry, page_data, location);
+
+    *e = entry;
+    ++count_;
+    return true;
+}
+
+bool PageStore::put_newest(int64_t key, const uint8_t* page_data,
+                           const PageLocation& location) {
+    Entry* e = const_cast<Entry*>(find(key));
+    if (!e) return put(key, page_data, location);
+
+    PageHeader hdr;
+    std::memcpy(&hdr, page_data, sizeof(hdr));
+
+    PageHeader stored;
+    if (const uint8_t* cur = view(key)) {
+        std::memcpy(&stored, cur, sizeof(stored));
+    } else {
+        std::vector<uint8_t> buf(PAGE_SIZE);
+        if (get(key, buf.data())) std::memcpy(&stored, buf.data(), sizeof(stored));
+        else std::memset(&stored, 0, sizeof(stored));   // Unreadable: replace it
+    }
+    if (!page_lsn_newer(hdr, stored)) return false;
+
+    e->obj_id     = hdr.obj_id;
+    e->page_type  = hdr.type;
+    e->slot_count = hdr.slot_count;
+
+    // A resident copy is overwritten in its own slot
+    if (e->where == Where::Resident) {
+        std::memcpy(slot_ptr(e->loc), page_data, PAGE_SIZE);
+        return true;
+    }
+
+    if (e->where == Where::Reference) --reference_count_;
+    else                              --spill_count_;
+    place(*e, page_data, location);
+    return true;
+}
+
+void PageStore::place(Entry& entry, const uint8_t* page_data, const PageLocation& location) {
+    uint64_t slot = 0;
+    if (uint8_t* dst = allocate_slot(slot)) {
+        std::memcpy(dst, page_data, PAGE_SIZE);
+        entry.where = Where::Resident;
+        entry.loc   = slot;
+        ++resident_count_;
+    } else if (config_.allow_offset_only && location.stripe_index >= 0 &&
+               location.stripe_index < 256 &&
+               static_cast<size_t>(location.stripe_index) < stripe_paths_.size() &&
+               location.file_offset <= REF_OFFSET_MASK) {
+        entry.where = Where::Reference;
+        entry.loc   = (static_cast<uint64_t>(location.stripe_index) << 56) |
+                      location.file_offset;
+        ++reference_count_;
+    } else {
+        uint64_t off = 0;
+        if (!spill(page_data, off)) {
+            throw FileIOError("Page store budget exhausted and spill file unavailable");
+        }
+        entry.where = Where::Spilled;
+        entry.loc   = off;
+        ++spill_count_;
+    }
+
+    if (resident_count_ == budget_pages_ && entry.where == Where::Resident) {
+        LOG_INFO("Page store memory budget reached (%zu MB); further pages %s",
+                 config_.memory_budget_mb,
+                 config_.allow_offset_only ? "are re-read from the backup on demand"
+                                           : "spill to disk");
+    }
+}
+
+bool PageStore::contains(int64_t key) const {
+    return find(key) != nullptr;
+}
+
+bool PageStore::meta(int64_t key, PageMeta& out) const {
+    const Entry* e = find(key);
+    if (!e) return false;
+    out.obj_id     = e->obj_id;
+    out.page_type  = e->page_type;
+    out.slot_count = e->slot_count;
+    return true;
+}
+
+bool PageStore::get(int64_t key, uint8_t* out_page) const {
+    const Entry* e = find(key);
+    if (!e) return false;
+
+    switch (e->where) {
+        case Where::Resident:
+            std::memcpy(out_page, slot_ptr(e->loc), PAGE_SIZE);
+            return true;
+        case Where::Reference:
+            return read_reference(*e, out_page);
+        case Where::Spilled: {
+            std::lock_guard<std::mutex> lock(spill_mutex_);
+            spill_file_.clear();
+            spill_file_.seekg(static_cast<std::streamoff>(e->loc));
+            spill_file_.read(reinterpret_cast<char*>(out_page), PAGE_SIZE);
+            return spill_file_.gcount() == static_cast<std::streamsize>(PAGE_SIZE);
+        }
+    }
+    return false;
+}
+
+const uint8_t* PageStore::view(int64_t key) const {
+    const Entry* e = find(key);
+    if (!e) return nullptr;
+
+    if (e->where == Where::Resident) return slot_ptr(e->loc);
+    if (e->where == Where::Reference) return reference_view(*e);
+    return nullptr;
+}
+
+size_t PageStore::memory_usage_bytes() const {
+    // Slab memory is only committed by the OS as slots are written
+    return used_slots_ * PAGE_SIZE + table_.size() * sizeof(Entry);
+}
+
+void PageStore::clear() {
+    slabs_.clear();
+    used_slots_ = 0;
+    table_.assign(INITIAL_CAPACITY, Entry{EMPTY_KEY, 0, 0, 0, Where::Resident, 0});
+    count_ = resident_count_ = reference_count_ = spill_count_ = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(source_mutex_);
+        for (auto& m : stripe_maps_) m.reset();
+        for (auto& f : stripe_files_) f.reset();
+        stripe_map_failed_.assign(stripe_map_failed_.size(), false);
+    }
+
+    std::lock_guard<std::mutex> lock(spill_mutex_);
+    if (spill_file_.is_open()) spill_file_.close();
+    if (!spill_path_.empty()) {
+        std::error_code ec;
+        fs::remove(spill_path_, ec);
+        spill_path_.clear();
+    }
+    spill_size_ = 0;
+}
+
+// -------------------------------------------------------------------------
+// Offset-only references
+// -------------------------------------------------------------------------
+
+const MappedStripe* PageStore::stripe_map(int stripe_index) const {
+    if (!config_.use_mmap) return nullptr;
+
+    std::lock_guard<std::mutex> lock(source_mutex_);
+    auto idx = static_cast<size_t>(stripe_index);
+    if (idx >= stripe_maps_.size()) return nullptr;
+    if (!stripe_maps_[idx] && !stripe_map_failed_[idx]) {
+        try {
+            stripe_maps_[idx] = std::make_unique<MappedStripe>(stripe_paths_[idx]);
+            stripe_maps_[idx]->advise(MappedStripe::Access::Random);
+        } catch (const BakReadError& e) {
+            LOG_DEBUG("Page store: mmap unavailable for stripe %d (%s)",
+                      stripe_index, e.what());
+            stripe_map_failed_[idx] = true;
+        }
+    }
+    return stripe_maps_[idx].get();
+}
+
+const uint8_t* PageStore::reference_view(const Entry& e) const {
+    int stripe = static_cast<int>(e.loc >> 56);
+    const MappedStripe* map = stripe_map(stripe);
+    return map ? map->page_at(e.loc & REF_OFFSET_MASK) : nullptr;
+}
+
+bool PageStore::read_reference(const Entry& e, uint8_t* out_page) const {
+    if (const uint8_t* p = reference_view(e)) {
+        std::memcpy(out_page, p, PAGE_SIZE);
+        return true;
+    }
+
+    size_t idx = static_cast<size_t>(e.loc >> 56);
+    std::lock_guard<std::mutex> lock(source_mutex_);
+    if (idx >= stripe_files_.size()) return false;
+
+    auto& file = stripe_files_[idx];
+    if (!file) {
+        file = std::make_unique<std::ifstream>(stripe_paths_[idx], std::ios::binary);
+        if (!file->is_open()) {
+            file.reset();
+            return false;
+        }
+    }
+    file->clear();
+    file->seekg(static_cast<std::streamoff>(e.loc & REF_OFFSET_MASK));
+    file->read(reinterpret_cast<char*>(out_page), PAGE_SIZE);
+    return file->gcount() == static_cast<std::streamsize>(PAGE_SIZE);
+}
+
+// -------------------------------------------------------------------------
+// Spill file
+// -------------------------------------------------------------------------
+
+bool PageStore::spill(const uint8_t* page_data, uint64_t& out_offset) {
+    std::lock_guard<std::mutex> lock(spill_mutex_);
+
+    if (!spill_file_.is_open()) {
+        static std::atomic<uint32_t> seq{0};
+        std::error_code ec;
+        fs::path dir = config_.spill_dir.empty()
+            ? fs::temp_directory_path(ec) : fs::path(config_.spill_dir);
+        auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        fs::path path = dir / ("bakread_spill_" + std::to_string(stamp) + "_" +
+                               std::to_string(seq++) + ".pages");
+
+        spill_file_.open(path, std::ios::binary | std::ios::in |
+                               std::ios::out | std::ios::trunc);
+        if (!spill_file_.is_open()) {
+            LOG_ERROR("Cannot create page spill file: %s", path.string().c_str());
+            return false;
+        }
+        spill_path_ = path.string();
+        LOG_INFO("Page store spilling to %s", spill_path_.c_str());
+    }
+
+    spill_file_.clear();
+    spill_file_.seekp(static_cast<std::streamoff>(spill_size_));
+    spill_file_.write(reinterpret_cast<const char*>(page_data), PAGE_SIZE);
+    if (!spill_file_) return false;
+
+    out_offset = spill_size_;
+    spill_size_ += PAGE_SIZE;
+    return true;
+}
+
+}  // namespace bakread
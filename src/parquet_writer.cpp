@@ -2,17 +2,185 @@
 #include "bakread/error.h"
 #include "bakread/logging.h"
 
+#include <algorithm>
+
 #ifdef BAKREAD_HAS_PARQUET
 #include <arrow/api.h>
 #include <arrow/io/api.h>
 #include <arrow/builder.h>
+#include <arrow/util/decimal.h>
 #include <parquet/arrow/writer.h>
 #include <parquet/properties.h>
 #endif
 
 namespace bakread {
 
-ParquetWriter::ParquetWriter() = default;
+#ifdef BAKREAD_HAS_PARQUET
+// -------------------------------------------------------------------------
+// Option and text helpers
+// -------------------------------------------------------------------------
+
+static bool parquet_codec(const std::string& name, parquet::Compression::type& out) {
+    if (name == "snappy")                        out = parquet::Compression::SNAPPY;
+    else if (name == "zstd")                     out = parquet::Compression::ZSTD;
+    else if (name == "lz4")                      out = parquet::Compression::LZ4;
+    else if (name == "gzip")                     out = parquet::Compression::GZIP;
+    else if (name == "brotli")                   out = parquet::Compression::BROTLI;
+    else if (name == "none" || name == "uncompressed") out = parquet::Compression::UNCOMPRESSED;
+    else return false;
+    return true;
+}
+
+// Civil date -> days since 1970-01-01 (Howard Hinnant's days_from_civil)
+static int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// Up to max_digits decimal digits; false if there are none
+static bool read_digits(const char*& p, const char* end, int max_digits, int64_t& value,
+                        int* count = nullptr) {
+    int n = 0;
+    value = 0;
+    while (p < end && n < max_digits && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p++ - '0');
+        ++n;
+    }
+    if (count) *count = n;
+    return n > 0;
+}
+
+static bool read_char(const char*& p, const char* end, char c) {
+    if (p < end && *p == c) { ++p; return true; }
+    return false;
+}
+
+// "YYYY-MM-DD"
+static bool parse_date_text(const char*& p, const char* end, int64_t& days) {
+    int64_t y, m, d;
+    if (!read_digits(p, end, 4, y) || !read_char(p, end, '-') ||
+        !read_digits(p, end, 2, m) || !read_char(p, end, '-') ||
+        !read_digits(p, end, 2, d)) return false;
+    if (m < 1 || m > 12 || d < 1 || d > 31) return false;
+    days = days_from_civil(y, static_cast<unsigned>(m), static_cast<unsigned>(d));
+    return true;
+}
+
+// "HH:MM[:SS[.fffffff]]" -> microseconds since midnight
+static bool parse_time_text(const char*& p, const char* end, int64_t& micros) {
+    int64_t h, mi, sec = 0, frac = 0;
+    int frac_digits = 0;
+    if (!read_digits(p, end, 2, h) || !read_char(p, end, ':') ||
+        !read_digits(p, end, 2, mi)) return false;
+    if (read_char(p, end, ':')) {
+        if (!read_digits(p, end, 2, sec)) return false;
+        if (read_char(p, end, '.')) {
+            read_digits(p, end, 9, frac, &frac_digits);
+            while (p < end && *p >= '0' && *p <= '9') ++p;   // beyond nanoseconds
+        }
+    }
+    while (frac_digits < 6) { frac *= 10; ++frac_digits; }
+    while (frac_digits > 6) { frac /= 10; --frac_digits; }
+    micros = ((h * 60 + mi) * 60 + sec) * 1000000 + frac;
+    return true;
+}
+
+// "YYYY-MM-DD[ |T]HH:MM:SS[.f][ ][+|-HH:MM]" -> microseconds since the epoch, UTC
+static bool parse_timestamp_text(const std::string& text, int64_t& micros) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    int64_t days, tod = 0;
+    if (!parse_date_text(p, end, days)) return false;
+    if (read_char(p, end, ' ') || read_char(p, end, 'T')) {
+        if (!parse_time_text(p, end, tod)) return false;
+    }
+    micros = days * 86400ll * 1000000ll + tod;
+
+    while (read_char(p, end, ' ')) {}
+    if (p < end && (*p == '+' || *p == '-')) {
+        int sign = *p++ == '-' ? -1 : 1;
+        int64_t oh, om = 0;
+        if (!read_digits(p, end, 2, oh)) return false;
+        if (read_char(p, end, ':')) read_digits(p, end, 2, om);
+        micros -= sign * (oh * 60 + om) * 60000000ll;
+    }
+    return true;
+}
+
+// "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx" (braces optional) -> RFC 4122 bytes
+static bool parse_guid_text(const std::string& text, uint8_t out[16]) {
+    int n = 0;
+    for (char c : text) {
+        int v;
+        if (c >= '0' && c <= '9')      v = c - '0';
+        else if (c >= 'a' && c <= 'f') v = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') v = c - 'A' + 10;
+        else if (c == '-' || c == '{' || c == '}') continue;
+        else return false;
+        if (n >= 32) return false;
+        if (n % 2 == 0) out[n / 2] = static_cast<uint8_t>(v << 4);
+        else            out[n / 2] |= static_cast<uint8_t>(v);
+        ++n;
+    }
+    return n == 32;
+}
+
+// Row path: a text value for a typed column (restore mode reads decimal,
+// GUID and date/time columns as text)
+static arrow::Status append_text(arrow::ArrayBuilder* builder, ColumnKind kind,
+                                 const ColumnDef& col, const std::string& text) {
+    switch (kind) {
+    case ColumnKind::Decimal128: {
+        arrow::Decimal128 value;
+        int32_t precision = 0, scale = 0;
+        if (!arrow::Decimal128::FromString(text, &value, &precision, &scale).ok())
+            return builder->AppendNull();
+        auto rescaled = value.Rescale(scale, col.scale);
+        if (!rescaled.ok()) return builder->AppendNull();
+        return static_cast<arrow::Decimal128Builder*>(builder)->Append(*rescaled);
+    }
+    case ColumnKind::Uuid: {
+        uint8_t bytes[16];
+        if (!parse_guid_text(text, bytes)) return builder->AppendNull();
+        return static_cast<arrow::FixedSizeBinaryBuilder*>(builder)->Append(bytes);
+    }
+    case ColumnKind::Date32: {
+        const char* p = text.data();
+        int64_t days;
+        if (!parse_date_text(p, p + text.size(), days)) return builder->AppendNull();
+        return static_cast<arrow::Date32Builder*>(builder)->Append(static_cast<int32_t>(days));
+    }
+    case ColumnKind::TimestampUs: {
+        int64_t micros;
+        if (!parse_timestamp_text(text, micros)) return builder->AppendNull();
+        return static_cast<arrow::TimestampBuilder*>(builder)->Append(micros);
+    }
+    case ColumnKind::Time64Us: {
+        const char* p = text.data();
+        int64_t micros;
+        if (!parse_time_text(p, p + text.size(), micros)) return builder->AppendNull();
+        return static_cast<arrow::Time64Builder*>(builder)->Append(micros);
+    }
+    default:
+        // StringBuilder derives from BinaryBuilder
+        return static_cast<arrow::BinaryBuilder*>(builder)->Append(text);
+    }
+}
+#endif
+
+// -------------------------------------------------------------------------
+// ParquetWriter
+// -------------------------------------------------------------------------
+
+ParquetWriter::ParquetWriter(const ParquetOptions& options)
+    : options_(options)
+{
+}
+
 ParquetWriter::~ParquetWriter() {
     if (open_) close();
 }
@@ -21,6 +189,11 @@ bool ParquetWriter::open(const std::string& path, const TableSchema& schema) {
 #ifdef BAKREAD_HAS_PARQUET
     schema_ = schema;
 
+    parquet::Compression::type codec;
+    if (!parquet_codec(options_.codec, codec)) {
+        throw ExportError("Unknown Parquet compression codec: " + options_.codec);
+    }
+
     arrow_schema_ = build_arrow_schema(schema);
     if (!arrow_schema_) {
         throw ExportError("Failed to build Arrow schema");
@@ -32,18 +205,26 @@ bool ParquetWriter::open(const std::string& path, const TableSchema& schema) {
     }
     output_stream_ = *result;
 
-    // Configure Parquet writer with Snappy compression
-    auto props = parquet::WriterProperties::Builder()
-        .compression(parquet::Compression::SNAPPY)
-        ->build();
+    // One builder flush per row group
+    batch_rows_ = std::max<int64_t>(1, options_.row_group_rows);
+
+    parquet::WriterProperties::Builder props;
+    props.compression(codec);
+    props.max_row_group_length(batch_rows_);
+    if (options_.codec_level > 0) props.compression_level(options_.codec_level);
+    if (!options_.dictionary || !options_.dictionary_columns.empty()) {
+        props.disable_dictionary();
+        for (const auto& name : options_.dictionary_columns) props.enable_dictionary(name);
+    }
 
     auto arrow_props = parquet::ArrowWriterProperties::Builder()
         .store_schema()
+        ->set_use_threads(options_.use_threads)
         ->build();
 
     auto writer_result = parquet::arrow::FileWriter::Open(
         *arrow_schema_, arrow::default_memory_pool(),
-        output_stream_, props, arrow_props);
+        output_stream_, props.build(), arrow_props);
 
     if (!writer_result.ok()) {
         throw ExportError("Cannot create Parquet writer: " +
@@ -67,8 +248,9 @@ bool ParquetWriter::open(const std::string& path, const TableSchema& schema) {
     open_ = true;
     current_batch_size_ = 0;
 
-    LOG_INFO("Parquet writer opened: %s (%zu columns, Snappy compression)",
-             path.c_str(), schema.columns.size());
+    LOG_INFO("Parquet writer opened: %s (%zu columns, %s compression, %lld-row groups%s)",
+             path.c_str(), schema.columns.size(), options_.codec.c_str(),
+             (long long)batch_rows_, options_.use_threads ? ", threaded" : "");
     return true;
 #else
     (void)path; (void)schema;
@@ -84,8 +266,10 @@ bool ParquetWriter::write_row(const Row& row) {
     for (size_t i = 0; i < row.size() && i < builders_.size(); ++i) {
         auto& builder = builders_[i];
         const auto& val = row[i];
+        const ColumnKind kind = kinds_[i];
+        const ColumnDef& col = schema_.columns[i];
 
-        std::visit([&builder](auto&& arg) {
+        std::visit([&](auto&& arg) {
             using T = std::decay_t<decltype(arg)>;
             arrow::Status s;
 
@@ -117,19 +301,21 @@ bool ParquetWriter::write_row(const Row& row) {
                 s = static_cast<arrow::DoubleBuilder*>(builder.get())->Append(arg);
             }
             else if constexpr (std::is_same_v<T, std::string>) {
-                s = static_cast<arrow::StringBuilder*>(builder.get())->Append(arg);
+                s = append_text(builder.get(), kind, col, arg);
             }
             else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
                 s = static_cast<arrow::BinaryBuilder*>(builder.get())->Append(
                     arg.data(), static_cast<int32_t>(arg.size()));
             }
             else if constexpr (std::is_same_v<T, SqlDecimal>) {
-                s = static_cast<arrow::StringBuilder*>(builder.get())->Append(
-                    arg.to_string());
+                uint8_t v[16];
+                arg.unscaled_le(v);
+                s = static_cast<arrow::FixedSizeBinaryBuilder*>(builder.get())->Append(v);
             }
             else if constexpr (std::is_same_v<T, SqlGuid>) {
-                s = static_cast<arrow::StringBuilder*>(builder.get())->Append(
-                    arg.to_string());
+                uint8_t v[16];
+                arg.rfc4122(v);
+                s = static_cast<arrow::FixedSizeBinaryBuilder*>(builder.get())->Append(v);
             }
             else {
                 s = builder->AppendNull();
@@ -141,7 +327,7 @@ bool ParquetWriter::write_row(const Row& row) {
     ++rows_written_;
     ++current_batch_size_;
 
-    if (current_batch_size_ >= BATCH_SIZE) {
+    if (current_batch_size_ >= batch_rows_) {
         flush_batch();
     }
 
@@ -152,6 +338,122 @@ bool ParquetWriter::write_row(const Row& row) {
 #endif
 }
 
+#ifdef BAKREAD_HAS_PARQUET
+bool ParquetWriter::write_columns(const ColumnBatch& batch) {
+    if (!open_) return false;
+    if (batch.num_columns() != builders_.size()) {
+        LOG_ERROR("Column batch has %zu columns, Parquet schema has %zu",
+                  batch.num_columns(), builders_.size());
+        return false;
+    }
+    if (batch.layout() != ColumnLayout::Typed) {
+        LOG_ERROR("Parquet writer needs typed column batches");
+        return false;
+    }
+
+    // Split the batch at row-group boundaries so flushes stay batch_rows_ rows
+    size_t first = 0;
+    while (first < batch.num_rows()) {
+        size_t room  = static_cast<size_t>(batch_rows_ - current_batch_size_);
+        size_t count = std::min(room, batch.num_rows() - first);
+
+        for (size_t i = 0; i < builders_.size(); ++i) {
+            if (!append_column(builders_[i].get(), batch.column(i), first, count))
+                return false;
+        }
+
+        first += count;
+        rows_written_       += count;
+        current_batch_size_ += static_cast<int64_t>(count);
+        if (current_batch_size_ >= batch_rows_) {
+            flush_batch();
+        }
+    }
+    return true;
+}
+
+bool ParquetWriter::append_column(arrow::ArrayBuilder* builder, const ColumnBuffer& col,
+                                  size_t first, size_t count) {
+    const int64_t n = static_cast<int64_t>(count);
+    const uint8_t* valid = col.validity.data() + first;
+    arrow::Status s;
+
+    switch (col.kind) {
+    case ColumnKind::Bool:
+        s = static_cast<arrow::BooleanBuilder*>(builder)->AppendValues(
+            col.values.data() + first, n, valid);
+        break;
+    case ColumnKind::Int8:
+        s = static_cast<arrow::Int8Builder*>(builder)->AppendValues(
+            reinterpret_cast<const int8_t*>(col.values.data()) + first, n, valid);
+        break;
+    case ColumnKind::Int16:
+        s = static_cast<arrow::Int16Builder*>(builder)->AppendValues(
+            reinterpret_cast<const int16_t*>(col.values.data()) + first, n, valid);
+        break;
+    case ColumnKind::Int32:
+        s = static_cast<arrow::Int32Builder*>(builder)->AppendValues(
+            reinterpret_cast<const int32_t*>(col.values.data()) + first, n, valid);
+        break;
+    case ColumnKind::Int64:
+        s = static_cast<arrow::Int64Builder*>(builder)->AppendValues(
+            reinterpret_cast<const int64_t*>(col.values.data()) + first, n, valid);
+        break;
+    case ColumnKind::Float32:
+        s = static_cast<arrow::FloatBuilder*>(builder)->AppendValues(
+            reinterpret_cast<const float*>(col.values.data()) + first, n, valid);
+        break;
+    case ColumnKind::Float64:
+        s = static_cast<arrow::DoubleBuilder*>(builder)->AppendValues(
+            reinterpret_cast<const double*>(col.values.data()) + first, n, valid);
+        break;
+    case ColumnKind::Decimal128:
+    case ColumnKind::Uuid:
+        // Decimal128Builder derives from FixedSizeBinaryBuilder; 16 bytes a value
+        s = static_cast<arrow::FixedSizeBinaryBuilder*>(builder)->AppendValues(
+            col.values.data() + first * col.width, n, valid);
+        break;
+    case ColumnKind::Date32:
+        s = static_cast<arrow::Date32Builder*>(builder)->AppendValues(
+            reinterpret_cast<const int32_t*>(col.values.data()) + first, n, valid);
+        break;
+    case ColumnKind::TimestampUs:
+        s = static_cast<arrow::TimestampBuilder*>(builder)->AppendValues(
+            reinterpret_cast<const int64_t*>(col.values.data()) + first, n, valid);
+        break;
+    case ColumnKind::Time64Us:
+        s = static_cast<arrow::Time64Builder*>(builder)->AppendValues(
+            reinterpret_cast<const int64_t*>(col.values.data()) + first, n, valid);
+        break;
+    case ColumnKind::Utf8:
+    case ColumnKind::Binary: {
+        // StringBuilder derives from BinaryBuilder, so one path serves both
+        auto* b = static_cast<arrow::BinaryBuilder*>(builder);
+        int32_t begin = col.offsets[first];
+        int32_t end   = col.offsets[first + count];
+        s = b->Reserve(n);
+        if (s.ok()) s = b->ReserveData(end - begin);
+        if (!s.ok()) break;
+        for (size_t r = first; r < first + count; ++r) {
+            if (col.validity[r]) {
+                b->UnsafeAppend(reinterpret_cast<const uint8_t*>(col.data.data()) + col.offsets[r],
+                                col.offsets[r + 1] - col.offsets[r]);
+            } else {
+                b->UnsafeAppendNull();
+            }
+        }
+        break;
+    }
+    }
+
+    if (!s.ok()) {
+        LOG_ERROR("Failed to append column data: %s", s.ToString().c_str());
+        return false;
+    }
+    return true;
+}
+#endif
+
 bool ParquetWriter::close() {
 #ifdef BAKREAD_HAS_PARQUET
     if (!open_) return true;
@@ -202,40 +504,41 @@ void ParquetWriter::flush_batch() {
 std::shared_ptr<arrow::Schema>
 ParquetWriter::build_arrow_schema(const TableSchema& schema) {
     std::vector<std::shared_ptr<arrow::Field>> fields;
+    kinds_.clear();
 
     for (auto& col : schema.columns) {
         std::shared_ptr<arrow::DataType> type;
 
-        switch (col.type) {
-        case SqlType::Bit:
-            type = arrow::boolean(); break;
-        case SqlType::TinyInt:
-            type = arrow::int8(); break;
-        case SqlType::SmallInt:
-            type = arrow::int16(); break;
-        case SqlType::Int:
-            type = arrow::int32(); break;
-        case SqlType::BigInt:
-            type = arrow::int64(); break;
-        case SqlType::Real:
-            type = arrow::float32(); break;
-        case SqlType::Float:
-            type = arrow::float64(); break;
-        case SqlType::Money:
-        case SqlType::SmallMoney:
-            type = arrow::float64(); break;
-        case SqlType::Decimal:
-        case SqlType::Numeric:
-            type = arrow::utf8(); break;  // Store as string for precision
-        case SqlType::Binary:
-        case SqlType::VarBinary:
-        case SqlType::Image:
-        case SqlType::Timestamp:
-            type = arrow::binary(); break;
-        default:
-            type = arrow::utf8(); break;
+        // Same mapping as the columnar decoder (column_kind_for, typed layout)
+        ColumnKind kind = column_kind_for(col.type, ColumnLayout::Typed);
+        switch (kind) {
+        case ColumnKind::Bool:    type = arrow::boolean(); break;
+        case ColumnKind::Int8:    type = arrow::int8();    break;
+        case ColumnKind::Int16:   type = arrow::int16();   break;
+        case ColumnKind::Int32:   type = arrow::int32();   break;
+        case ColumnKind::Int64:   type = arrow::int64();   break;
+        case ColumnKind::Float32: type = arrow::float32(); break;
+        case ColumnKind::Float64: type = arrow::float64(); break;
+        case ColumnKind::Binary:  type = arrow::binary();  break;
+        case ColumnKind::Utf8:    type = arrow::utf8();    break;
+        case ColumnKind::Decimal128: {
+            // Catalog precision is 1-38; 0 means it was not recorded
+            int32_t precision = col.precision >= 1 && col.precision <= 38 ? col.precision : 38;
+            int32_t scale = std::min<int32_t>(col.scale, precision);
+            type = arrow::decimal128(precision, scale);
+            break;
+        }
+        case ColumnKind::Uuid:        type = arrow::fixed_size_binary(16); break;
+        case ColumnKind::Date32:      type = arrow::date32(); break;
+        case ColumnKind::Time64Us:    type = arrow::time64(arrow::TimeUnit::MICRO); break;
+        case ColumnKind::TimestampUs:
+            type = col.type == SqlType::DateTimeOffset
+                ? arrow::timestamp(arrow::TimeUnit::MICRO, "UTC")
+                : arrow::timestamp(arrow::TimeUnit::MICRO);
+            break;
         }
 
+        kinds_.push_back(kind);
         fields.push_back(arrow::field(col.name, type, col.is_nullable));
     }
 
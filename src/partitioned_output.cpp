@@ -0,0 +1,145 @@
+#include "bakread/partitioned_output.h"
+#include "bakread/error.h"
+#include "bakread/json_writer.h"
+#include "bakread/logging.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace bakread {
+
+static const char* MANIFEST_NAME = "_manifest.json";
+
+static const char* format_extension(OutputFormat format) {
+    return format == OutputFormat::Parquet ? ".parquet" :
+           format == OutputFormat::JSONL   ? ".jsonl" : ".csv";
+}
+
+static const char* format_name(OutputFormat format) {
+    return format == OutputFormat::Parquet ? "parquet" :
+           format == OutputFormat::JSONL   ? "jsonl" : "csv";
+}
+
+PartitionedOutput::PartitionedOutput(const std::string& dir, OutputFormat format,
+                                     const std::string& delimiter, uint64_t split_rows,
+                                     const ParquetOptions& parquet)
+    : dir_(dir)
+    , format_(format)
+    , delimiter_(delimiter)
+    , split_rows_(split_rows)
+    , parquet_(parquet)
+{
+}
+
+void PartitionedOutput::prepare() {
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    if (!fs::is_directory(dir_, ec)) {
+        throw ExportError("Cannot create output directory: " + dir_);
+    }
+
+    // A rerun with fewer parts must not leave stale parts for loaders to pick up
+    const std::string ext = format_extension(format_);
+    size_t removed = 0;
+    for (const auto& entry : fs::directory_iterator(dir_, ec)) {
+        std::string name = entry.path().filename().string();
+        bool stale = name == MANIFEST_NAME ||
+                     (name.size() == 10 + ext.size() && name.compare(0, 5, "part-") == 0 &&
+                      name.compare(10, std::string::npos, ext) == 0 &&
+                      name.find_first_not_of("0123456789", 5) == 10);
+        if (stale && fs::remove(entry.path(), ec)) ++removed;
+    }
+    if (removed > 0) {
+        LOG_INFO("Removed %zu files of an earlier partitioned export from %s",
+                 removed, dir_.c_str());
+    }
+}
+
+std::string PartitionedOutput::part_name(size_t part) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "part-%05zu", part);
+    return name + std::string(format_extension(format_));
+}
+
+std::unique_ptr<IExportWriter> PartitionedOutput::open_part(const TableSchema& schema,
+                                                            size_t& part) {
+    std::string file;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        part = parts_.size();
+        file = part_name(part);
+        parts_.push_back({file, 0});
+    }
+
+    auto writer = create_writer(format_, delimiter_, parquet_);
+    writer->open((fs::path(dir_) / file).string(), schema);
+    return writer;
+}
+
+void PartitionedOutput::close_part(size_t part, IExportWriter& writer) {
+    writer.close();
+    std::lock_guard<std::mutex> lk(mu_);
+    parts_[part].rows = writer.rows_written();
+}
+
+size_t PartitionedOutput::part_count() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return parts_.size();
+}
+
+uint64_t PartitionedOutput::bytes_written() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    uint64_t total = 0;
+    for (const auto& p : parts_) {
+        std::error_code ec;
+        auto size = fs::file_size(fs::path(dir_) / p.file, ec);
+        if (!ec) total += size;
+    }
+    return total;
+}
+
+bool PartitionedOutput::write_manifest(const std::string& table,
+                                       const TableSchema& schema) const {
+    std::lock_guard<std::mutex> lk(mu_);
+
+    uint64_t total = 0;
+    for (const auto& p : parts_) total += p.rows;
+
+    std::string path = (fs::path(dir_) / MANIFEST_NAME).string();
+    std::ofstream out(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!out.is_open()) {
+        LOG_ERROR("Cannot write manifest: %s", path.c_str());
+        return false;
+    }
+
+    out << "{\n"
+        << "  \"table\": \"" << JsonWriter::escape_json(table) << "\",\n"
+        << "  \"format\": \"" << format_name(format_) << "\",\n"
+        << "  \"rows\": " << total << ",\n"
+        << "  \"columns\": [";
+    for (size_t i = 0; i < schema.columns.size(); ++i) {
+        const ColumnDef& c = schema.columns[i];
+        out << (i > 0 ? ",\n" : "\n")
+            << "    {\"name\": \"" << JsonWriter::escape_json(c.name) << "\", "
+            << "\"type_id\": " << static_cast<int>(c.type) << ", "
+            << "\"nullable\": " << (c.is_nullable ? "true" : "false") << "}";
+    }
+    out << "\n  ],\n"
+        << "  \"parts\": [";
+    for (size_t i = 0; i < parts_.size(); ++i) {
+        out << (i > 0 ? ",\n" : "\n")
+            << "    {\"file\": \"" << JsonWriter::escape_json(parts_[i].file) << "\", "
+            << "\"rows\": " << parts_[i].rows << "}";
+    }
+    out << "\n  ]\n"
+        << "}\n";
+
+    LOG_INFO("Manifest written: %s (%zu parts, %llu rows)", path.c_str(),
+             parts_.size(), (unsigned long long)total);
+    return out.good();
+}
+
+}  // namespace bakread
@@ -1,12 +1,16 @@
 #include "bakread/pipeline.h"
 #include "bakread/direct_extractor.h"
+#include "bakread/partitioned_output.h"
 #include "bakread/restore_adapter.h"
 #include "bakread/error.h"
 #include "bakread/logging.h"
 
+#include <algorithm>
 #include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <thread>
 #include <unordered_set>
 
 namespace bakread {
@@ -72,48 +76,195 @@ static std::unordered_set<int64_t> load_allocation_hints(const std::string& path
     return hints;
 }
 
+// Direct mode settings from the command line
+static DirectExtractorConfig direct_config(const Options& opts) {
+    DirectExtractorConfig config;
+    config.use_indexed_mode = opts.indexed_mode;
+    config.cache_size_mb = opts.cache_size_mb;
+    config.index_dir = opts.index_dir;
+    config.force_rescan = opts.force_rescan;
+    config.use_mmap = opts.use_mmap;
+    config.readahead_depth = opts.readahead_depth;
+    config.readahead_mb = opts.readahead_mb;
+    config.direct_io = opts.direct_io;
+    config.memory_budget_mb = opts.memory_budget_mb;
+    config.spill_dir = opts.spill_dir;
+    config.lob_cache_mb = opts.lob_cache_mb;
+    config.decode_workers = opts.workers;
+    config.preserve_order = opts.preserve_order;
+    config.catalog_cache = opts.catalog_cache;
+    config.diff_paths = opts.diff_paths;
+    return config;
+}
+
+// Size of an output file (0 if it cannot be read)
+static uint64_t output_bytes(const std::string& path) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<uint64_t>(size);
+}
+
+// Write-stage measurement of one writer thread: wall and thread CPU time
+// inside the write calls only, so queue waits and (for writers fed on the
+// decode thread) decoding are not charged to the writer. A meter that
+// only times the final close() does not count as a writer.
+class WriteMeter {
+public:
+    explicit WriteMeter(RunStats* stats, bool writer = true)
+        : stats_(stats), writer_(writer) {}
+    ~WriteMeter() {
+        if (!stats_ || !used_) return;
+        s_.calls = writer_ ? 1 : 0;
+        stats_->add_stage("write", s_);
+    }
+
+    template <typename Fn>
+    bool time(uint64_t rows, Fn&& write) {
+        if (!stats_) return write();
+        auto   t0  = std::chrono::steady_clock::now();
+        double cpu = thread_cpu_seconds();
+        bool ok = write();
+        s_.cpu_seconds  += thread_cpu_seconds() - cpu;
+        s_.wall_seconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - t0).count();
+        s_.rows += rows;
+        used_ = true;
+        return ok;
+    }
+
+private:
+    RunStats*  stats_;
+    bool       writer_;
+    bool       used_ = false;
+    StageStats s_;
+};
+
+// Bytes of output, added to the write stage once the files are closed
+static void add_output_bytes(RunStats* stats, uint64_t bytes) {
+    if (!stats) return;
+    StageStats s;
+    s.bytes = bytes;
+    stats->add_stage("write", s);
+}
+
 // =========================================================================
-// RowQueue
+// BatchQueue
 // =========================================================================
 
-RowQueue::RowQueue(size_t capacity)
-    : capacity_(capacity)
+template <typename Batch>
+BatchQueue<Batch>::BatchQueue(size_t capacity, size_t batch_rows)
+    : capacity_(capacity > 0 ? capacity : 1)
+    , batch_rows_(batch_rows > 0 ? batch_rows : RowBatch::DEFAULT_CAPACITY)
 {
 }
 
-bool RowQueue::push(Row row) {
+// Seconds since t0, added to a wait counter
+static double seconds_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+template <typename Batch>
+std::unique_ptr<Batch> BatchQueue<Batch>::acquire() {
+    std::unique_lock<std::mutex> lk(mu_);
+    auto can_acquire = [&] {
+        return !free_.empty() || allocated_ < capacity_ || finished_ || aborted_;
+    };
+    if (!can_acquire()) {
+        auto t0 = std::chrono::steady_clock::now();
+        batch_free_.wait(lk, can_acquire);
+        producer_wait_ += seconds_since(t0);
+    }
+    if (finished_ || aborted_) return nullptr;
+
+    if (!free_.empty()) {
+        auto batch = std::move(free_.back());
+        free_.pop_back();
+        batch->clear();
+        return batch;
+    }
+
+    ++allocated_;
+    lk.unlock();
+    if constexpr (std::is_constructible_v<Batch, size_t>) {
+        return std::make_unique<Batch>(batch_rows_);
+    } else {
+        return std::make_unique<Batch>();
+    }
+}
+
+template <typename Batch>
+bool BatchQueue<Batch>::push(std::unique_ptr<Batch> batch) {
     std::unique_lock<std::mutex> lk(mu_);
-    not_full_.wait(lk, [&] { return queue_.size() < capacity_ || finished_; });
-    if (finished_) return false;
-    queue_.push(std::move(row));
+    if (finished_ || aborted_) return false;
+    queue_.push_back(std::move(batch));
+    high_water_ = std::max(high_water_, queue_.size());
+    ++batches_;
     lk.unlock();
     not_empty_.notify_one();
     return true;
 }
 
-bool RowQueue::pop(Row& row) {
+template <typename Batch>
+bool BatchQueue<Batch>::pop(std::unique_ptr<Batch>& batch) {
     std::unique_lock<std::mutex> lk(mu_);
-    not_empty_.wait(lk, [&] { return !queue_.empty() || finished_; });
-    if (queue_.empty()) return false;
-    row = std::move(queue_.front());
-    queue_.pop();
-    lk.unlock();
-    not_full_.notify_one();
+    auto can_pop = [&] { return !queue_.empty() || finished_ || aborted_; };
+    if (!can_pop()) {
+        auto t0 = std::chrono::steady_clock::now();
+        not_empty_.wait(lk, can_pop);
+        consumer_wait_ += seconds_since(t0);
+    }
+    if (aborted_ || queue_.empty()) return false;
+    batch = std::move(queue_.front());
+    queue_.pop_front();
     return true;
 }
 
-void RowQueue::finish() {
+template <typename Batch>
+void BatchQueue<Batch>::release(std::unique_ptr<Batch> batch) {
+    if (!batch) return;
+    std::unique_lock<std::mutex> lk(mu_);
+    free_.push_back(std::move(batch));
+    lk.unlock();
+    batch_free_.notify_one();
+}
+
+template <typename Batch>
+void BatchQueue<Batch>::finish() {
     std::lock_guard<std::mutex> lk(mu_);
     finished_ = true;
-    not_full_.notify_all();
+    batch_free_.notify_all();
     not_empty_.notify_all();
 }
 
-size_t RowQueue::size() const {
+template <typename Batch>
+void BatchQueue<Batch>::abort() {
+    std::lock_guard<std::mutex> lk(mu_);
+    aborted_ = true;
+    batch_free_.notify_all();
+    not_empty_.notify_all();
+}
+
+template <typename Batch>
+size_t BatchQueue<Batch>::size() const {
     std::lock_guard<std::mutex> lk(mu_);
     return queue_.size();
 }
 
+template <typename Batch>
+QueueStats BatchQueue<Batch>::stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    QueueStats q;
+    q.capacity              = capacity_;
+    q.high_water            = high_water_;
+    q.batches               = batches_;
+    q.producer_wait_seconds = producer_wait_;
+    q.consumer_wait_seconds = consumer_wait_;
+    return q;
+}
+
+template class BatchQueue<RowBatch>;
+template class BatchQueue<ColumnBatch>;
+
 // =========================================================================
 // Pipeline
 // =========================================================================
@@ -140,7 +291,17 @@ PipelineResult Pipeline::run() {
             LOG_INFO("  [%zu] %s", i + 1, opts_.bak_paths[i].c_str());
         }
     }
-    LOG_INFO("Table:   %s.%s", opts_.schema_name.c_str(), opts_.table_name.c_str());
+    for (const auto& diff : opts_.diff_paths) {
+        LOG_INFO("Diff:    %s", diff.c_str());
+    }
+    if (opts_.tables.empty()) {
+        LOG_INFO("Table:   %s.%s", opts_.schema_name.c_str(), opts_.table_name.c_str());
+    } else {
+        LOG_INFO("Tables:  %zu", opts_.tables.size());
+        for (const auto& [schema, table] : opts_.tables) {
+            LOG_INFO("  %s.%s", schema.c_str(), table.c_str());
+        }
+    }
     LOG_INFO("Output:  %s", opts_.output_path.c_str());
     LOG_INFO("Format:  %s",
              opts_.format == OutputFormat::CSV ? "CSV" :
@@ -153,7 +314,9 @@ PipelineResult Pipeline::run() {
     }
     LOG_INFO("========================================");
 
-    switch (opts_.mode) {
+    if (!opts_.tables.empty()) {
+        result = run_tables();
+    } else switch (opts_.mode) {
     case ExecMode::Direct:
         result = try_direct_mode();
         break;
@@ -188,6 +351,10 @@ PipelineResult Pipeline::run() {
     result.elapsed_seconds = std::chrono::duration<double>(
         end_time - start_time).count();
 
+    stats_->set_result(result.success, result.mode_used, result.error_message,
+                       result.rows_exported, result.elapsed_seconds);
+    if (!opts_.stats_json.empty()) stats_->write_json(opts_.stats_json);
+
     LOG_INFO("========================================");
     if (result.success) {
         LOG_INFO("SUCCESS: %llu rows exported to %s",
@@ -209,16 +376,14 @@ PipelineResult Pipeline::try_direct_mode() {
 
     try {
         // Configure extractor based on options
-        DirectExtractorConfig config;
-        config.use_indexed_mode = opts_.indexed_mode;
-        config.cache_size_mb = opts_.cache_size_mb;
-        config.index_dir = opts_.index_dir;
-        config.force_rescan = opts_.force_rescan;
+        DirectExtractorConfig config = direct_config(opts_);
 
         DirectExtractor extractor(opts_.bak_paths, config);
         extractor.set_table(opts_.schema_name, opts_.table_name);
         extractor.set_columns(opts_.columns);
+        extractor.set_where(opts_.where_clause);
         extractor.set_max_rows(opts_.max_rows);
+        extractor.set_stats(stats_);
 
         if (config.use_indexed_mode) {
             result.mode_used = "direct (indexed)";
@@ -236,42 +401,201 @@ PipelineResult Pipeline::try_direct_mode() {
             report_progress(p.rows_exported, p.pct);
         });
 
-        // Create the writer
-        auto writer = create_writer(opts_.format, opts_.delimiter);
+        PipelineResult exported = export_direct(extractor);
+        result.success = exported.success;
+        result.rows_exported = exported.rows_exported;
+        result.error_message = exported.error_message;
 
-        // Set up row queue for pipelined writing
-        RowQueue queue(10000);
-        std::atomic<uint64_t> written{0};
-        std::atomic<bool> write_error{false};
+    } catch (const std::exception& e) {
+        result.error_message = e.what();
+    }
 
-        // We need the schema before opening the writer, so we use a
-        // two-phase approach: extract writes to queue, writer reads from queue.
+    return result;
+}
 
-        // Phase: Extract rows, collect schema, write output
-        bool schema_set = false;
-        TableSchema schema;
+Options Pipeline::table_options(const std::string& schema, const std::string& table) const {
+    Options t = opts_;
+    t.tables_qualified.clear();
+    t.tables.clear();
+    t.schema_name     = schema;
+    t.table_name      = table;
+    t.table_qualified = schema + "." + table;
+    t.output_path     = opts_.table_output_path(schema, table);
+    return t;
+}
 
-        auto extract_result = extractor.extract([&](const Row& row) -> bool {
-            if (!schema_set) {
-                schema = extractor.resolved_schema();
-                writer->open(opts_.output_path, schema);
-                schema_set = true;
+PipelineResult Pipeline::run_tables() {
+    PipelineResult result;
+    result.mode_used = opts_.mode == ExecMode::Restore ? "restore" :
+                       opts_.indexed_mode ? "direct (indexed)" : "direct";
+
+    std::vector<Options> targets;
+    for (const auto& [schema, table] : opts_.tables) {
+        targets.push_back(table_options(schema, table));
+
+        // Outputs land in a directory (or a templated path) that may not exist yet
+        std::error_code ec;
+        auto parent = std::filesystem::path(targets.back().output_path).parent_path();
+        if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+    }
+
+    std::vector<PipelineResult> results(targets.size());
+    std::string load_error;
+
+    if (opts_.mode != ExecMode::Restore) {
+        try {
+            // One extractor for every table: headers, catalog and the data
+            // pages of all targets come from a single pass over the backup
+            DirectExtractor extractor(opts_.bak_paths, direct_config(opts_));
+            extractor.set_columns(opts_.columns);
+            extractor.set_where(opts_.where_clause);
+            extractor.set_max_rows(opts_.max_rows);
+            extractor.set_stats(stats_);
+
+            if (!opts_.allocation_hint_path.empty()) {
+                auto hints = load_allocation_hints(opts_.allocation_hint_path);
+                if (!hints.empty()) {
+                    extractor.set_allocation_hints(std::move(hints));
+                }
             }
 
-            if (!writer->write_row(row)) {
-                LOG_ERROR("Write failed at row %llu",
-                          (unsigned long long)writer->rows_written());
-                return false;
+            extractor.set_progress_callback([this](const Progress& p) {
+                report_progress(p.rows_exported, p.pct);
+            });
+
+            DirectExtractResult loaded = extractor.load_tables(opts_.tables);
+            if (loaded.success) {
+                for (size_t i = 0; i < targets.size(); ++i) {
+                    LOG_INFO("---- %s -> %s", targets[i].table_qualified.c_str(),
+                             targets[i].output_path.c_str());
+                    extractor.set_table(targets[i].schema_name, targets[i].table_name);
+                    Pipeline table(targets[i]);
+                    table.set_stats(stats_);
+                    results[i] = table.export_direct(extractor);
+                    results[i].mode_used = result.mode_used;
+                }
+            } else {
+                load_error = loaded.error_message;
             }
 
-            if (writer->rows_written() % 100000 == 0) {
-                report_progress(writer->rows_written(), 0);
+        } catch (const std::exception& e) {
+            load_error = e.what();
+        }
+
+        if (!load_error.empty()) {
+            LOG_ERROR("Direct mode failed for all tables: %s", load_error.c_str());
+            for (auto& r : results) r.error_message = load_error;
+        }
+    }
+
+    // Restore mode, or auto mode's fallback for the tables direct mode
+    // missed. One restore serves them all: every table reuses the database
+    // restored from this backup set, every table but the last keeps it for
+    // the next, and the last drops it (unless --keep-restored-db).
+    std::vector<size_t> restore_tables;
+    for (size_t i = 0; i < targets.size(); ++i) {
+        if (results[i].success) continue;
+        if (opts_.mode == ExecMode::Direct || opts_.target_server.empty()) continue;
+        restore_tables.push_back(i);
+    }
+    for (size_t k = 0; k < restore_tables.size(); ++k) {
+        size_t i = restore_tables[k];
+        if (opts_.mode == ExecMode::Auto) {
+            LOG_INFO("Falling back to restore mode for %s...", targets[i].table_qualified.c_str());
+        }
+        Options table_opts = targets[i];
+        table_opts.reuse_restored_db = true;
+        if (k + 1 < restore_tables.size()) table_opts.keep_restored_db = true;
+        Pipeline table(table_opts);
+        table.set_stats(stats_);
+        results[i] = table.try_restore_mode();
+    }
+
+    size_t failed = 0;
+    for (size_t i = 0; i < targets.size(); ++i) {
+        const PipelineResult& r = results[i];
+        if (r.success) {
+            result.rows_exported += r.rows_exported;
+            LOG_INFO("  %-40s %12llu rows  %s (%s)", targets[i].table_qualified.c_str(),
+                     (unsigned long long)r.rows_exported, targets[i].output_path.c_str(),
+                     r.mode_used.c_str());
+        } else {
+            ++failed;
+            LOG_ERROR("  %-40s FAILED: %s", targets[i].table_qualified.c_str(),
+                      r.error_message.c_str());
+        }
+    }
+
+    result.success = failed == 0;
+    if (failed > 0) {
+        result.error_message = std::to_string(failed) + " of " +
+                               std::to_string(targets.size()) + " tables failed";
+        if (opts_.mode == ExecMode::Auto && opts_.target_server.empty()) {
+            result.error_message += " (no --target-server specified for restore fallback)";
+        }
+    }
+    return result;
+}
+
+PipelineResult Pipeline::export_direct(DirectExtractor& extractor) {
+    PipelineResult result;
+    result.mode_used = "direct";
+
+    try {
+        // Create the writer
+        auto writer = create_writer(opts_.format, opts_.delimiter, opts_.parquet);
+
+        // The writer needs the schema before it can be opened, so it is
+        // opened (and the writer thread started) on the first row. Rows
+        // travel to the writer thread in batches.
+        DirectExtractResult extract_result;
+        bool writes_ok = true;
+
+        if (opts_.partitioned()) {
+            PartitionedOutput parts(opts_.output_path, opts_.format, opts_.delimiter,
+                                    opts_.split_rows, opts_.parquet);
+            parts.prepare();
+            if (writer->accepts_columns()) {
+                writes_ok = run_partitioned_columns(parts, extractor, extract_result,
+                                                    writer->column_layout());
+            } else {
+                writes_ok = run_partitioned(parts,
+                    [&] { return extractor.resolved_schema(); },
+                    [&](const RowSink& sink) { extract_result = extractor.extract(sink); });
             }
-            return true;
-        });
+            if (writes_ok && extract_result.success) {
+                writes_ok = parts.write_manifest(opts_.schema_name + "." + opts_.table_name,
+                                                 extractor.resolved_schema());
+            }
+        } else if (writer->accepts_columns()) {
+            // Columnar writers (Parquet) take column buffers straight from
+            // the decoder; written on this thread as batches arrive
+            bool opened = false;
+            WriteMeter meter(stats_);
+            extract_result = extractor.extract_columns([&](const ColumnBatch& batch) -> bool {
+                if (!opened) {
+                    writer->open(opts_.output_path, extractor.resolved_schema());
+                    opened = true;
+                }
+                if (!meter.time(batch.num_rows(), [&] { return writer->write_columns(batch); })) {
+                    writes_ok = false;
+                    return false;
+                }
+                return true;
+            }, writer->column_layout());
+            if (opened) {
+                if (!meter.time(0, [&] { return writer->close(); })) writes_ok = false;
+                add_output_bytes(stats_, output_bytes(opts_.output_path));
+            }
+        } else {
+            writes_ok = run_batched(*writer,
+                [&] { writer->open(opts_.output_path, extractor.resolved_schema()); },
+                [&](const RowSink& sink) { extract_result = extractor.extract(sink); });
+        }
 
-        if (schema_set) {
-            writer->close();
+        if (!writes_ok && extract_result.success) {
+            extract_result.success = false;
+            extract_result.error_message = "Write failed";
         }
 
         result.success = extract_result.success;
@@ -293,6 +617,11 @@ PipelineResult Pipeline::try_restore_mode() {
         result.error_message = "Restore mode requires --target-server";
         return result;
     }
+    if (!opts_.diff_paths.empty()) {
+        // Restoring the full backup alone would export stale data
+        result.error_message = "Restore mode does not chain differential backups (--diff)";
+        return result;
+    }
 
     try {
         RestoreOptions ropts;
@@ -311,32 +640,48 @@ PipelineResult Pipeline::try_restore_mode() {
         ropts.tde_cert_password  = opts_.tde_cert_password;
         ropts.master_key_password = opts_.master_key_password;
         ropts.cleanup_keys       = opts_.cleanup_keys;
+        ropts.parallel_queries   = opts_.restore_queries;
+        ropts.buffer_count       = opts_.restore_buffer_count;
+        ropts.max_transfer_size  = opts_.restore_max_transfer;
+        ropts.data_dirs          = opts_.restore_data_dirs;
+        ropts.log_dir            = opts_.restore_log_dir;
+        ropts.keep_database      = opts_.keep_restored_db;
+        ropts.reuse_database     = opts_.reuse_restored_db;
 
         RestoreAdapter adapter(ropts);
 
-        auto writer = create_writer(opts_.format, opts_.delimiter);
-        bool writer_opened = false;
-
-        auto restore_result = adapter.extract([&](const Row& row) -> bool {
-            if (!writer_opened) {
-                writer->open(opts_.output_path, adapter.resolved_schema());
-                writer_opened = true;
-            }
-
-            if (!writer->write_row(row)) {
-                LOG_ERROR("Write failed at row %llu",
-                          (unsigned long long)writer->rows_written());
-                return false;
-            }
+        // RESTORE, queries and row fetch are one stage
+        auto extract_restore = [&](RestoreAdapter& a, const RowSink& sink) {
+            RunStats::Timer timer(stats_, "restore");
+            RestoreResult r = a.extract(sink);
+            timer.add_rows(r.rows_read);
+            return r;
+        };
 
-            if (writer->rows_written() % 100000 == 0) {
-                report_progress(writer->rows_written(), 0);
+        auto writer = create_writer(opts_.format, opts_.delimiter, opts_.parquet);
+
+        RestoreResult restore_result;
+        bool writes_ok = true;
+        if (opts_.partitioned()) {
+            PartitionedOutput parts(opts_.output_path, opts_.format, opts_.delimiter,
+                                    opts_.split_rows, opts_.parquet);
+            parts.prepare();
+            writes_ok = run_partitioned(parts,
+                [&] { return adapter.resolved_schema(); },
+                [&](const RowSink& sink) { restore_result = extract_restore(adapter, sink); });
+            if (writes_ok && restore_result.success) {
+                writes_ok = parts.write_manifest(opts_.schema_name + "." + opts_.table_name,
+                                                 adapter.resolved_schema());
             }
-            return true;
-        });
+        } else {
+            writes_ok = run_batched(*writer,
+                [&] { writer->open(opts_.output_path, adapter.resolved_schema()); },
+                [&](const RowSink& sink) { restore_result = extract_restore(adapter, sink); });
+        }
 
-        if (writer_opened) {
-            writer->close();
+        if (!writes_ok && restore_result.success) {
+            restore_result.success = false;
+            restore_result.error_message = "Write failed";
         }
 
         result.success       = restore_result.success;
@@ -354,21 +699,238 @@ void Pipeline::writer_thread_func(IExportWriter* writer,
                                    RowQueue& queue,
                                    std::atomic<uint64_t>& written,
                                    std::atomic<bool>& error_flag) {
-    Row row;
-    while (queue.pop(row)) {
-        if (error_flag.load()) break;
+    std::unique_ptr<RowBatch> batch;
+    uint64_t next_progress = 100000;
+    WriteMeter meter(stats_);
 
-        if (!writer->write_row(row)) {
+    while (queue.pop(batch)) {
+        if (!meter.time(batch->size(), [&] { return writer->write_batch(*batch); })) {
             error_flag.store(true);
-            LOG_ERROR("Writer error at row %llu", (unsigned long long)written.load());
+            LOG_ERROR("Writer error at row %llu",
+                      (unsigned long long)writer->rows_written());
+            queue.abort();  // unblock the producer
             break;
         }
 
-        written.fetch_add(1);
+        uint64_t total = written.fetch_add(batch->size()) + batch->size();
+        queue.release(std::move(batch));
+
+        if (total >= next_progress) {
+            report_progress(total, 0);
+            next_progress = (total / 100000 + 1) * 100000;
+        }
+    }
+}
+
+bool Pipeline::run_batched(IExportWriter& writer,
+                           const std::function<void()>& open_writer,
+                           const ExtractFn& extract) {
+    RowQueue queue;
+    std::atomic<uint64_t> written{0};
+    std::atomic<bool> write_error{false};
+    std::thread writer_thread;
+    std::unique_ptr<RowBatch> batch;
+    bool opened = false;
+
+    RowSink sink = [&](const Row& row) -> bool {
+        if (!opened) {
+            open_writer();
+            opened = true;
+            writer_thread = std::thread(&Pipeline::writer_thread_func, this,
+                                        &writer, std::ref(queue),
+                                        std::ref(written), std::ref(write_error));
+        }
+        if (!batch) {
+            batch = queue.acquire();
+            if (!batch) return false;   // writer gave up
+        }
+
+        batch->add(row);
+        if (batch->full() && !queue.push(std::move(batch))) return false;
+        return true;
+    };
+
+    try {
+        extract(sink);
+    } catch (...) {
+        queue.abort();
+        if (writer_thread.joinable()) writer_thread.join();
+        throw;
+    }
+
+    if (batch && !batch->empty()) queue.push(std::move(batch));
+    queue.finish();
+    if (writer_thread.joinable()) writer_thread.join();
+    if (stats_) stats_->add_queue("write", queue.stats());
+
+    if (opened) {
+        if (!WriteMeter(stats_, false).time(0, [&] { return writer.close(); }))
+            write_error = true;
+        add_output_bytes(stats_, output_bytes(opts_.output_path));
+    }
+    return !write_error.load();
+}
+
+// =========================================================================
+// Partitioned output
+// =========================================================================
+
+static bool write_part_batch(IExportWriter& writer, const RowBatch& batch) {
+    return writer.write_batch(batch);
+}
+
+static bool write_part_batch(IExportWriter& writer, const ColumnBatch& batch) {
+    return writer.write_columns(batch);
+}
+
+static size_t batch_rows(const RowBatch& batch)    { return batch.size(); }
+static size_t batch_rows(const ColumnBatch& batch) { return batch.num_rows(); }
+
+template <typename Batch>
+void Pipeline::part_writer_func(BatchQueue<Batch>& queue,
+                                PartitionedOutput& parts,
+                                const TableSchema& schema,
+                                std::atomic<uint64_t>& written,
+                                std::atomic<bool>& error_flag) {
+    std::unique_ptr<IExportWriter> writer;
+    std::unique_ptr<Batch> batch;
+    size_t part = 0;
+    WriteMeter meter(stats_);
+
+    try {
+        while (queue.pop(batch)) {
+            if (!writer) writer = parts.open_part(schema, part);
+            if (!meter.time(batch_rows(*batch), [&] { return write_part_batch(*writer, *batch); })) {
+                error_flag.store(true);
+                LOG_ERROR("Writer error in part %zu at row %llu", part,
+                          (unsigned long long)writer->rows_written());
+                queue.abort();  // unblock the producer and the other writers
+                break;
+            }
+
+            size_t n = batch_rows(*batch);
+            uint64_t total = written.fetch_add(n) + n;
+            queue.release(std::move(batch));
+
+            if (parts.part_full(*writer)) {
+                meter.time(0, [&] { parts.close_part(part, *writer); return true; });
+                writer.reset();
+            }
+
+            // Writers share the counter; whoever crosses a 100K mark reports it
+            if (total / 100000 != (total - n) / 100000) report_progress(total, 0);
+        }
+    } catch (const std::exception& e) {
+        error_flag.store(true);
+        LOG_ERROR("Writer error: %s", e.what());
+        queue.abort();
+    }
+
+    if (writer) meter.time(0, [&] { parts.close_part(part, *writer); return true; });
+}
+
+bool Pipeline::run_partitioned(PartitionedOutput& parts,
+                               const std::function<TableSchema()>& schema_of,
+                               const ExtractFn& extract) {
+    // Enough batches in flight that no writer waits on another's batch
+    RowQueue queue(std::max<size_t>(8, opts_.writers * 2));
+    std::atomic<uint64_t> written{0};
+    std::atomic<bool> write_error{false};
+    std::vector<std::thread> writer_threads;
+    std::unique_ptr<RowBatch> batch;
+    TableSchema schema;
+
+    auto join_all = [&] {
+        for (auto& t : writer_threads) {
+            if (t.joinable()) t.join();
+        }
+    };
+
+    RowSink sink = [&](const Row& row) -> bool {
+        if (writer_threads.empty()) {
+            schema = schema_of();
+            for (size_t i = 0; i < opts_.writers; ++i) {
+                writer_threads.emplace_back(&Pipeline::part_writer_func<RowBatch>, this,
+                                            std::ref(queue), std::ref(parts), std::cref(schema),
+                                            std::ref(written), std::ref(write_error));
+            }
+        }
+        if (!batch) {
+            batch = queue.acquire();
+            if (!batch) return false;   // a writer gave up
+        }
+
+        batch->add(row);
+        if (batch->full() && !queue.push(std::move(batch))) return false;
+        return true;
+    };
+
+    try {
+        extract(sink);
+    } catch (...) {
+        queue.abort();
+        join_all();
+        throw;
     }
+
+    if (batch && !batch->empty()) queue.push(std::move(batch));
+    queue.finish();
+    join_all();
+    if (stats_) stats_->add_queue("write", queue.stats());
+    add_output_bytes(stats_, parts.bytes_written());
+
+    LOG_INFO("Partitioned output: %zu parts in %s", parts.part_count(), parts.dir().c_str());
+    return !write_error.load();
+}
+
+bool Pipeline::run_partitioned_columns(PartitionedOutput& parts, DirectExtractor& extractor,
+                                       DirectExtractResult& result, ColumnLayout layout) {
+    ColumnQueue queue(std::max<size_t>(8, opts_.writers * 2));
+    std::atomic<uint64_t> written{0};
+    std::atomic<bool> write_error{false};
+    std::vector<std::thread> writer_threads;
+    TableSchema schema;
+
+    auto join_all = [&] {
+        for (auto& t : writer_threads) {
+            if (t.joinable()) t.join();
+        }
+    };
+
+    try {
+        // The decoder reuses its batch, so each one is copied into a queue
+        // slot (capacity is kept, so after warm-up this is a memcpy)
+        result = extractor.extract_columns([&](const ColumnBatch& batch) -> bool {
+            if (writer_threads.empty()) {
+                schema = extractor.resolved_schema();
+                for (size_t i = 0; i < opts_.writers; ++i) {
+                    writer_threads.emplace_back(&Pipeline::part_writer_func<ColumnBatch>, this,
+                                                std::ref(queue), std::ref(parts), std::cref(schema),
+                                                std::ref(written), std::ref(write_error));
+                }
+            }
+            auto slot = queue.acquire();
+            if (!slot) return false;   // a writer gave up
+            *slot = batch;
+            return queue.push(std::move(slot));
+        }, layout);
+    } catch (...) {
+        queue.abort();
+        join_all();
+        throw;
+    }
+
+    queue.finish();
+    join_all();
+    if (stats_) stats_->add_queue("write", queue.stats());
+    add_output_bytes(stats_, parts.bytes_written());
+
+    LOG_INFO("Partitioned output: %zu parts in %s", parts.part_count(), parts.dir().c_str());
+    return !write_error.load();
 }
 
 void Pipeline::report_progress(uint64_t rows, double pct) {
+    if (pct < 100.0 && !progress_limit_.allow()) return;
     if (pct > 0) {
         LOG_INFO("Progress: %.1f%% | %llu rows exported", pct,
                  (unsigned long long)rows);
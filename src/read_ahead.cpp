@@ -0,0 +1,226 @@
+#include "bakread/read_ahead.h"
+#include "bakread/error.h"
+#include "bakread/logging.h"
+#include "bakread/page.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+namespace bakread {
+
+static constexpr size_t BUFFER_ALIGN = 4096;
+
+ReadAhead::ReadAhead(const std::string& path, uint64_t begin, uint64_t end,
+                     const ReadAheadConfig& config)
+    : path_(path)
+    , begin_(begin)
+    , end_(std::max(begin, end))
+{
+    size_t depth = std::max<size_t>(2, config.depth);
+    buffer_size_ = std::max<size_t>(PAGE_SIZE, config.buffer_size / PAGE_SIZE * PAGE_SIZE);
+
+    bool want_unbuffered = config.unbuffered;
+    if (want_unbuffered && begin_ % BUFFER_ALIGN != 0) {
+        LOG_WARN("Unaligned read-ahead start %llu, using cached reads: %s",
+                 (unsigned long long)begin_, path.c_str());
+        want_unbuffered = false;
+    }
+
+#ifdef _WIN32
+    HANDLE h = INVALID_HANDLE_VALUE;
+    if (want_unbuffered) {
+        h = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                        nullptr, OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING, nullptr);
+        unbuffered_ = h != INVALID_HANDLE_VALUE;
+    }
+    if (h == INVALID_HANDLE_VALUE) {
+        h = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                        nullptr, OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    }
+    if (h == INVALID_HANDLE_VALUE)
+        throw FileIOError("Cannot open file for reading: " + path);
+    handle_ = h;
+#else
+#if defined(O_DIRECT)
+    if (want_unbuffered) {
+        fd_ = ::open(path.c_str(), O_RDONLY | O_DIRECT);
+        unbuffered_ = fd_ >= 0;
+    }
+#endif
+    if (fd_ < 0) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+#if defined(F_NOCACHE)
+        if (fd_ >= 0 && want_unbuffered) {
+            unbuffered_ = ::fcntl(fd_, F_NOCACHE, 1) == 0;
+        }
+#endif
+    }
+    if (fd_ < 0)
+        throw FileIOError("Cannot open file for reading: " + path);
+#if defined(POSIX_FADV_SEQUENTIAL)
+    if (!unbuffered_) {
+        ::posix_fadvise(fd_, static_cast<off_t>(begin_), static_cast<off_t>(end_ - begin_),
+                        POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+#endif
+
+    if (want_unbuffered && !unbuffered_) {
+        LOG_WARN("Unbuffered I/O not supported for %s, using cached reads", path.c_str());
+    }
+
+    // One allocation, carved into aligned buffers
+    storage_.resize(depth * buffer_size_ + BUFFER_ALIGN);
+    uintptr_t base = reinterpret_cast<uintptr_t>(storage_.data());
+    uint8_t* aligned = storage_.data() + ((BUFFER_ALIGN - base % BUFFER_ALIGN) % BUFFER_ALIGN);
+    slots_.resize(depth);
+    for (size_t i = 0; i < depth; ++i) {
+        slots_[i].data = aligned + i * buffer_size_;
+    }
+
+    io_thread_ = std::thread(&ReadAhead::io_loop, this);
+}
+
+ReadAhead::~ReadAhead() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    space_cv_.notify_all();
+    if (io_thread_.joinable()) io_thread_.join();
+
+#ifdef _WIN32
+    if (handle_) CloseHandle(static_cast<HANDLE>(handle_));
+#else
+    if (fd_ >= 0) ::close(fd_);
+#endif
+}
+
+bool ReadAhead::failed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
+
+bool ReadAhead::next(const uint8_t*& data, size_t& length, uint64_t& offset) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (holding_) {
+        ++consumed_;
+        holding_ = false;
+        space_cv_.notify_one();
+    }
+
+    data_cv_.wait(lock, [&] { return produced_ > consumed_ || done_; });
+    if (produced_ == consumed_) return false;
+
+    const Slot& slot = slots_[consumed_ % slots_.size()];
+    data    = slot.data;
+    length  = slot.length;
+    offset  = slot.offset;
+    holding_ = true;
+    return true;
+}
+
+void ReadAhead::io_loop() {
+    const size_t depth = slots_.size();
+    uint64_t offset = begin_;
+    uint64_t issued = 0;
+
+    while (offset < end_) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            space_cv_.wait(lock, [&] { return stop_ || issued - consumed_ < depth; });
+            if (stop_) break;
+        }
+
+        // The slot is ours until produced_ is bumped
+        Slot& slot = slots_[issued % depth];
+        size_t want = static_cast<size_t>(std::min<uint64_t>(buffer_size_, end_ - offset));
+        size_t got = 0;
+        bool ok;
+        if (unbuffered_) {
+            // Whole aligned units; a short read at end of file is fine
+            size_t aligned = (want + BUFFER_ALIGN - 1) / BUFFER_ALIGN * BUFFER_ALIGN;
+            ok = read_at(slot.data, aligned, offset, got);
+            got = std::min(got, want);
+        } else {
+            ok = read_at(slot.data, want, offset, got);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!ok) {
+            LOG_ERROR("Read failed at offset %llu in %s",
+                      (unsigned long long)offset, path_.c_str());
+            failed_ = true;
+            break;
+        }
+        if (got == 0) break;
+
+        slot.length = got;
+        slot.offset = offset;
+        ++issued;
+        ++produced_;
+        data_cv_.notify_one();
+
+        offset += got;
+        if (got < want) break;   // End of file
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = true;
+    data_cv_.notify_all();
+}
+
+#ifdef _WIN32
+
+bool ReadAhead::read_at(uint8_t* dest, size_t count, uint64_t offset, size_t& got) {
+    got = 0;
+    while (got < count) {
+        OVERLAPPED ov{};
+        uint64_t pos = offset + got;
+        ov.Offset     = static_cast<DWORD>(pos & 0xFFFFFFFFu);
+        ov.OffsetHigh = static_cast<DWORD>(pos >> 32);
+
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(count - got, 1u << 30));
+        DWORD n = 0;
+        if (!ReadFile(static_cast<HANDLE>(handle_), dest + got, chunk, &n, &ov)) {
+            if (GetLastError() == ERROR_HANDLE_EOF) return true;
+            return false;
+        }
+        if (n == 0) return true;
+        got += n;
+        if (unbuffered_ && got % BUFFER_ALIGN != 0) return true;
+    }
+    return true;
+}
+
+#else
+
+bool ReadAhead::read_at(uint8_t* dest, size_t count, uint64_t offset, size_t& got) {
+    got = 0;
+    while (got < count) {
+        ssize_t n = ::pread(fd_, dest + got, count - got, static_cast<off_t>(offset + got));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) return true;
+        got += static_cast<size_t>(n);
+        // An unaligned short read under O_DIRECT is the end of the file
+        if (unbuffered_ && got % BUFFER_ALIGN != 0) return true;
+    }
+    return true;
+}
+
+#endif
+
+}  // namespace bakread
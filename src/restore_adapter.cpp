@@ -3,9 +3,13 @@
 #include "bakread/logging.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <chrono>
 #include <cstdlib>
 #include <cstring>
+#include <map>
+#include <mutex>
 #include <random>
 #include <sstream>
 #include <thread>
@@ -242,33 +246,254 @@ bool OdbcConnection::query_scalar_int(const std::string& sql, int64_t& result) {
     return true;
 }
 
+bool is_lob_column(const ColumnDef& col) {
+    switch (col.type) {
+    case SqlType::Text:
+    case SqlType::NText:
+    case SqlType::Image:
+    case SqlType::Xml:
+    case SqlType::Sql_Variant:
+        return true;
+    case SqlType::VarChar:
+    case SqlType::NVarChar:
+    case SqlType::VarBinary:
+        return col.max_length <= 0;   // (MAX) types report -1
+    case SqlType::TinyInt:
+    case SqlType::SmallInt:
+    case SqlType::Int:
+    case SqlType::BigInt:
+    case SqlType::Bit:
+    case SqlType::Float:
+    case SqlType::Real:
+    case SqlType::Decimal:
+    case SqlType::Numeric:
+    case SqlType::Money:
+    case SqlType::SmallMoney:
+    case SqlType::Date:
+    case SqlType::Time:
+    case SqlType::DateTime:
+    case SqlType::DateTime2:
+    case SqlType::SmallDateTime:
+    case SqlType::DateTimeOffset:
+    case SqlType::Char:
+    case SqlType::NChar:
+    case SqlType::Binary:
+    case SqlType::UniqueId:
+    case SqlType::Timestamp:
+        return false;
+    default:
+        // CLR types (hierarchyid, geometry, geography all report
+        // system_type_id 240) and anything else unrecognised have no
+        // fixed text width; read them unbound like LOBs
+        return true;
+    }
+}
+
+// -------------------------------------------------------------------------
+// Column-wise bound fetch buffers
+// -------------------------------------------------------------------------
+
+namespace {
+
+struct BoundColumn {
+    SQLSMALLINT          c_type = SQL_C_CHAR;
+    SQLLEN               width  = 0;     // bytes per row
+    std::vector<uint8_t> data;           // width * rows
+    std::vector<SQLLEN>  ind;            // length / SQL_NULL_DATA per row
+};
+
+// C type and per-row buffer width for a non-LOB column. Character data
+// arrives in the client code page, which can take up to 3 bytes for each
+// VARCHAR byte or NVARCHAR character, plus a terminator. TINYINT is bound
+// unsigned (0..255 does not fit SQL_C_STINYINT) and stored as int8_t like
+// direct mode does.
+void choose_binding(const ColumnDef& col, BoundColumn& b) {
+    const SQLLEN len = std::max<SQLLEN>(col.max_length, 1);
+    switch (col.type) {
+    case SqlType::TinyInt:  b.c_type = SQL_C_UTINYINT; b.width = 1; break;
+    case SqlType::SmallInt: b.c_type = SQL_C_SSHORT;   b.width = 2; break;
+    case SqlType::Int:      b.c_type = SQL_C_SLONG;    b.width = 4; break;
+    case SqlType::BigInt:   b.c_type = SQL_C_SBIGINT;  b.width = 8; break;
+    case SqlType::Bit:      b.c_type = SQL_C_BIT;      b.width = 1; break;
+    case SqlType::Float:    b.c_type = SQL_C_DOUBLE;   b.width = 8; break;
+    case SqlType::Real:     b.c_type = SQL_C_FLOAT;    b.width = 4; break;
+    case SqlType::Binary:
+    case SqlType::VarBinary:
+    case SqlType::Timestamp:
+        b.c_type = SQL_C_BINARY;
+        b.width  = col.type == SqlType::Timestamp ? 8 : len;
+        break;
+    case SqlType::Char:
+    case SqlType::VarChar:
+        b.width = len * 3 + 1;
+        break;
+    case SqlType::NChar:
+    case SqlType::NVarChar:
+        b.width = (len / 2 + 1) * 3 + 1;
+        break;
+    default:
+        // Numbers, dates and GUIDs as text: decimal(38) with sign and
+        // point, datetimeoffset(7) and the 36-character GUID all fit
+        b.width = 64;
+        break;
+    }
+}
+
+// Store text in a row slot, reusing the string already there
+void assign_text(RowValue& slot, const char* p, size_t n) {
+    if (auto* s = std::get_if<std::string>(&slot)) {
+        s->assign(p, n);
+    } else {
+        slot = std::string(p, n);
+    }
+}
+
+// Row r of a bound column as a RowValue
+void read_bound(const BoundColumn& b, size_t r, RowValue& slot) {
+    SQLLEN n = b.ind[r];
+    if (n == SQL_NULL_DATA) { slot = NullValue{}; return; }
+    const uint8_t* p = b.data.data() + r * static_cast<size_t>(b.width);
+
+    switch (b.c_type) {
+    case SQL_C_UTINYINT: slot = static_cast<int8_t>(p[0]); return;
+    case SQL_C_SSHORT: { int16_t v; std::memcpy(&v, p, 2); slot = v; return; }
+    case SQL_C_SLONG:  { int32_t v; std::memcpy(&v, p, 4); slot = v; return; }
+    case SQL_C_SBIGINT:{ int64_t v; std::memcpy(&v, p, 8); slot = v; return; }
+    case SQL_C_BIT:    slot = p[0] != 0; return;
+    case SQL_C_DOUBLE: { double v; std::memcpy(&v, p, 8); slot = v; return; }
+    case SQL_C_FLOAT:  { float v;  std::memcpy(&v, p, 4); slot = v; return; }
+    case SQL_C_BINARY: {
+        size_t len = (n == SQL_NO_TOTAL || n > b.width) ? static_cast<size_t>(b.width)
+                                                        : static_cast<size_t>(n);
+        if (auto* v = std::get_if<std::vector<uint8_t>>(&slot)) {
+            v->assign(p, p + len);
+        } else {
+            slot = std::vector<uint8_t>(p, p + len);
+        }
+        return;
+    }
+    default: {
+        // SQL_C_CHAR: the indicator excludes the terminator
+        const char* c = reinterpret_cast<const char*>(p);
+        size_t len = (n == SQL_NO_TOTAL || n >= b.width) ? strnlen(c, static_cast<size_t>(b.width))
+                                                          : static_cast<size_t>(n);
+        assign_text(slot, c, len);
+        return;
+    }
+    }
+}
+
+}  // namespace
+
 bool OdbcConnection::query_rows(const std::string& sql,
                                  const std::vector<ColumnDef>& schema,
                                  RowCallback callback,
-                                 int64_t max_rows) {
+                                 int64_t max_rows,
+                                 const std::vector<size_t>& positions) {
     if (!execute(sql)) return false;
 
+    // Bound columns are the select-list prefix before the first LOB
+    size_t bound_count = 0;
+    while (bound_count < schema.size() && !is_lob_column(schema[bound_count])) ++bound_count;
+    for (size_t i = bound_count; i < schema.size(); ++i) {
+        if (!is_lob_column(schema[i])) {
+            LOG_WARN("Column %s follows a LOB column and is read with SQLGetData",
+                     schema[i].name.c_str());
+        }
+    }
+
+    std::vector<BoundColumn> bound(bound_count);
+    size_t row_bytes = 0;
+    for (size_t i = 0; i < bound_count; ++i) {
+        choose_binding(schema[i], bound[i]);
+        row_bytes += static_cast<size_t>(bound[i].width) + sizeof(SQLLEN);
+    }
+
+    // SQLGetData on LOB columns needs a single-row cursor
+    size_t rows_per_fetch = 1;
+    if (bound_count == schema.size()) {
+        rows_per_fetch = std::clamp<size_t>(FETCH_BUFFER_BYTES / std::max<size_t>(row_bytes, 1),
+                                            1, FETCH_ROWS);
+    }
+
+    SQLULEN fetched = 0;
+    std::vector<SQLUSMALLINT> status(rows_per_fetch);
+    SQLSetStmtAttr(stmt_, SQL_ATTR_ROW_BIND_TYPE,
+                   reinterpret_cast<SQLPOINTER>(static_cast<SQLULEN>(SQL_BIND_BY_COLUMN)), 0);
+    SQLSetStmtAttr(stmt_, SQL_ATTR_ROW_ARRAY_SIZE,
+                   reinterpret_cast<SQLPOINTER>(static_cast<SQLULEN>(rows_per_fetch)), 0);
+    SQLSetStmtAttr(stmt_, SQL_ATTR_ROWS_FETCHED_PTR, &fetched, 0);
+    SQLSetStmtAttr(stmt_, SQL_ATTR_ROW_STATUS_PTR, status.data(), 0);
+
+    // Close the cursor and drop the bindings and fetch pointers however
+    // this returns: the callback may throw, and the buffers the statement
+    // points at go away with this frame
+    struct FetchReset {
+        OdbcConnection* conn;
+        ~FetchReset() {
+            SQLFreeStmt(conn->stmt_, SQL_CLOSE);
+            conn->reset_fetch_attrs();
+        }
+    } fetch_reset{this};
+
+    for (size_t i = 0; i < bound_count; ++i) {
+        BoundColumn& b = bound[i];
+        b.data.resize(static_cast<size_t>(b.width) * rows_per_fetch);
+        b.ind.resize(rows_per_fetch);
+        SQLRETURN br = SQLBindCol(stmt_, static_cast<SQLUSMALLINT>(i + 1), b.c_type,
+                                  b.data.data(), b.width, b.ind.data());
+        if (!SQL_SUCCEEDED(br)) {
+            last_error_ = get_diag(SQL_HANDLE_STMT, stmt_);
+            LOG_ERROR("Cannot bind column %s: %s", schema[i].name.c_str(), last_error_.c_str());
+            return false;
+        }
+    }
+
+    LOG_DEBUG("Block fetch: %zu rows per fetch, %zu bound / %zu LOB columns",
+              rows_per_fetch, bound_count, schema.size() - bound_count);
+
+    auto position = [&](size_t i) { return positions.empty() ? i : positions[i]; };
+
     int64_t row_count = 0;
+    bool stop = false;
+    Row row(schema.size());
     SQLRETURN ret;
 
-    while ((ret = SQLFetch(stmt_)) == SQL_SUCCESS ||
-           ret == SQL_SUCCESS_WITH_INFO) {
+    while (!stop && ((ret = SQLFetch(stmt_)) == SQL_SUCCESS ||
+                     ret == SQL_SUCCESS_WITH_INFO)) {
+        for (size_t r = 0; r < fetched; ++r) {
+            if (status[r] == SQL_ROW_NOROW) continue;
+            if (status[r] == SQL_ROW_ERROR) {
+                LOG_WARN("Skipping row with a fetch error: %s",
+                         get_diag(SQL_HANDLE_STMT, stmt_).c_str());
+                continue;
+            }
 
-        Row row(schema.size());
-        for (size_t i = 0; i < schema.size(); ++i) {
-            row[i] = fetch_column_value(stmt_, static_cast<int>(i + 1), schema[i]);
-        }
+            for (size_t i = 0; i < bound_count; ++i) {
+                read_bound(bound[i], r, row[position(i)]);
+            }
+            for (size_t i = bound_count; i < schema.size(); ++i) {
+                row[position(i)] = fetch_column_value(stmt_, static_cast<int>(i + 1), schema[i]);
+            }
 
-        if (!callback(row)) break;
+            if (!callback(row)) { stop = true; break; }
 
-        ++row_count;
-        if (max_rows > 0 && row_count >= max_rows) break;
+            ++row_count;
+            if (max_rows > 0 && row_count >= max_rows) { stop = true; break; }
+        }
     }
 
-    SQLFreeStmt(stmt_, SQL_CLOSE);
     return true;
 }
 
+void OdbcConnection::reset_fetch_attrs() {
+    SQLFreeStmt(stmt_, SQL_UNBIND);
+    SQLSetStmtAttr(stmt_, SQL_ATTR_ROW_ARRAY_SIZE,
+                   reinterpret_cast<SQLPOINTER>(static_cast<SQLULEN>(1)), 0);
+    SQLSetStmtAttr(stmt_, SQL_ATTR_ROWS_FETCHED_PTR, nullptr, 0);
+    SQLSetStmtAttr(stmt_, SQL_ATTR_ROW_STATUS_PTR, nullptr, 0);
+}
+
 RowValue OdbcConnection::fetch_column_value(SQLHSTMT stmt, int col_index,
                                              const ColumnDef& col_def) {
     SQLLEN indicator;
@@ -384,6 +609,68 @@ std::string OdbcConnection::get_diag(SQLSMALLINT handle_type, SQLHANDLE handle)
 // RestoreAdapter
 // =========================================================================
 
+namespace {
+
+using TextRow = std::map<std::string, std::string>;
+
+// 1-based indices of the named columns of the current result set, in
+// ascending order. For result sets whose layout changes between SQL Server
+// versions (RESTORE HEADERONLY gains columns with most releases).
+std::vector<std::pair<SQLUSMALLINT, std::string>>
+find_columns(SQLHSTMT stmt, const std::vector<std::string>& names) {
+    std::vector<std::pair<SQLUSMALLINT, std::string>> found;
+    SQLSMALLINT count = 0;
+    SQLNumResultCols(stmt, &count);
+    for (SQLSMALLINT i = 1; i <= count; ++i) {
+        SQLCHAR name[128];
+        SQLSMALLINT name_len = 0, type = 0, digits = 0, nullable = 0;
+        SQLULEN size = 0;
+        if (!SQL_SUCCEEDED(SQLDescribeColA(stmt, static_cast<SQLUSMALLINT>(i), name,
+                                           sizeof(name), &name_len, &type, &size,
+                                           &digits, &nullable)))
+            continue;
+        std::string col(reinterpret_cast<char*>(name));
+        if (std::find(names.begin(), names.end(), col) != names.end())
+            found.emplace_back(static_cast<SQLUSMALLINT>(i), col);
+    }
+    return found;
+}
+
+// The given columns of the fetched row as text (NULLs are left out). The
+// SQL Server driver only allows SQLGetData in ascending column order.
+TextRow read_text_row(SQLHSTMT stmt,
+                      const std::vector<std::pair<SQLUSMALLINT, std::string>>& cols) {
+    TextRow row;
+    char buf[1024];
+    SQLLEN ind;
+    for (const auto& col : cols) {
+        SQLRETURN ret = SQLGetData(stmt, col.first, SQL_C_CHAR, buf, sizeof(buf), &ind);
+        if (SQL_SUCCEEDED(ret) && ind != SQL_NULL_DATA) row[col.second] = buf;
+    }
+    return row;
+}
+
+int64_t row_int(const TextRow& row, const char* name) {
+    auto it = row.find(name);
+    return it == row.end() ? 0 : std::atoll(it->second.c_str());
+}
+
+std::string row_text(const TextRow& row, const char* name) {
+    auto it = row.find(name);
+    return it == row.end() ? std::string() : it->second;
+}
+
+// Directory with a trailing separator in the server's style
+std::string as_dir(std::string dir) {
+    if (dir.empty()) return dir;
+    char sep = (dir.find('/') != std::string::npos && dir.find('\\') == std::string::npos)
+             ? '/' : '\\';
+    if (dir.back() != '/' && dir.back() != '\\') dir += sep;
+    return dir;
+}
+
+}  // namespace
+
 RestoreAdapter::RestoreAdapter(const RestoreOptions& opts)
     : opts_(opts)
 {
@@ -557,39 +844,33 @@ bool RestoreAdapter::step_read_backup_info() {
         return false;
     }
 
-    // Read header results
-    SQLRETURN ret;
-    while ((ret = SQLFetch(conn_->raw_stmt())) == SQL_SUCCESS) {
-        BackupSetInfo bsi;
-
-        char buf[1024];
-        SQLLEN ind;
-
-        SQLGetData(conn_->raw_stmt(), 1, SQL_C_CHAR, buf, sizeof(buf), &ind);
-        // Field 1 = BackupName
-
-        SQLGetData(conn_->raw_stmt(), 4, SQL_C_CHAR, buf, sizeof(buf), &ind);
-        if (ind != SQL_NULL_DATA) bsi.database_name = buf;
-
-        SQLGetData(conn_->raw_stmt(), 7, SQL_C_CHAR, buf, sizeof(buf), &ind);
-        if (ind != SQL_NULL_DATA) bsi.server_name = buf;
+    // Read header results by column name: positions differ by version
+    const SQLHSTMT stmt = conn_->raw_stmt();
+    const auto header_cols = find_columns(stmt, {
+        "BackupType", "Compressed", "Position", "ServerName", "DatabaseName",
+        "BackupSize", "BackupStartDate", "BackupFinishDate", "SoftwareVersionMajor",
+        "SoftwareVersionMinor", "CompatibilityLevel", "CompressedBackupSize",
+        "BackupSetGUID", "EncryptorType"});
 
-        int32_t bt = 0;
-        SQLGetData(conn_->raw_stmt(), 3, SQL_C_SLONG, &bt, sizeof(bt), &ind);
-        bsi.backup_type = static_cast<BackupType>(bt);
-
-        int32_t pos = 0;
-        SQLGetData(conn_->raw_stmt(), 2, SQL_C_SLONG, &pos, sizeof(pos), &ind);
-        bsi.position = pos;
-
-        int32_t compressed = 0;
-        SQLGetData(conn_->raw_stmt(), 53, SQL_C_SLONG, &compressed, sizeof(compressed), &ind);
-        bsi.is_compressed = (compressed != 0);
+    SQLRETURN ret;
+    while ((ret = SQLFetch(stmt)) == SQL_SUCCESS || ret == SQL_SUCCESS_WITH_INFO) {
+        TextRow row = read_text_row(stmt, header_cols);
 
-        // Check for encryption (column varies by version)
-        int32_t encrypted = 0;
-        SQLGetData(conn_->raw_stmt(), 62, SQL_C_SLONG, &encrypted, sizeof(encrypted), &ind);
-        bsi.is_encrypted = (ind != SQL_NULL_DATA && encrypted != 0);
+        BackupSetInfo bsi;
+        bsi.position            = static_cast<int32_t>(row_int(row, "Position"));
+        bsi.backup_type         = static_cast<BackupType>(row_int(row, "BackupType"));
+        bsi.database_name       = row_text(row, "DatabaseName");
+        bsi.server_name         = row_text(row, "ServerName");
+        bsi.is_compressed       = row_int(row, "Compressed") != 0;
+        bsi.is_encrypted        = !row_text(row, "EncryptorType").empty();
+        bsi.backup_size         = static_cast<uint64_t>(row_int(row, "BackupSize"));
+        bsi.compressed_size     = static_cast<uint64_t>(row_int(row, "CompressedBackupSize"));
+        bsi.backup_start_date   = row_text(row, "BackupStartDate");
+        bsi.backup_finish_date  = row_text(row, "BackupFinishDate");
+        bsi.compatibility_level = static_cast<int32_t>(row_int(row, "CompatibilityLevel"));
+        bsi.software_major      = static_cast<int32_t>(row_int(row, "SoftwareVersionMajor"));
+        bsi.software_minor      = static_cast<int32_t>(row_int(row, "SoftwareVersionMinor"));
+        bsi.backup_set_guid     = row_text(row, "BackupSetGUID");
 
         backup_info_.backup_sets.push_back(bsi);
 
@@ -599,7 +880,7 @@ bool RestoreAdapter::step_read_backup_info() {
                  bsi.is_compressed ? "yes" : "no",
                  bsi.is_encrypted ? "yes" : "no");
     }
-    SQLFreeStmt(conn_->raw_stmt(), SQL_CLOSE);
+    SQLFreeStmt(stmt, SQL_CLOSE);
 
     if (backup_info_.backup_sets.empty()) {
         LOG_ERROR("No backup sets found in file");
@@ -638,6 +919,17 @@ bool RestoreAdapter::step_read_backup_info() {
         SQLFreeStmt(conn_->raw_stmt(), SQL_CLOSE);
     }
 
+    fingerprint_ = backup_set_fingerprint();
+    if ((opts_.keep_database || opts_.reuse_database) && opts_.target_database.empty()) {
+        // Same backup set, same name: later runs find the database
+        std::string db;
+        for (char c : backup_info_.backup_sets[0].database_name) {
+            if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') db += c;
+        }
+        temp_db_name_ = "bakread_" + db.substr(0, 64) + (db.empty() ? "" : "_") + fingerprint_;
+    }
+    LOG_DEBUG("Backup set fingerprint: %s", fingerprint_.c_str());
+
     return true;
 }
 
@@ -688,6 +980,18 @@ bool RestoreAdapter::step_provision_tde() {
 
     std::string cert_name = "bakread_tde_cert_" + temp_db_name_;
     std::string sql;
+
+    // A kept database's certificate stays behind for the next run
+    std::string cert_exists;
+    conn_->query_scalar(
+        "SELECT CASE WHEN EXISTS(SELECT 1 FROM sys.certificates "
+        "WHERE name = N'" + cert_name + "') THEN 'Y' ELSE 'N' END",
+        cert_exists);
+    if (cert_exists == "Y") {
+        cert_imported_ = true;
+        LOG_INFO("TDE certificate already present: %s", cert_name.c_str());
+        return true;
+    }
     
     // Determine the private key file path
     std::string key_file = opts_.tde_cert_key.empty() 
@@ -718,6 +1022,8 @@ bool RestoreAdapter::step_provision_tde() {
 }
 
 bool RestoreAdapter::step_restore_database() {
+    if ((opts_.keep_database || opts_.reuse_database) && reuse_database()) return true;
+
     LOG_INFO("Step 4: Restoring database as '%s'...", temp_db_name_.c_str());
 
     // Get default data/log directories
@@ -732,41 +1038,57 @@ bool RestoreAdapter::step_restore_database() {
     if (default_data_dir.empty()) default_data_dir = "C:\\SQLData\\";
     if (default_log_dir.empty()) default_log_dir = default_data_dir;
 
-    // Build RESTORE command with MOVE clauses
-    std::ostringstream sql;
-    sql << "RESTORE DATABASE [" << temp_db_name_ << "] "
-        << "FROM " << build_from_disk_clause() << " "
-        << "WITH ";
+    // Data files go round-robin across the data directories, so several
+    // volumes share the restore writes; logs go to the log directory
+    std::vector<std::string> data_dirs = opts_.data_dirs;
+    if (data_dirs.empty()) data_dirs.push_back(default_data_dir);
+    for (auto& d : data_dirs) d = as_dir(d);
+    const std::string log_dir = as_dir(opts_.log_dir.empty() ? default_log_dir : opts_.log_dir);
 
-    // Add MOVE clauses for each file
+    // WITH options; without a file list the files keep their original paths
+    std::vector<std::string> with;
+    size_t data_files = 0;
     for (size_t i = 0; i < backup_info_.file_list.size(); ++i) {
         auto& fi = backup_info_.file_list[i];
-        std::string target_dir = (fi.file_type == 'L') ? default_log_dir : default_data_dir;
-        std::string ext = (fi.file_type == 'L') ? ".ldf" : ".mdf";
-        if (i > 0 && fi.file_type != 'L') ext = ".ndf";
+        bool is_log = fi.file_type == 'L';
+        std::string target_dir = is_log ? log_dir : data_dirs[data_files % data_dirs.size()];
+        std::string ext = is_log ? ".ldf" : (data_files == 0 ? ".mdf" : ".ndf");
+        if (!is_log) ++data_files;
 
-        sql << "MOVE N'" << fi.logical_name << "' TO N'"
-            << target_dir << temp_db_name_ << "_" << i << ext << "'";
-
-        if (i < backup_info_.file_list.size() - 1) sql << ", ";
-    }
-
-    // If no file list was obtained, try without MOVE (risky but may work)
-    if (backup_info_.file_list.empty()) {
-        sql.str("");
-        sql << "RESTORE DATABASE [" << temp_db_name_ << "] "
-            << "FROM " << build_from_disk_clause() << " "
-            << "WITH ";
+        with.push_back("MOVE N'" + fi.logical_name + "' TO N'" +
+                       target_dir + temp_db_name_ + "_" + std::to_string(i) + ext + "'");
     }
 
-    sql << ", REPLACE, RECOVERY";
+    with.push_back("REPLACE");
+    with.push_back("RECOVERY");
 
     // Backup set selection
     if (opts_.backupset > 0) {
-        sql << ", FILE = " << opts_.backupset;
+        with.push_back("FILE = " + std::to_string(opts_.backupset));
+    }
+
+    // Throughput: I/O buffers and transfer unit between backup and database
+    if (opts_.buffer_count > 0) {
+        with.push_back("BUFFERCOUNT = " + std::to_string(opts_.buffer_count));
     }
+    if (opts_.max_transfer_size > 0) {
+        with.push_back("MAXTRANSFERSIZE = " + std::to_string(opts_.max_transfer_size));
+    }
+    if (opts_.buffer_count > 0 || opts_.max_transfer_size > 0 || data_dirs.size() > 1) {
+        LOG_INFO("Restore tuning: BUFFERCOUNT=%d MAXTRANSFERSIZE=%d, data files over %zu director%s",
+                 opts_.buffer_count, opts_.max_transfer_size, data_dirs.size(),
+                 data_dirs.size() == 1 ? "y" : "ies");
+    }
+
+    with.push_back("STATS = 10");
 
-    sql << ", STATS = 10";
+    std::ostringstream sql;
+    sql << "RESTORE DATABASE [" << temp_db_name_ << "] "
+        << "FROM " << build_from_disk_clause() << " WITH ";
+    for (size_t i = 0; i < with.size(); ++i) {
+        if (i > 0) sql << ", ";
+        sql << with[i];
+    }
 
     LOG_DEBUG("RESTORE SQL: %s", sql.str().c_str());
 
@@ -797,6 +1119,12 @@ bool RestoreAdapter::step_restore_database() {
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
 
+    // Mark the database as restored from this backup set for later runs
+    if (opts_.keep_database || opts_.reuse_database) {
+        conn_->execute("EXEC [" + temp_db_name_ + "].sys.sp_addextendedproperty "
+                       "@name = N'bakread_fingerprint', @value = N'" + fingerprint_ + "'");
+    }
+
     // Verify TDE state if applicable
     if (!opts_.tde_cert_pfx.empty()) {
         std::string tde_state;
@@ -810,6 +1138,33 @@ bool RestoreAdapter::step_restore_database() {
     return true;
 }
 
+bool RestoreAdapter::reuse_database() {
+    std::string state;
+    conn_->query_scalar(
+        "SELECT state_desc FROM sys.databases WHERE name = N'" + temp_db_name_ + "'",
+        state);
+    if (state.empty()) return false;
+
+    std::string recorded;
+    if (state == "ONLINE") {
+        conn_->query_scalar(
+            "SELECT CAST(value AS NVARCHAR(128)) FROM [" + temp_db_name_ +
+            "].sys.extended_properties WHERE class = 0 AND name = N'bakread_fingerprint'",
+            recorded);
+    }
+    if (recorded != fingerprint_) {
+        LOG_INFO("Database '%s' exists but was not restored from this backup set (%s); "
+                 "restoring over it", temp_db_name_.c_str(), state.c_str());
+        return false;
+    }
+
+    // Dropped by step_cleanup unless it is still to be kept
+    db_restored_ = true;
+    LOG_INFO("Step 4: Reusing database '%s' restored from this backup set",
+             temp_db_name_.c_str());
+    return true;
+}
+
 bool RestoreAdapter::step_read_schema() {
     LOG_INFO("Step 5: Reading table schema for '%s.%s'...",
              opts_.schema_name.c_str(), opts_.table_name.c_str());
@@ -943,6 +1298,17 @@ bool RestoreAdapter::step_read_schema() {
 uint64_t RestoreAdapter::step_extract_rows(RowCallback& callback) {
     LOG_INFO("Step 6: Extracting rows...");
 
+    size_t queries = opts_.parallel_queries > 1 ? static_cast<size_t>(opts_.parallel_queries) : 1;
+    if (queries > 1 && opts_.max_rows > 0) {
+        LOG_INFO("Row limit set; extracting with a single query");
+        queries = 1;
+    }
+    if (queries > 1) {
+        std::vector<std::string> ranges = plan_ranges(queries);
+        if (ranges.size() > 1) return extract_ranges(ranges, callback);
+        LOG_INFO("Table cannot be split; extracting with a single query");
+    }
+
     std::string query = build_select_query();
     LOG_INFO("Query: %s", query.c_str());
 
@@ -954,7 +1320,192 @@ uint64_t RestoreAdapter::step_extract_rows(RowCallback& callback) {
         return callback(row);
     };
 
-    conn_->query_rows(query, schema_.columns, counting_callback, opts_.max_rows);
+    // The select list has LOB columns last; rows keep schema order
+    std::vector<size_t> order = select_order();
+    std::vector<ColumnDef> select_columns;
+    select_columns.reserve(order.size());
+    for (size_t i : order) select_columns.push_back(schema_.columns[i]);
+
+    conn_->query_rows(query, select_columns, counting_callback, opts_.max_rows, order);
+    return count;
+}
+
+std::vector<std::string> RestoreAdapter::plan_ranges(size_t n) {
+    std::vector<std::string> ranges;
+    const std::string obj_id = std::to_string(schema_.object_id);
+    SQLHSTMT stmt = conn_->raw_stmt();
+    char buf[256];
+    SQLLEN ind;
+
+    // Partitioned heap or clustered index: contiguous partition-number
+    // ranges, so each query reads only its own partitions
+    std::string func, part_col;
+    int32_t fanout = 0;
+    if (conn_->execute(
+            "SELECT TOP(1) pf.name, c.name, pf.fanout FROM sys.indexes i "
+            "JOIN sys.partition_schemes ps ON ps.data_space_id = i.data_space_id "
+            "JOIN sys.partition_functions pf ON pf.function_id = ps.function_id "
+            "JOIN sys.index_columns ic ON ic.object_id = i.object_id "
+            "AND ic.index_id = i.index_id AND ic.partition_ordinal = 1 "
+            "JOIN sys.columns c ON c.object_id = ic.object_id AND c.column_id = ic.column_id "
+            "WHERE i.object_id = " + obj_id + " AND i.index_id IN (0, 1)")) {
+        if (SQLFetch(stmt) == SQL_SUCCESS) {
+            SQLGetData(stmt, 1, SQL_C_CHAR, buf, sizeof(buf), &ind);
+            if (ind != SQL_NULL_DATA) func = buf;
+            SQLGetData(stmt, 2, SQL_C_CHAR, buf, sizeof(buf), &ind);
+            if (ind != SQL_NULL_DATA) part_col = buf;
+            SQLGetData(stmt, 3, SQL_C_SLONG, &fanout, sizeof(fanout), &ind);
+        }
+        SQLFreeStmt(stmt, SQL_CLOSE);
+    }
+
+    if (fanout > 1 && !func.empty() && !part_col.empty()) {
+        size_t parts = std::min<size_t>(n, static_cast<size_t>(fanout));
+        for (size_t i = 0; i < parts; ++i) {
+            size_t lo = 1 + static_cast<size_t>(fanout) * i / parts;
+            size_t hi = static_cast<size_t>(fanout) * (i + 1) / parts;
+            ranges.push_back("$PARTITION.[" + func + "]([" + part_col + "]) BETWEEN " +
+                             std::to_string(lo) + " AND " + std::to_string(hi));
+        }
+        LOG_INFO("Splitting by partition: %zu ranges over %d partitions", parts, fanout);
+        return ranges;
+    }
+
+    // Integer leading clustered key: equal-width key ranges between MIN and
+    // MAX (two index seeks). The outer ranges are open-ended, and NULL keys
+    // go to the first.
+    if (!schema_.is_heap) {
+        std::string key;
+        int32_t key_type = 0;
+        if (conn_->execute(
+                "SELECT c.name, c.system_type_id FROM sys.index_columns ic "
+                "JOIN sys.columns c ON c.object_id = ic.object_id AND c.column_id = ic.column_id "
+                "WHERE ic.object_id = " + obj_id + " AND ic.index_id = 1 AND ic.key_ordinal = 1")) {
+            if (SQLFetch(stmt) == SQL_SUCCESS) {
+                SQLGetData(stmt, 1, SQL_C_CHAR, buf, sizeof(buf), &ind);
+                if (ind != SQL_NULL_DATA) key = buf;
+                SQLGetData(stmt, 2, SQL_C_SLONG, &key_type, sizeof(key_type), &ind);
+            }
+            SQLFreeStmt(stmt, SQL_CLOSE);
+        }
+
+        SqlType type = static_cast<SqlType>(key_type);
+        if (!key.empty() && (type == SqlType::TinyInt || type == SqlType::SmallInt ||
+                             type == SqlType::Int || type == SqlType::BigInt)) {
+            const std::string table = "[" + opts_.schema_name + "].[" + opts_.table_name + "]";
+            const std::string col = "[" + key + "]";
+            int64_t lo = 0, hi = 0;
+            if (!conn_->query_scalar_int("SELECT MIN(" + col + ") FROM " + table, lo) ||
+                !conn_->query_scalar_int("SELECT MAX(" + col + ") FROM " + table, hi) ||
+                hi <= lo) {
+                return ranges;   // empty or single-key table
+            }
+
+            uint64_t span = static_cast<uint64_t>(hi) - static_cast<uint64_t>(lo);
+            size_t parts = span < n ? static_cast<size_t>(span) + 1 : n;
+            uint64_t step = span / parts + (span % parts != 0 ? 1 : 0);
+            auto bound = [&](size_t i) {
+                return std::to_string(static_cast<int64_t>(static_cast<uint64_t>(lo) + step * i));
+            };
+            for (size_t i = 0; i < parts; ++i) {
+                if (i == 0)
+                    ranges.push_back(col + " < " + bound(1) + " OR " + col + " IS NULL");
+                else if (i + 1 == parts)
+                    ranges.push_back(col + " >= " + bound(i));
+                else
+                    ranges.push_back(col + " >= " + bound(i) + " AND " + col + " < " + bound(i + 1));
+            }
+            LOG_INFO("Splitting by clustered key %s: %zu ranges over [%lld, %lld]",
+                     key.c_str(), parts, (long long)lo, (long long)hi);
+            return ranges;
+        }
+    }
+
+    // Anything else: page id (bytes 0-3 of %%physloc%%, little-endian)
+    // modulo n. The predicate is not sargable, so every query scans the
+    // table; repeated scans are served from the buffer pool.
+    const std::string page_id =
+        "CAST(SUBSTRING(%%physloc%%, 4, 1) + SUBSTRING(%%physloc%%, 3, 1) + "
+        "SUBSTRING(%%physloc%%, 2, 1) + SUBSTRING(%%physloc%%, 1, 1) AS int)";
+    for (size_t i = 0; i < n; ++i) {
+        ranges.push_back(page_id + " % " + std::to_string(n) + " = " + std::to_string(i));
+    }
+    LOG_INFO("Splitting by page id modulo %zu", n);
+    return ranges;
+}
+
+uint64_t RestoreAdapter::extract_ranges(const std::vector<std::string>& ranges,
+                                        RowCallback& callback) {
+    LOG_INFO("Running %zu range queries concurrently", ranges.size());
+
+    std::vector<size_t> order = select_order();
+    std::vector<ColumnDef> select_columns;
+    select_columns.reserve(order.size());
+    for (size_t i : order) select_columns.push_back(schema_.columns[i]);
+
+    // Each query collects MERGE_ROWS rows, then hands them to callback
+    // under one lock
+    constexpr size_t MERGE_ROWS = 1024;
+    std::mutex merge_mutex;
+    std::atomic<bool> stop{false};
+    uint64_t count = 0;
+    std::string error;
+
+    auto deliver = [&](const std::vector<Row>& rows, size_t n) {
+        std::lock_guard<std::mutex> lock(merge_mutex);
+        for (size_t i = 0; i < n && !stop.load(); ++i) {
+            ++count;
+            if (count % 100000 == 0)
+                LOG_INFO("  Exported %llu rows...", (unsigned long long)count);
+            if (!callback(rows[i])) stop.store(true);
+        }
+    };
+
+    auto fail = [&](const std::string& msg) {
+        std::lock_guard<std::mutex> lock(merge_mutex);
+        if (error.empty()) error = msg;
+        stop.store(true);
+    };
+
+    auto run_range = [&](size_t r) {
+        try {
+            OdbcConnection conn;
+            if (!conn.connect(opts_.target_server, temp_db_name_,
+                              opts_.sql_username, opts_.sql_password)) {
+                fail("Range query " + std::to_string(r) + ": " + conn.last_error());
+                return;
+            }
+
+            std::string query = build_select_query(ranges[r]);
+            LOG_DEBUG("Range %zu: %s", r, query.c_str());
+
+            std::vector<Row> rows(MERGE_ROWS);
+            size_t pending = 0;
+            bool ok = conn.query_rows(query, select_columns, [&](const Row& row) -> bool {
+                rows[pending++] = row;
+                if (pending == MERGE_ROWS) {
+                    deliver(rows, pending);
+                    pending = 0;
+                }
+                return !stop.load();
+            }, -1, order);
+
+            if (!ok) {
+                fail("Range query " + std::to_string(r) + ": " + conn.last_error());
+                return;
+            }
+            if (pending > 0) deliver(rows, pending);
+        } catch (const std::exception& e) {
+            fail(e.what());
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(ranges.size());
+    for (size_t r = 0; r < ranges.size(); ++r) threads.emplace_back(run_range, r);
+    for (auto& t : threads) t.join();
+
+    if (!error.empty()) throw OdbcError(error);
     return count;
 }
 
@@ -966,8 +1517,11 @@ void RestoreAdapter::step_cleanup() {
     // Switch back to master
     conn_->execute("USE master");
 
-    // Drop temporary database
-    if (db_restored_) {
+    // Drop temporary database, unless it is kept for later runs
+    if (db_restored_ && opts_.keep_database) {
+        LOG_INFO("Keeping restored database: %s", temp_db_name_.c_str());
+        db_restored_ = false;
+    } else if (db_restored_) {
         LOG_INFO("Dropping temporary database: %s", temp_db_name_.c_str());
         conn_->execute("ALTER DATABASE [" + temp_db_name_ +
                         "] SET SINGLE_USER WITH ROLLBACK IMMEDIATE");
@@ -976,21 +1530,32 @@ void RestoreAdapter::step_cleanup() {
     }
 
     // Cleanup certificates if requested
-    if (cert_imported_ && opts_.cleanup_keys) {
+    // (a kept TDE database still needs its certificate and master key)
+    if (cert_imported_ && opts_.cleanup_keys && !opts_.keep_database) {
         std::string cert_name = "bakread_tde_cert_" + temp_db_name_;
         LOG_INFO("Removing certificate: %s", cert_name.c_str());
         conn_->execute("DROP CERTIFICATE [" + cert_name + "]");
         cert_imported_ = false;
     }
 
-    if (master_key_created_ && opts_.cleanup_keys) {
+    if (master_key_created_ && opts_.cleanup_keys && !opts_.keep_database) {
         LOG_INFO("Dropping temporary master key");
         conn_->execute("DROP MASTER KEY");
         master_key_created_ = false;
     }
 }
 
-std::string RestoreAdapter::build_select_query() const {
+std::vector<size_t> RestoreAdapter::select_order() const {
+    std::vector<size_t> order;
+    order.reserve(schema_.columns.size());
+    for (size_t i = 0; i < schema_.columns.size(); ++i)
+        if (!is_lob_column(schema_.columns[i])) order.push_back(i);
+    for (size_t i = 0; i < schema_.columns.size(); ++i)
+        if (is_lob_column(schema_.columns[i])) order.push_back(i);
+    return order;
+}
+
+std::string RestoreAdapter::build_select_query(const std::string& range) const {
     std::ostringstream sql;
     sql << "SELECT ";
 
@@ -1001,16 +1566,21 @@ std::string RestoreAdapter::build_select_query() const {
     if (schema_.columns.empty()) {
         sql << "*";
     } else {
-        for (size_t i = 0; i < schema_.columns.size(); ++i) {
+        std::vector<size_t> order = select_order();
+        for (size_t i = 0; i < order.size(); ++i) {
             if (i > 0) sql << ", ";
-            sql << "[" << schema_.columns[i].name << "]";
+            sql << "[" << schema_.columns[order[i]].name << "]";
         }
     }
 
     sql << " FROM [" << opts_.schema_name << "].[" << opts_.table_name << "]";
 
-    if (!opts_.where_clause.empty()) {
+    if (!opts_.where_clause.empty() && !range.empty()) {
+        sql << " WHERE (" << opts_.where_clause << ") AND (" << range << ")";
+    } else if (!opts_.where_clause.empty()) {
         sql << " WHERE " << opts_.where_clause;
+    } else if (!range.empty()) {
+        sql << " WHERE " << range;
     }
 
     return sql.str();
@@ -1025,6 +1595,42 @@ std::string RestoreAdapter::build_from_disk_clause() const {
     return ss.str();
 }
 
+std::string RestoreAdapter::backup_set_fingerprint() const {
+    // The set RESTORE will pick: FILE = backupset, or the first
+    const std::vector<BackupSetInfo>& sets = backup_info_.backup_sets;
+    int32_t position = opts_.backupset > 0 ? opts_.backupset : 1;
+    const BackupSetInfo* set = sets.empty() ? nullptr : &sets[0];
+    for (const auto& s : sets) {
+        if (s.position == position) { set = &s; break; }
+    }
+
+    // FNV-1a over the set's identity
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const void* data, size_t len) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < len; ++i) h = (h ^ p[i]) * 1099511628211ull;
+    };
+    auto mix_str = [&mix](const std::string& v) { mix(v.data(), v.size() + 1); };
+    auto mix_u64 = [&mix](uint64_t v) { mix(&v, sizeof(v)); };
+
+    mix_u64(opts_.bak_paths.size());
+    if (set) {
+        mix_str(set->backup_set_guid);
+        mix_str(set->database_name);
+        mix_str(set->server_name);
+        mix_str(set->backup_start_date);
+        mix_str(set->backup_finish_date);
+        mix_u64(set->backup_size);
+        mix_u64(static_cast<uint64_t>(set->position));
+        mix_u64(static_cast<uint64_t>(set->backup_type));
+    }
+
+    static const char HEX[] = "0123456789abcdef";
+    std::string out(16, '0');
+    for (int i = 15; i >= 0; --i, h >>= 4) out[i] = HEX[h & 0xF];
+    return out;
+}
+
 std::string RestoreAdapter::generate_temp_db_name() {
     auto now = std::chrono::system_clock::now().time_since_epoch();
     auto ms  = std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
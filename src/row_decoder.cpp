@@ -1,12 +1,14 @@
 #include "bakread/row_decoder.h"
 #include "bakread/error.h"
+#include "bakread/lob_reader.h"
 #include "bakread/logging.h"
+#include "bakread/row_filter.h"
+#include "bakread/utf16.h"
 
 #include <algorithm>
 #include <cmath>
 #include <cstring>
-#include <sstream>
-#include <iomanip>
+#include <limits>
 
 namespace bakread {
 
@@ -15,11 +17,11 @@ namespace bakread {
 // Uses the algorithm from Howard Hinnant's date library.
 // -------------------------------------------------------------------------
 static void days_to_ymd(int days, int& y, int& m, int& d) {
-    days += 305;  // shift epoch from 0001-01-01 to 0000-03-01
+    days += 306;  // shift epoch from 0001-01-01 to 0000-03-01
     int era = (days >= 0 ? days : days - 146096) / 146097;
     int doe = days - era * 146097;
     int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
-    y = yoe + era * 400 + 1;
+    y = yoe + era * 400;
     int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
     int mp = (5 * doy + 2) / 153;
     d = doy - (153 * mp + 2) / 5 + 1;
@@ -27,6 +29,67 @@ static void days_to_ymd(int days, int& y, int& m, int& d) {
     if (m <= 2) ++y;
 }
 
+// DATETIME / SMALLDATETIME count days from 1900-01-01
+static constexpr int DAYS_0001_TO_1900 = 693595;
+
+// -------------------------------------------------------------------------
+// Digit writers: two digits at a time from a "00".."99" table, so the
+// formatters below need no printf and no allocation
+// -------------------------------------------------------------------------
+struct DigitPairs {
+    char text[200];
+    constexpr DigitPairs() : text() {
+        for (int i = 0; i < 100; ++i) {
+            text[i * 2]     = static_cast<char>('0' + i / 10);
+            text[i * 2 + 1] = static_cast<char>('0' + i % 10);
+        }
+    }
+};
+static constexpr DigitPairs DIGIT_PAIRS;
+
+static inline char* put2(char* p, unsigned v) {
+    std::memcpy(p, DIGIT_PAIRS.text + v * 2, 2);
+    return p + 2;
+}
+
+static inline char* put4(char* p, unsigned v) {
+    return put2(put2(p, v / 100), v % 100);
+}
+
+// Exactly `digits` digits of v, zero-padded on the left
+static inline char* put_fixed(char* p, uint64_t v, int digits) {
+    for (int i = digits - 1; i >= 0; --i) {
+        p[i] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    }
+    return p + digits;
+}
+
+// "YYYY-MM-DD"
+static inline char* put_date(char* p, int days_since_0001) {
+    int y, m, d;
+    days_to_ymd(days_since_0001, y, m, d);
+    p = put4(p, static_cast<unsigned>(y));
+    *p++ = '-';
+    p = put2(p, static_cast<unsigned>(m));
+    *p++ = '-';
+    return put2(p, static_cast<unsigned>(d));
+}
+
+// "HH:MM:SS" plus ".f" with `frac_digits` digits when frac_digits > 0
+static inline char* put_time(char* p, uint64_t total_secs, uint64_t frac, int frac_digits) {
+    p = put2(p, static_cast<unsigned>(total_secs / 3600 % 100));
+    *p++ = ':';
+    p = put2(p, static_cast<unsigned>(total_secs % 3600 / 60));
+    *p++ = ':';
+    p = put2(p, static_cast<unsigned>(total_secs % 60));
+    if (frac_digits > 0) {
+        *p++ = '.';
+        p = put_fixed(p, frac, frac_digits);
+    }
+    return p;
+}
+
 // -------------------------------------------------------------------------
 // SqlDecimal helpers
 // -------------------------------------------------------------------------
@@ -43,11 +106,69 @@ double SqlDecimal::to_double() const {
     return positive ? val : -val;
 }
 
+void SqlDecimal::unscaled_le(uint8_t out[16]) const {
+    std::memcpy(out, data, 16);
+    if (positive) return;
+    // Two's complement negation: invert, then add one with carry
+    unsigned carry = 1;
+    for (int i = 0; i < 16; ++i) {
+        unsigned v = static_cast<uint8_t>(~out[i]) + carry;
+        out[i] = static_cast<uint8_t>(v);
+        carry = v >> 8;
+    }
+}
+
 std::string SqlDecimal::to_string() const {
-    // Simple string representation via double (sufficient for most cases)
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(scale) << to_double();
-    return oss.str();
+    char buf[FORMAT_SIZE];
+    return std::string(buf, format(buf));
+}
+
+size_t SqlDecimal::format(char* out) const {
+    // Magnitude as four 32-bit limbs, most significant first
+    uint32_t limbs[4];
+    for (int i = 0; i < 4; ++i) {
+        std::memcpy(&limbs[3 - i], data + i * 4, 4);
+    }
+
+    // Peel off 9 decimal digits at a time (long division by 10^9); the
+    // remainder stays below 10^9, so (rem << 32 | limb) fits in 64 bits
+    char digits[45];
+    char* end = digits + sizeof(digits);
+    char* p = end;
+    int top = 0;
+    while (top < 4 && limbs[top] == 0) ++top;
+    while (top < 4) {
+        uint64_t rem = 0;
+        for (int i = top; i < 4; ++i) {
+            uint64_t cur = (rem << 32) | limbs[i];
+            limbs[i] = static_cast<uint32_t>(cur / 1000000000u);
+            rem = cur % 1000000000u;
+        }
+        while (top < 4 && limbs[top] == 0) ++top;
+        if (top < 4) {
+            p -= 9;
+            put_fixed(p, rem, 9);
+        } else {
+            do { *--p = static_cast<char>('0' + rem % 10); rem /= 10; } while (rem);
+        }
+    }
+
+    const int s = std::min<int>(scale, 38);
+    const bool zero = p == end;
+    // At least one digit before the point
+    while (end - p < s + 1) *--p = '0';
+
+    char* o = out;
+    if (!positive && !zero) *o++ = '-';
+    size_t int_digits = static_cast<size_t>(end - p) - static_cast<size_t>(s);
+    std::memcpy(o, p, int_digits);
+    o += int_digits;
+    if (s > 0) {
+        *o++ = '.';
+        std::memcpy(o, p + int_digits, static_cast<size_t>(s));
+        o += s;
+    }
+    return static_cast<size_t>(o - out);
 }
 
 // -------------------------------------------------------------------------
@@ -55,40 +176,190 @@ std::string SqlDecimal::to_string() const {
 // -------------------------------------------------------------------------
 
 std::string SqlGuid::to_string() const {
+    char buf[FORMAT_SIZE + 1];
+    return std::string(buf, format(buf));
+}
+
+size_t SqlGuid::format(char* out) const {
     // SQL Server stores GUIDs in mixed-endian format:
     //   Data1 (4 bytes LE), Data2 (2 bytes LE), Data3 (2 bytes LE),
     //   Data4 (8 bytes BE)
-    char buf[64];
-    snprintf(buf, sizeof(buf),
+    snprintf(out, FORMAT_SIZE + 1,
              "%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X",
              bytes[3], bytes[2], bytes[1], bytes[0],
              bytes[5], bytes[4],
              bytes[7], bytes[6],
              bytes[8], bytes[9],
              bytes[10], bytes[11], bytes[12], bytes[13], bytes[14], bytes[15]);
-    return buf;
+    return FORMAT_SIZE;
+}
+
+void SqlGuid::rfc4122(uint8_t out[16]) const {
+    static const int order[16] = { 3, 2, 1, 0, 5, 4, 7, 6, 8, 9, 10, 11, 12, 13, 14, 15 };
+    for (int i = 0; i < 16; ++i) out[i] = bytes[order[i]];
+}
+
+// -------------------------------------------------------------------------
+// Temporal storage helpers, and typed values (ColumnLayout::Typed) as days
+// and microseconds relative to the Unix epoch
+// -------------------------------------------------------------------------
+static constexpr int64_t DAYS_0001_TO_1970 = 719162;
+static constexpr int64_t DAYS_1900_TO_1970 = 25567;
+static constexpr int64_t MICROS_PER_DAY    = 86400ll * 1000000ll;
+
+// TIME / DATETIME2 time part: 3-5 bytes of 10^-scale second ticks since midnight
+static uint64_t read_time_ticks(const uint8_t* data, int time_bytes) {
+    uint64_t time_val = 0;
+    std::memcpy(&time_val, data, time_bytes);
+    if (time_bytes == 3) time_val &= 0x00FFFFFF;
+    else if (time_bytes == 4) time_val &= 0xFFFFFFFF;
+    return time_val;
+}
+
+static const uint64_t TICKS_PER_SEC[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+
+// Time of day stored in 3-5 bytes in units of 10^-scale seconds
+static int64_t time_micros(const uint8_t* data, int time_bytes, uint8_t scale) {
+    uint64_t time_val = read_time_ticks(data, time_bytes);
+    return scale <= 6 ? static_cast<int64_t>(time_val * (1000000 / TICKS_PER_SEC[scale]))
+                      : static_cast<int64_t>(time_val / 10);
+}
+
+static int time_bytes_for(uint8_t scale) {
+    return (scale <= 2) ? 3 : (scale <= 4) ? 4 : 5;
 }
 
+// DATETIME2 / DATETIMEOFFSET date+time part
+static int64_t datetime2_micros(const uint8_t* data, uint8_t scale) {
+    int time_bytes = time_bytes_for(scale);
+    uint32_t date_val = 0;
+    std::memcpy(&date_val, data + time_bytes, 3);
+    date_val &= 0x00FFFFFF;
+    return (static_cast<int64_t>(date_val) - DAYS_0001_TO_1970) * MICROS_PER_DAY +
+           time_micros(data, time_bytes, scale);
+}
+
+// -------------------------------------------------------------------------
+// Off-row values
+// -------------------------------------------------------------------------
+static const char LOB_PLACEHOLDER[] = "[LOB data]";
+
+// Output space reserved up front for a LOB value at most; the declared
+// size comes from the pointer and is not trusted beyond this
+static constexpr uint64_t LOB_RESERVE_LIMIT = 64ull * 1024 * 1024;
+
+// UTF-16LE arriving in fragments: each piece is converted up to its last
+// whole code point; a split code unit or a high surrogate waiting for its
+// pair is held back and converted with the next piece
+class Utf16Pieces {
+public:
+    // emit(const uint8_t* utf16, size_t len) receives whole code points
+    template <typename Emit>
+    void feed(const uint8_t* p, size_t n, Emit emit) {
+        while (held_ > 0 && n > 0) {
+            hold_[held_++] = *p++;
+            --n;
+            size_t whole = whole_prefix(hold_, held_);
+            if (whole == 0) continue;
+            emit(hold_, whole);
+            std::memmove(hold_, hold_ + whole, held_ - whole);
+            held_ -= whole;
+        }
+        if (n == 0) return;
+
+        size_t whole = whole_prefix(p, n);
+        if (whole > 0) emit(p, whole);
+        held_ = n - whole;
+        std::memcpy(hold_, p + whole, held_);
+    }
+
+    // End of the value: an unpaired high surrogate goes out as is, a stray
+    // odd byte is dropped
+    template <typename Emit>
+    void finish(Emit emit) {
+        if (held_ >= 2) emit(hold_, held_ & ~static_cast<size_t>(1));
+        held_ = 0;
+    }
+
+private:
+    // Longest even prefix that does not end in a high surrogate
+    static size_t whole_prefix(const uint8_t* p, size_t n) {
+        n &= ~static_cast<size_t>(1);
+        if (n >= 2) {
+            unsigned unit = p[n - 2] | (static_cast<unsigned>(p[n - 1]) << 8);
+            if (unit >= 0xD800 && unit <= 0xDBFF) n -= 2;
+        }
+        return n;
+    }
+
+    uint8_t hold_[4];
+    size_t  held_ = 0;
+};
+
 // -------------------------------------------------------------------------
 // RowDecoder
 // -------------------------------------------------------------------------
 
 RowDecoder::RowDecoder(const TableSchema& schema)
-    : schema_(schema)
+    : RowDecoder(schema, {})
 {
+}
+
+RowDecoder::RowDecoder(const TableSchema& schema, const std::vector<int>& projection,
+                       const RowFilter* filter)
+    : schema_(schema), filter_(filter)
+{
+    const int ncols = static_cast<int>(schema_.columns.size());
+
+    // Resolve the physical layout of every column: fixed-data offset for
+    // fixed columns, offset-array slot for variable ones, null bit and the
+    // type-specific decoders
+    layout_.resize(ncols);
     int cur_offset = 4;  // fixed data starts after the 4-byte record header
-    for (int i = 0; i < static_cast<int>(schema_.columns.size()); ++i) {
+    int var_count  = 0;
+    for (int i = 0; i < ncols; ++i) {
         auto& col = schema_.columns[i];
+        ColumnPlan& plan = layout_[i];
+        plan.value     = value_fn_for(col.type);
+        plan.append    = append_fn_for(col.type);
+        plan.def       = &col;
+        plan.physical  = static_cast<uint16_t>(i);
+        plan.null_byte = static_cast<uint16_t>(i >> 3);
+        plan.null_mask = static_cast<uint8_t>(1u << (i & 7));
+        plan.text_ptr  = col.type == SqlType::Text || col.type == SqlType::NText ||
+                         col.type == SqlType::Image;
+        plan.lob = is_unicode(col.type) ? LobText::Utf16
+                 : (col.type == SqlType::Char || col.type == SqlType::VarChar ||
+                    col.type == SqlType::Text) ? LobText::Chars
+                 : LobText::Bytes;
+
         if (is_fixed_length(col.type) && !is_lob(col.type)) {
-            fixed_col_indices_.push_back(i);
             int off = (col.leaf_offset > 0) ? col.leaf_offset : cur_offset;
-            fixed_col_offsets_.push_back(off);
             cur_offset = off + col.max_length;
+            plan.fixed  = true;
+            plan.offset = static_cast<uint16_t>(std::clamp(off, 4, 0xFFFF));
+            plan.length = static_cast<uint16_t>(std::max<int>(col.max_length, 0));
         } else {
-            var_col_indices_.push_back(i);
+            plan.var_index = static_cast<uint16_t>(var_count++);
         }
     }
-    null_bitmap_bytes_ = (static_cast<int>(schema_.columns.size()) + 7) / 8;
+
+    std::vector<int> wanted = projection;
+    if (wanted.empty()) {
+        for (int i = 0; i < ncols; ++i) wanted.push_back(i);
+    }
+
+    // The decode plan covers the projected columns only
+    output_schema_ = schema_;
+    output_schema_.columns.clear();
+    for (int i : wanted) {
+        if (i < 0 || i >= ncols) continue;
+        ColumnPlan plan = layout_[i];
+        plan.column = static_cast<uint16_t>(output_schema_.columns.size());
+        output_schema_.columns.push_back(schema_.columns[i]);
+        (plan.fixed ? fixed_plan_ : var_plan_).push_back(plan);
+    }
+    null_bitmap_bytes_ = (ncols + 7) / 8;
 }
 
 int RowDecoder::decode_page(const uint8_t* page_data,
@@ -104,7 +375,7 @@ int RowDecoder::decode_page(const uint8_t* page_data,
     for (int slot = 0; slot < hdr.slot_count; ++slot) {
         uint16_t offset = get_slot_offset(page_data, slot);
         if (offset < PAGE_HEADER_SIZE || offset >= PAGE_SIZE - 2) {
-            LOG_DEBUG("Invalid slot offset %u for slot %d on page %u:%u",
+            LOG_DEBUG_HOT("Invalid slot offset %u for slot %d on page %u:%u",
                       offset, slot, hdr.this_file, hdr.this_page);
             continue;
         }
@@ -114,17 +385,19 @@ int RowDecoder::decode_page(const uint8_t* page_data,
         uint8_t rec_type = status_a & RecordStatus::TypeMask;
         if (rec_type == RecordStatus::ForwardingStub) continue;
 
-        Row row;
-        if (decode_row(page_data, offset, row)) {
-            out_rows.push_back(std::move(row));
-            ++decoded;
-        }
+        RecordView view;
+        if (!parse_record(page_data, offset, view)) continue;
+        if (filter_ && !passes(view)) continue;
+
+        out_rows.emplace_back();
+        materialize(view, out_rows.back());
+        ++decoded;
     }
     return decoded;
 }
 
-bool RowDecoder::decode_row(const uint8_t* page_data, uint16_t record_offset,
-                             Row& out_row) const {
+bool RowDecoder::parse_record(const uint8_t* page_data, uint16_t record_offset,
+                              RecordView& view) const {
     const uint8_t* rec = page_data + record_offset;
     size_t max_len = PAGE_SIZE - record_offset;
 
@@ -141,14 +414,18 @@ bool RowDecoder::decode_row(const uint8_t* page_data, uint16_t record_offset,
     std::memcpy(&fixed_end, rec + 2, 2);
 
     if (fixed_end > max_len) {
-        LOG_DEBUG("Fixed data end offset %u exceeds record bounds", fixed_end);
+        LOG_DEBUG_HOT("Fixed data end offset %u exceeds record bounds", fixed_end);
         return false;
     }
 
-    // -- Parse null bitmap --
+    view = RecordView{};
+    view.rec       = rec;
+    view.max_len   = max_len;
+    view.fixed_end = fixed_end;
+
+    // -- Null bitmap --
     // The null bitmap area starts with a 2-byte column count,
     // followed by ceil(column_count/8) bitmap bytes.
-    std::vector<bool> null_bits(schema_.columns.size(), false);
     size_t bitmap_start = fixed_end;
     size_t null_area_size = 0;
 
@@ -159,111 +436,535 @@ bool RowDecoder::decode_row(const uint8_t* page_data, uint16_t record_offset,
         null_area_size = 2 + null_bmp_bytes;
 
         if (bitmap_start + null_area_size <= max_len) {
-            for (size_t col = 0; col < schema_.columns.size() && col < rec_col_count; ++col) {
-                size_t byte_idx = col / 8;
-                size_t bit_idx  = col % 8;
-                if (rec[bitmap_start + 2 + byte_idx] & (1 << bit_idx)) {
-                    null_bits[col] = true;
-                }
-            }
+            view.null_bitmap = rec + bitmap_start + 2;
+            view.null_cols   = rec_col_count;
         }
     }
 
-    // -- Parse variable-length column offset array --
+    // -- Variable-length column offset array --
     size_t var_offset_start = bitmap_start + null_area_size;
-    uint16_t var_col_count = 0;
-    std::vector<uint16_t> var_end_offsets;
 
     if (has_var_cols && var_offset_start + 2 <= max_len) {
+        uint16_t var_col_count;
         std::memcpy(&var_col_count, rec + var_offset_start, 2);
         var_offset_start += 2;
 
-        var_end_offsets.resize(var_col_count);
-        for (uint16_t v = 0; v < var_col_count; ++v) {
-            if (var_offset_start + 2 > max_len) break;
-            std::memcpy(&var_end_offsets[v], rec + var_offset_start, 2);
-            var_offset_start += 2;
-        }
+        // Keep only the offsets that lie inside the record
+        size_t fit = (max_len - var_offset_start) / 2;
+        view.var_count   = static_cast<uint16_t>(std::min<size_t>(var_col_count, fit));
+        view.var_offsets = rec + var_offset_start;
+        var_offset_start += view.var_count * 2;
     }
+    view.var_data_start = static_cast<uint16_t>(var_offset_start);
 
-    // -- Decode columns --
-    out_row.resize(schema_.columns.size());
+    return true;
+}
 
-    // Fixed-length columns
-    for (size_t fi = 0; fi < fixed_col_indices_.size(); ++fi) {
-        int ci = fixed_col_indices_[fi];
-        auto& col = schema_.columns[ci];
+RowDecoder::Cell RowDecoder::fixed_cell(const RecordView& view, const ColumnPlan& plan,
+                                        const uint8_t*& data, size_t& len) {
+    if (plan.is_null(view)) return Cell::Null;
+    if (plan.offset >= view.fixed_end) return Cell::Null;
+
+    data = view.rec + plan.offset;
+    len  = std::min<size_t>(view.fixed_end - plan.offset, plan.length);
+    return Cell::Value;
+}
+
+RowDecoder::Cell RowDecoder::var_cell(const RecordView& view, const ColumnPlan& plan,
+                                      const uint8_t*& data, size_t& len) {
+    if (plan.is_null(view)) return Cell::Null;
+
+    size_t vi = plan.var_index;
+    if (vi >= view.var_count) return Cell::Null;
+
+    uint16_t end_off = view.var_end(vi);
+    uint16_t start_off = (vi == 0) ? view.var_data_start
+                                   : static_cast<uint16_t>(view.var_end(vi - 1) & 0x7FFF);
+
+    // High bit of end_off may indicate a complex column (LOB pointer)
+    bool is_complex = (end_off & 0x8000) != 0;
+    end_off &= 0x7FFF;
 
-        if (null_bits[ci]) {
-            out_row[ci] = NullValue{};
+    if (start_off >= end_off || end_off > view.max_len) return Cell::Null;
+
+    data = view.rec + start_off;
+    len  = end_off - start_off;
+
+    // Off-row value: a complex column holds an in-row root or row-overflow
+    // pointer, a TEXT/NTEXT/IMAGE column a text pointer
+    if (is_complex || (plan.text_ptr && LobReader::is_text_pointer(len))) return Cell::Lob;
+    return Cell::Value;
+}
+
+bool RowDecoder::decode_row(const uint8_t* page_data, uint16_t record_offset,
+                             Row& out_row) const {
+    RecordView view;
+    if (!parse_record(page_data, record_offset, view)) return false;
+    materialize(view, out_row);
+    return true;
+}
+
+void RowDecoder::materialize(const RecordView& view, Row& out_row) const {
+    out_row.resize(output_schema_.columns.size());
+
+    const uint8_t* data = nullptr;
+    size_t len = 0;
+
+    // Fixed-length columns
+    for (const ColumnPlan& p : fixed_plan_) {
+        if (fixed_cell(view, p, data, len) != Cell::Value) {
+            out_row[p.column] = NullValue{};
             continue;
         }
+        out_row[p.column] = p.value(data, len, *p.def);
+    }
 
-        int data_offset = fixed_col_offsets_[fi];
+    // Variable-length columns
+    for (const ColumnPlan& p : var_plan_) {
+        switch (var_cell(view, p, data, len)) {
+        case Cell::Null:
+            out_row[p.column] = NullValue{};
+            break;
+        case Cell::Lob:
+            out_row[p.column] = lob_value(p, data, len);
+            break;
+        case Cell::Value:
+            out_row[p.column] = p.value(data, len, *p.def);
+            break;
+        }
+    }
+}
 
-        if (data_offset < 4) data_offset = 4;
-        if (static_cast<size_t>(data_offset) >= fixed_end) {
-            out_row[ci] = NullValue{};
-            continue;
+bool RowDecoder::passes(const RecordView& view) const {
+    return filter_->matches([&](int physical, const uint8_t*& data, size_t& len) {
+        const ColumnPlan& p = layout_[physical];
+        Cell c = p.fixed ? fixed_cell(view, p, data, len) : var_cell(view, p, data, len);
+        if (c == Cell::Lob) { data = view.rec; len = 0; }   // present, not comparable
+        return c != Cell::Null;
+    });
+}
+
+RowValue RowDecoder::lob_value(const ColumnPlan& plan, const uint8_t* pointer,
+                               size_t len) const {
+    if (lob_) {
+        const size_t reserve = static_cast<size_t>(std::min(
+            LobReader::declared_size(pointer, len, plan.text_ptr), LOB_RESERVE_LIMIT));
+
+        if (plan.lob == LobText::Bytes) {
+            std::vector<uint8_t> value;
+            value.reserve(reserve);
+            if (lob_->read(pointer, len, plan.text_ptr, [&](const uint8_t* d, size_t n) {
+                    value.insert(value.end(), d, d + n);
+                }))
+                return value;
+        } else if (plan.lob == LobText::Chars) {
+            std::string value;
+            value.reserve(reserve);
+            if (lob_->read(pointer, len, plan.text_ptr, [&](const uint8_t* d, size_t n) {
+                    value.append(reinterpret_cast<const char*>(d), n);
+                }))
+                return value;
+        } else {
+            std::string value;
+            value.reserve(reserve);
+            Utf16Pieces text;
+            auto emit = [&](const uint8_t* u, size_t n) {
+                size_t pos = value.size();
+                value.resize(pos + utf8_capacity_for_utf16(n));
+                value.resize(pos + utf16le_to_utf8(u, n, &value[pos]));
+            };
+            if (lob_->read(pointer, len, plan.text_ptr, [&](const uint8_t* d, size_t n) {
+                    text.feed(d, n, emit);
+                })) {
+                text.finish(emit);
+                return value;
+            }
         }
+    }
+    return std::string(LOB_PLACEHOLDER);
+}
 
-        size_t avail = fixed_end - data_offset;
-        out_row[ci] = decode_fixed_column(rec + data_offset,
-                                           std::min<size_t>(avail, col.max_length),
-                                           col);
+void RowDecoder::append_lob(ColumnBuffer& out, const ColumnPlan& plan,
+                            const uint8_t* pointer, size_t len) const {
+    if (!out.is_variable()) {
+        out.append_null();
+        return;
     }
 
-    // Variable-length columns
-    uint16_t var_data_start_offset = static_cast<uint16_t>(var_offset_start);
-    for (size_t vi = 0; vi < var_col_indices_.size(); ++vi) {
-        int ci = var_col_indices_[vi];
-        auto& col = schema_.columns[ci];
+    if (lob_) {
+        // Fragments go straight into the column's data buffer
+        const size_t start = out.data.size();
+        bool ok;
+        if (plan.lob == LobText::Utf16) {
+            Utf16Pieces text;
+            auto emit = [&](const uint8_t* u, size_t n) {
+                size_t reserve = utf8_capacity_for_utf16(n);
+                char* dst = out.begin_var(reserve);
+                out.end_part(reserve, utf16le_to_utf8(u, n, dst));
+            };
+            ok = lob_->read(pointer, len, plan.text_ptr, [&](const uint8_t* d, size_t n) {
+                text.feed(d, n, emit);
+            });
+            if (ok) text.finish(emit);
+        } else {
+            ok = lob_->read(pointer, len, plan.text_ptr, [&](const uint8_t* d, size_t n) {
+                out.append_part(d, n);
+            });
+        }
 
-        if (null_bits[ci]) {
-            out_row[ci] = NullValue{};
-            continue;
+        // Arrow offsets are 32-bit: a batch cannot hold more than 2GB
+        if (ok && out.data.size() <= static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+            out.commit_parts();
+            return;
         }
+        out.discard_parts(start);
+    }
+    out.append_bytes(LOB_PLACEHOLDER, sizeof(LOB_PLACEHOLDER) - 1);
+}
 
-        if (vi >= var_end_offsets.size()) {
-            out_row[ci] = NullValue{};
-            continue;
+bool RowDecoder::decode_row_dynamic(const uint8_t* page_data, uint16_t record_offset,
+                                    Row& out_row) const {
+    RecordView view;
+    if (!parse_record(page_data, record_offset, view)) return false;
+
+    out_row.resize(output_schema_.columns.size());
+
+    const uint8_t* data = nullptr;
+    size_t len = 0;
+
+    for (const ColumnPlan& p : fixed_plan_) {
+        out_row[p.column] = (fixed_cell(view, p, data, len) == Cell::Value)
+            ? bytes_to_value(data, len, *p.def)
+            : RowValue{NullValue{}};
+    }
+
+    for (const ColumnPlan& p : var_plan_) {
+        switch (var_cell(view, p, data, len)) {
+        case Cell::Null:  out_row[p.column] = NullValue{}; break;
+        case Cell::Lob:   out_row[p.column] = lob_value(p, data, len); break;
+        case Cell::Value: out_row[p.column] = bytes_to_value(data, len, *p.def); break;
         }
+    }
+
+    return true;
+}
+
+int RowDecoder::decode_page_columnar(const uint8_t* page_data,
+                                     ColumnBatch& out) const {
+    PageHeader hdr;
+    std::memcpy(&hdr, page_data, sizeof(hdr));
 
-        uint16_t end_off = var_end_offsets[vi];
-        uint16_t start_off = (vi == 0) ? var_data_start_offset
-                                       : var_end_offsets[vi - 1];
+    if (hdr.type != static_cast<uint8_t>(PageType::Data)) {
+        return 0;
+    }
+    if (out.num_columns() != output_schema_.columns.size()) {
+        out.reset(output_schema_);
+    }
 
-        // High bit of end_off may indicate a complex column (LOB pointer)
-        bool is_complex = (end_off & 0x8000) != 0;
-        end_off &= 0x7FFF;
+    int decoded = 0;
+    for (int slot = 0; slot < hdr.slot_count; ++slot) {
+        uint16_t offset = get_slot_offset(page_data, slot);
+        if (offset < PAGE_HEADER_SIZE || offset >= PAGE_SIZE - 2) continue;
 
-        if (is_complex) {
-            // LOB/overflow pointer -- we cannot resolve this in direct mode
-            // without following the pointer chain
-            out_row[ci] = std::string("[LOB data]");
-            continue;
+        uint8_t rec_type = page_data[offset] & RecordStatus::TypeMask;
+        if (rec_type == RecordStatus::ForwardingStub) continue;
+
+        RecordView view;
+        if (!parse_record(page_data, offset, view)) continue;
+        if (filter_ && !passes(view)) continue;
+
+        const uint8_t* data = nullptr;
+        size_t len = 0;
+
+        for (const ColumnPlan& p : fixed_plan_) {
+            ColumnBuffer& col = out.column(p.column);
+            if (fixed_cell(view, p, data, len) != Cell::Value) {
+                col.append_null();
+                continue;
+            }
+            p.append(col, data, len, *p.def);
         }
 
-        if (start_off >= end_off || end_off > max_len) {
-            out_row[ci] = NullValue{};
-            continue;
+        for (const ColumnPlan& p : var_plan_) {
+            ColumnBuffer& col = out.column(p.column);
+            switch (var_cell(view, p, data, len)) {
+            case Cell::Null:
+                col.append_null();
+                break;
+            case Cell::Lob:
+                append_lob(col, p, data, len);
+                break;
+            case Cell::Value:
+                p.append(col, data, len, *p.def);
+                break;
+            }
         }
 
-        out_row[ci] = decode_variable_column(rec + start_off,
-                                              end_off - start_off, col);
+        out.commit_row();
+        ++decoded;
     }
+    return decoded;
+}
 
-    return true;
+// -------------------------------------------------------------------------
+// Type-specialized column decoders
+//
+// value_as<T> builds the RowValue for one cell, append_as<T> writes the same
+// value into a column buffer (the text forms match what the row writers
+// print). Types sharing a physical representation share an instantiation;
+// value_fn_for/append_fn_for pick one per SqlType.
+// -------------------------------------------------------------------------
+
+template <SqlType T>
+RowValue RowDecoder::value_as(const uint8_t* data, size_t len, const ColumnDef& col) {
+    if (len == 0) return NullValue{};
+
+    if constexpr (T == SqlType::TinyInt) {
+        return static_cast<int8_t>(data[0]);
+    } else if constexpr (T == SqlType::SmallInt) {
+        if (len < 2) return NullValue{};
+        int16_t v; std::memcpy(&v, data, 2); return v;
+    } else if constexpr (T == SqlType::Int) {
+        if (len < 4) return NullValue{};
+        int32_t v; std::memcpy(&v, data, 4); return v;
+    } else if constexpr (T == SqlType::BigInt) {
+        if (len < 8) return NullValue{};
+        int64_t v; std::memcpy(&v, data, 8); return v;
+    } else if constexpr (T == SqlType::Bit) {
+        return static_cast<bool>(data[0] != 0);
+    } else if constexpr (T == SqlType::Real) {
+        if (len < 4) return NullValue{};
+        float v; std::memcpy(&v, data, 4); return v;
+    } else if constexpr (T == SqlType::Float) {
+        if (len < 8) return NullValue{};
+        double v; std::memcpy(&v, data, 8); return v;
+    } else if constexpr (T == SqlType::Money) {
+        if (len < 8) return NullValue{};
+        int32_t hi; std::memcpy(&hi, data, 4);
+        int32_t lo; std::memcpy(&lo, data + 4, 4);
+        int64_t combined = (static_cast<int64_t>(hi) << 32) | static_cast<uint32_t>(lo);
+        return static_cast<double>(combined) / 10000.0;
+    } else if constexpr (T == SqlType::SmallMoney) {
+        if (len < 4) return NullValue{};
+        int32_t v; std::memcpy(&v, data, 4); return static_cast<double>(v) / 10000.0;
+    } else if constexpr (T == SqlType::Decimal) {
+        return decode_decimal(data, len, col.precision, col.scale);
+    } else if constexpr (T == SqlType::Char) {
+        return std::string(reinterpret_cast<const char*>(data), len);
+    } else if constexpr (T == SqlType::NChar) {
+        return utf16le_to_utf8(data, len);
+    } else if constexpr (T == SqlType::UniqueId) {
+        if (len < 16) return NullValue{};
+        return decode_guid(data);
+    } else if constexpr (T == SqlType::Date) {
+        if (len < 3) return NullValue{};
+        return decode_date(data);
+    } else if constexpr (T == SqlType::DateTime) {
+        if (len < 8) return NullValue{};
+        return decode_datetime(data);
+    } else if constexpr (T == SqlType::SmallDateTime) {
+        if (len < 4) return NullValue{};
+        return decode_smalldatetime(data);
+    } else if constexpr (T == SqlType::DateTime2) {
+        return decode_datetime2(data, col.scale);
+    } else if constexpr (T == SqlType::Time) {
+        return decode_time(data, len, col.scale);
+    } else if constexpr (T == SqlType::DateTimeOffset) {
+        return decode_datetimeoffset(data, len, col.scale);
+    } else {
+        // Binary types and anything without a dedicated decoder
+        (void)col;
+        return std::vector<uint8_t>(data, data + len);
+    }
 }
 
-RowValue RowDecoder::decode_fixed_column(const uint8_t* data, size_t data_len,
-                                          const ColumnDef& col) const {
-    return bytes_to_value(data, data_len, col);
+template <SqlType T>
+void RowDecoder::append_as(ColumnBuffer& out, const uint8_t* data, size_t len,
+                           const ColumnDef& col) {
+    if (len == 0) { out.append_null(); return; }
+
+    char buf[FORMAT_BUF_SIZE];
+
+    if constexpr (T == SqlType::TinyInt) {
+        out.append_fixed(static_cast<int8_t>(data[0]));
+    } else if constexpr (T == SqlType::SmallInt) {
+        if (len < 2) { out.append_null(); return; }
+        int16_t v; std::memcpy(&v, data, 2); out.append_fixed(v);
+    } else if constexpr (T == SqlType::Int) {
+        if (len < 4) { out.append_null(); return; }
+        int32_t v; std::memcpy(&v, data, 4); out.append_fixed(v);
+    } else if constexpr (T == SqlType::BigInt) {
+        if (len < 8) { out.append_null(); return; }
+        int64_t v; std::memcpy(&v, data, 8); out.append_fixed(v);
+    } else if constexpr (T == SqlType::Bit) {
+        out.append_fixed(static_cast<uint8_t>(data[0] != 0));
+    } else if constexpr (T == SqlType::Real) {
+        if (len < 4) { out.append_null(); return; }
+        float v; std::memcpy(&v, data, 4); out.append_fixed(v);
+    } else if constexpr (T == SqlType::Float) {
+        if (len < 8) { out.append_null(); return; }
+        double v; std::memcpy(&v, data, 8); out.append_fixed(v);
+    } else if constexpr (T == SqlType::Money) {
+        if (len < 8) { out.append_null(); return; }
+        int32_t hi; std::memcpy(&hi, data, 4);
+        int32_t lo; std::memcpy(&lo, data + 4, 4);
+        int64_t combined = (static_cast<int64_t>(hi) << 32) | static_cast<uint32_t>(lo);
+        out.append_fixed(static_cast<double>(combined) / 10000.0);
+    } else if constexpr (T == SqlType::SmallMoney) {
+        if (len < 4) { out.append_null(); return; }
+        int32_t v; std::memcpy(&v, data, 4);
+        out.append_fixed(static_cast<double>(v) / 10000.0);
+    } else if constexpr (T == SqlType::Decimal) {
+        SqlDecimal dec = decode_decimal(data, len, col.precision, col.scale);
+        if (out.kind == ColumnKind::Decimal128) {
+            uint8_t v[16];
+            dec.unscaled_le(v);
+            out.append_fixed_bytes(v);
+            return;
+        }
+        out.append_bytes(buf, dec.format(buf));
+    } else if constexpr (T == SqlType::Char || T == SqlType::Binary) {
+        out.append_bytes(data, len);
+    } else if constexpr (T == SqlType::NChar) {
+        size_t reserve = utf8_capacity_for_utf16(len);
+        char* dst = out.begin_var(reserve);
+        out.commit_var(reserve, utf16le_to_utf8(data, len, dst));
+    } else if constexpr (T == SqlType::UniqueId) {
+        if (len < 16) { out.append_null(); return; }
+        if (out.kind == ColumnKind::Uuid) {
+            uint8_t v[16];
+            decode_guid(data).rfc4122(v);
+            out.append_fixed_bytes(v);
+            return;
+        }
+        out.append_bytes(buf, decode_guid(data).format(buf));
+    } else if constexpr (T == SqlType::Date) {
+        if (len < 3) { out.append_null(); return; }
+        if (out.kind == ColumnKind::Date32) {
+            uint32_t date_val = 0;
+            std::memcpy(&date_val, data, 3);
+            out.append_fixed(static_cast<int32_t>((date_val & 0x00FFFFFF) - DAYS_0001_TO_1970));
+            return;
+        }
+        out.append_bytes(buf, format_date(data, buf));
+    } else if constexpr (T == SqlType::DateTime) {
+        if (len < 8) { out.append_null(); return; }
+        if (out.kind == ColumnKind::TimestampUs) {
+            // Days since 1900-01-01, then 1/300 second ticks
+            int32_t days, ticks;
+            std::memcpy(&days, data, 4);
+            std::memcpy(&ticks, data + 4, 4);
+            out.append_fixed((days - DAYS_1900_TO_1970) * MICROS_PER_DAY +
+                             static_cast<int64_t>(ticks) * 10000 / 3);
+            return;
+        }
+        out.append_bytes(buf, format_datetime(data, buf));
+    } else if constexpr (T == SqlType::SmallDateTime) {
+        if (len < 4) { out.append_null(); return; }
+        if (out.kind == ColumnKind::TimestampUs) {
+            // Days since 1900-01-01, then minutes
+            uint16_t days, minutes;
+            std::memcpy(&days, data, 2);
+            std::memcpy(&minutes, data + 2, 2);
+            out.append_fixed((days - DAYS_1900_TO_1970) * MICROS_PER_DAY +
+                             static_cast<int64_t>(minutes) * 60000000);
+            return;
+        }
+        out.append_bytes(buf, format_smalldatetime(data, buf));
+    } else if constexpr (T == SqlType::DateTime2) {
+        uint8_t scale = std::min<uint8_t>(col.scale, 7);
+        if (out.kind == ColumnKind::TimestampUs) {
+            if (static_cast<int>(len) < time_bytes_for(scale) + 3) { out.append_null(); return; }
+            out.append_fixed(datetime2_micros(data, scale));
+            return;
+        }
+        out.append_bytes(buf, format_datetime2(data, col.scale, buf));
+    } else if constexpr (T == SqlType::Time) {
+        uint8_t scale = std::min<uint8_t>(col.scale, 7);
+        if (out.kind == ColumnKind::Time64Us) {
+            if (static_cast<int>(len) < time_bytes_for(scale)) { out.append_null(); return; }
+            out.append_fixed(time_micros(data, time_bytes_for(scale), scale));
+            return;
+        }
+        out.append_bytes(buf, format_time(data, len, col.scale, buf));
+    } else if constexpr (T == SqlType::DateTimeOffset) {
+        uint8_t scale = std::min<uint8_t>(col.scale, 7);
+        if (out.kind == ColumnKind::TimestampUs) {
+            // The date/time part is stored in UTC; the offset only affects display
+            if (static_cast<int>(len) < time_bytes_for(scale) + 5) { out.append_null(); return; }
+            out.append_fixed(datetime2_micros(data, scale));
+            return;
+        }
+        out.append_bytes(buf, format_datetimeoffset(data, len, col.scale, buf));
+    } else {
+        // Types the writers treat as raw bytes
+        if (out.is_variable() && !is_fixed_length(col.type)) out.append_bytes(data, len);
+        else                                                 out.append_null();
+    }
+}
+
+RowDecoder::ValueFn RowDecoder::value_fn_for(SqlType t) {
+    switch (t) {
+    case SqlType::TinyInt:        return &value_as<SqlType::TinyInt>;
+    case SqlType::SmallInt:       return &value_as<SqlType::SmallInt>;
+    case SqlType::Int:            return &value_as<SqlType::Int>;
+    case SqlType::BigInt:         return &value_as<SqlType::BigInt>;
+    case SqlType::Bit:            return &value_as<SqlType::Bit>;
+    case SqlType::Real:           return &value_as<SqlType::Real>;
+    case SqlType::Float:          return &value_as<SqlType::Float>;
+    case SqlType::Money:          return &value_as<SqlType::Money>;
+    case SqlType::SmallMoney:     return &value_as<SqlType::SmallMoney>;
+    case SqlType::Decimal:
+    case SqlType::Numeric:        return &value_as<SqlType::Decimal>;
+    case SqlType::Char:
+    case SqlType::VarChar:
+    case SqlType::Text:           return &value_as<SqlType::Char>;
+    case SqlType::NChar:
+    case SqlType::NVarChar:
+    case SqlType::NText:          return &value_as<SqlType::NChar>;
+    case SqlType::UniqueId:       return &value_as<SqlType::UniqueId>;
+    case SqlType::Date:           return &value_as<SqlType::Date>;
+    case SqlType::DateTime:       return &value_as<SqlType::DateTime>;
+    case SqlType::SmallDateTime:  return &value_as<SqlType::SmallDateTime>;
+    case SqlType::DateTime2:      return &value_as<SqlType::DateTime2>;
+    case SqlType::Time:           return &value_as<SqlType::Time>;
+    case SqlType::DateTimeOffset: return &value_as<SqlType::DateTimeOffset>;
+    default:                      return &value_as<SqlType::Binary>;
+    }
 }
 
-RowValue RowDecoder::decode_variable_column(const uint8_t* data, size_t data_len,
-                                             const ColumnDef& col) const {
-    return bytes_to_value(data, data_len, col);
+RowDecoder::AppendFn RowDecoder::append_fn_for(SqlType t) {
+    switch (t) {
+    case SqlType::TinyInt:        return &append_as<SqlType::TinyInt>;
+    case SqlType::SmallInt:       return &append_as<SqlType::SmallInt>;
+    case SqlType::Int:            return &append_as<SqlType::Int>;
+    case SqlType::BigInt:         return &append_as<SqlType::BigInt>;
+    case SqlType::Bit:            return &append_as<SqlType::Bit>;
+    case SqlType::Real:           return &append_as<SqlType::Real>;
+    case SqlType::Float:          return &append_as<SqlType::Float>;
+    case SqlType::Money:          return &append_as<SqlType::Money>;
+    case SqlType::SmallMoney:     return &append_as<SqlType::SmallMoney>;
+    case SqlType::Decimal:
+    case SqlType::Numeric:        return &append_as<SqlType::Decimal>;
+    case SqlType::Char:
+    case SqlType::VarChar:
+    case SqlType::Text:           return &append_as<SqlType::Char>;
+    case SqlType::NChar:
+    case SqlType::NVarChar:
+    case SqlType::NText:          return &append_as<SqlType::NChar>;
+    case SqlType::Binary:
+    case SqlType::VarBinary:
+    case SqlType::Image:
+    case SqlType::Timestamp:      return &append_as<SqlType::Binary>;
+    case SqlType::UniqueId:       return &append_as<SqlType::UniqueId>;
+    case SqlType::Date:           return &append_as<SqlType::Date>;
+    case SqlType::DateTime:       return &append_as<SqlType::DateTime>;
+    case SqlType::SmallDateTime:  return &append_as<SqlType::SmallDateTime>;
+    case SqlType::DateTime2:      return &append_as<SqlType::DateTime2>;
+    case SqlType::Time:           return &append_as<SqlType::Time>;
+    case SqlType::DateTimeOffset: return &append_as<SqlType::DateTimeOffset>;
+    default:                      return &append_as<SqlType::Unknown>;
+    }
 }
 
 RowValue RowDecoder::bytes_to_value(const uint8_t* data, size_t len,
@@ -362,40 +1063,16 @@ RowValue RowDecoder::bytes_to_value(const uint8_t* data, size_t len,
 }
 
 std::string RowDecoder::utf16le_to_utf8(const uint8_t* data, size_t byte_len) {
-    std::string result;
-    result.reserve(byte_len);
-
-    for (size_t i = 0; i + 1 < byte_len; i += 2) {
-        uint16_t ch = static_cast<uint16_t>(data[i]) |
-                      (static_cast<uint16_t>(data[i+1]) << 8);
-        if (ch == 0) break;
-
-        if (ch < 0x80) {
-            result.push_back(static_cast<char>(ch));
-        } else if (ch < 0x800) {
-            result.push_back(static_cast<char>(0xC0 | (ch >> 6)));
-            result.push_back(static_cast<char>(0x80 | (ch & 0x3F)));
-        } else {
-            // Handle surrogate pairs for characters outside BMP
-            if (ch >= 0xD800 && ch <= 0xDBFF && i + 3 < byte_len) {
-                uint16_t low = static_cast<uint16_t>(data[i+2]) |
-                               (static_cast<uint16_t>(data[i+3]) << 8);
-                if (low >= 0xDC00 && low <= 0xDFFF) {
-                    uint32_t cp = 0x10000 + ((ch - 0xD800) << 10) + (low - 0xDC00);
-                    result.push_back(static_cast<char>(0xF0 | (cp >> 18)));
-                    result.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
-                    result.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
-                    result.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
-                    i += 2;
-                    continue;
-                }
-            }
-            result.push_back(static_cast<char>(0xE0 | (ch >> 12)));
-            result.push_back(static_cast<char>(0x80 | ((ch >> 6) & 0x3F)));
-            result.push_back(static_cast<char>(0x80 | (ch & 0x3F)));
-        }
-    }
-    return result;
+    // Transcode into a per-thread scratch buffer, so the only allocation
+    // is the exactly sized result string
+    thread_local std::vector<char> scratch;
+    size_t need = utf8_capacity_for_utf16(byte_len);
+    if (scratch.size() < need) scratch.resize(need);
+    return std::string(scratch.data(), bakread::utf16le_to_utf8(data, byte_len, scratch.data()));
+}
+
+size_t RowDecoder::utf16le_to_utf8(const uint8_t* data, size_t byte_len, char* out) {
+    return bakread::utf16le_to_utf8(data, byte_len, out);
 }
 
 SqlDecimal RowDecoder::decode_decimal(const uint8_t* data, size_t len,
@@ -423,158 +1100,138 @@ SqlGuid RowDecoder::decode_guid(const uint8_t* data) {
     return guid;
 }
 
-std::string RowDecoder::decode_datetime(const uint8_t* data) {
+size_t RowDecoder::format_datetime(const uint8_t* data, char* out) {
     // DATETIME: 4 bytes (days since 1900-01-01) + 4 bytes (1/300 sec ticks)
     int32_t days, ticks;
     std::memcpy(&days, data, 4);
     std::memcpy(&ticks, data + 4, 4);
 
-    // Convert days to date (simplified)
-    struct tm base = {};
-    base.tm_year = 0;   // 1900
-    base.tm_mon  = 0;   // January
-    base.tm_mday = 1 + days;
-    mktime(&base);
+    // Milliseconds rounded the way SQL Server shows them (.000/.003/.007)
+    uint32_t t = static_cast<uint32_t>(ticks);
+    uint64_t millis = ((t % 300) * 10 + 1) / 3;
 
-    int total_seconds = ticks / 300;
-    int hours   = total_seconds / 3600;
-    int minutes = (total_seconds % 3600) / 60;
-    int seconds = total_seconds % 60;
-    int millis  = (ticks % 300) * 10 / 3;
+    char* p = put_date(out, days + DAYS_0001_TO_1900);
+    *p++ = ' ';
+    p = put_time(p, t / 300, millis, 3);
+    return static_cast<size_t>(p - out);
+}
 
-    char buf[64];
-    snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d.%03d",
-             base.tm_year + 1900, base.tm_mon + 1, base.tm_mday,
-             hours, minutes, seconds, millis);
-    return buf;
+// "YYYY-MM-DD HH:MM:SS[.f]" from days since 0001-01-01 and time ticks
+static char* put_datetime2(char* p, int days, uint64_t time_val, uint8_t scale) {
+    uint64_t ticks_per_sec = TICKS_PER_SEC[scale];
+    p = put_date(p, days);
+    *p++ = ' ';
+    return put_time(p, time_val / ticks_per_sec, time_val % ticks_per_sec, scale);
 }
 
-std::string RowDecoder::decode_datetime2(const uint8_t* data, uint8_t scale) {
+size_t RowDecoder::format_datetime2(const uint8_t* data, uint8_t scale, char* out) {
     // DATETIME2 packs time and date into variable-length representation
     // Time: first N bytes (3-5 depending on scale), Date: last 3 bytes
     if (scale > 7) scale = 7;
-
-    int time_bytes = (scale <= 2) ? 3 : (scale <= 4) ? 4 : 5;
+    int time_bytes = time_bytes_for(scale);
 
     // Date: last 3 bytes (days since 0001-01-01)
     uint32_t date_val = 0;
     std::memcpy(&date_val, data + time_bytes, 3);
     date_val &= 0x00FFFFFF;
 
-    // Time: first N bytes (fractional time units)
-    uint64_t time_val = 0;
-    std::memcpy(&time_val, data, time_bytes);
-    if (time_bytes == 3) time_val &= 0x00FFFFFF;
-    else if (time_bytes == 4) time_val &= 0x00FFFFFFFF;
-
-    int y, m, d;
-    days_to_ymd(static_cast<int>(date_val), y, m, d);
-
-    // Convert time_val to HH:MM:SS.fraction
-    static const uint64_t scales[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
-    uint64_t ticks_per_sec = scales[scale];
-    uint64_t total_secs = time_val / ticks_per_sec;
-    uint64_t frac = time_val % ticks_per_sec;
-
-    int hours   = static_cast<int>(total_secs / 3600);
-    int minutes = static_cast<int>((total_secs % 3600) / 60);
-    int seconds = static_cast<int>(total_secs % 60);
-
-    char buf[64];
-    if (scale > 0) {
-        snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d.%0*llu",
-                 y, m, d, hours, minutes, seconds,
-                 scale, (unsigned long long)frac);
-    } else {
-        snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d",
-                 y, m, d, hours, minutes, seconds);
-    }
-    return buf;
+    char* p = put_datetime2(out, static_cast<int>(date_val),
+                            read_time_ticks(data, time_bytes), scale);
+    return static_cast<size_t>(p - out);
 }
 
-std::string RowDecoder::decode_smalldatetime(const uint8_t* data) {
+size_t RowDecoder::format_smalldatetime(const uint8_t* data, char* out) {
     // SMALLDATETIME: 2 bytes (days since 1900-01-01) + 2 bytes (minutes)
     uint16_t days, minutes;
     std::memcpy(&days, data, 2);
     std::memcpy(&minutes, data + 2, 2);
 
-    struct tm base = {};
-    base.tm_year = 0;
-    base.tm_mon  = 0;
-    base.tm_mday = 1 + days;
-    mktime(&base);
-
-    int hours = minutes / 60;
-    int mins  = minutes % 60;
-
-    char buf[32];
-    snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:00",
-             base.tm_year + 1900, base.tm_mon + 1, base.tm_mday,
-             hours, mins);
-    return buf;
+    char* p = put_date(out, days + DAYS_0001_TO_1900);
+    *p++ = ' ';
+    p = put_time(p, static_cast<uint64_t>(minutes) * 60, 0, 0);
+    return static_cast<size_t>(p - out);
 }
 
-std::string RowDecoder::decode_date(const uint8_t* data) {
+size_t RowDecoder::format_date(const uint8_t* data, char* out) {
     // DATE: 3 bytes (days since 0001-01-01)
     uint32_t date_val = 0;
     std::memcpy(&date_val, data, 3);
     date_val &= 0x00FFFFFF;
 
-    int y, m, d;
-    days_to_ymd(static_cast<int>(date_val), y, m, d);
+    return static_cast<size_t>(put_date(out, static_cast<int>(date_val)) - out);
+}
 
-    char buf[16];
-    snprintf(buf, sizeof(buf), "%04d-%02d-%02d", y, m, d);
-    return buf;
+size_t RowDecoder::format_time(const uint8_t* data, size_t len, uint8_t scale, char* out) {
+    if (scale > 7) scale = 7;
+    int time_bytes = time_bytes_for(scale);
+    if (static_cast<int>(len) < time_bytes) { out[0] = '\0'; return 0; }
+
+    uint64_t time_val = read_time_ticks(data, time_bytes);
+    uint64_t ticks_per_sec = TICKS_PER_SEC[scale];
+    char* p = put_time(out, time_val / ticks_per_sec, time_val % ticks_per_sec, scale);
+    return static_cast<size_t>(p - out);
 }
 
-std::string RowDecoder::decode_time(const uint8_t* data, size_t len, uint8_t scale) {
+size_t RowDecoder::format_datetimeoffset(const uint8_t* data, size_t len,
+                                         uint8_t scale, char* out) {
     if (scale > 7) scale = 7;
-    int time_bytes = (scale <= 2) ? 3 : (scale <= 4) ? 4 : 5;
-    if (static_cast<int>(len) < time_bytes) return "";
+    int time_bytes = time_bytes_for(scale);
+    int total_needed = time_bytes + 3 + 2;  // time + date + offset
+    if (static_cast<int>(len) < total_needed) { out[0] = '\0'; return 0; }
 
-    uint64_t time_val = 0;
-    std::memcpy(&time_val, data, time_bytes);
-    if (time_bytes == 3) time_val &= 0x00FFFFFF;
-    else if (time_bytes == 4) time_val &= 0xFFFFFFFF;
+    uint32_t date_val = 0;
+    std::memcpy(&date_val, data + time_bytes, 3);
+    date_val &= 0x00FFFFFF;
+    int16_t tz_offset;
+    std::memcpy(&tz_offset, data + time_bytes + 3, 2);
 
-    static const uint64_t scales[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
-    uint64_t ticks_per_sec = scales[scale];
-    uint64_t total_secs = time_val / ticks_per_sec;
-    uint64_t frac = time_val % ticks_per_sec;
+    // The stored date/time is UTC; print local time (UTC + offset) followed
+    // by the offset, as SQL Server does
+    const int64_t ticks_per_day = 86400 * static_cast<int64_t>(TICKS_PER_SEC[scale]);
+    int64_t days = date_val;
+    int64_t local = static_cast<int64_t>(read_time_ticks(data, time_bytes)) +
+                    tz_offset * 60 * static_cast<int64_t>(TICKS_PER_SEC[scale]);
+    if (local < 0)              { local += ticks_per_day; --days; }
+    else if (local >= ticks_per_day) { local -= ticks_per_day; ++days; }
+
+    char* p = put_datetime2(out, static_cast<int>(days), static_cast<uint64_t>(local), scale);
+    unsigned abs_offset = static_cast<unsigned>(tz_offset < 0 ? -tz_offset : tz_offset);
+    *p++ = tz_offset < 0 ? '-' : '+';
+    p = put2(p, abs_offset / 60 % 100);
+    *p++ = ':';
+    p = put2(p, abs_offset % 60);
+    return static_cast<size_t>(p - out);
+}
 
-    int hours   = static_cast<int>(total_secs / 3600);
-    int minutes = static_cast<int>((total_secs % 3600) / 60);
-    int seconds = static_cast<int>(total_secs % 60);
+std::string RowDecoder::decode_datetime(const uint8_t* data) {
+    char buf[FORMAT_BUF_SIZE];
+    return std::string(buf, format_datetime(data, buf));
+}
 
-    char buf[32];
-    if (scale > 0) {
-        snprintf(buf, sizeof(buf), "%02d:%02d:%02d.%0*llu",
-                 hours, minutes, seconds,
-                 scale, (unsigned long long)frac);
-    } else {
-        snprintf(buf, sizeof(buf), "%02d:%02d:%02d", hours, minutes, seconds);
-    }
-    return buf;
+std::string RowDecoder::decode_datetime2(const uint8_t* data, uint8_t scale) {
+    char buf[FORMAT_BUF_SIZE];
+    return std::string(buf, format_datetime2(data, scale, buf));
 }
 
-std::string RowDecoder::decode_datetimeoffset(const uint8_t* data, size_t len,
-                                               uint8_t scale) {
-    if (scale > 7) scale = 7;
-    int time_bytes = (scale <= 2) ? 3 : (scale <= 4) ? 4 : 5;
-    int total_needed = time_bytes + 3 + 2;  // time + date + offset
-    if (static_cast<int>(len) < total_needed) return "";
+std::string RowDecoder::decode_smalldatetime(const uint8_t* data) {
+    char buf[FORMAT_BUF_SIZE];
+    return std::string(buf, format_smalldatetime(data, buf));
+}
 
-    std::string dt = decode_datetime2(data, scale);
+std::string RowDecoder::decode_date(const uint8_t* data) {
+    char buf[FORMAT_BUF_SIZE];
+    return std::string(buf, format_date(data, buf));
+}
 
-    int16_t tz_offset;
-    std::memcpy(&tz_offset, data + time_bytes + 3, 2);
-    int tz_hours = tz_offset / 60;
-    int tz_mins  = std::abs(tz_offset % 60);
+std::string RowDecoder::decode_time(const uint8_t* data, size_t len, uint8_t scale) {
+    char buf[FORMAT_BUF_SIZE];
+    return std::string(buf, format_time(data, len, scale, buf));
+}
 
-    char buf[8];
-    snprintf(buf, sizeof(buf), "%+03d:%02d", tz_hours, tz_mins);
-    return dt + buf;
+std::string RowDecoder::decode_datetimeoffset(const uint8_t* data, size_t len,
+                                               uint8_t scale) {
+    char buf[FORMAT_BUF_SIZE];
+    return std::string(buf, format_datetimeoffset(data, len, scale, buf));
 }
 
 }  // namespace bakread
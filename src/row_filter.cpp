@@ -0,0 +1,521 @@
+#include "bakread/row_filter.h"
+#include "bakread/error.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace bakread {
+
+namespace {
+
+// -------------------------------------------------------------------------
+// Calendar helpers (proleptic Gregorian, Howard Hinnant's algorithm)
+// -------------------------------------------------------------------------
+
+// Days since 1970-01-01
+int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+constexpr int64_t DAYS_0001_TO_1970 = 719162;   // DATE / DATETIME2 epoch
+constexpr int64_t DAYS_1900_TO_1970 = 25567;    // DATETIME / SMALLDATETIME epoch
+
+constexpr int64_t POW10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+
+int time_bytes_for_scale(uint8_t scale) {
+    return (scale <= 2) ? 3 : (scale <= 4) ? 4 : 5;
+}
+
+// 'YYYY-MM-DD', 'YYYY-MM-DD HH:MM[:SS[.fffffff]]' (or 'T' separator),
+// or a bare 'HH:MM[:SS[.fffffff]]'. frac is in 100ns units.
+struct DateTimeLiteral {
+    bool    has_date = false;
+    int64_t days = 0;         // since 1970-01-01
+    int64_t seconds = 0;      // since midnight
+    int64_t frac = 0;         // 100ns units within the second
+};
+
+bool parse_number(const char*& p, int digits_min, int digits_max, int64_t& out) {
+    int n = 0;
+    out = 0;
+    while (n < digits_max && std::isdigit(static_cast<unsigned char>(*p))) {
+        out = out * 10 + (*p - '0');
+        ++p; ++n;
+    }
+    return n >= digits_min;
+}
+
+bool parse_time_part(const char*& p, DateTimeLiteral& lit) {
+    int64_t h, mi, s = 0;
+    if (!parse_number(p, 1, 2, h) || *p++ != ':') return false;
+    if (!parse_number(p, 2, 2, mi)) return false;
+    if (*p == ':') {
+        ++p;
+        if (!parse_number(p, 2, 2, s)) return false;
+        if (*p == '.') {
+            ++p;
+            int64_t scale = 1000000;  // first digit = 100ms = 1,000,000 * 100ns
+            bool any = false;
+            while (std::isdigit(static_cast<unsigned char>(*p))) {
+                lit.frac += (*p - '0') * scale;
+                scale /= 10;
+                ++p;
+                any = true;
+                if (scale == 0) {       // ignore digits past 100ns
+                    while (std::isdigit(static_cast<unsigned char>(*p))) ++p;
+                    break;
+                }
+            }
+            if (!any) return false;
+        }
+    }
+    if (h > 23 || mi > 59 || s > 59) return false;
+    lit.seconds = h * 3600 + mi * 60 + s;
+    return true;
+}
+
+bool parse_datetime_literal(const std::string& text, DateTimeLiteral& lit) {
+    const char* p = text.c_str();
+    while (*p == ' ') ++p;
+
+    const char* colon = std::strchr(p, ':');
+    const char* dash  = std::strchr(p, '-');
+    if (dash && (!colon || dash < colon)) {
+        int64_t y, m, d;
+        if (!parse_number(p, 4, 4, y) || *p++ != '-') return false;
+        if (!parse_number(p, 1, 2, m) || *p++ != '-') return false;
+        if (!parse_number(p, 1, 2, d)) return false;
+        if (m < 1 || m > 12 || d < 1 || d > 31) return false;
+        lit.has_date = true;
+        lit.days = days_from_civil(y, static_cast<unsigned>(m), static_cast<unsigned>(d));
+        if (*p == ' ' || *p == 'T') {
+            while (*p == ' ' || *p == 'T') ++p;
+            if (*p && !parse_time_part(p, lit)) return false;
+        }
+    } else if (!parse_time_part(p, lit)) {
+        return false;
+    }
+
+    while (*p == ' ') ++p;
+    return *p == '\0';
+}
+
+template <typename T>
+T load(const uint8_t* data) {
+    T v;
+    std::memcpy(&v, data, sizeof(T));
+    return v;
+}
+
+bool is_integer_type(SqlType t) {
+    return t == SqlType::TinyInt || t == SqlType::SmallInt || t == SqlType::Int ||
+           t == SqlType::BigInt || t == SqlType::Bit;
+}
+
+bool is_real_type(SqlType t) {
+    return t == SqlType::Real || t == SqlType::Float || t == SqlType::Money ||
+           t == SqlType::SmallMoney || t == SqlType::Decimal || t == SqlType::Numeric;
+}
+
+bool is_temporal_type(SqlType t) {
+    return t == SqlType::Date || t == SqlType::Time || t == SqlType::DateTime ||
+           t == SqlType::SmallDateTime || t == SqlType::DateTime2;
+}
+
+}  // namespace
+
+// -------------------------------------------------------------------------
+// Parser -- recursive descent over a small token stream
+// -------------------------------------------------------------------------
+
+class RowFilter::Parser {
+public:
+    Parser(RowFilter& filter, const std::string& text, const TableSchema& schema)
+        : f_(filter), schema_(schema)
+    {
+        tokenize(text);
+    }
+
+    int parse() {
+        int root = parse_or();
+        if (peek().kind != Tok::End) fail("unexpected '" + peek().text + "'");
+        return root;
+    }
+
+private:
+    struct Tok {
+        enum Kind { End, Ident, Number, String, Symbol } kind = End;
+        std::string text;
+    };
+
+    [[noreturn]] void fail(const std::string& why) const {
+        throw ConfigError("Cannot push --where down to direct mode: " + why);
+    }
+
+    void tokenize(const std::string& s) {
+        size_t i = 0;
+        while (i < s.size()) {
+            char c = s[i];
+            if (std::isspace(static_cast<unsigned char>(c))) { ++i; continue; }
+
+            Tok t;
+            if (c == '\'') {
+                t.kind = Tok::String;
+                ++i;
+                while (true) {
+                    if (i >= s.size()) fail("unterminated string literal");
+                    if (s[i] == '\'') {
+                        if (i + 1 < s.size() && s[i + 1] == '\'') { t.text += '\''; i += 2; continue; }
+                        ++i;
+                        break;
+                    }
+                    t.text += s[i++];
+                }
+            } else if (c == '[' || c == '"') {
+                char close = (c == '[') ? ']' : '"';
+                size_t end = s.find(close, i + 1);
+                if (end == std::string::npos) fail("unterminated identifier");
+                t.kind = Tok::Ident;
+                t.text = s.substr(i + 1, end - i - 1);
+                i = end + 1;
+            } else if (std::isdigit(static_cast<unsigned char>(c)) ||
+                       ((c == '-' || c == '+' || c == '.') && i + 1 < s.size() &&
+                        (std::isdigit(static_cast<unsigned char>(s[i + 1])) || s[i + 1] == '.'))) {
+                t.kind = Tok::Number;
+                size_t j = i + 1;
+                while (j < s.size() && (std::isdigit(static_cast<unsigned char>(s[j])) ||
+                                        s[j] == '.' || s[j] == 'e' || s[j] == 'E' ||
+                                        ((s[j] == '-' || s[j] == '+') &&
+                                         (s[j - 1] == 'e' || s[j - 1] == 'E'))))
+                    ++j;
+                t.text = s.substr(i, j - i);
+                i = j;
+            } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_' || c == '@' || c == '#') {
+                t.kind = Tok::Ident;
+                size_t j = i + 1;
+                while (j < s.size() && (std::isalnum(static_cast<unsigned char>(s[j])) ||
+                                        s[j] == '_' || s[j] == '@' || s[j] == '#' || s[j] == '$'))
+                    ++j;
+                t.text = s.substr(i, j - i);
+                i = j;
+            } else {
+                t.kind = Tok::Symbol;
+                static const char* two[] = {"<>", "!=", "<=", ">="};
+                t.text = std::string(1, c);
+                for (const char* op : two) {
+                    if (s.compare(i, 2, op) == 0) { t.text = op; break; }
+                }
+                if (t.text != "(" && t.text != ")" && t.text != "," && t.text != "=" &&
+                    t.text != "<" && t.text != ">" && t.text.size() != 2)
+                    fail("unsupported symbol '" + t.text + "'");
+                i += t.text.size();
+            }
+            toks_.push_back(std::move(t));
+        }
+        toks_.push_back(Tok{});
+    }
+
+    const Tok& peek() const { return toks_[pos_]; }
+    Tok next() { return toks_[pos_ < toks_.size() - 1 ? pos_++ : pos_]; }
+
+    static bool iequals(const std::string& a, const char* b) {
+        size_t n = std::strlen(b);
+        if (a.size() != n) return false;
+        for (size_t i = 0; i < n; ++i)
+            if (std::tolower(static_cast<unsigned char>(a[i])) != b[i]) return false;
+        return true;
+    }
+
+    bool accept_keyword(const char* kw) {
+        if (peek().kind == Tok::Ident && iequals(peek().text, kw)) { ++pos_; return true; }
+        return false;
+    }
+
+    bool accept_symbol(const char* sym) {
+        if (peek().kind == Tok::Symbol && peek().text == sym) { ++pos_; return true; }
+        return false;
+    }
+
+    void expect_symbol(const char* sym) {
+        if (!accept_symbol(sym)) fail(std::string("expected '") + sym + "'");
+    }
+
+    int add_node(Node::Kind kind, int left, int right = -1) {
+        Node n;
+        n.kind  = kind;
+        n.left  = left;
+        n.right = right;
+        f_.nodes_.push_back(n);
+        return static_cast<int>(f_.nodes_.size()) - 1;
+    }
+
+    int parse_or() {
+        int left = parse_and();
+        while (accept_keyword("or")) left = add_node(Node::Or, left, parse_and());
+        return left;
+    }
+
+    int parse_and() {
+        int left = parse_not();
+        while (accept_keyword("and")) left = add_node(Node::And, left, parse_not());
+        return left;
+    }
+
+    int parse_not() {
+        if (accept_keyword("not")) return add_node(Node::Not, parse_not());
+        if (accept_symbol("(")) {
+            int inner = parse_or();
+            expect_symbol(")");
+            return inner;
+        }
+        return parse_predicate();
+    }
+
+    int resolve_column(const std::string& name) const {
+        for (size_t i = 0; i < schema_.columns.size(); ++i) {
+            const std::string& c = schema_.columns[i].name;
+            if (c.size() == name.size() &&
+                std::equal(c.begin(), c.end(), name.begin(), [](char a, char b) {
+                    return std::tolower(static_cast<unsigned char>(a)) ==
+                           std::tolower(static_cast<unsigned char>(b));
+                }))
+                return static_cast<int>(i);
+        }
+        fail("unknown column '" + name + "'");
+    }
+
+    int parse_predicate() {
+        Tok name = next();
+        if (name.kind != Tok::Ident) fail("expected a column name");
+
+        Leaf leaf;
+        leaf.column = resolve_column(name.text);
+        const ColumnDef& col = schema_.columns[leaf.column];
+        leaf.type  = col.type;
+        leaf.scale = std::min<uint8_t>(col.scale, 7);
+        leaf.real  = is_real_type(col.type);
+
+        if (accept_keyword("is")) {
+            bool neg = accept_keyword("not");
+            if (!accept_keyword("null")) fail("expected NULL after IS");
+            leaf.op = neg ? Op::IsNotNull : Op::IsNull;
+            return add_leaf(std::move(leaf));
+        }
+
+        if (!is_integer_type(col.type) && !is_real_type(col.type) &&
+            !is_temporal_type(col.type))
+            fail("comparisons on column '" + col.name + "' (type " +
+                 std::to_string(static_cast<int>(col.type)) + ") are not supported");
+
+        bool neg = accept_keyword("not");
+        if (accept_keyword("in")) {
+            leaf.op = Op::In;
+            leaf.negate = neg;
+            expect_symbol("(");
+            do {
+                leaf.keys.push_back(literal(col));
+            } while (accept_symbol(","));
+            expect_symbol(")");
+        } else if (accept_keyword("between")) {
+            leaf.op = Op::Between;
+            leaf.negate = neg;
+            leaf.keys.push_back(literal(col));
+            if (!accept_keyword("and")) fail("expected AND in BETWEEN");
+            leaf.keys.push_back(literal(col));
+        } else {
+            if (neg) fail("expected IN or BETWEEN after NOT");
+            Tok op = next();
+            if (op.kind != Tok::Symbol) fail("expected a comparison operator");
+            if      (op.text == "=")                     leaf.op = Op::Eq;
+            else if (op.text == "<>" || op.text == "!=") leaf.op = Op::Ne;
+            else if (op.text == "<")                     leaf.op = Op::Lt;
+            else if (op.text == "<=")                    leaf.op = Op::Le;
+            else if (op.text == ">")                     leaf.op = Op::Gt;
+            else if (op.text == ">=")                    leaf.op = Op::Ge;
+            else fail("unsupported operator '" + op.text + "'");
+            leaf.keys.push_back(literal(col));
+        }
+        return add_leaf(std::move(leaf));
+    }
+
+    int add_leaf(Leaf&& leaf) {
+        if (std::find(f_.columns_.begin(), f_.columns_.end(), leaf.column) == f_.columns_.end())
+            f_.columns_.push_back(leaf.column);
+        f_.leaves_.push_back(std::move(leaf));
+        int n = add_node(Node::Pred, -1);
+        f_.nodes_[n].leaf = static_cast<int>(f_.leaves_.size()) - 1;
+        return n;
+    }
+
+    // Convert a literal into the comparable key of the column's on-disk form
+    Key literal(const ColumnDef& col) {
+        Tok t = next();
+        if (t.kind == Tok::Ident && iequals(t.text, "null"))
+            fail("comparison with NULL is never true; use IS NULL");
+        if (t.kind != Tok::Number && t.kind != Tok::String) fail("expected a literal");
+
+        Key key;
+        if (is_integer_type(col.type)) {
+            char* end = nullptr;
+            long long v = std::strtoll(t.text.c_str(), &end, 10);
+            if (!end || *end != '\0') fail("'" + t.text + "' is not an integer");
+            key.i = v;
+        } else if (is_real_type(col.type)) {
+            char* end = nullptr;
+            key.r = std::strtold(t.text.c_str(), &end);
+            if (!end || *end != '\0') fail("'" + t.text + "' is not a number");
+        } else {
+            if (t.kind != Tok::String) fail("temporal literals must be quoted");
+            DateTimeLiteral lit;
+            if (!parse_datetime_literal(t.text, lit))
+                fail("cannot parse '" + t.text + "' as a date/time");
+            key.i = temporal_key(col, lit);
+        }
+        return key;
+    }
+
+    // Same scale as RowFilter::eval_leaf reads from the record
+    int64_t temporal_key(const ColumnDef& col, const DateTimeLiteral& lit) const {
+        uint8_t scale = std::min<uint8_t>(col.scale, 7);
+        switch (col.type) {
+        case SqlType::Date:
+            return lit.days + DAYS_0001_TO_1970;
+        case SqlType::DateTime: {
+            // 1/300 second ticks, rounded like SQL Server's conversion
+            int64_t ticks = lit.seconds * 300 + (lit.frac * 3 + 50000) / 100000;
+            return (lit.days + DAYS_1900_TO_1970) * 300 * 86400 + ticks;
+        }
+        case SqlType::SmallDateTime:
+            // Compared in seconds so a literal's seconds are not rounded away
+            return (lit.days + DAYS_1900_TO_1970) * 86400 + lit.seconds;
+        case SqlType::DateTime2:
+        case SqlType::Time: {
+            int64_t unit  = POW10[7 - scale];          // 100ns per tick
+            int64_t ticks = lit.seconds * POW10[scale] + (lit.frac + unit / 2) / unit;
+            if (col.type == SqlType::Time) return ticks;
+            return (lit.days + DAYS_0001_TO_1970) * 86400 * POW10[scale] + ticks;
+        }
+        default:
+            return 0;
+        }
+    }
+
+    RowFilter&         f_;
+    const TableSchema& schema_;
+    std::vector<Tok>   toks_;
+    size_t             pos_ = 0;
+};
+
+// -------------------------------------------------------------------------
+// RowFilter
+// -------------------------------------------------------------------------
+
+RowFilter::RowFilter(const std::string& condition, const TableSchema& schema)
+    : text_(condition)
+{
+    Parser parser(*this, condition, schema);
+    root_ = parser.parse();
+}
+
+RowFilter::Truth RowFilter::eval_leaf(const Leaf& leaf, const uint8_t* data,
+                                      size_t len) const {
+    if (leaf.op == Op::IsNull)    return data ? Truth::False : Truth::True;
+    if (leaf.op == Op::IsNotNull) return data ? Truth::True : Truth::False;
+    if (!data || len == 0) return Truth::Unknown;
+
+    // Read the cell into the same form as the literal keys
+    Key v;
+    switch (leaf.type) {
+    case SqlType::TinyInt:  v.i = data[0]; break;
+    case SqlType::Bit:      v.i = data[0] != 0; break;
+    case SqlType::SmallInt: if (len < 2) return Truth::Unknown; v.i = load<int16_t>(data); break;
+    case SqlType::Int:      if (len < 4) return Truth::Unknown; v.i = load<int32_t>(data); break;
+    case SqlType::BigInt:   if (len < 8) return Truth::Unknown; v.i = load<int64_t>(data); break;
+    case SqlType::Real:     if (len < 4) return Truth::Unknown; v.r = load<float>(data); break;
+    case SqlType::Float:    if (len < 8) return Truth::Unknown; v.r = load<double>(data); break;
+    case SqlType::Money: {
+        if (len < 8) return Truth::Unknown;
+        int64_t combined = (static_cast<int64_t>(load<int32_t>(data)) << 32) |
+                           load<uint32_t>(data + 4);
+        v.r = static_cast<long double>(combined) / 10000;
+        break;
+    }
+    case SqlType::SmallMoney:
+        if (len < 4) return Truth::Unknown;
+        v.r = static_cast<long double>(load<int32_t>(data)) / 10000;
+        break;
+    case SqlType::Decimal:
+    case SqlType::Numeric: {
+        // sign byte, then a little-endian magnitude of up to 16 bytes
+        long double mag = 0;
+        for (size_t b = std::min<size_t>(len - 1, 16); b > 0; --b)
+            mag = mag * 256 + data[b];
+        mag /= std::pow(10.0L, leaf.scale);
+        v.r = data[0] ? mag : -mag;
+        break;
+    }
+    case SqlType::Date:
+        if (len < 3) return Truth::Unknown;
+        v.i = data[0] | (data[1] << 8) | (data[2] << 16);
+        break;
+    case SqlType::DateTime:
+        if (len < 8) return Truth::Unknown;
+        v.i = static_cast<int64_t>(load<int32_t>(data)) * 300 * 86400 + load<int32_t>(data + 4);
+        break;
+    case SqlType::SmallDateTime:
+        if (len < 4) return Truth::Unknown;
+        v.i = static_cast<int64_t>(load<uint16_t>(data)) * 86400 +
+              static_cast<int64_t>(load<uint16_t>(data + 2)) * 60;
+        break;
+    case SqlType::Time:
+    case SqlType::DateTime2: {
+        int tb = time_bytes_for_scale(leaf.scale);
+        size_t need = tb + (leaf.type == SqlType::DateTime2 ? 3 : 0);
+        if (len < need) return Truth::Unknown;
+        int64_t ticks = 0;
+        for (int b = tb - 1; b >= 0; --b) ticks = (ticks << 8) | data[b];
+        if (leaf.type == SqlType::Time) { v.i = ticks; break; }
+        int64_t days = data[tb] | (data[tb + 1] << 8) | (data[tb + 2] << 16);
+        v.i = days * 86400 * POW10[leaf.scale] + ticks;
+        break;
+    }
+    default:
+        return Truth::Unknown;
+    }
+
+    auto cmp = [&](const Key& k) -> int {
+        if (leaf.real) return (v.r < k.r) ? -1 : (v.r > k.r) ? 1 : 0;
+        return (v.i < k.i) ? -1 : (v.i > k.i) ? 1 : 0;
+    };
+
+    bool result = false;
+    switch (leaf.op) {
+    case Op::Eq: result = cmp(leaf.keys[0]) == 0; break;
+    case Op::Ne: result = cmp(leaf.keys[0]) != 0; break;
+    case Op::Lt: result = cmp(leaf.keys[0]) <  0; break;
+    case Op::Le: result = cmp(leaf.keys[0]) <= 0; break;
+    case Op::Gt: result = cmp(leaf.keys[0]) >  0; break;
+    case Op::Ge: result = cmp(leaf.keys[0]) >= 0; break;
+    case Op::In:
+        result = std::any_of(leaf.keys.begin(), leaf.keys.end(),
+                             [&](const Key& k) { return cmp(k) == 0; });
+        break;
+    case Op::Between:
+        result = cmp(leaf.keys[0]) >= 0 && cmp(leaf.keys[1]) <= 0;
+        break;
+    default:
+        break;
+    }
+    if (leaf.negate) result = !result;
+    return result ? Truth::True : Truth::False;
+}
+
+}  // namespace bakread
@@ -0,0 +1,278 @@
+#include "bakread/run_stats.h"
+#include "bakread/json_writer.h"
+#include "bakread/logging.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+namespace bakread {
+
+// -------------------------------------------------------------------------
+// CPU clocks
+// -------------------------------------------------------------------------
+
+#ifdef _WIN32
+static double filetime_seconds(const FILETIME& ft) {
+    ULARGE_INTEGER v;
+    v.LowPart  = ft.dwLowDateTime;
+    v.HighPart = ft.dwHighDateTime;
+    return static_cast<double>(v.QuadPart) / 1e7;   // 100ns units
+}
+
+double process_cpu_seconds() {
+    FILETIME created, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0.0;
+    return filetime_seconds(kernel) + filetime_seconds(user);
+}
+
+double thread_cpu_seconds() {
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user)) return 0.0;
+    return filetime_seconds(kernel) + filetime_seconds(user);
+}
+#else
+double process_cpu_seconds() {
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0.0;
+    return static_cast<double>(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) +
+           static_cast<double>(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+double thread_cpu_seconds() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0.0;
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+}
+#endif
+
+// -------------------------------------------------------------------------
+// Timer
+// -------------------------------------------------------------------------
+
+RunStats::Timer::Timer(RunStats* stats, const char* stage)
+    : stats_(stats)
+    , stage_(stage)
+{
+    if (!stats_) return;
+    start_     = std::chrono::steady_clock::now();
+    cpu_start_ = process_cpu_seconds();
+}
+
+RunStats::Timer::~Timer() {
+    if (!stats_) return;
+    s_.wall_seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_).count();
+    s_.cpu_seconds  = process_cpu_seconds() - cpu_start_;
+    s_.calls = 1;
+    stats_->add_stage(stage_, s_);
+}
+
+// -------------------------------------------------------------------------
+// RunStats
+// -------------------------------------------------------------------------
+
+void RunStats::add_stage(const std::string& name, const StageStats& s) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = std::find_if(stages_.begin(), stages_.end(),
+                           [&](const Stage& st) { return st.name == name; });
+    if (it == stages_.end()) {
+        stages_.push_back({name, s});
+        return;
+    }
+    it->s.wall_seconds += s.wall_seconds;
+    it->s.cpu_seconds  += s.cpu_seconds;
+    it->s.calls += s.calls;
+    it->s.rows  += s.rows;
+    it->s.bytes += s.bytes;
+    it->s.pages += s.pages;
+}
+
+void RunStats::add_scan(const ScanStats& s) {
+    std::lock_guard<std::mutex> lk(mu_);
+    scan_.bytes_read   += s.bytes_read;
+    scan_.slots_tested += s.slots_tested;
+    scan_.pages_valid  += s.pages_valid;
+    scan_.pages_kept   += s.pages_kept;
+}
+
+void RunStats::set_cache(const std::string& name, uint64_t hits, uint64_t misses) {
+    std::lock_guard<std::mutex> lk(mu_);
+    for (auto& c : caches_) {
+        if (c.name == name) {
+            c.hits   = hits;
+            c.misses = misses;
+            return;
+        }
+    }
+    caches_.push_back({name, hits, misses});
+}
+
+void RunStats::set_page_store(const PageStoreStats& s) {
+    std::lock_guard<std::mutex> lk(mu_);
+    page_store_     = s;
+    has_page_store_ = true;
+}
+
+void RunStats::add_queue(const std::string& name, const QueueStats& q) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = std::find_if(queues_.begin(), queues_.end(),
+                           [&](const Queue& qu) { return qu.name == name; });
+    if (it == queues_.end()) {
+        queues_.push_back({name, q});
+        return;
+    }
+    it->q.capacity   = std::max(it->q.capacity, q.capacity);
+    it->q.high_water = std::max(it->q.high_water, q.high_water);
+    it->q.batches   += q.batches;
+    it->q.producer_wait_seconds += q.producer_wait_seconds;
+    it->q.consumer_wait_seconds += q.consumer_wait_seconds;
+}
+
+void RunStats::set_result(bool success, const std::string& mode, const std::string& error,
+                          uint64_t rows, double elapsed_seconds) {
+    std::lock_guard<std::mutex> lk(mu_);
+    success_         = success;
+    mode_            = mode;
+    error_           = error;
+    rows_            = rows;
+    elapsed_seconds_ = elapsed_seconds;
+    cpu_seconds_     = process_cpu_seconds() - cpu_start_;
+}
+
+void RunStats::reset() {
+    std::lock_guard<std::mutex> lk(mu_);
+    stages_.clear();
+    scan_ = ScanStats{};
+    caches_.clear();
+    page_store_     = PageStoreStats{};
+    has_page_store_ = false;
+    queues_.clear();
+    success_ = false;
+    mode_.clear();
+    error_.clear();
+    rows_            = 0;
+    elapsed_seconds_ = 0.0;
+    cpu_seconds_     = 0.0;
+    cpu_start_       = process_cpu_seconds();
+}
+
+// Fixed-point number for the report (JSON has no NaN/inf)
+static std::string num(double v, int decimals) {
+    if (!(v >= 0.0 && v < 1e18)) v = 0.0;
+    char buf[40];
+    std::snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    return buf;
+}
+
+static double per_second(double amount, double seconds) {
+    return seconds > 0.0 ? amount / seconds : 0.0;
+}
+
+std::string RunStats::to_json() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    std::string out;
+    auto field = [&](const char* name, const std::string& value, bool last = false) {
+        out += "\"";
+        out += name;
+        out += "\": ";
+        out += value;
+        if (!last) out += ", ";
+    };
+    auto str = [](const std::string& s) { return "\"" + JsonWriter::escape_json(s) + "\""; };
+    auto u64 = [](uint64_t v) { return std::to_string(v); };
+
+    out += "{\n  ";
+    field("success", success_ ? "true" : "false");
+    field("mode", str(mode_));
+    field("error", str(error_), true);
+    out += ",\n  ";
+    field("rows", u64(rows_));
+    field("elapsed_seconds", num(elapsed_seconds_, 4));
+    field("cpu_seconds", num(cpu_seconds_, 4));
+    field("rows_per_second", num(per_second(static_cast<double>(rows_), elapsed_seconds_), 1),
+          true);
+    out += ",\n  \"stages\": [";
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        const StageStats& s = stages_[i].s;
+        out += i > 0 ? ",\n    {" : "\n    {";
+        field("name", str(stages_[i].name));
+        field("calls", u64(s.calls));
+        field("wall_seconds", num(s.wall_seconds, 4));
+        field("cpu_seconds", num(s.cpu_seconds, 4));
+        field("rows", u64(s.rows));
+        field("bytes", u64(s.bytes));
+        field("pages", u64(s.pages));
+        field("rows_per_second",
+              num(per_second(static_cast<double>(s.rows), s.wall_seconds), 1));
+        field("mb_per_second",
+              num(per_second(static_cast<double>(s.bytes) / (1024.0 * 1024.0), s.wall_seconds), 2),
+              true);
+        out += "}";
+    }
+    out += stages_.empty() ? "],\n  " : "\n  ],\n  ";
+
+    out += "\"scan\": {";
+    field("bytes_read", u64(scan_.bytes_read));
+    field("slots_tested", u64(scan_.slots_tested));
+    field("pages_valid", u64(scan_.pages_valid));
+    field("pages_rejected", u64(scan_.slots_tested - std::min(scan_.slots_tested, scan_.pages_valid)));
+    field("pages_kept", u64(scan_.pages_kept), true);
+    out += "},\n  \"caches\": [";
+    for (size_t i = 0; i < caches_.size(); ++i) {
+        const CacheStats& c = caches_[i];
+        uint64_t lookups = c.hits + c.misses;
+        out += i > 0 ? ",\n    {" : "\n    {";
+        field("name", str(c.name));
+        field("hits", u64(c.hits));
+        field("misses", u64(c.misses));
+        field("hit_rate", num(lookups > 0 ? static_cast<double>(c.hits) / lookups : 0.0, 4), true);
+        out += "}";
+    }
+    out += caches_.empty() ? "],\n  " : "\n  ],\n  ";
+
+    if (has_page_store_) {
+        out += "\"page_store\": {";
+        field("pages", u64(page_store_.pages));
+        field("resident_pages", u64(page_store_.resident_pages));
+        field("referenced_pages", u64(page_store_.referenced_pages));
+        field("spilled_pages", u64(page_store_.spilled_pages));
+        field("memory_bytes", u64(page_store_.memory_bytes), true);
+        out += "},\n  ";
+    }
+
+    out += "\"queues\": [";
+    for (size_t i = 0; i < queues_.size(); ++i) {
+        const QueueStats& q = queues_[i].q;
+        out += i > 0 ? ",\n    {" : "\n    {";
+        field("name", str(queues_[i].name));
+        field("capacity", u64(q.capacity));
+        field("high_water", u64(q.high_water));
+        field("batches", u64(q.batches));
+        field("producer_wait_seconds", num(q.producer_wait_seconds, 4));
+        field("consumer_wait_seconds", num(q.consumer_wait_seconds, 4), true);
+        out += "}";
+    }
+    out += queues_.empty() ? "]\n}\n" : "\n  ]\n}\n";
+    return out;
+}
+
+bool RunStats::write_json(const std::string& path) const {
+    std::string json = to_json();
+    std::ofstream out(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!out.is_open() || !out.write(json.data(), static_cast<std::streamsize>(json.size()))) {
+        LOG_ERROR("Cannot write stats report: %s", path.c_str());
+        return false;
+    }
+    LOG_INFO("Stats report written to %s", path.c_str());
+    return true;
+}
+
+}  // namespace bakread
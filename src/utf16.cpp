@@ -0,0 +1,189 @@
+#include "bakread/utf16.h"
+#include "bakread/cpu_features.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BAKREAD_UTF16_SSE2 1
+#endif
+
+#ifdef BAKREAD_HAS_AVX2_KERNELS
+#include <immintrin.h>
+#define BAKREAD_UTF16_AVX2 1
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define BAKREAD_UTF16_NEON 1
+#endif
+
+namespace bakread {
+
+// -------------------------------------------------------------------------
+// Scalar conversion
+// -------------------------------------------------------------------------
+
+// Convert the code units at byte offsets [i, stop); a surrogate pair that
+// starts before stop is consumed whole, so i may end up past stop.
+// Returns false once a NUL code unit ends the string.
+static inline bool convert_units(const uint8_t* data, size_t byte_len,
+                                 size_t& i, size_t stop, char*& p) {
+    for (; i < stop && i + 1 < byte_len; i += 2) {
+        uint16_t ch = static_cast<uint16_t>(data[i]) |
+                      (static_cast<uint16_t>(data[i+1]) << 8);
+        if (ch == 0) return false;
+
+        if (ch < 0x80) {
+            *p++ = static_cast<char>(ch);
+        } else if (ch < 0x800) {
+            *p++ = static_cast<char>(0xC0 | (ch >> 6));
+            *p++ = static_cast<char>(0x80 | (ch & 0x3F));
+        } else {
+            // Handle surrogate pairs for characters outside BMP
+            if (ch >= 0xD800 && ch <= 0xDBFF && i + 3 < byte_len) {
+                uint16_t low = static_cast<uint16_t>(data[i+2]) |
+                               (static_cast<uint16_t>(data[i+3]) << 8);
+                if (low >= 0xDC00 && low <= 0xDFFF) {
+                    uint32_t cp = 0x10000 + ((ch - 0xD800) << 10) + (low - 0xDC00);
+                    *p++ = static_cast<char>(0xF0 | (cp >> 18));
+                    *p++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                    *p++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    *p++ = static_cast<char>(0x80 | (cp & 0x3F));
+                    i += 2;
+                    continue;
+                }
+            }
+            *p++ = static_cast<char>(0xE0 | (ch >> 12));
+            *p++ = static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+            *p++ = static_cast<char>(0x80 | (ch & 0x3F));
+        }
+    }
+    return true;
+}
+
+size_t utf16le_to_utf8_scalar(const uint8_t* data, size_t byte_len, char* out) {
+    char* p = out;
+    size_t i = 0;
+    convert_units(data, byte_len, i, byte_len, p);
+    return static_cast<size_t>(p - out);
+}
+
+// -------------------------------------------------------------------------
+// SIMD kernels: a block whose code units are all in 1..0x7F is narrowed
+// to bytes in one store; any other block goes through convert_units
+// -------------------------------------------------------------------------
+
+#ifdef BAKREAD_UTF16_SSE2
+// 16 code units per step
+static size_t utf16le_to_utf8_sse2(const uint8_t* data, size_t byte_len, char* out) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i high = _mm_set1_epi16(static_cast<short>(0xFF80));
+    char* p = out;
+    size_t i = 0;
+    while (i + 32 <= byte_len) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 16));
+        __m128i non_ascii = _mm_and_si128(_mm_or_si128(a, b), high);
+        __m128i nul = _mm_or_si128(_mm_cmpeq_epi16(a, zero), _mm_cmpeq_epi16(b, zero));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, zero)) == 0xFFFF &&
+            _mm_movemask_epi8(nul) == 0) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(a, b));
+            p += 16;
+            i += 32;
+        } else if (!convert_units(data, byte_len, i, i + 32, p)) {
+            return static_cast<size_t>(p - out);
+        }
+    }
+    convert_units(data, byte_len, i, byte_len, p);
+    return static_cast<size_t>(p - out);
+}
+#endif
+
+#ifdef BAKREAD_UTF16_AVX2
+// 32 code units per step
+BAKREAD_TARGET_AVX2
+static size_t utf16le_to_utf8_avx2(const uint8_t* data, size_t byte_len, char* out) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i high = _mm256_set1_epi16(static_cast<short>(0xFF80));
+    char* p = out;
+    size_t i = 0;
+    while (i + 64 <= byte_len) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        __m256i non_ascii = _mm256_and_si256(_mm256_or_si256(a, b), high);
+        __m256i nul = _mm256_or_si256(_mm256_cmpeq_epi16(a, zero), _mm256_cmpeq_epi16(b, zero));
+        if (_mm256_testz_si256(non_ascii, non_ascii) && _mm256_testz_si256(nul, nul)) {
+            // packus interleaves 128-bit lanes (a0 b0 a1 b1); restore a0 a1 b0 b1
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), packed);
+            p += 32;
+            i += 64;
+        } else if (!convert_units(data, byte_len, i, i + 64, p)) {
+            return static_cast<size_t>(p - out);
+        }
+    }
+    convert_units(data, byte_len, i, byte_len, p);
+    return static_cast<size_t>(p - out);
+}
+#endif
+
+#ifdef BAKREAD_UTF16_NEON
+// 16 code units per step
+static size_t utf16le_to_utf8_neon(const uint8_t* data, size_t byte_len, char* out) {
+    char* p = out;
+    size_t i = 0;
+    while (i + 32 <= byte_len) {
+        uint16x8_t a = vreinterpretq_u16_u8(vld1q_u8(data + i));
+        uint16x8_t b = vreinterpretq_u16_u8(vld1q_u8(data + i + 16));
+        if (vmaxvq_u16(vorrq_u16(a, b)) < 0x80 && vminvq_u16(vminq_u16(a, b)) != 0) {
+            vst1q_u8(reinterpret_cast<uint8_t*>(p), vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+            p += 16;
+            i += 32;
+        } else if (!convert_units(data, byte_len, i, i + 32, p)) {
+            return static_cast<size_t>(p - out);
+        }
+    }
+    convert_units(data, byte_len, i, byte_len, p);
+    return static_cast<size_t>(p - out);
+}
+#endif
+
+// -------------------------------------------------------------------------
+// Dispatch
+// -------------------------------------------------------------------------
+
+namespace {
+
+struct Utf16Kernel {
+    size_t (*fn)(const uint8_t*, size_t, char*);
+    const char* name;
+};
+
+Utf16Kernel select_kernel() {
+#ifdef BAKREAD_UTF16_AVX2
+    if (cpu_has_avx2()) return {utf16le_to_utf8_avx2, "avx2"};
+#endif
+#ifdef BAKREAD_UTF16_SSE2
+    return {utf16le_to_utf8_sse2, "sse2"};
+#elif defined(BAKREAD_UTF16_NEON)
+    return {utf16le_to_utf8_neon, "neon"};
+#else
+    return {utf16le_to_utf8_scalar, "scalar"};
+#endif
+}
+
+const Utf16Kernel& kernel() {
+    static const Utf16Kernel k = select_kernel();
+    return k;
+}
+
+}  // namespace
+
+size_t utf16le_to_utf8(const uint8_t* data, size_t byte_len, char* out) {
+    return kernel().fn(data, byte_len, out);
+}
+
+const char* utf16_kernel_name() {
+    return kernel().name;
+}
+
+}  // namespace bakread
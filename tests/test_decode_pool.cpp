@@ -0,0 +1,92 @@
+// Direct extraction with a parallel decode pool whose sink throws: the
+// exception must reach the caller (as a failed result) after the decode
+// workers have been joined, not abort the process.
+
+#include "bench_synthetic.h"
+
+#include "bakread/direct_extractor.h"
+#include "bakread/logging.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace bakread;
+using namespace bakread::bench;
+
+namespace {
+
+class DecodePoolTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        Logger::instance().set_level(LogLevel::Error);
+        dir_ = std::filesystem::temp_directory_path() / "bakread_decode_pool_test";
+        BackupTemplate t;
+        t.rows_per_table = 50000;   // Enough pages for several batches per worker
+        t.stripes        = 2;
+        paths_ = write_synthetic_backup(dir_.string(), t);
+    }
+
+    static void TearDownTestSuite() {
+        std::error_code ec;
+        std::filesystem::remove_all(dir_, ec);
+    }
+
+    static DirectExtractorConfig config(bool preserve_order) {
+        DirectExtractorConfig c;
+        c.catalog_cache  = false;
+        c.decode_workers = 4;
+        c.preserve_order = preserve_order;
+        return c;
+    }
+
+    static std::filesystem::path    dir_;
+    static std::vector<std::string> paths_;
+};
+
+std::filesystem::path    DecodePoolTest::dir_;
+std::vector<std::string> DecodePoolTest::paths_;
+
+}  // namespace
+
+TEST_F(DecodePoolTest, ThrowingRowSinkFailsCleanly) {
+    for (bool ordered : {true, false}) {
+        DirectExtractor extractor(paths_, config(ordered));
+        extractor.set_table("dbo", synthetic_table_name(0));
+        uint64_t seen = 0;
+        auto result = extractor.extract([&](const Row&) -> bool {
+            if (++seen == 10) throw std::runtime_error("sink failed");
+            return true;
+        });
+        EXPECT_FALSE(result.success);
+        EXPECT_NE(result.error_message.find("sink failed"), std::string::npos);
+    }
+}
+
+TEST_F(DecodePoolTest, ThrowingBatchSinkFailsCleanly) {
+    for (bool ordered : {true, false}) {
+        DirectExtractor extractor(paths_, config(ordered));
+        extractor.set_table("dbo", synthetic_table_name(0));
+        auto result = extractor.extract_columns([](const ColumnBatch&) -> bool {
+            throw std::runtime_error("sink failed");
+        });
+        EXPECT_FALSE(result.success);
+        EXPECT_NE(result.error_message.find("sink failed"), std::string::npos);
+    }
+}
+
+TEST_F(DecodePoolTest, ExtractorReusableAfterSinkFailure) {
+    DirectExtractor extractor(paths_, config(true));
+    extractor.set_table("dbo", synthetic_table_name(0));
+    auto failed = extractor.extract([](const Row&) -> bool {
+        throw std::runtime_error("sink failed");
+    });
+    EXPECT_FALSE(failed.success);
+
+    auto result = extractor.extract([](const Row&) { return true; });
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.rows_read, 50000u);
+}